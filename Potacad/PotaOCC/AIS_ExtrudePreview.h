@@ -0,0 +1,210 @@
+#pragma once
+#include <AIS_InteractiveObject.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager3d.hxx>
+#include <Graphic3d_AttribBuffer.hxx>
+#include <Graphic3d_IndexBuffer.hxx>
+#include <Graphic3d_BoundBuffer.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_AspectFillArea3d.hxx>
+#include <Graphic3d_MaterialAspect.hxx>
+#include <Graphic3d_Vec3.hxx>
+#include <Quantity_Color.hxx>
+#include <SelectMgr_Selection.hxx>
+#include "ProfileMesh.h"
+#include <Bnd_Box.hxx>
+#include <TopoDS_Face.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Pnt.hxx>
+#include <algorithm>
+#include <vector>
+
+// Extrusion preview built from the profile mesh once per wire.
+// The base cap and the bottom of the side walls never change; SetHeight() only rewrites the
+// top-cap and wall-top vertices in a mutable attribute buffer, so dragging the height costs
+// one partial buffer upload per frame instead of a prism + re-mesh.
+class AIS_ExtrudePreview : public AIS_InteractiveObject
+{
+public:
+    AIS_ExtrudePreview(const TopoDS_Face& face, const gp_Dir& normal)
+        : myNormal(normal), myHeight(0.0), myBoxHeight(0.0), myNbStatic(0)
+    {
+        ProfileMesh profile;
+        if (profile.Build(face))
+        {
+            myBase = std::move(profile.nodes);
+            myCapTriangles = std::move(profile.triangles);
+            mySegments = std::move(profile.segments);
+        }
+    }
+
+    bool IsValid() const { return !myBase.empty(); }
+
+    // Returns true when the presentation must be recomputed (height outgrew the cached bounding box)
+    bool SetHeight(double height)
+    {
+        const bool isFlipped = (height < 0.0) != (myHeight < 0.0);
+        myHeight = height;
+        if (myAttribs.IsNull())
+            return true;
+
+        WriteDynamicVertices(isFlipped);
+        if (std::abs(height) > myBoxHeight)
+        {
+            myBoxHeight = 2.0 * std::abs(height);
+            return true;
+        }
+        return false;
+    }
+
+    virtual void Compute(
+        const Handle(PrsMgr_PresentationManager3d)& /*thePM*/,
+        const Handle(Prs3d_Presentation)& thePresentation,
+        const Standard_Integer /*theMode*/) override
+    {
+        if (myBase.empty())
+            return;
+        if (myAttribs.IsNull())
+            BuildBuffers();
+        myBoxHeight = std::max(myBoxHeight, std::abs(myHeight));
+
+        Handle(Graphic3d_AspectFillArea3d) asp = new Graphic3d_AspectFillArea3d();
+        Graphic3d_MaterialAspect mat(Graphic3d_NameOfMaterial_Plastified);
+        mat.SetColor(Quantity_Color(Quantity_NOC_PINK));
+        asp->SetFrontMaterial(mat);
+        asp->SetBackMaterial(mat);
+        asp->SetInteriorStyle(Aspect_IS_SOLID);
+        asp->SetFaceCulling(Graphic3d_TypeOfBackfacingModel_DoubleSided);
+
+        Handle(Graphic3d_Group) aGroup = thePresentation->NewGroup();
+        aGroup->SetGroupPrimitivesAspect(asp);
+        aGroup->AddPrimitiveArray(Graphic3d_TOPA_TRIANGLES, myIndices, myAttribs, Handle(Graphic3d_BoundBuffer)(), Standard_False);
+
+        // Bounds cover heights up to myBoxHeight either way, so growing the preview does not need a recompute
+        const gp_Vec offset = gp_Vec(myNormal) * myBoxHeight;
+        Bnd_Box box;
+        for (const gp_Pnt& p : myBase)
+        {
+            box.Add(p.Translated(offset));
+            box.Add(p.Translated(-offset));
+        }
+        Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+        box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+        aGroup->SetMinMaxValues(xmin, ymin, zmin, xmax, ymax, zmax);
+    }
+
+    // Preview is display-only
+    virtual void ComputeSelection(
+        const Handle(SelectMgr_Selection)& /*theSelection*/,
+        const Standard_Integer /*theMode*/) override
+    {
+    }
+
+private:
+    void BuildBuffers()
+    {
+        const int nbCap = (int)myBase.size();
+        const int nbSeg = (int)mySegments.size() / 2;
+
+        // Static vertices: bottom cap, then wall bottoms (2 per segment).
+        // Dynamic vertices: top cap, then wall tops (2 per segment).
+        myNbStatic = nbCap + 2 * nbSeg;
+        const int nbVerts = 2 * myNbStatic;
+
+        Graphic3d_Attribute attribs[2] = { { Graphic3d_TOA_POS, Graphic3d_TOD_VEC3 }, { Graphic3d_TOA_NORM, Graphic3d_TOD_VEC3 } };
+        myAttribs = new Graphic3d_AttribBuffer(Graphic3d_Buffer::DefaultAllocator());
+        myAttribs->Init(nbVerts, attribs, 2);
+        myAttribs->SetMutable(Standard_True);
+
+        for (int i = 0; i < nbCap; ++i)
+            SetPosition(i, myBase[i]);
+        for (int s = 0; s < nbSeg; ++s)
+        {
+            SetPosition(nbCap + 2 * s, myBase[mySegments[2 * s]]);
+            SetPosition(nbCap + 2 * s + 1, myBase[mySegments[2 * s + 1]]);
+        }
+
+        const int nbIndices = 2 * (int)myCapTriangles.size() + 6 * nbSeg;
+        myIndices = new Graphic3d_IndexBuffer(Graphic3d_Buffer::DefaultAllocator());
+        myIndices->InitInt32(nbIndices);
+        int k = 0;
+        for (size_t t = 0; t < myCapTriangles.size(); t += 3)
+        {
+            // Bottom cap faces away from the extrusion, top cap towards it
+            myIndices->SetIndex(k++, myCapTriangles[t]);
+            myIndices->SetIndex(k++, myCapTriangles[t + 2]);
+            myIndices->SetIndex(k++, myCapTriangles[t + 1]);
+            myIndices->SetIndex(k++, myNbStatic + myCapTriangles[t]);
+            myIndices->SetIndex(k++, myNbStatic + myCapTriangles[t + 1]);
+            myIndices->SetIndex(k++, myNbStatic + myCapTriangles[t + 2]);
+        }
+        for (int s = 0; s < nbSeg; ++s)
+        {
+            const int a0 = nbCap + 2 * s, b0 = a0 + 1;
+            const int a1 = myNbStatic + a0, b1 = myNbStatic + b0;
+            myIndices->SetIndex(k++, a0); myIndices->SetIndex(k++, b0); myIndices->SetIndex(k++, b1);
+            myIndices->SetIndex(k++, a0); myIndices->SetIndex(k++, b1); myIndices->SetIndex(k++, a1);
+        }
+
+        WriteDynamicVertices(true);
+    }
+
+    void SetPosition(int v, const gp_Pnt& p)
+    {
+        myAttribs->ChangeValue<Graphic3d_Vec3>(v) = Graphic3d_Vec3((float)p.X(), (float)p.Y(), (float)p.Z());
+    }
+
+    void SetNormal(int v, const gp_Vec& n)
+    {
+        Graphic3d_Vec3* normal = reinterpret_cast<Graphic3d_Vec3*>(myAttribs->changeValue(v) + sizeof(Graphic3d_Vec3));
+        *normal = Graphic3d_Vec3((float)n.X(), (float)n.Y(), (float)n.Z());
+    }
+
+    void WriteDynamicVertices(bool withNormals)
+    {
+        const int nbCap = (int)myBase.size();
+        const int nbSeg = (int)mySegments.size() / 2;
+        const gp_Vec offset = gp_Vec(myNormal) * myHeight;
+
+        for (int i = 0; i < nbCap; ++i)
+            SetPosition(myNbStatic + i, myBase[i].Translated(offset));
+        for (int s = 0; s < nbSeg; ++s)
+        {
+            SetPosition(myNbStatic + nbCap + 2 * s, myBase[mySegments[2 * s]].Translated(offset));
+            SetPosition(myNbStatic + nbCap + 2 * s + 1, myBase[mySegments[2 * s + 1]].Translated(offset));
+        }
+
+        if (!withNormals)
+        {
+            myAttribs->Invalidate(myNbStatic, 2 * myNbStatic - 1);
+            return;
+        }
+
+        // Normals only change orientation when the height crosses zero
+        const gp_Vec up = gp_Vec(myNormal) * (myHeight < 0.0 ? -1.0 : 1.0);
+        for (int i = 0; i < nbCap; ++i)
+        {
+            SetNormal(i, -up);
+            SetNormal(myNbStatic + i, up);
+        }
+        for (int s = 0; s < nbSeg; ++s)
+        {
+            gp_Vec side = gp_Vec(myBase[mySegments[2 * s]], myBase[mySegments[2 * s + 1]]).Crossed(up);
+            if (side.SquareMagnitude() > 1.0e-24) side.Normalize();
+            const int a0 = nbCap + 2 * s;
+            SetNormal(a0, side); SetNormal(a0 + 1, side);
+            SetNormal(myNbStatic + a0, side); SetNormal(myNbStatic + a0 + 1, side);
+        }
+        myAttribs->Invalidate();
+    }
+
+    gp_Dir myNormal;
+    double myHeight;
+    double myBoxHeight;
+    int myNbStatic;
+    std::vector<gp_Pnt> myBase;                 // cap nodes in world space
+    std::vector<int> myCapTriangles;            // 0-based node triples
+    std::vector<int> mySegments;                // boundary node pairs
+    Handle(Graphic3d_AttribBuffer) myAttribs;
+    Handle(Graphic3d_IndexBuffer) myIndices;
+};
@@ -0,0 +1,164 @@
+#pragma once
+#include "AIS_PackedCurves.h"
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Graphic3d_AspectLine3d.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#include <PrsMgr_PresentationManager3d.hxx>
+#include <Select3D_SensitivePrimitiveArray.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <gp_Trsf.hxx>
+#include <vector>
+
+// Copies of one template drawn from a single vertex buffer per style. The template is tessellated once;
+// each copy is only a gp_Trsf in the instance list, expanded into the buffers when they are rebuilt.
+// No B-Rep or AIS object exists per copy, and the whole array is one entity for selection.
+class AIS_InstancedArray : public AIS_InteractiveObject
+{
+public:
+    // Template geometry of one style, in world coordinates before any instance transformation
+    struct Part
+    {
+        Quantity_Color color;
+        Aspect_TypeOfLine lineType = Aspect_TOL_SOLID;
+        double width = 1.0;
+
+        std::vector<gp_Pnt> lineNodes;
+        std::vector<int> lineIndices;       // segment pairs into lineNodes
+        std::vector<gp_Pnt> faceNodes;
+        std::vector<gp_Dir> faceNormals;    // one per face node
+        std::vector<int> faceIndices;       // triangles into faceNodes
+    };
+
+    // Buffers hold positions relative to origin (keeps float precision on large site coordinates)
+    AIS_InstancedArray(const std::vector<Part>& parts, const gp_Pnt& origin)
+        : myParts(parts), myOrigin(origin)
+    {
+        gp_Trsf shift;
+        shift.SetTranslation(gp_Vec(origin.XYZ()));
+        SetLocalTransformation(shift);
+    }
+
+    // Replaces the instance list; the context's Redisplay then rebuilds the buffers and sensitives
+    void SetInstances(const std::vector<gp_Trsf>& instances)
+    {
+        myInstances = instances;
+        myLines.clear();
+        myFaces.clear();
+        SetToUpdate();
+    }
+
+    const std::vector<gp_Trsf>& Instances() const { return myInstances; }
+    int NbInstances() const { return (int)myInstances.size(); }
+    const std::vector<Part>& Parts() const { return myParts; }
+    const gp_Pnt& Origin() const { return myOrigin; }
+
+    virtual void Compute(
+        const Handle(PrsMgr_PresentationManager3d)& /*thePM*/,
+        const Handle(Prs3d_Presentation)& thePresentation,
+        const Standard_Integer theMode) override
+    {
+        if (theMode != 0)
+            return;
+        Build();
+
+        for (size_t i = 0; i < myParts.size(); ++i)
+        {
+            const Part& part = myParts[i];
+            if (!myFaces[i].IsNull())
+            {
+                Handle(Prs3d_ShadingAspect) shading = new Prs3d_ShadingAspect();
+                shading->SetColor(part.color);
+                Handle(Graphic3d_Group) aGroup = thePresentation->NewGroup();
+                aGroup->SetGroupPrimitivesAspect(shading->Aspect());
+                aGroup->AddPrimitiveArray(myFaces[i]);
+            }
+            if (!myLines[i].IsNull())
+            {
+                Handle(Graphic3d_Group) aGroup = thePresentation->NewGroup();
+                aGroup->SetGroupPrimitivesAspect(new Graphic3d_AspectLine3d(part.color, part.lineType, part.width));
+                aGroup->AddPrimitiveArray(myLines[i]);
+            }
+        }
+    }
+
+    // Sensitives read the same buffers the renderer draws; one owner covers every copy
+    virtual void ComputeSelection(
+        const Handle(SelectMgr_Selection)& theSelection,
+        const Standard_Integer theMode) override
+    {
+        if (theMode != 0)
+            return;
+        Build();
+
+        Handle(SelectMgr_EntityOwner) owner = new SelectMgr_EntityOwner(this);
+        for (size_t i = 0; i < myParts.size(); ++i)
+        {
+            if (!myLines[i].IsNull())
+                theSelection->Add(new Select3D_SensitivePackedSegments(owner, myLines[i]->Attributes(), myLines[i]->Indices(), gp_Pnt()));
+            if (!myFaces[i].IsNull())
+            {
+                Handle(Select3D_SensitivePrimitiveArray) faces = new Select3D_SensitivePrimitiveArray(owner);
+                if (faces->InitTriangulation(myFaces[i]->Attributes(), myFaces[i]->Indices(), TopLoc_Location()))
+                    theSelection->Add(faces);
+            }
+        }
+    }
+
+private:
+    // Expands the template once per instance; kept until the instance list changes
+    void Build()
+    {
+        if (myLines.size() == myParts.size())
+            return;
+
+        myLines.assign(myParts.size(), Handle(Graphic3d_ArrayOfSegments)());
+        myFaces.assign(myParts.size(), Handle(Graphic3d_ArrayOfTriangles)());
+        const int nbInstances = (int)myInstances.size();
+        if (nbInstances == 0)
+            return;
+
+        for (size_t i = 0; i < myParts.size(); ++i)
+        {
+            const Part& part = myParts[i];
+            if (part.lineIndices.size() >= 2)
+            {
+                Handle(Graphic3d_ArrayOfSegments) lines = new Graphic3d_ArrayOfSegments(
+                    (int)part.lineNodes.size() * nbInstances, (int)part.lineIndices.size() * nbInstances);
+                for (const gp_Trsf& trsf : myInstances)
+                {
+                    const int base = lines->VertexNumber();
+                    for (const gp_Pnt& node : part.lineNodes)
+                        lines->AddVertex(gp_Pnt(node.Transformed(trsf).XYZ() - myOrigin.XYZ()));
+                    for (size_t k = 0; k + 1 < part.lineIndices.size(); k += 2)
+                        lines->AddEdges(base + 1 + part.lineIndices[k], base + 1 + part.lineIndices[k + 1]);
+                }
+                myLines[i] = lines;
+            }
+            if (part.faceIndices.size() >= 3)
+            {
+                Handle(Graphic3d_ArrayOfTriangles) faces = new Graphic3d_ArrayOfTriangles(
+                    (int)part.faceNodes.size() * nbInstances, (int)part.faceIndices.size() * nbInstances, Graphic3d_ArrayFlags_VertexNormal);
+                for (const gp_Trsf& trsf : myInstances)
+                {
+                    const int base = faces->VertexNumber();
+                    for (size_t k = 0; k < part.faceNodes.size(); ++k)
+                        faces->AddVertex(gp_Pnt(part.faceNodes[k].Transformed(trsf).XYZ() - myOrigin.XYZ()), part.faceNormals[k].Transformed(trsf));
+                    for (size_t k = 0; k + 2 < part.faceIndices.size(); k += 3)
+                        faces->AddEdges(base + 1 + part.faceIndices[k], base + 1 + part.faceIndices[k + 1], base + 1 + part.faceIndices[k + 2]);
+                }
+                myFaces[i] = faces;
+            }
+        }
+    }
+
+    std::vector<Part> myParts;
+    gp_Pnt myOrigin;
+    std::vector<gp_Trsf> myInstances;
+    std::vector<Handle(Graphic3d_ArrayOfSegments)> myLines;     // per part, built on demand
+    std::vector<Handle(Graphic3d_ArrayOfTriangles)> myFaces;
+};
@@ -0,0 +1,451 @@
+#pragma once
+#include <AIS_InteractiveObject.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager3d.hxx>
+#include <Graphic3d_Buffer.hxx>
+#include <Graphic3d_IndexBuffer.hxx>
+#include <Graphic3d_BoundBuffer.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_AspectLine3d.hxx>
+#include <Graphic3d_Vec3.hxx>
+#include <Aspect_TypeOfLine.hxx>
+#include <Quantity_Color.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <SelectBasics_SelectingVolumeManager.hxx>
+#include <Select3D_SensitiveSet.hxx>
+#include <Select3D_SensitiveEntity.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <Bnd_Box.hxx>
+#include <gp_Trsf.hxx>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Vertex or index data that lives in memory owned by someone else (a mapped project file).
+// The owner is kept alive for as long as the renderer holds the buffer; nothing is copied.
+template <class Buffer>
+class PackedBufferView : public Buffer
+{
+public:
+    // Vertex data must be followed by its nbAttributes Graphic3d_Attribute descriptors,
+    // which is where Graphic3d_Buffer looks for them
+    PackedBufferView(const std::shared_ptr<const void>& owner, const uint8_t* data, size_t bytes,
+        int stride, int nbElements, int nbAttributes)
+        : Buffer(Handle(NCollection_BaseAllocator)()), myOwner(owner)
+    {
+        this->myData = const_cast<Standard_Byte*>(data);   // never written: the buffers are not mutable
+        this->mySize = bytes;
+        this->Stride = stride;
+        this->NbElements = nbElements;
+        this->NbAttributes = nbAttributes;
+    }
+
+private:
+    std::shared_ptr<const void> myOwner;
+};
+
+// Segment soup over packed nodes and index pairs; one owner for the whole batch.
+// The BVH only reorders a segment-id array, so picking a million lines costs 4 bytes per segment.
+class Select3D_SensitivePackedSegments : public Select3D_SensitiveSet
+{
+public:
+    Select3D_SensitivePackedSegments(const Handle(SelectMgr_EntityOwner)& owner, const Handle(Graphic3d_Buffer)& nodes,
+        const Handle(Graphic3d_IndexBuffer)& indices, const gp_Pnt& center)
+        : Select3D_SensitiveSet(owner), myNodes(nodes), myIndices(indices), myCenter(center)
+    {
+        const int nbSegments = indices->NbElements / 2;
+        myOrder.resize(nbSegments);
+        for (int i = 0; i < nbSegments; ++i)
+            myOrder[i] = i;
+        myContent.MarkDirty();
+    }
+
+    // Segment (pair index into the index buffer) under the last successful pick, or -1
+    int LastDetectedSegment() const { return myDetectedIdx >= 0 ? myOrder[myDetectedIdx] : -1; }
+
+    virtual Standard_Integer NbSubElements() const override { return (int)myOrder.size(); }
+    virtual Standard_Integer Size() const override { return (int)myOrder.size(); }
+
+    virtual Select3D_BndBox3d Box(const Standard_Integer theIdx) const override
+    {
+        const Graphic3d_Vec3& p1 = Node(theIdx, 0);
+        const Graphic3d_Vec3& p2 = Node(theIdx, 1);
+        return Select3D_BndBox3d(
+            SelectMgr_Vec3(std::min(p1.x(), p2.x()), std::min(p1.y(), p2.y()), std::min(p1.z(), p2.z())),
+            SelectMgr_Vec3(std::max(p1.x(), p2.x()), std::max(p1.y(), p2.y()), std::max(p1.z(), p2.z())));
+    }
+
+    virtual Standard_Real Center(const Standard_Integer theIdx, const Standard_Integer theAxis) const override
+    {
+        return 0.5 * (Node(theIdx, 0)[theAxis] + Node(theIdx, 1)[theAxis]);
+    }
+
+    virtual void Swap(const Standard_Integer theIdx1, const Standard_Integer theIdx2) override
+    {
+        std::swap(myOrder[theIdx1], myOrder[theIdx2]);
+    }
+
+    virtual gp_Pnt CenterOfGeometry() const override { return myCenter; }
+
+    virtual Handle(Select3D_SensitiveEntity) GetConnected() override
+    {
+        return new Select3D_SensitivePackedSegments(myOwnerId, myNodes, myIndices, myCenter);
+    }
+
+protected:
+    virtual Standard_Boolean overlapsElement(SelectBasics_PickResult& thePickResult, SelectBasics_SelectingVolumeManager& theMgr,
+        Standard_Integer theElemIdx, Standard_Boolean theIsFullInside) override
+    {
+        if (theIsFullInside)
+            return Standard_True;
+        return theMgr.OverlapsSegment(Point(theElemIdx, 0), Point(theElemIdx, 1), thePickResult);
+    }
+
+    virtual Standard_Boolean elementIsInside(SelectBasics_SelectingVolumeManager& theMgr,
+        Standard_Integer theElemIdx, Standard_Boolean theIsFullInside) override
+    {
+        if (theIsFullInside)
+            return Standard_True;
+        return theMgr.OverlapsPoint(Point(theElemIdx, 0)) && theMgr.OverlapsPoint(Point(theElemIdx, 1));
+    }
+
+    virtual Standard_Real distanceToCOG(SelectBasics_SelectingVolumeManager& theMgr) override
+    {
+        return theMgr.DistToGeometryCenter(myCenter);
+    }
+
+private:
+    const Graphic3d_Vec3& Node(int elem, int end) const
+    {
+        return myNodes->Value<Graphic3d_Vec3>(myIndices->Index(2 * myOrder[elem] + end));
+    }
+
+    gp_Pnt Point(int elem, int end) const
+    {
+        const Graphic3d_Vec3& p = Node(elem, end);
+        return gp_Pnt(p.x(), p.y(), p.z());
+    }
+
+    Handle(Graphic3d_Buffer) myNodes;
+    Handle(Graphic3d_IndexBuffer) myIndices;
+    gp_Pnt myCenter;
+    std::vector<int> myOrder;
+};
+
+// Owner of one curve of an AIS_PackedCurves: a range of segment pairs in one style's index buffer
+class AIS_PackedCurveOwner : public SelectMgr_EntityOwner
+{
+public:
+    AIS_PackedCurveOwner(const Handle(SelectMgr_SelectableObject)& object, int style, int firstIndex, int nbIndices, uint32_t key)
+        : SelectMgr_EntityOwner(object), myStyle(style), myFirstIndex(firstIndex), myNbIndices(nbIndices), myKey(key)
+    {
+    }
+
+    int Style() const { return myStyle; }
+    int FirstIndex() const { return myFirstIndex; }
+    int NbIndices() const { return myNbIndices; }
+    uint32_t Key() const { return myKey; }
+
+    // A real entity replaced the curve: it is no longer picked
+    bool IsDetached() const { return myIsDetached; }
+    void SetDetached() { myIsDetached = true; }
+
+    DEFINE_STANDARD_RTTI_INLINE(AIS_PackedCurveOwner, SelectMgr_EntityOwner)
+
+private:
+    int myStyle;
+    int myFirstIndex;
+    int myNbIndices;
+    uint32_t myKey;
+    bool myIsDetached = false;
+};
+
+// The segments of one curve, tested one by one: curves are short, and a BVH per curve would cost
+// more memory than the segments it orders
+class Select3D_SensitivePackedCurve : public Select3D_SensitiveEntity
+{
+public:
+    Select3D_SensitivePackedCurve(const Handle(AIS_PackedCurveOwner)& owner, const Handle(Graphic3d_Buffer)& nodes,
+        const Handle(Graphic3d_IndexBuffer)& indices)
+        : Select3D_SensitiveEntity(owner), myNodes(nodes), myIndices(indices),
+        myFirstIndex(owner->FirstIndex()), myNbIndices(owner->NbIndices())
+    {
+        gp_XYZ sum;
+        for (int k = 0; k < myNbIndices; ++k)
+        {
+            const gp_Pnt p = Point(k);
+            myBox.Add(SelectMgr_Vec3(p.X(), p.Y(), p.Z()));
+            sum += p.XYZ();
+        }
+        myCenter = myNbIndices > 0 ? gp_Pnt(sum / myNbIndices) : gp_Pnt();
+    }
+
+    virtual Standard_Boolean Matches(SelectBasics_SelectingVolumeManager& theMgr, SelectBasics_PickResult& thePickResult) override
+    {
+        const AIS_PackedCurveOwner* owner = static_cast<const AIS_PackedCurveOwner*>(myOwnerId.get());
+        if (owner == nullptr || owner->IsDetached())
+            return Standard_False;
+
+        // Window selection: every vertex inside
+        if (!theMgr.IsOverlapAllowed())
+        {
+            for (int k = 0; k < myNbIndices; ++k)
+                if (!theMgr.OverlapsPoint(Point(k)))
+                    return Standard_False;
+            return Standard_True;
+        }
+
+        bool isMatched = false;
+        for (int k = 0; k + 1 < myNbIndices; k += 2)
+        {
+            SelectBasics_PickResult segmentResult;
+            if (!theMgr.OverlapsSegment(Point(k), Point(k + 1), segmentResult))
+                continue;
+            thePickResult = isMatched ? SelectBasics_PickResult::Min(thePickResult, segmentResult) : segmentResult;
+            isMatched = true;
+        }
+        if (isMatched)
+            thePickResult.SetDistToGeomCenter(theMgr.DistToGeometryCenter(myCenter));
+        return isMatched;
+    }
+
+    virtual Standard_Integer NbSubElements() const override { return myNbIndices / 2; }
+    virtual Select3D_BndBox3d BoundingBox() override { return myBox; }
+    virtual gp_Pnt CenterOfGeometry() const override { return myCenter; }
+    virtual Standard_Boolean ToBuildBVH() const override { return Standard_False; }
+
+private:
+    gp_Pnt Point(int k) const
+    {
+        const Graphic3d_Vec3& p = myNodes->Value<Graphic3d_Vec3>(myIndices->Index(myFirstIndex + k));
+        return gp_Pnt(p.x(), p.y(), p.z());
+    }
+
+    Handle(Graphic3d_Buffer) myNodes;
+    Handle(Graphic3d_IndexBuffer) myIndices;
+    int myFirstIndex;
+    int myNbIndices;
+    Select3D_BndBox3d myBox;
+    gp_Pnt myCenter;
+};
+
+// Curves of a whole drawing drawn straight from packed buffers: one shared vertex buffer and one
+// segment index buffer per line style. No per-entity objects exist; the buffers can point into a
+// memory-mapped project file, so displaying a million curves costs one group per style.
+// Picking still resolves single curves: each curve gets its own owner, highlighted by drawing its
+// own segments, and a curve that is edited is detached once a real entity takes its place.
+class AIS_PackedCurves : public AIS_InteractiveObject
+{
+public:
+    struct Style
+    {
+        Quantity_Color color;
+        Aspect_TypeOfLine lineType = Aspect_TOL_SOLID;
+        double width = 1.0;
+        Handle(Graphic3d_IndexBuffer) indices;     // segment pairs into the shared vertex buffer
+        std::vector<int> curveStarts;               // first index of each curve, ascending; empty = one owner
+        std::vector<uint32_t> curveKeys;            // caller's key of each curve
+    };
+
+    // Nodes are positions relative to origin (keeps float precision on large site coordinates)
+    AIS_PackedCurves(const Handle(Graphic3d_Buffer)& nodes, const std::vector<Style>& styles,
+        const gp_Pnt& origin, const Bnd_Box& localBox)
+        : myNodes(nodes), myStyles(styles), myOrigin(origin), myLocalBox(localBox)
+    {
+        gp_Trsf shift;
+        shift.SetTranslation(gp_Vec(origin.XYZ()));
+        SetLocalTransformation(shift);
+        SetAutoHilight(Standard_False);
+        myIsCopied.resize(myStyles.size(), false);
+    }
+
+    const gp_Pnt& Origin() const { return myOrigin; }
+
+    // True once the curves were moved or rotated after they were built
+    bool HasPlacement() const
+    {
+        const gp_Trsf& local = LocalTransformation();
+        return local.Form() != gp_Translation || !local.TranslationPart().IsEqual(myOrigin.XYZ(), 0.0);
+    }
+
+    // Moves and rotations applied to the curves since they were built, in world coordinates
+    gp_Trsf Placement() const
+    {
+        gp_Trsf shift;
+        shift.SetTranslation(gp_Vec(myOrigin.XYZ()));
+        return LocalTransformation().Multiplied(shift.Inverted());
+    }
+
+    bool IsDetached(uint32_t key) const { return myDetached.count(key) > 0; }
+    std::vector<uint32_t> DetachedKeys() const { return std::vector<uint32_t>(myDetached.begin(), myDetached.end()); }
+
+    // Leaves the owner's curve out of drawing and picking; the caller redisplays the object.
+    // The style's indices are copied first (they may point into a read-only mapping), then the
+    // curve's segments collapse onto its first vertex.
+    void Detach(const Handle(AIS_PackedCurveOwner)& owner)
+    {
+        if (owner.IsNull() || owner->IsDetached() || owner->Style() >= (int)myStyles.size())
+            return;
+        owner->SetDetached();
+        myDetached.insert(owner->Key());
+
+        Style& style = myStyles[owner->Style()];
+        if (!myIsCopied[owner->Style()])
+        {
+            Handle(Graphic3d_IndexBuffer) copy = new Graphic3d_IndexBuffer(Graphic3d_Buffer::DefaultAllocator());
+            copy->InitInt32(style.indices->NbElements);
+            for (int i = 0; i < style.indices->NbElements; ++i)
+                copy->SetIndex(i, style.indices->Index(i));
+            style.indices = copy;
+            myIsCopied[owner->Style()] = true;
+        }
+        const int first = style.indices->Index(owner->FirstIndex());
+        for (int k = 0; k < owner->NbIndices(); ++k)
+            style.indices->SetIndex(owner->FirstIndex() + k, first);
+    }
+    int NbStyles() const { return (int)myStyles.size(); }
+    const Style& StyleAt(int i) const { return myStyles[i]; }
+    const Handle(Graphic3d_Buffer)& Nodes() const { return myNodes; }
+
+    virtual void Compute(
+        const Handle(PrsMgr_PresentationManager3d)& /*thePM*/,
+        const Handle(Prs3d_Presentation)& thePresentation,
+        const Standard_Integer /*theMode*/) override
+    {
+        if (myNodes.IsNull() || myLocalBox.IsVoid())
+            return;
+
+        Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+        myLocalBox.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+        for (const Style& style : myStyles)
+        {
+            if (style.indices.IsNull() || style.indices->NbElements == 0)
+                continue;
+
+            Handle(Graphic3d_Group) aGroup = thePresentation->NewGroup();
+            aGroup->SetGroupPrimitivesAspect(new Graphic3d_AspectLine3d(style.color, style.lineType, style.width));
+            aGroup->AddPrimitiveArray(Graphic3d_TOPA_SEGMENTS, style.indices, myNodes, Handle(Graphic3d_BoundBuffer)(), Standard_False);
+            aGroup->SetMinMaxValues(xmin, ymin, zmin, xmax, ymax, zmax);
+        }
+    }
+
+    // One owner per curve; styles without curve ranges fall back to one owner for their soup.
+    // Sensitives are only built when the drawing is first picked.
+    virtual void ComputeSelection(
+        const Handle(SelectMgr_Selection)& theSelection,
+        const Standard_Integer theMode) override
+    {
+        if (theMode != 0 || myNodes.IsNull())
+            return;
+
+        Handle(SelectMgr_EntityOwner) sharedOwner;
+        const gp_Pnt center = myLocalBox.IsVoid() ? gp_Pnt() : gp_Pnt((myLocalBox.CornerMin().XYZ() + myLocalBox.CornerMax().XYZ()) * 0.5);
+        for (int s = 0; s < (int)myStyles.size(); ++s)
+        {
+            const Style& style = myStyles[s];
+            if (style.indices.IsNull() || style.indices->NbElements < 2)
+                continue;
+
+            if (style.curveStarts.empty())
+            {
+                if (sharedOwner.IsNull()) sharedOwner = new SelectMgr_EntityOwner(this);
+                theSelection->Add(new Select3D_SensitivePackedSegments(sharedOwner, myNodes, style.indices, center));
+                continue;
+            }
+
+            for (size_t c = 0; c < style.curveStarts.size(); ++c)
+            {
+                const int first = style.curveStarts[c];
+                const int last = c + 1 < style.curveStarts.size() ? style.curveStarts[c + 1] : style.indices->NbElements;
+                if (last - first < 2 || IsDetached(style.curveKeys[c]))
+                    continue;
+                Handle(AIS_PackedCurveOwner) owner = new AIS_PackedCurveOwner(this, s, first, last - first, style.curveKeys[c]);
+                theSelection->Add(new Select3D_SensitivePackedCurve(owner, myNodes, style.indices));
+            }
+        }
+    }
+
+    // Hover draws only the detected curve
+    virtual void HilightOwnerWithColor(const Handle(PrsMgr_PresentationManager)& thePM,
+        const Handle(Prs3d_Drawer)& theStyle, const Handle(SelectMgr_EntityOwner)& theOwner) override
+    {
+        Handle(Prs3d_Presentation) presentation = GetHilightPresentation(thePM);
+        if (presentation.IsNull())
+            return;
+        presentation->Clear();
+        presentation->SetTransformation(TransformationGeom());
+        if (theStyle->ZLayer() != Graphic3d_ZLayerId_UNKNOWN)
+            presentation->SetZLayer(theStyle->ZLayer());
+
+        Handle(AIS_PackedCurveOwner) owner = Handle(AIS_PackedCurveOwner)::DownCast(theOwner);
+        if (!owner.IsNull())
+            AddCurve(presentation, *owner, theStyle->Color());
+        else
+            AddAll(presentation, theStyle->Color());
+
+        if (thePM->IsImmediateModeOn())
+            thePM->AddToImmediateList(presentation);
+        else
+            presentation->Display();
+    }
+
+    virtual void HilightSelected(const Handle(PrsMgr_PresentationManager)& thePM, const SelectMgr_SequenceOfOwner& theSeq) override
+    {
+        Handle(Prs3d_Presentation) presentation = GetSelectPresentation(thePM);
+        if (presentation.IsNull())
+            return;
+        presentation->Clear();
+        presentation->SetTransformation(TransformationGeom());
+
+        const Quantity_Color color = HilightAttributes().IsNull() ? Quantity_Color(Quantity_NOC_GRAY80) : HilightAttributes()->Color();
+        for (SelectMgr_SequenceOfOwner::Iterator it(theSeq); it.More(); it.Next())
+        {
+            Handle(AIS_PackedCurveOwner) owner = Handle(AIS_PackedCurveOwner)::DownCast(it.Value());
+            if (!owner.IsNull())
+                AddCurve(presentation, *owner, color);
+            else
+                AddAll(presentation, color);
+        }
+        presentation->Display();
+    }
+
+private:
+    void AddCurve(const Handle(Prs3d_Presentation)& presentation, const AIS_PackedCurveOwner& owner, const Quantity_Color& color) const
+    {
+        if (owner.Style() >= (int)myStyles.size() || owner.NbIndices() < 2)
+            return;
+        const Style& style = myStyles[owner.Style()];
+
+        Handle(Graphic3d_IndexBuffer) indices = new Graphic3d_IndexBuffer(Graphic3d_Buffer::DefaultAllocator());
+        indices->InitInt32(owner.NbIndices());
+        for (int k = 0; k < owner.NbIndices(); ++k)
+            indices->SetIndex(k, style.indices->Index(owner.FirstIndex() + k));
+
+        Handle(Graphic3d_Group) group = presentation->NewGroup();
+        group->SetGroupPrimitivesAspect(new Graphic3d_AspectLine3d(color, style.lineType, style.width));
+        group->AddPrimitiveArray(Graphic3d_TOPA_SEGMENTS, indices, myNodes, Handle(Graphic3d_BoundBuffer)(), Standard_False);
+    }
+
+    void AddAll(const Handle(Prs3d_Presentation)& presentation, const Quantity_Color& color) const
+    {
+        for (const Style& style : myStyles)
+        {
+            if (style.indices.IsNull() || style.indices->NbElements == 0)
+                continue;
+            Handle(Graphic3d_Group) group = presentation->NewGroup();
+            group->SetGroupPrimitivesAspect(new Graphic3d_AspectLine3d(color, style.lineType, style.width));
+            group->AddPrimitiveArray(Graphic3d_TOPA_SEGMENTS, style.indices, myNodes, Handle(Graphic3d_BoundBuffer)(), Standard_False);
+        }
+    }
+
+    Handle(Graphic3d_Buffer) myNodes;
+    std::vector<Style> myStyles;
+    gp_Pnt myOrigin;
+    Bnd_Box myLocalBox;
+    std::vector<bool> myIsCopied;               // style indices owned by the object (detached curves collapse in them)
+    std::unordered_set<uint32_t> myDetached;
+};
@@ -0,0 +1,286 @@
+#pragma once
+#include <AIS_InteractiveObject.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager3d.hxx>
+#include <Graphic3d_AttribBuffer.hxx>
+#include <Graphic3d_MutableIndexBuffer.hxx>
+#include <Graphic3d_BoundBuffer.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_AspectFillArea3d.hxx>
+#include <Graphic3d_MaterialAspect.hxx>
+#include <Graphic3d_Vec3.hxx>
+#include <Quantity_Color.hxx>
+#include <SelectMgr_Selection.hxx>
+#include "ProfileMesh.h"
+#include <Bnd_Box.hxx>
+#include <TopoDS_Face.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Pnt.hxx>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Revolve preview built from the profile mesh once per wire.
+// The boundary segments are instanced as rotated rings at a fixed angular step and packed once;
+// SetAngle() only switches which bands are live in a mutable index buffer and rotates the end
+// ring + end cap, so scrubbing the angle never touches BRepPrimAPI_MakeRevol or the mesher.
+class AIS_RevolvePreview : public AIS_InteractiveObject
+{
+public:
+    static const int THE_MAX_RING_VERTICES = 200000;
+
+    AIS_RevolvePreview(const TopoDS_Face& face, const gp_Ax1& axis)
+        : myAxis(axis), myAngle(0.0), myNbRings(0), myNbBandsShown(0)
+    {
+        ProfileMesh profile;
+        if (profile.Build(face))
+        {
+            myBase = std::move(profile.nodes);
+            myCapTriangles = std::move(profile.triangles);
+            mySegments = std::move(profile.segments);
+        }
+
+        // Fewer rings for dense profiles so the packed sweep stays bounded
+        const int nbSeg = std::max(1, (int)mySegments.size() / 2);
+        myNbRings = std::max(12, std::min(72, THE_MAX_RING_VERTICES / (2 * nbSeg)));
+    }
+
+    bool IsValid() const { return !myBase.empty() && !mySegments.empty(); }
+
+    double Angle() const { return myAngle; }
+
+    // Sweep to angleDeg (0..360). Bounds already cover the full revolution, so a redraw is enough
+    void SetAngle(double angleDeg)
+    {
+        myAngle = std::max(0.0, std::min(360.0, angleDeg));
+        if (myAttribs.IsNull())
+            return;
+
+        WriteEndVertices();
+        WriteBands();
+    }
+
+    virtual void Compute(
+        const Handle(PrsMgr_PresentationManager3d)& /*thePM*/,
+        const Handle(Prs3d_Presentation)& thePresentation,
+        const Standard_Integer /*theMode*/) override
+    {
+        if (!IsValid())
+            return;
+        if (myAttribs.IsNull())
+            BuildBuffers();
+
+        Handle(Graphic3d_AspectFillArea3d) asp = new Graphic3d_AspectFillArea3d();
+        Graphic3d_MaterialAspect mat(Graphic3d_NameOfMaterial_Plastified);
+        mat.SetColor(Quantity_Color(Quantity_NOC_PINK));
+        asp->SetFrontMaterial(mat);
+        asp->SetBackMaterial(mat);
+        asp->SetInteriorStyle(Aspect_IS_SOLID);
+        asp->SetFaceCulling(Graphic3d_TypeOfBackfacingModel_DoubleSided);
+
+        Handle(Graphic3d_Group) aGroup = thePresentation->NewGroup();
+        aGroup->SetGroupPrimitivesAspect(asp);
+        aGroup->AddPrimitiveArray(Graphic3d_TOPA_TRIANGLES, myIndices, myAttribs, Handle(Graphic3d_BoundBuffer)(), Standard_False);
+
+        // Every profile node stays on its circle around the axis, whatever the angle
+        const gp_Pnt origin = myAxis.Location();
+        const gp_Vec dir(myAxis.Direction());
+        Bnd_Box box;
+        for (const gp_Pnt& p : myBase)
+        {
+            const gp_Vec v(origin, p);
+            const gp_Pnt center = origin.Translated(dir * v.Dot(dir));
+            const double r = center.Distance(p);
+            box.Add(gp_Pnt(center.X() - r, center.Y() - r, center.Z() - r));
+            box.Add(gp_Pnt(center.X() + r, center.Y() + r, center.Z() + r));
+        }
+        Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+        box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+        aGroup->SetMinMaxValues(xmin, ymin, zmin, xmax, ymax, zmax);
+    }
+
+    // Preview is display-only
+    virtual void ComputeSelection(
+        const Handle(SelectMgr_Selection)& /*theSelection*/,
+        const Standard_Integer /*theMode*/) override
+    {
+    }
+
+private:
+    int NbCap() const { return (int)myBase.size(); }
+    int NbSeg() const { return (int)mySegments.size() / 2; }
+
+    // Vertex layout: start cap, rings 0..K-1 (2 per segment), then the dynamic end ring and end cap
+    int RingVertex(int ring) const { return NbCap() + ring * 2 * NbSeg(); }
+    int EndRingVertex() const { return RingVertex(myNbRings); }
+    int EndCapVertex() const { return EndRingVertex() + 2 * NbSeg(); }
+
+    // Index layout: start cap, K bands of 6 per segment, end cap
+    int BandSlot(int band) const { return 3 * ((int)myCapTriangles.size() / 3) + band * 6 * NbSeg(); }
+
+    double Step() const { return 2.0 * M_PI / myNbRings; }
+
+    void BuildBuffers()
+    {
+        const int nbCap = NbCap();
+        const int nbSeg = NbSeg();
+        const int nbVerts = EndCapVertex() + nbCap;
+
+        Graphic3d_Attribute attribs[2] = { { Graphic3d_TOA_POS, Graphic3d_TOD_VEC3 }, { Graphic3d_TOA_NORM, Graphic3d_TOD_VEC3 } };
+        myAttribs = new Graphic3d_AttribBuffer(Graphic3d_Buffer::DefaultAllocator());
+        myAttribs->Init(nbVerts, attribs, 2);
+        myAttribs->SetMutable(Standard_True);
+
+        // Start cap faces against the sweep direction
+        const gp_Vec sweep = SweepDirection();
+        for (int i = 0; i < nbCap; ++i)
+        {
+            SetPosition(i, myBase[i]);
+            SetNormal(i, -sweep);
+        }
+
+        // Wall normals of the unrotated profile, then one rotated copy per ring
+        mySideNormals.resize(nbSeg);
+        for (int s = 0; s < nbSeg; ++s)
+        {
+            const gp_Pnt& a = myBase[mySegments[2 * s]];
+            const gp_Pnt& b = myBase[mySegments[2 * s + 1]];
+            gp_Vec side = gp_Vec(a, b).Crossed(Tangent(gp_Pnt(0.5 * (a.XYZ() + b.XYZ()))));
+            if (side.SquareMagnitude() > 1.0e-24) side.Normalize();
+            mySideNormals[s] = side;
+        }
+        for (int ring = 0; ring < myNbRings; ++ring)
+            WriteRing(RingVertex(ring), Rotation(ring * Step()));
+
+        const int nbCapIndices = (int)myCapTriangles.size();
+        myIndices = new Graphic3d_MutableIndexBuffer(Graphic3d_Buffer::DefaultAllocator());
+        myIndices->InitInt32(2 * nbCapIndices + myNbRings * 6 * nbSeg);
+        for (size_t t = 0; t < myCapTriangles.size(); t += 3)
+        {
+            myIndices->SetIndex((int)t, myCapTriangles[t]);
+            myIndices->SetIndex((int)t + 1, myCapTriangles[t + 2]);
+            myIndices->SetIndex((int)t + 2, myCapTriangles[t + 1]);
+
+            const int k = BandSlot(myNbRings) + (int)t;
+            myIndices->SetIndex(k, EndCapVertex() + myCapTriangles[t]);
+            myIndices->SetIndex(k + 1, EndCapVertex() + myCapTriangles[t + 1]);
+            myIndices->SetIndex(k + 2, EndCapVertex() + myCapTriangles[t + 2]);
+        }
+
+        for (int band = 0; band < myNbRings; ++band)
+            WriteBand(band, -1);
+        myNbBandsShown = 0;
+        WriteEndVertices();
+        WriteBands();
+    }
+
+    gp_Trsf Rotation(double angleRad) const
+    {
+        gp_Trsf rot;
+        rot.SetRotation(myAxis, angleRad);
+        return rot;
+    }
+
+    // Direction a point moves in when the angle grows
+    gp_Vec Tangent(const gp_Pnt& p) const
+    {
+        gp_Vec t = gp_Vec(myAxis.Direction()).Crossed(gp_Vec(myAxis.Location(), p));
+        if (t.SquareMagnitude() > 1.0e-24) t.Normalize();
+        return t;
+    }
+
+    gp_Vec SweepDirection() const
+    {
+        gp_XYZ centroid(0.0, 0.0, 0.0);
+        for (const gp_Pnt& p : myBase) centroid += p.XYZ();
+        return Tangent(gp_Pnt(centroid / (double)myBase.size()));
+    }
+
+    void SetPosition(int v, const gp_Pnt& p)
+    {
+        myAttribs->ChangeValue<Graphic3d_Vec3>(v) = Graphic3d_Vec3((float)p.X(), (float)p.Y(), (float)p.Z());
+    }
+
+    void SetNormal(int v, const gp_Vec& n)
+    {
+        Graphic3d_Vec3* normal = reinterpret_cast<Graphic3d_Vec3*>(myAttribs->changeValue(v) + sizeof(Graphic3d_Vec3));
+        *normal = Graphic3d_Vec3((float)n.X(), (float)n.Y(), (float)n.Z());
+    }
+
+    void WriteRing(int first, const gp_Trsf& rot)
+    {
+        for (int s = 0; s < NbSeg(); ++s)
+        {
+            const gp_Vec n = mySideNormals[s].Transformed(rot);
+            SetPosition(first + 2 * s, myBase[mySegments[2 * s]].Transformed(rot));
+            SetPosition(first + 2 * s + 1, myBase[mySegments[2 * s + 1]].Transformed(rot));
+            SetNormal(first + 2 * s, n);
+            SetNormal(first + 2 * s + 1, n);
+        }
+    }
+
+    void WriteEndVertices()
+    {
+        const gp_Trsf rot = Rotation(myAngle * M_PI / 180.0);
+        WriteRing(EndRingVertex(), rot);
+
+        const gp_Vec capNormal = SweepDirection().Transformed(rot);
+        for (int i = 0; i < NbCap(); ++i)
+        {
+            SetPosition(EndCapVertex() + i, myBase[i].Transformed(rot));
+            SetNormal(EndCapVertex() + i, capNormal);
+        }
+        myAttribs->Invalidate(EndRingVertex(), EndCapVertex() + NbCap() - 1);
+    }
+
+    // Bands below the swept angle link consecutive rings, the last one closes on the end ring,
+    // and the rest collapse to degenerate triangles. Only bands whose role changed are rewritten.
+    void WriteBands()
+    {
+        const int nbFull = std::min(myNbRings, (int)std::floor(myAngle * M_PI / 180.0 / Step()));
+        const int nbShown = std::min(myNbRings, nbFull + 1);
+
+        const int lo = std::max(0, std::min(myNbBandsShown, nbShown) - 1);
+        const int hi = std::max(myNbBandsShown, nbShown);
+        for (int band = lo; band < hi; ++band)
+        {
+            int next = -1;
+            if (band < nbShown)
+                next = (band + 1 < myNbRings && band + 1 <= nbFull) ? RingVertex(band + 1) : EndRingVertex();
+            WriteBand(band, next);
+        }
+        if (hi > lo)
+            myIndices->Invalidate(BandSlot(lo), BandSlot(hi) - 1);
+        myNbBandsShown = nbShown;
+    }
+
+    void WriteBand(int band, int nextRing)
+    {
+        const int a = RingVertex(band);
+        int k = BandSlot(band);
+        for (int s = 0; s < NbSeg(); ++s)
+        {
+            if (nextRing < 0)
+            {
+                for (int i = 0; i < 6; ++i) myIndices->SetIndex(k++, a);
+                continue;
+            }
+            const int a0 = a + 2 * s, b0 = a0 + 1;
+            const int a1 = nextRing + 2 * s, b1 = a1 + 1;
+            myIndices->SetIndex(k++, a0); myIndices->SetIndex(k++, b0); myIndices->SetIndex(k++, b1);
+            myIndices->SetIndex(k++, a0); myIndices->SetIndex(k++, b1); myIndices->SetIndex(k++, a1);
+        }
+    }
+
+    gp_Ax1 myAxis;
+    double myAngle;                             // degrees
+    int myNbRings;                              // precomputed rotated copies of the profile boundary
+    int myNbBandsShown;                         // bands currently written as live triangles
+    std::vector<gp_Pnt> myBase;                 // cap nodes in world space
+    std::vector<int> myCapTriangles;            // 0-based node triples
+    std::vector<int> mySegments;                // boundary node pairs
+    std::vector<gp_Vec> mySideNormals;          // wall normal per segment at angle 0
+    Handle(Graphic3d_AttribBuffer) myAttribs;
+    Handle(Graphic3d_MutableIndexBuffer) myIndices;
+};
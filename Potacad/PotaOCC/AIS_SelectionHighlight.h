@@ -0,0 +1,441 @@
+#pragma once
+#include <AIS_InteractiveObject.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager3d.hxx>
+#include <Graphic3d_AttribBuffer.hxx>
+#include <Graphic3d_MutableIndexBuffer.hxx>
+#include <Graphic3d_BoundBuffer.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_AspectLine3d.hxx>
+#include <Graphic3d_Vec3.hxx>
+#include <Quantity_Color.hxx>
+#include <Graphic3d_ZLayerId.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <Standard_Transient.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// Entity outlines of one viewer, written once into shared vertex pages.
+// An outline is tessellated on first use and appended to the current page; it stays there until the entity
+// geometry changes (its points become garbage in the page) or the scene is reset. A page is released when
+// none of its outlines is live any more. Consumers draw outlines with index buffers over the pages.
+// Points are stored relative to the first packed point (keeps float precision on large site coordinates).
+class AIS_OutlinePages : public Standard_Transient
+{
+public:
+    static const int THE_PAGE_SIZE = 16384;     // vertices; a longer outline gets a page of its own
+
+    // Appends the XY outline of entity id as polylines (points + polyline start offsets)
+    typedef std::function<void(int, std::vector<gp_Pnt>&, std::vector<int>&)> Tessellator;
+
+    struct Outline
+    {
+        int page = -1;                          // -1 while not packed or when there is nothing to draw
+        int firstVertex = 0;
+        int nbVertices = 0;
+        int nbSegments = 0;
+        std::vector<int> starts;                // polyline starts, relative to firstVertex
+        bool isPacked = false;
+    };
+
+    explicit AIS_OutlinePages(const Tessellator& tessellator)
+        : myTessellator(tessellator), myCurrentPage(-1), myHasOrigin(false)
+    {
+    }
+
+    const gp_Pnt& Origin() const { return myOrigin; }
+
+    const Handle(Graphic3d_AttribBuffer)& Vertices(int page) const { return myPages[page].vertices; }
+
+    // Outline of entity id, packed on first use
+    const Outline& Acquire(int id)
+    {
+        if (id >= (int)myOutlines.size())
+            myOutlines.resize(id + 1);
+        Outline& outline = myOutlines[id];
+        if (!outline.isPacked)
+            Pack(id, outline);
+        return outline;
+    }
+
+    // Entity geometry changed: its points stay behind as garbage and the next Acquire packs it again
+    void Release(int id)
+    {
+        if (id >= (int)myOutlines.size() || !myOutlines[id].isPacked) return;
+
+        Outline& outline = myOutlines[id];
+        if (outline.page >= 0)
+        {
+            Page& page = myPages[outline.page];
+            if (--page.nbLive == 0)
+            {
+                page.vertices.Nullify();
+                if (outline.page == myCurrentPage)
+                    myCurrentPage = -1;
+            }
+        }
+        outline = Outline();
+    }
+
+private:
+    struct Page
+    {
+        Handle(Graphic3d_AttribBuffer) vertices;
+        int nbVertices = 0;                     // used part of vertices
+        int nbLive = 0;                         // packed outlines still pointing into the page
+    };
+
+    void Pack(int id, Outline& outline)
+    {
+        std::vector<gp_Pnt> points;
+        outline.starts.clear();
+        myTessellator(id, points, outline.starts);
+        outline.isPacked = true;
+
+        for (size_t p = 0; p < outline.starts.size(); ++p)
+        {
+            const int last = (p + 1 < outline.starts.size()) ? outline.starts[p + 1] : (int)points.size();
+            outline.nbSegments += std::max(0, last - outline.starts[p] - 1);
+        }
+        if (outline.nbSegments == 0)
+        {
+            outline.starts.clear();
+            return;
+        }
+
+        if (!myHasOrigin)
+        {
+            myOrigin = points.front();
+            myHasOrigin = true;
+        }
+
+        const int nbVertices = (int)points.size();
+        if (myCurrentPage < 0 || myPages[myCurrentPage].nbVertices + nbVertices > myPages[myCurrentPage].vertices->NbElements)
+        {
+            Page page;
+            Graphic3d_Attribute attrib = { Graphic3d_TOA_POS, Graphic3d_TOD_VEC3 };
+            page.vertices = new Graphic3d_AttribBuffer(Graphic3d_Buffer::DefaultAllocator());
+            page.vertices->Init(std::max(THE_PAGE_SIZE, nbVertices), &attrib, 1);
+            page.vertices->SetMutable(Standard_True);
+            std::memset(page.vertices->ChangeData(), 0, page.vertices->Size());
+            myCurrentPage = (int)myPages.size();
+            myPages.push_back(page);
+        }
+
+        Page& page = myPages[myCurrentPage];
+        outline.page = myCurrentPage;
+        outline.firstVertex = page.nbVertices;
+        outline.nbVertices = nbVertices;
+        for (int i = 0; i < nbVertices; ++i)
+        {
+            page.vertices->ChangeValue<Graphic3d_Vec3>(outline.firstVertex + i) = Graphic3d_Vec3(
+                (float)(points[i].X() - myOrigin.X()), (float)(points[i].Y() - myOrigin.Y()), (float)(points[i].Z() - myOrigin.Z()));
+        }
+        page.vertices->Invalidate(outline.firstVertex, outline.firstVertex + nbVertices - 1);
+        page.nbVertices += nbVertices;
+        ++page.nbLive;
+    }
+
+    Tessellator myTessellator;
+    std::vector<Outline> myOutlines;            // by entity id
+    std::vector<Page> myPages;                  // released pages keep their slot; page numbers are stable
+    int myCurrentPage;                          // page new outlines go to, -1 when a new one is needed
+    gp_Pnt myOrigin;
+    bool myHasOrigin;
+};
+
+// One highlight presentation per viewer for the selection set.
+// The highlight owns no vertices: per outline page it keeps one mutable index buffer with two slots per
+// segment of its selected entities. Deselecting collapses the entity's segments to zero length and keeps its
+// slots for a later reselection; an index buffer that runs out of room is rebuilt from the outlines of its
+// selected entities only, and freed when nothing on its page is selected.
+class AIS_SelectionHighlight : public AIS_InteractiveObject
+{
+public:
+    static const int THE_MIN_CAPACITY = 256;
+
+    explicit AIS_SelectionHighlight(const Handle(AIS_OutlinePages)& outlines)
+        : myOutlines(outlines), myNbSelected(0), myHasLocation(false)
+    {
+        this->SetZLayer(Graphic3d_ZLayerId_Top);
+    }
+
+    int NbSelected() const { return myNbSelected; }
+
+    // Location of the outline pages; a transform session composes its move with it
+    gp_Trsf OriginShift() const
+    {
+        gp_Trsf shift;
+        shift.SetTranslation(gp_Vec(myOutlines->Origin().XYZ()));
+        return shift;
+    }
+
+    bool IsSelected(int id) const
+    {
+        return id < (int)mySelected.size() && mySelected[id] != 0;
+    }
+
+    // Returns true when the presentation must be recomputed (an index buffer was reallocated or freed, or a
+    // page is shown for the first time); otherwise index buffer contents changed in place and a redraw is enough
+    bool SetSelected(int id, bool isSelected)
+    {
+        if (id >= (int)mySelected.size())
+        {
+            if (!isSelected) return false;
+            mySelected.resize(id + 1, 0);
+            if (id >= (int)mySlots.size())
+                mySlots.resize(id + 1);
+        }
+        if ((mySelected[id] != 0) == isSelected)
+            return false;
+
+        mySelected[id] = isSelected ? 1 : 0;
+        myNbSelected += isSelected ? 1 : -1;
+        return isSelected ? Show(id) : Hide(id);
+    }
+
+    // Entity geometry changed: its slots and packed outline are dropped, selected entities are packed again.
+    // Returns true when the highlight must be redisplayed
+    bool Invalidate(const std::vector<int>& ids)
+    {
+        bool needsCompute = false;
+        for (int id : ids)
+        {
+            const bool isSelected = IsSelected(id);
+            if (isSelected)
+                needsCompute |= Hide(id);
+            if (id < (int)mySlots.size())
+                mySlots[id].group = -1;     // collapsed segments stay until the index buffer is rebuilt
+
+            myOutlines->Release(id);
+            if (isSelected)
+                needsCompute |= Show(id);
+        }
+        return needsCompute;
+    }
+
+    // Deselect everything and release the index buffers; outlines stay packed in the pages.
+    // Returns true when the highlight was shown
+    bool Clear()
+    {
+        bool wasShown = false;
+        for (size_t page = 0; page < myGroups.size(); ++page)
+        {
+            wasShown |= myGroups[page].isShown;
+            myGroups[page].nbSelected = 0;
+            FreeGroup((int)page);
+        }
+        mySelected.clear();
+        myNbSelected = 0;
+        return wasShown;
+    }
+
+    virtual void Compute(
+        const Handle(PrsMgr_PresentationManager3d)& /*thePM*/,
+        const Handle(Prs3d_Presentation)& thePresentation,
+        const Standard_Integer /*theMode*/) override
+    {
+        Quantity_Color colLine(Quantity_NOC_GREEN);
+        Handle(Graphic3d_AspectLine3d) asp = new Graphic3d_AspectLine3d(colLine, Aspect_TOL_SOLID, 2.0f);
+
+        // Outlines appended in place may leave the bounds taken here; the highlight never clips
+        // against them and never counts in FitAll, the entities it outlines do
+        thePresentation->SetInfiniteState(Standard_True);
+
+        for (size_t page = 0; page < myGroups.size(); ++page)
+        {
+            Group& group = myGroups[page];
+            group.isShown = group.nbSelected > 0 && !group.indices.IsNull();
+            if (!group.isShown) continue;
+
+            Handle(Graphic3d_Group) aGroup = thePresentation->NewGroup();
+            aGroup->SetPrimitivesAspect(asp);
+            aGroup->AddPrimitiveArray(Graphic3d_TOPA_SEGMENTS, group.indices, myOutlines->Vertices((int)page), Handle(Graphic3d_BoundBuffer)());
+        }
+    }
+
+    // Highlight is display-only; it must never catch picks meant for the entities below it
+    virtual void ComputeSelection(
+        const Handle(SelectMgr_Selection)& /*theSelection*/,
+        const Standard_Integer /*theMode*/) override
+    {
+    }
+
+private:
+    struct Slots
+    {
+        int group = -1;                                   // outline page, -1 = no slots
+        int firstSlot = 0;
+        int nbSlots = 0;                                  // two per segment
+    };
+
+    struct Group
+    {
+        int nbSelected = 0;
+        int nbSlots = 0;                                  // used part of indices; the rest are (0, 0)
+        bool isShown = false;
+        Handle(Graphic3d_MutableIndexBuffer) indices;     // page-local vertex indices, two slots per segment
+        std::vector<int> ids;                             // entities with slots, in slot order
+    };
+
+    void FreeGroup(int page)
+    {
+        Group& group = myGroups[page];
+        for (int id : group.ids)
+        {
+            if (mySlots[id].group == page)
+                mySlots[id].group = -1;
+        }
+        group.ids.clear();
+        group.indices.Nullify();
+        group.nbSlots = 0;
+    }
+
+    bool Show(int id)
+    {
+        const AIS_OutlinePages::Outline& outline = myOutlines->Acquire(id);
+        if (outline.nbSegments == 0) return false;
+
+        if (!myHasLocation)
+        {
+            SetLocalTransformation(OriginShift());
+            myHasLocation = true;
+        }
+
+        if (outline.page >= (int)myGroups.size())
+            myGroups.resize(outline.page + 1);
+        Group& group = myGroups[outline.page];
+        ++group.nbSelected;
+
+        bool needsCompute = false;
+        if (mySlots[id].group == outline.page)
+            WriteEntityIndices(id);         // slots kept from an earlier selection
+        else
+            needsCompute = AppendSlots(id, outline);
+        return needsCompute || !group.isShown;
+    }
+
+    bool Hide(int id)
+    {
+        const int page = mySlots[id].group;
+        if (page < 0) return false;
+
+        // Last selected entity of the page gone: its index buffer goes with the next compute
+        Group& group = myGroups[page];
+        if (--group.nbSelected == 0)
+        {
+            FreeGroup(page);
+            return group.isShown;
+        }
+        WriteEntityIndices(id);
+        return false;
+    }
+
+    // Writes the segments of an outline from slot on, as pairs of page-local vertex indices
+    static void WriteSegments(const AIS_OutlinePages::Outline& outline, Graphic3d_MutableIndexBuffer& indices, int slot)
+    {
+        for (size_t p = 0; p < outline.starts.size(); ++p)
+        {
+            const int last = (p + 1 < outline.starts.size()) ? outline.starts[p + 1] : outline.nbVertices;
+            for (int v = outline.starts[p]; v + 1 < last; ++v)
+            {
+                indices.SetIndex(slot++, outline.firstVertex + v);
+                indices.SetIndex(slot++, outline.firstVertex + v + 1);
+            }
+        }
+    }
+
+    // Appends slots for a selected entity. Returns true when the page's index buffer was reallocated
+    bool AppendSlots(int id, const AIS_OutlinePages::Outline& outline)
+    {
+        Group& group = myGroups[outline.page];
+        const int nbSlots = 2 * outline.nbSegments;
+        const bool isReallocated = Reserve(outline.page, id, nbSlots);
+
+        Slots& slots = mySlots[id];
+        slots.group = outline.page;
+        slots.firstSlot = group.nbSlots;
+        slots.nbSlots = nbSlots;
+
+        WriteSegments(outline, *group.indices, slots.firstSlot);
+        group.indices->Invalidate(slots.firstSlot, slots.firstSlot + nbSlots - 1);
+        group.ids.push_back(id);
+        group.nbSlots += nbSlots;
+        return isReallocated;
+    }
+
+    // Makes room for nbSlots more. When the index buffer is full it is rebuilt, twice the live size, from the
+    // outlines of the selected entities on the page but appendedId; deselected ones lose their slots. Vertices
+    // never move. Returns true when the index buffer was reallocated
+    bool Reserve(int page, int appendedId, int nbSlots)
+    {
+        Group& group = myGroups[page];
+        if (!group.indices.IsNull() && group.nbSlots + nbSlots <= group.indices->NbElements)
+            return false;
+
+        // An entity dropped by Invalidate and packed again on the same page is listed twice; slots are
+        // detached first so that each one is written once
+        int liveSlots = 0;
+        for (int id : group.ids)
+        {
+            if (mySlots[id].group != page) continue;
+            mySlots[id].group = -1;
+            if (IsSelected(id) && id != appendedId)
+                liveSlots += mySlots[id].nbSlots;
+        }
+
+        Handle(Graphic3d_MutableIndexBuffer) indices = new Graphic3d_MutableIndexBuffer(Graphic3d_Buffer::DefaultAllocator());
+        indices->InitInt32(std::max(2 * THE_MIN_CAPACITY, 2 * (liveSlots + nbSlots)));
+        std::memset(indices->ChangeData(), 0, indices->Size());
+
+        std::vector<int> ids;
+        int nbUsedSlots = 0;
+        for (int id : group.ids)
+        {
+            Slots& slots = mySlots[id];
+            if (slots.group >= 0 || !IsSelected(id) || id == appendedId) continue;
+            const AIS_OutlinePages::Outline& outline = myOutlines->Acquire(id);
+            if (outline.page != page) continue;
+
+            WriteSegments(outline, *indices, nbUsedSlots);
+            slots.group = page;
+            slots.firstSlot = nbUsedSlots;
+            nbUsedSlots += slots.nbSlots;
+            ids.push_back(id);
+        }
+
+        group.indices = indices;
+        group.ids.swap(ids);
+        group.nbSlots = nbUsedSlots;
+        return true;
+    }
+
+    // Selected segments join consecutive outline points; deselected ones collapse onto their first point.
+    // Segments always join v and v + 1, so the first index alone restores a collapsed slot pair
+    void WriteEntityIndices(int id)
+    {
+        const Slots& slots = mySlots[id];
+        if (slots.group < 0 || slots.nbSlots == 0) return;
+        const Handle(Graphic3d_MutableIndexBuffer)& indices = myGroups[slots.group].indices;
+        if (indices.IsNull()) return;
+
+        const bool isSelected = IsSelected(id);
+        for (int slot = slots.firstSlot; slot < slots.firstSlot + slots.nbSlots; slot += 2)
+        {
+            const int v = indices->Index(slot);
+            indices->SetIndex(slot + 1, isSelected ? v + 1 : v);
+        }
+        indices->Invalidate(slots.firstSlot, slots.firstSlot + slots.nbSlots - 1);
+    }
+
+    Handle(AIS_OutlinePages) myOutlines;
+    std::vector<Group> myGroups;                          // by outline page
+    std::vector<Slots> mySlots;                           // by entity id
+    std::vector<char> mySelected;
+    int myNbSelected;
+    bool myHasLocation;
+};
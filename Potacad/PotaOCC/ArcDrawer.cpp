@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "ArcDrawer.h"
+#include "SelectionHelper.h"
+#include "ViewerManager.h"
 #include <AIS_InteractiveContext.hxx>
 #include <GC_MakeArcOfCircle.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
@@ -53,9 +56,12 @@ array<int>^ ArcDrawer::DrawArcBatch(
     if (!rawCtx) return gcnew array<int>(0);
 
     Handle(AIS_InteractiveContext) ctx(rawCtx);
+    NativeViewerHandle* native = ViewerRegistry::FindByContext(rawCtx);
+    if (!native) return gcnew array<int>(0);
 
     int n = cx->Length;
     auto ids = gcnew array<int>(n);
+    const uint16_t layer = native->layers.Current();
 
     for (int i = 0; i < n; ++i)
     {
@@ -68,9 +74,6 @@ array<int>^ ArcDrawer::DrawArcBatch(
             endAngle[i] * M_PI / 180.0,
             true);
 
-        Handle(AIS_Shape) aisArc = new AIS_Shape(BRepBuilderAPI_MakeEdge(arc));
-        aisArc->SetDisplayMode(AIS_WireFrame);
-
         // Map DXF linetype string to Aspect_TypeOfLine
         Aspect_TypeOfLine occType = Aspect_TOL_SOLID;
         if (lineTypes != nullptr && i < lineTypes->Length && lineTypes[i] != nullptr)
@@ -87,28 +90,17 @@ array<int>^ ArcDrawer::DrawArcBatch(
         double db = (b != nullptr && i < b->Length) ? (double)b[i] / 255.0 : 0.5;
         Quantity_Color qcol(dr, dg, db, Quantity_TOC_RGB);
 
-        Handle(Prs3d_Drawer) drawer = aisArc->Attributes();
-        if (drawer.IsNull()) drawer = new Prs3d_Drawer();
-
-        Handle(Prs3d_LineAspect) lineAsp = new Prs3d_LineAspect(qcol, occType, 1.0);
-        drawer->SetWireAspect(lineAsp);
-        aisArc->SetAttributes(drawer);
-
-        ctx->Display(aisArc, Standard_False);
-        ctx->SetColor(aisArc, qcol, Standard_False);
-
+        EntityStyle style;
+        style.color = qcol;
+        style.lineType = occType;
         if (transparency != nullptr && i < transparency->Length)
-            ctx->SetTransparency(aisArc, transparency[i], Standard_False);
-
-        aisArc->Attributes()->SetLineAspect(lineAsp);
-        ctx->Redisplay(aisArc, Standard_False);
-
-        ctx->Activate(aisArc);
-
-        ids[i] = (int)aisArc.get();
+            style.transparency = transparency[i];
+        ids[i] = native->document.Create(EntityType::Arc, BRepBuilderAPI_MakeEdge(arc), style, layer);
     }
 
-    ctx->UpdateCurrentViewer();
+    // Presentations are derived from the new rows in one pass
+    native->document.Sync(native);
+    FrameScheduler::Redraw(ctx);
     return ids;
 }
 
@@ -0,0 +1,428 @@
+#include "pch.h"
+#include "ArrayTable.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "SceneDocument.h"
+#include "SelectionHelper.h"
+#include <AIS_Shape.hxx>
+#include <Bnd_Box.hxx>
+#include <BRep_Tool.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <gp_Quaternion.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const double THE_MESH_ANGLE = 0.5;
+    const double THE_MESH_DEFLECTION = 0.001;       // of the shape's diagonal
+
+    AIS_InstancedArray::Part& PartFor(std::vector<AIS_InstancedArray::Part>& parts, const PotaOCC::EntityStyle& style)
+    {
+        for (AIS_InstancedArray::Part& part : parts)
+        {
+            if (part.color.IsEqual(style.color) && part.lineType == style.lineType && part.width == style.width)
+                return part;
+        }
+        parts.push_back(AIS_InstancedArray::Part());
+        parts.back().color = style.color;
+        parts.back().lineType = style.lineType;
+        parts.back().width = style.width;
+        return parts.back();
+    }
+
+    // Edges as polylines and faces as triangles, in world coordinates; tessellated once for all copies
+    void AddTemplate(const Handle(AIS_Shape)& ais, std::vector<AIS_InstancedArray::Part>& parts)
+    {
+        AIS_InstancedArray::Part& part = PartFor(parts, PotaOCC::SceneDocument::StyleOf(ais));
+
+        std::vector<gp_Pnt> points;
+        std::vector<int> starts;
+        PotaOCC::SelectionHelper::TessellateEntity(ais, points, starts);
+        for (size_t k = 0; k < starts.size(); ++k)
+        {
+            const int first = starts[k];
+            const int last = k + 1 < starts.size() ? starts[k + 1] : (int)points.size();
+            const int base = (int)part.lineNodes.size();
+            for (int i = first; i < last; ++i)
+            {
+                part.lineNodes.push_back(points[i]);
+                if (i > first)
+                {
+                    part.lineIndices.push_back(base + i - first - 1);
+                    part.lineIndices.push_back(base + i - first);
+                }
+            }
+        }
+
+        const TopoDS_Shape& shape = ais->Shape();
+        if (!TopExp_Explorer(shape, TopAbs_FACE).More())
+            return;
+
+        bool isMeshed = true;
+        for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More() && isMeshed; exp.Next())
+        {
+            TopLoc_Location loc;
+            isMeshed = !BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), loc).IsNull();
+        }
+        if (!isMeshed)
+        {
+            Bnd_Box box;
+            BRepBndLib::Add(shape, box, Standard_False);
+            const double deflection = box.IsVoid() ? 1.0e-3 : std::max(std::sqrt(box.SquareExtent()) * THE_MESH_DEFLECTION, 1.0e-6);
+            BRepMesh_IncrementalMesh(shape, deflection, Standard_False, THE_MESH_ANGLE, Standard_False);
+        }
+
+        const gp_Trsf world = ais->HasTransformation() ? ais->Transformation() : gp_Trsf();
+        for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next())
+        {
+            const TopoDS_Face& face = TopoDS::Face(exp.Current());
+            TopLoc_Location loc;
+            Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
+            if (triangulation.IsNull())
+                continue;
+
+            const gp_Trsf trsf = world.Multiplied(loc.Transformation());
+            const int base = (int)part.faceNodes.size();
+            for (int i = 1; i <= triangulation->NbNodes(); ++i)
+                part.faceNodes.push_back(triangulation->Node(i).Transformed(trsf));
+
+            // Smooth normals within the face from the triangles around each node
+            std::vector<gp_Vec> normals(triangulation->NbNodes(), gp_Vec(0.0, 0.0, 0.0));
+            const bool isReversed = face.Orientation() == TopAbs_REVERSED;
+            for (int t = 1; t <= triangulation->NbTriangles(); ++t)
+            {
+                int a, b, c;
+                triangulation->Triangle(t).Get(a, b, c);
+                if (isReversed) std::swap(b, c);
+
+                const gp_Pnt& pa = part.faceNodes[base + a - 1];
+                const gp_Vec normal = gp_Vec(pa, part.faceNodes[base + b - 1]).Crossed(gp_Vec(pa, part.faceNodes[base + c - 1]));
+                normals[a - 1] += normal; normals[b - 1] += normal; normals[c - 1] += normal;
+
+                part.faceIndices.push_back(base + a - 1);
+                part.faceIndices.push_back(base + b - 1);
+                part.faceIndices.push_back(base + c - 1);
+            }
+            for (const gp_Vec& normal : normals)
+                part.faceNormals.push_back(normal.SquareMagnitude() > 1.0e-24 ? gp_Dir(normal) : gp::DZ());
+        }
+    }
+}
+
+namespace PotaOCC
+{
+    int ArrayTablePublic::CreateRectangular(System::IntPtr viewerHandlePtr, int columns, int rows, int levels,
+        double columnSpacing, double rowSpacing, double levelSpacing)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return 0;
+
+        ArrayParameters parameters;
+        parameters.kind = ArrayKind::Rectangular;
+        parameters.columns = columns; parameters.rows = rows; parameters.levels = levels;
+        parameters.columnSpacing = columnSpacing; parameters.rowSpacing = rowSpacing; parameters.levelSpacing = levelSpacing;
+        return native->arrays.Create(native, parameters);
+    }
+
+    int ArrayTablePublic::CreatePolar(System::IntPtr viewerHandlePtr, double cx, double cy, double cz,
+        double axisX, double axisY, double axisZ, int count, double fillAngleDeg, bool rotateItems)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return 0;
+        if (gp_Vec(axisX, axisY, axisZ).SquareMagnitude() < 1.0e-24) return 0;
+
+        ArrayParameters parameters;
+        parameters.kind = ArrayKind::Polar;
+        parameters.axis = gp_Ax1(gp_Pnt(cx, cy, cz), gp_Dir(axisX, axisY, axisZ));
+        parameters.columns = count;
+        parameters.fillAngleDeg = fillAngleDeg;
+        parameters.isAligned = rotateItems;
+        return native->arrays.Create(native, parameters);
+    }
+
+    int ArrayTablePublic::CreatePath(System::IntPtr viewerHandlePtr, array<double>^ path, int count, double spacing, bool alignItems)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || path == nullptr) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return 0;
+
+        ArrayParameters parameters;
+        parameters.kind = ArrayKind::Path;
+        for (int i = 0; i + 2 < path->Length; i += 3)
+            parameters.path.push_back(gp_Pnt(path[i], path[i + 1], path[i + 2]));
+        parameters.columns = count;
+        parameters.columnSpacing = spacing;
+        parameters.isAligned = alignItems;
+        return native->arrays.Create(native, parameters);
+    }
+
+    bool ArrayTablePublic::SetRectangular(System::IntPtr viewerHandlePtr, int arrayId, int columns, int rows, int levels,
+        double columnSpacing, double rowSpacing, double levelSpacing)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return false;
+
+        const ArrayParameters* current = native->arrays.Parameters(arrayId);
+        if (current == nullptr || current->kind != ArrayKind::Rectangular) return false;
+
+        ArrayParameters parameters = *current;
+        parameters.columns = columns; parameters.rows = rows; parameters.levels = levels;
+        parameters.columnSpacing = columnSpacing; parameters.rowSpacing = rowSpacing; parameters.levelSpacing = levelSpacing;
+        return native->arrays.Update(native, arrayId, parameters);
+    }
+
+    bool ArrayTablePublic::SetPolar(System::IntPtr viewerHandlePtr, int arrayId, int count, double fillAngleDeg, bool rotateItems)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return false;
+
+        const ArrayParameters* current = native->arrays.Parameters(arrayId);
+        if (current == nullptr || current->kind != ArrayKind::Polar) return false;
+
+        ArrayParameters parameters = *current;
+        parameters.columns = count;
+        parameters.fillAngleDeg = fillAngleDeg;
+        parameters.isAligned = rotateItems;
+        return native->arrays.Update(native, arrayId, parameters);
+    }
+
+    bool ArrayTablePublic::SetPath(System::IntPtr viewerHandlePtr, int arrayId, int count, double spacing, bool alignItems)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return false;
+
+        const ArrayParameters* current = native->arrays.Parameters(arrayId);
+        if (current == nullptr || current->kind != ArrayKind::Path) return false;
+
+        ArrayParameters parameters = *current;
+        parameters.columns = count;
+        parameters.columnSpacing = spacing;
+        parameters.isAligned = alignItems;
+        return native->arrays.Update(native, arrayId, parameters);
+    }
+
+    int ArrayTablePublic::GetItemCount(System::IntPtr viewerHandlePtr, int arrayId)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return 0;
+
+        Handle(AIS_InstancedArray) presentation = native->arrays.Presentation(arrayId);
+        return presentation.IsNull() ? 0 : presentation->NbInstances();
+    }
+
+    bool ArrayTable::InstanceTransforms(const ArrayParameters& parameters, const gp_Pnt& base, std::vector<gp_Trsf>& transforms)
+    {
+        transforms.clear();
+        switch (parameters.kind)
+        {
+        case ArrayKind::Rectangular:
+        {
+            const int columns = std::max(1, parameters.columns), rows = std::max(1, parameters.rows), levels = std::max(1, parameters.levels);
+            if ((double)columns * rows * levels > THE_MAX_ITEMS) break;
+
+            transforms.reserve((size_t)columns * rows * levels);
+            for (int level = 0; level < levels; ++level)
+                for (int row = 0; row < rows; ++row)
+                    for (int column = 0; column < columns; ++column)
+                    {
+                        gp_Trsf trsf;
+                        trsf.SetTranslation(gp_Vec(column * parameters.columnSpacing, row * parameters.rowSpacing, level * parameters.levelSpacing));
+                        transforms.push_back(trsf);
+                    }
+            break;
+        }
+        case ArrayKind::Polar:
+        {
+            const int count = parameters.columns;
+            if (count < 1 || count > THE_MAX_ITEMS) break;
+
+            // A full circle would put the last item on the first one
+            const double fill = parameters.fillAngleDeg * M_PI / 180.0;
+            const bool isFullCircle = std::fabs(std::fabs(parameters.fillAngleDeg) - 360.0) < 1.0e-9;
+            const double step = isFullCircle ? fill / count : (count > 1 ? fill / (count - 1) : 0.0);
+
+            transforms.reserve(count);
+            for (int i = 0; i < count; ++i)
+            {
+                gp_Trsf rotation;
+                rotation.SetRotation(parameters.axis, i * step);
+                if (parameters.isAligned)
+                {
+                    transforms.push_back(rotation);
+                    continue;
+                }
+
+                gp_Trsf shift;
+                shift.SetTranslation(base, base.Transformed(rotation));
+                transforms.push_back(shift);
+            }
+            break;
+        }
+        case ArrayKind::Path:
+        {
+            const std::vector<gp_Pnt>& path = parameters.path;
+            const int count = parameters.columns;
+            if (path.size() < 2 || count < 1 || count > THE_MAX_ITEMS) break;
+
+            std::vector<double> lengths(1, 0.0);
+            for (size_t i = 1; i < path.size(); ++i)
+                lengths.push_back(lengths.back() + path[i - 1].Distance(path[i]));
+            const double total = lengths.back();
+            if (total < 1.0e-12) break;
+
+            const double spacing = parameters.columnSpacing > 0.0 ? parameters.columnSpacing : (count > 1 ? total / (count - 1) : 0.0);
+            const gp_Vec startTangent(path[0], path[1]);
+
+            transforms.reserve(count);
+            size_t segment = 1;
+            for (int i = 0; i < count; ++i)
+            {
+                const double s = i * spacing;
+                if (s > total * (1.0 + 1.0e-9)) break;
+                while (segment + 1 < path.size() && lengths[segment] < s) ++segment;
+
+                const double length = lengths[segment] - lengths[segment - 1];
+                const double t = length > 0.0 ? std::min(1.0, (s - lengths[segment - 1]) / length) : 0.0;
+                const gp_Pnt point(path[segment - 1].XYZ() + (path[segment].XYZ() - path[segment - 1].XYZ()) * t);
+
+                // Items keep their placement relative to the path start, turned with the local tangent when aligned
+                gp_Trsf trsf;
+                const gp_Vec tangent(path[segment - 1], path[segment]);
+                if (parameters.isAligned && tangent.SquareMagnitude() > 1.0e-24 && startTangent.SquareMagnitude() > 1.0e-24)
+                    trsf.SetRotation(gp_Quaternion(startTangent, tangent));
+                trsf.SetTranslationPart(gp_Vec(path[0].Transformed(trsf), point));
+                transforms.push_back(trsf);
+            }
+            break;
+        }
+        }
+        return !transforms.empty();
+    }
+
+    int ArrayTable::Create(NativeViewerHandle* native, const ArrayParameters& parameters)
+    {
+        if (native == nullptr || native->context.IsNull()) return 0;
+        const Handle(AIS_InteractiveContext)& context = native->context;
+
+        std::vector<Handle(AIS_InteractiveObject)> sources;
+        std::vector<AIS_InstancedArray::Part> parts;
+        for (int id : native->selectedEntities)
+        {
+            const Handle(AIS_InteractiveObject)& obj = native->entityIndex.Object(id);
+            Handle(AIS_Shape) ais = Handle(AIS_Shape)::DownCast(obj);
+            if (ais.IsNull() || ais->Shape().IsNull() || !context->IsDisplayed(obj))
+                continue;
+
+            AddTemplate(ais, parts);
+            sources.push_back(obj);
+        }
+        if (sources.empty())
+        {
+            std::cout << "⚠️ Array: nothing in the selection can be arrayed." << std::endl;
+            return 0;
+        }
+
+        Bnd_Box box;
+        for (const AIS_InstancedArray::Part& part : parts)
+        {
+            for (const gp_Pnt& p : part.lineNodes) box.Add(p);
+            for (const gp_Pnt& p : part.faceNodes) box.Add(p);
+        }
+        if (box.IsVoid()) return 0;
+
+        Entry entry;
+        entry.parameters = parameters;
+        entry.base = gp_Pnt((box.CornerMin().XYZ() + box.CornerMax().XYZ()) * 0.5);
+
+        std::vector<gp_Trsf> transforms;
+        if (!InstanceTransforms(parameters, entry.base, transforms))
+        {
+            std::cout << "❌ Array: the parameters give no items (or more than " << THE_MAX_ITEMS << ")." << std::endl;
+            return 0;
+        }
+
+        entry.presentation = new AIS_InstancedArray(parts, entry.base);
+        entry.presentation->SetInstances(transforms);
+        entry.sources = sources;
+
+        // The sources are erased, not removed, so undo shows them again in place of the array
+        native->commandJournal.Begin("Array");
+        SelectionHelper::ClearSelection(native, context);
+        for (const Handle(AIS_InteractiveObject)& obj : sources)
+            native->commandJournal.Removed(context, obj);
+
+        context->Display(entry.presentation, 0, 0, Standard_False);
+        SelectionHelper::IndexEntity(native, entry.presentation);
+        native->commandJournal.Added(context, entry.presentation);
+        native->commandJournal.Commit(context);
+        FrameScheduler::Redraw(context);
+
+        const int arrayId = myNextId++;
+        myArrays[arrayId] = entry;
+        std::cout << "✅ Array " << arrayId << " created: " << sources.size() << " entities x " << transforms.size() << " items." << std::endl;
+        return arrayId;
+    }
+
+    bool ArrayTable::Update(NativeViewerHandle* native, int arrayId, const ArrayParameters& parameters)
+    {
+        if (native == nullptr || native->context.IsNull()) return false;
+
+        auto it = myArrays.find(arrayId);
+        if (it == myArrays.end()) return false;
+
+        std::vector<gp_Trsf> transforms;
+        if (!InstanceTransforms(parameters, it->second.base, transforms))
+            return false;
+
+        Entry& entry = it->second;
+        entry.parameters = parameters;
+        entry.presentation->SetInstances(transforms);
+
+        // An erased (undone) array picks the new instances up when it is shown again
+        const Handle(AIS_InteractiveContext)& context = native->context;
+        if (context->IsDisplayed(entry.presentation))
+        {
+            context->Redisplay(entry.presentation, Standard_False);
+            SelectionHelper::RefreshEntity(native, context, entry.presentation);
+            FrameScheduler::Redraw(context);
+        }
+        return true;
+    }
+
+    const ArrayParameters* ArrayTable::Parameters(int arrayId) const
+    {
+        auto it = myArrays.find(arrayId);
+        return it == myArrays.end() ? nullptr : &it->second.parameters;
+    }
+
+    Handle(AIS_InstancedArray) ArrayTable::Presentation(int arrayId) const
+    {
+        auto it = myArrays.find(arrayId);
+        return it == myArrays.end() ? Handle(AIS_InstancedArray)() : it->second.presentation;
+    }
+
+    const std::vector<Handle(AIS_InteractiveObject)>* ArrayTable::Sources(const AIS_InteractiveObject* presentation) const
+    {
+        for (const auto& array : myArrays)
+            if (array.second.presentation.get() == presentation) return &array.second.sources;
+        return nullptr;
+    }
+
+    void ArrayTable::Clear()
+    {
+        myArrays.clear();
+        myNextId = 1;
+    }
+}
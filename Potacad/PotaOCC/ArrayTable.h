@@ -0,0 +1,91 @@
+#pragma once
+#include "AIS_InstancedArray.h"
+#include <gp_Ax1.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: ARRAY commands over the current selection.
+    // Create... turns the selected entities into one associative array and returns its id (0 on failure);
+    // Set... edits the array afterwards, which only changes its instance transformations.
+    public ref class ArrayTablePublic
+    {
+    public:
+        static int CreateRectangular(System::IntPtr viewerHandlePtr, int columns, int rows, int levels,
+            double columnSpacing, double rowSpacing, double levelSpacing);
+
+        // Fill angle 360 spreads the items over the full circle; otherwise the first and last items span it
+        static int CreatePolar(System::IntPtr viewerHandlePtr, double cx, double cy, double cz,
+            double axisX, double axisY, double axisZ, int count, double fillAngleDeg, bool rotateItems);
+
+        // Path as x, y, z triples; spacing 0 spreads the items over the whole path
+        static int CreatePath(System::IntPtr viewerHandlePtr, array<double>^ path, int count, double spacing, bool alignItems);
+
+        static bool SetRectangular(System::IntPtr viewerHandlePtr, int arrayId, int columns, int rows, int levels,
+            double columnSpacing, double rowSpacing, double levelSpacing);
+        static bool SetPolar(System::IntPtr viewerHandlePtr, int arrayId, int count, double fillAngleDeg, bool rotateItems);
+        static bool SetPath(System::IntPtr viewerHandlePtr, int arrayId, int count, double spacing, bool alignItems);
+
+        // Number of copies the array shows, or 0 for an unknown id
+        static int GetItemCount(System::IntPtr viewerHandlePtr, int arrayId);
+    };
+
+    enum class ArrayKind : uint8_t
+    {
+        Rectangular, Polar, Path
+    };
+
+    struct ArrayParameters
+    {
+        ArrayKind kind = ArrayKind::Rectangular;
+        int columns = 1, rows = 1, levels = 1;          // polar and path arrays use columns as the item count
+        double columnSpacing = 0.0, rowSpacing = 0.0, levelSpacing = 0.0;   // path: spacing along the path
+        gp_Ax1 axis;                                    // polar
+        double fillAngleDeg = 360.0;                    // polar
+        bool isAligned = true;                          // polar: items rotate; path: items follow the tangent
+        std::vector<gp_Pnt> path;                       // path polyline
+    };
+
+    // Associative arrays of one viewer. The selected entities become the template of one AIS_InstancedArray
+    // (and are erased through the command journal); the parameters are kept, so an edit recomputes the
+    // instance transformations and redisplays that single object.
+    class ArrayTable
+    {
+    public:
+        static const int THE_MAX_ITEMS = 1000000;
+
+        int Create(NativeViewerHandle* native, const ArrayParameters& parameters);
+        bool Update(NativeViewerHandle* native, int arrayId, const ArrayParameters& parameters);
+
+        const ArrayParameters* Parameters(int arrayId) const;
+        Handle(AIS_InstancedArray) Presentation(int arrayId) const;
+
+        // Template entities of the array shown by presentation; nullptr when it is not one of ours
+        const std::vector<Handle(AIS_InteractiveObject)>* Sources(const AIS_InteractiveObject* presentation) const;
+
+        int Size() const { return (int)myArrays.size(); }
+        void Clear();
+
+        // World transformation of every item; base is the point that non-rotating polar items keep their offset to.
+        // False when the parameters describe no item or more than THE_MAX_ITEMS.
+        static bool InstanceTransforms(const ArrayParameters& parameters, const gp_Pnt& base, std::vector<gp_Trsf>& transforms);
+
+    private:
+        struct Entry
+        {
+            ArrayParameters parameters;
+            gp_Pnt base;
+            Handle(AIS_InstancedArray) presentation;
+            std::vector<Handle(AIS_InteractiveObject)> sources;     // exact geometry of the template
+        };
+
+        std::map<int, Entry> myArrays;
+        int myNextId = 1;
+    };
+}
@@ -0,0 +1,398 @@
+#include "pch.h"
+#include "BlockTable.h"
+#include "NativeViewerHandle.h"
+#include "SelectionHelper.h"
+#include <AIS_ConnectedInteractive.hxx>
+#include <BRep_Builder.hxx>
+#include <BRepBuilderAPI_GTransform.hxx>
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_MakePolygon.hxx>
+#include <GC_MakeArcOfCircle.hxx>
+#include <Geom_Circle.hxx>
+#include <Geom_TrimmedCurve.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Circ.hxx>
+#include <gp_Mat.hxx>
+#include <Standard_Failure.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS.hxx>
+#include <msclr/marshal_cppstd.h>
+#include <algorithm>
+#include <cmath>
+#include <cwctype>
+#include <iostream>
+
+namespace PotaOCC
+{
+    bool BlockTablePublic::BeginBlock(System::IntPtr viewerHandlePtr, System::String^ name, double baseX, double baseY, double baseZ)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || name == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return false;
+
+        msclr::interop::marshal_context ctx;
+        return native->blocks.Begin(ctx.marshal_as<std::wstring>(name), gp_Pnt(baseX, baseY, baseZ));
+    }
+
+    void BlockTablePublic::AddLine(System::IntPtr viewerHandlePtr, double x1, double y1, double z1, double x2, double y2, double z2, int r, int g, int b)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        const gp_Pnt p1(x1, y1, z1), p2(x2, y2, z2);
+        if (p1.IsEqual(p2, 1e-9)) return;
+        native->blocks.AddShape(BRepBuilderAPI_MakeEdge(p1, p2).Edge(), Quantity_Color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB));
+    }
+
+    void BlockTablePublic::AddArc(System::IntPtr viewerHandlePtr, double cx, double cy, double cz, double radius, double startDeg, double endDeg, int r, int g, int b)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || radius <= 0.0) return;
+
+        const gp_Circ circle(gp_Ax2(gp_Pnt(cx, cy, cz), gp::DZ()), radius);
+        double sweep = std::fmod(endDeg - startDeg, 360.0);
+        if (sweep <= 0.0) sweep += 360.0;
+
+        const Quantity_Color color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB);
+        try
+        {
+            if (sweep >= 360.0 - 1e-9)
+            {
+                native->blocks.AddShape(BRepBuilderAPI_MakeEdge(circle).Edge(), color);
+                return;
+            }
+            const double start = startDeg * M_PI / 180.0;
+            native->blocks.AddShape(BRepBuilderAPI_MakeEdge(circle, start, start + sweep * M_PI / 180.0).Edge(), color);
+        }
+        catch (const Standard_Failure&)
+        {
+            std::cout << "⚠️ BlockTable: arc skipped." << std::endl;
+        }
+    }
+
+    void BlockTablePublic::AddPolyline(System::IntPtr viewerHandlePtr, array<double>^ x, array<double>^ y, array<double>^ bulge, double elevation, bool isClosed, int r, int g, int b)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || x == nullptr || y == nullptr) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        const int n = std::min(x->Length, y->Length);
+        if (!native || n < 2) return;
+
+        BRep_Builder builder;
+        TopoDS_Compound compound;
+        builder.MakeCompound(compound);
+
+        const int nbSegments = isClosed ? n : n - 1;
+        for (int i = 0; i < nbSegments; ++i)
+        {
+            const int j = (i + 1) % n;
+            const gp_Pnt p1(x[i], y[i], elevation), p2(x[j], y[j], elevation);
+            if (p1.IsEqual(p2, 1e-9)) continue;
+
+            const double segmentBulge = (bulge != nullptr && i < bulge->Length) ? bulge[i] : 0.0;
+            try
+            {
+                if (std::fabs(segmentBulge) < 1e-12)
+                {
+                    builder.Add(compound, BRepBuilderAPI_MakeEdge(p1, p2).Edge());
+                    continue;
+                }
+
+                // Arc midpoint lies a sagitta of bulge * chord / 2 to the right of the chord for CCW (positive) bulges
+                const gp_Vec chord(p1, p2);
+                gp_Vec right(chord.Y(), -chord.X(), 0.0);
+                right.Normalize();
+                const gp_Pnt mid = p1.Translated(chord * 0.5).Translated(right * (segmentBulge * chord.Magnitude() * 0.5));
+                Handle(Geom_TrimmedCurve) arc = GC_MakeArcOfCircle(p1, mid, p2);
+                builder.Add(compound, BRepBuilderAPI_MakeEdge(arc).Edge());
+            }
+            catch (const Standard_Failure&)
+            {
+                builder.Add(compound, BRepBuilderAPI_MakeEdge(p1, p2).Edge());
+            }
+        }
+
+        native->blocks.AddShape(compound, Quantity_Color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB));
+    }
+
+    void BlockTablePublic::AddFace(System::IntPtr viewerHandlePtr, array<double>^ corners, int r, int g, int b)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || corners == nullptr || corners->Length < 9) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        BRepBuilderAPI_MakePolygon polygon;
+        gp_Pnt previous;
+        for (int i = 0; i + 2 < corners->Length && i < 12; i += 3)
+        {
+            const gp_Pnt p(corners[i], corners[i + 1], corners[i + 2]);
+            // The fourth corner of a triangle repeats the third
+            if (i > 0 && p.IsEqual(previous, 1e-9)) continue;
+            polygon.Add(p);
+            previous = p;
+        }
+        polygon.Close();
+        if (!polygon.IsDone()) return;
+
+        BRepBuilderAPI_MakeFace face(polygon.Wire(), Standard_True);
+        native->blocks.AddShape(face.IsDone() ? face.Shape() : polygon.Shape(), Quantity_Color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB));
+    }
+
+    void BlockTablePublic::AddInsert(System::IntPtr viewerHandlePtr, System::String^ name, double x, double y, double z, double scaleX, double scaleY, double scaleZ, double rotationDeg)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || name == nullptr) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        BlockPlacement placement;
+        placement.point = gp_Pnt(x, y, z);
+        placement.scaleX = scaleX; placement.scaleY = scaleY; placement.scaleZ = scaleZ;
+        placement.rotationDeg = rotationDeg;
+
+        msclr::interop::marshal_context ctx;
+        native->blocks.AddReference(ctx.marshal_as<std::wstring>(name), placement);
+    }
+
+    bool BlockTablePublic::EndBlock(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        return native && native->blocks.End();
+    }
+
+    int BlockTablePublic::Insert(System::IntPtr viewerHandlePtr, System::String^ name, double x, double y, double z,
+        double scaleX, double scaleY, double scaleZ, double rotationDeg,
+        int columns, int rows, double columnSpacing, double rowSpacing)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || name == nullptr) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return 0;
+
+        BlockPlacement placement;
+        placement.point = gp_Pnt(x, y, z);
+        placement.scaleX = scaleX; placement.scaleY = scaleY; placement.scaleZ = scaleZ;
+        placement.rotationDeg = rotationDeg;
+
+        msclr::interop::marshal_context ctx;
+        return native->blocks.Insert(native, ctx.marshal_as<std::wstring>(name), placement, columns, rows, columnSpacing, rowSpacing);
+    }
+
+    uint32_t BlockTable::PackColor(const Quantity_Color& color)
+    {
+        auto channel = [](double value) { return (uint32_t)std::lround(std::min(1.0, std::max(0.0, value)) * 255.0); };
+        return (channel(color.Red()) << 16) | (channel(color.Green()) << 8) | channel(color.Blue());
+    }
+
+    Quantity_Color BlockTable::UnpackColor(uint32_t rgb)
+    {
+        return Quantity_Color(((rgb >> 16) & 0xFF) / 255.0, ((rgb >> 8) & 0xFF) / 255.0, (rgb & 0xFF) / 255.0, Quantity_TOC_RGB);
+    }
+
+    // Block names are case-insensitive in DXF
+    std::wstring BlockTable::Key(const std::wstring& name)
+    {
+        std::wstring key(name);
+        std::transform(key.begin(), key.end(), key.begin(), [](wchar_t c) { return (wchar_t)std::towupper(c); });
+        return key;
+    }
+
+    bool BlockTable::PlacementTrsf(const gp_Pnt& base, const BlockPlacement& placement, gp_Trsf& trsf, gp_GTrsf& gtrsf)
+    {
+        const double angle = placement.rotationDeg * M_PI / 180.0;
+        const double c = std::cos(angle), s = std::sin(angle);
+
+        // world = point + R(angle) * diag(scale) * (local - base)
+        const gp_Mat linear(c * placement.scaleX, -s * placement.scaleY, 0.0,
+                            s * placement.scaleX,  c * placement.scaleY, 0.0,
+                            0.0, 0.0, placement.scaleZ);
+        gp_XYZ translation = base.XYZ();
+        translation.Multiply(linear);
+        translation = placement.point.XYZ() - translation;
+
+        gtrsf.SetVectorialPart(linear);
+        gtrsf.SetTranslationPart(translation);
+
+        const double ax = std::fabs(placement.scaleX), ay = std::fabs(placement.scaleY), az = std::fabs(placement.scaleZ);
+        const double tolerance = 1e-12 * std::max(ax, std::max(ay, az));
+        if (ax < tolerance || std::fabs(ax - ay) > tolerance || std::fabs(ax - az) > tolerance)
+            return false;
+
+        // Mirrors and uniform scales still fit gp_Trsf (a negative scale folds the reflection)
+        trsf.SetValues(linear(1, 1), linear(1, 2), linear(1, 3), translation.X(),
+                       linear(2, 1), linear(2, 2), linear(2, 3), translation.Y(),
+                       linear(3, 1), linear(3, 2), linear(3, 3), translation.Z());
+        return true;
+    }
+
+    bool BlockTable::Begin(const std::wstring& name, const gp_Pnt& base)
+    {
+        if (name.empty()) return false;
+
+        // A redefinition replaces the block; instances already shown keep the old prototype
+        Definition& def = myBlocks[Key(name)];
+        def = Definition();
+        def.name = name;
+        def.base = base;
+        myOpen = &def;
+        return true;
+    }
+
+    void BlockTable::AddShape(const TopoDS_Shape& shape, const Quantity_Color& color)
+    {
+        if (myOpen == nullptr || shape.IsNull()) return;
+
+        BRep_Builder builder;
+        TopoDS_Compound& group = myOpen->groups[PackColor(color)];
+        if (group.IsNull()) builder.MakeCompound(group);
+        builder.Add(group, shape);
+    }
+
+    void BlockTable::AddReference(const std::wstring& name, const BlockPlacement& placement)
+    {
+        if (myOpen == nullptr || name.empty()) return;
+
+        Reference reference;
+        reference.name = name;
+        reference.placement = placement;
+        myOpen->references.push_back(reference);
+    }
+
+    bool BlockTable::End()
+    {
+        const bool wasOpen = myOpen != nullptr;
+        myOpen = nullptr;
+        return wasOpen;
+    }
+
+    Handle(AIS_ColoredShape) BlockTable::Present(const std::map<uint32_t, TopoDS_Compound>& groups, TopoDS_Compound& shape) const
+    {
+        BRep_Builder builder;
+        builder.MakeCompound(shape);
+        for (const auto& group : groups)
+            builder.Add(shape, group.second);
+
+        Handle(AIS_ColoredShape) prototype = new AIS_ColoredShape(shape);
+        for (const auto& group : groups)
+            prototype->SetCustomColor(group.second, UnpackColor(group.first));
+        return prototype;
+    }
+
+    BlockTable::Definition* BlockTable::Resolve(const std::wstring& name)
+    {
+        auto it = myBlocks.find(Key(name));
+        if (it == myBlocks.end())
+        {
+            std::wcout << L"⚠️ Block not defined: " << name << std::endl;
+            return nullptr;
+        }
+
+        Definition& def = it->second;
+        if (def.isResolved) return &def;
+        if (def.isResolving)
+        {
+            std::wcout << L"⚠️ Block references itself: " << name << std::endl;
+            return nullptr;
+        }
+        def.isResolving = true;
+
+        BRep_Builder builder;
+        def.resolved = def.groups;
+        for (const Reference& reference : def.references)
+        {
+            Definition* nested = Resolve(reference.name);
+            if (nested == nullptr) continue;
+
+            gp_Trsf trsf;
+            gp_GTrsf gtrsf;
+            const bool isRigid = PlacementTrsf(nested->base, reference.placement, trsf, gtrsf);
+            for (const auto& group : nested->resolved)
+            {
+                // Located references share the nested TShapes; only a non-uniform scale copies geometry
+                TopoDS_Shape placed;
+                if (isRigid)
+                {
+                    placed = group.second.Moved(TopLoc_Location(trsf), Standard_False);
+                }
+                else
+                {
+                    BRepBuilderAPI_GTransform transform(group.second, gtrsf, Standard_True);
+                    if (!transform.IsDone()) continue;
+                    placed = transform.Shape();
+                }
+
+                TopoDS_Compound& target = def.resolved[group.first];
+                if (target.IsNull()) builder.MakeCompound(target);
+                builder.Add(target, placed);
+            }
+        }
+
+        if (!def.resolved.empty())
+            def.prototype = Present(def.resolved, def.shape);
+
+        def.isResolving = false;
+        def.isResolved = true;
+        return &def;
+    }
+
+    int BlockTable::Insert(NativeViewerHandle* native, const std::wstring& name, const BlockPlacement& placement,
+        int columns, int rows, double columnSpacing, double rowSpacing)
+    {
+        if (native == nullptr || native->context.IsNull()) return 0;
+
+        Definition* def = Resolve(name);
+        if (def == nullptr || def->prototype.IsNull()) return 0;
+
+        columns = std::max(1, columns);
+        rows = std::max(1, rows);
+        const double angle = placement.rotationDeg * M_PI / 180.0;
+        const gp_Vec columnStep(std::cos(angle) * columnSpacing, std::sin(angle) * columnSpacing, 0.0);
+        const gp_Vec rowStep(-std::sin(angle) * rowSpacing, std::cos(angle) * rowSpacing, 0.0);
+
+        int nbShown = 0;
+        for (int row = 0; row < rows; ++row)
+        {
+            for (int column = 0; column < columns; ++column)
+            {
+                BlockPlacement cell = placement;
+                cell.point = placement.point.Translated(columnStep * column + rowStep * row);
+
+                gp_Trsf trsf;
+                gp_GTrsf gtrsf;
+                Handle(AIS_InteractiveObject) instance;
+                if (PlacementTrsf(def->base, cell, trsf, gtrsf))
+                {
+                    Handle(AIS_ConnectedInteractive) connected = new AIS_ConnectedInteractive();
+                    connected->Connect(def->prototype, trsf);
+                    instance = connected;
+                }
+                else
+                {
+                    // Stretched insert: the only case that needs geometry of its own
+                    std::map<uint32_t, TopoDS_Compound> stretched;
+                    for (const auto& group : def->resolved)
+                    {
+                        BRepBuilderAPI_GTransform transform(group.second, gtrsf, Standard_True);
+                        if (transform.IsDone())
+                            stretched[group.first] = TopoDS::Compound(transform.Shape());
+                    }
+                    if (stretched.empty()) continue;
+
+                    TopoDS_Compound shape;
+                    instance = Present(stretched, shape);
+                }
+
+                SelectionHelper::DisplayDeferred(native, native->context, instance);
+                ++nbShown;
+            }
+        }
+        return nbShown;
+    }
+
+    void BlockTable::Clear()
+    {
+        myBlocks.clear();
+        myOpen = nullptr;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <AIS_ColoredShape.hxx>
+#include <gp_GTrsf.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <TopoDS_Compound.hxx>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: DXF block definitions and their INSERT instances.
+    // Definitions are streamed in with BeginBlock / Add... / EndBlock, in any order;
+    // nested references are resolved when a block is first inserted.
+    public ref class BlockTablePublic
+    {
+    public:
+        static bool BeginBlock(System::IntPtr viewerHandlePtr, System::String^ name, double baseX, double baseY, double baseZ);
+        static void AddLine(System::IntPtr viewerHandlePtr, double x1, double y1, double z1, double x2, double y2, double z2, int r, int g, int b);
+
+        // Full circle when the angles span 360 degrees
+        static void AddArc(System::IntPtr viewerHandlePtr, double cx, double cy, double cz, double radius, double startDeg, double endDeg, int r, int g, int b);
+
+        // LWPOLYLINE / POLYLINE vertices; bulge[i] bends the segment from vertex i to the next
+        static void AddPolyline(System::IntPtr viewerHandlePtr, array<double>^ x, array<double>^ y, array<double>^ bulge, double elevation, bool isClosed, int r, int g, int b);
+
+        // SOLID / 3DFACE corners as x, y, z triples (3 or 4 corners)
+        static void AddFace(System::IntPtr viewerHandlePtr, array<double>^ corners, int r, int g, int b);
+
+        static void AddInsert(System::IntPtr viewerHandlePtr, System::String^ name, double x, double y, double z, double scaleX, double scaleY, double scaleZ, double rotationDeg);
+        static bool EndBlock(System::IntPtr viewerHandlePtr);
+
+        // INSERT (or MINSERT when columns/rows exceed 1) on the current layer; returns the number of instances shown
+        static int Insert(System::IntPtr viewerHandlePtr, System::String^ name, double x, double y, double z,
+            double scaleX, double scaleY, double scaleZ, double rotationDeg,
+            int columns, int rows, double columnSpacing, double rowSpacing);
+    };
+
+    // Where and how a block reference places the block's geometry
+    struct BlockPlacement
+    {
+        gp_Pnt point;
+        double scaleX = 1.0, scaleY = 1.0, scaleZ = 1.0;
+        double rotationDeg = 0.0;
+    };
+
+    // Block definitions of one viewer. Each block is built once: its geometry is grouped by colour into
+    // compounds, nested blocks join those groups as located sub-shapes sharing the nested TShapes,
+    // and one AIS_ColoredShape prototype presents the result. Every INSERT is an AIS_ConnectedInteractive
+    // of that prototype with its own transformation, so memory follows the number of distinct blocks.
+    // Only references with non-uniform scale, which a TopLoc_Location cannot express, get their own geometry.
+    class BlockTable
+    {
+    public:
+        bool Begin(const std::wstring& name, const gp_Pnt& base);
+        void AddShape(const TopoDS_Shape& shape, const Quantity_Color& color);
+        void AddReference(const std::wstring& name, const BlockPlacement& placement);
+        bool End();
+
+        int Insert(NativeViewerHandle* native, const std::wstring& name, const BlockPlacement& placement,
+            int columns, int rows, double columnSpacing, double rowSpacing);
+
+        int Size() const { return (int)myBlocks.size(); }
+        void Clear();
+
+        // Block space to world; false when the scale is non-uniform and only the general form applies
+        static bool PlacementTrsf(const gp_Pnt& base, const BlockPlacement& placement, gp_Trsf& trsf, gp_GTrsf& gtrsf);
+
+    private:
+        struct Reference
+        {
+            std::wstring name;
+            BlockPlacement placement;
+        };
+
+        struct Definition
+        {
+            std::wstring name;
+            gp_Pnt base;
+            std::map<uint32_t, TopoDS_Compound> groups;     // own geometry by packed RGB
+            std::vector<Reference> references;
+
+            bool isResolved = false;
+            bool isResolving = false;                       // guards against self-referencing blocks
+            std::map<uint32_t, TopoDS_Compound> resolved;   // own and nested geometry by packed RGB
+            TopoDS_Compound shape;
+            Handle(AIS_ColoredShape) prototype;
+        };
+
+        static uint32_t PackColor(const Quantity_Color& color);
+        static Quantity_Color UnpackColor(uint32_t rgb);
+        static std::wstring Key(const std::wstring& name);
+
+        Definition* Resolve(const std::wstring& name);
+        Handle(AIS_ColoredShape) Present(const std::map<uint32_t, TopoDS_Compound>& groups, TopoDS_Compound& shape) const;
+
+        std::unordered_map<std::wstring, Definition> myBlocks;
+        Definition* myOpen = nullptr;                       // block between Begin and End
+    };
+}
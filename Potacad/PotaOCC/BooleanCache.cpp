@@ -0,0 +1,147 @@
+#include "pch.h"
+#include "BooleanCache.h"
+#include <TopExp_Explorer.hxx>
+#include <functional>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        void HashCombine(size_t& seed, size_t value)
+        {
+            seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        }
+
+        bool SameShapes(const std::vector<TopoDS_Shape>& cached, const TopTools_ListOfShape& shapes)
+        {
+            if ((int)cached.size() != shapes.Extent()) return false;
+            size_t i = 0;
+            for (TopTools_ListOfShape::Iterator it(shapes); it.More(); it.Next(), ++i)
+                if (!cached[i].IsEqual(it.Value())) return false;
+            return true;
+        }
+
+        std::vector<TopoDS_Shape> ToVector(const TopTools_ListOfShape& shapes)
+        {
+            std::vector<TopoDS_Shape> out;
+            out.reserve(shapes.Extent());
+            for (TopTools_ListOfShape::Iterator it(shapes); it.More(); it.Next())
+                out.push_back(it.Value());
+            return out;
+        }
+    }
+
+    size_t BooleanCache::HashKey(BooleanOperation operation, const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools,
+        const BooleanOptions& options)
+    {
+        size_t key = std::hash<int>{}((int)operation);
+        for (TopTools_ListOfShape::Iterator it(arguments); it.More(); it.Next())
+        {
+            HashCombine(key, std::hash<TopoDS_Shape>{}(it.Value()));
+            HashCombine(key, std::hash<int>{}((int)it.Value().Orientation()));
+        }
+        HashCombine(key, 0x7f);                 // argument/tool separator
+        for (TopTools_ListOfShape::Iterator it(tools); it.More(); it.Next())
+        {
+            HashCombine(key, std::hash<TopoDS_Shape>{}(it.Value()));
+            HashCombine(key, std::hash<int>{}((int)it.Value().Orientation()));
+        }
+        HashCombine(key, std::hash<double>{}(options.fuzzyValue));
+        HashCombine(key, std::hash<int>{}((int)options.glue));
+        return key;
+    }
+
+    bool BooleanCache::Matches(const Entry& entry, BooleanOperation operation, const TopTools_ListOfShape& arguments,
+        const TopTools_ListOfShape& tools, const BooleanOptions& options)
+    {
+        return entry.operation == operation
+            && entry.fuzzyValue == options.fuzzyValue
+            && entry.glue == options.glue
+            && SameShapes(entry.arguments, arguments)
+            && SameShapes(entry.tools, tools);
+    }
+
+    // Rough B-Rep footprint: surfaces and curves dominate, so weigh faces and edges most
+    size_t BooleanCache::EstimateBytes(const TopoDS_Shape& shape)
+    {
+        size_t bytes = 256;
+        for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) bytes += 2048;
+        for (TopExp_Explorer exp(shape, TopAbs_EDGE); exp.More(); exp.Next()) bytes += 512;
+        for (TopExp_Explorer exp(shape, TopAbs_VERTEX); exp.More(); exp.Next()) bytes += 128;
+        return bytes;
+    }
+
+    bool BooleanCache::Find(BooleanOperation operation, const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools,
+        const BooleanOptions& options, TopoDS_Shape& result)
+    {
+        const size_t key = HashKey(operation, arguments, tools, options);
+        auto range = myIndex.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (!Matches(*it->second, operation, arguments, tools, options)) continue;
+
+            myEntries.splice(myEntries.begin(), myEntries, it->second);
+            result = it->second->result;
+            return true;
+        }
+        return false;
+    }
+
+    void BooleanCache::Insert(BooleanOperation operation, const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools,
+        const BooleanOptions& options, const TopoDS_Shape& result)
+    {
+        if (result.IsNull()) return;
+
+        TopoDS_Shape existing;
+        if (Find(operation, arguments, tools, options, existing))
+            return;
+
+        Entry entry;
+        entry.key = HashKey(operation, arguments, tools, options);
+        entry.operation = operation;
+        entry.arguments = ToVector(arguments);
+        entry.tools = ToVector(tools);
+        entry.fuzzyValue = options.fuzzyValue;
+        entry.glue = options.glue;
+        entry.result = result;
+
+        // Operands are held too, so they count against the budget
+        entry.bytes = EstimateBytes(result);
+        for (const TopoDS_Shape& s : entry.arguments) entry.bytes += EstimateBytes(s);
+        for (const TopoDS_Shape& s : entry.tools) entry.bytes += EstimateBytes(s);
+        if (entry.bytes > myBudget) return;
+
+        myBytes += entry.bytes;
+        myEntries.push_front(std::move(entry));
+        myIndex.emplace(myEntries.front().key, myEntries.begin());
+        EvictToBudget();
+    }
+
+    void BooleanCache::SetBudget(size_t budgetBytes)
+    {
+        myBudget = budgetBytes;
+        EvictToBudget();
+    }
+
+    void BooleanCache::Clear()
+    {
+        myEntries.clear();
+        myIndex.clear();
+        myBytes = 0;
+    }
+
+    void BooleanCache::EvictToBudget()
+    {
+        while (myBytes > myBudget && !myEntries.empty())
+        {
+            EntryIterator last = std::prev(myEntries.end());
+            auto range = myIndex.equal_range(last->key);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == last) { myIndex.erase(it); break; }
+            }
+            myBytes -= last->bytes;
+            myEntries.erase(last);
+        }
+    }
+}
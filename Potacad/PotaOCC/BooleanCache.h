@@ -0,0 +1,60 @@
+#pragma once
+#include "BooleanOptions.h"
+#include <TopoDS_Shape.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace PotaOCC
+{
+    // LRU memo of boolean results keyed by (operation, operand identities, fuzzy value, glue).
+    // Operands are compared by TShape + location + orientation, so a re-run on untouched shapes hits,
+    // while any edit (which always produces new topology) misses. Bounded by an estimated byte budget.
+    class BooleanCache
+    {
+    public:
+        static const size_t THE_DEFAULT_BUDGET = 256u * 1024u * 1024u;
+
+        explicit BooleanCache(size_t budgetBytes = THE_DEFAULT_BUDGET) : myBudget(budgetBytes) {}
+
+        bool Find(BooleanOperation operation, const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools,
+            const BooleanOptions& options, TopoDS_Shape& result);
+        void Insert(BooleanOperation operation, const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools,
+            const BooleanOptions& options, const TopoDS_Shape& result);
+
+        void SetBudget(size_t budgetBytes);
+        void Clear();
+
+        int Size() const { return (int)myEntries.size(); }
+        size_t Bytes() const { return myBytes; }
+
+    private:
+        struct Entry
+        {
+            size_t key = 0;
+            BooleanOperation operation = BooleanOperation::Fuse;
+            std::vector<TopoDS_Shape> arguments;
+            std::vector<TopoDS_Shape> tools;
+            double fuzzyValue = 0.0;
+            BOPAlgo_GlueEnum glue = BOPAlgo_GlueOff;
+            TopoDS_Shape result;
+            size_t bytes = 0;
+        };
+        typedef std::list<Entry>::iterator EntryIterator;
+
+        static size_t HashKey(BooleanOperation operation, const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools,
+            const BooleanOptions& options);
+        static bool Matches(const Entry& entry, BooleanOperation operation, const TopTools_ListOfShape& arguments,
+            const TopTools_ListOfShape& tools, const BooleanOptions& options);
+        static size_t EstimateBytes(const TopoDS_Shape& shape);
+
+        void EvictToBudget();
+
+        std::list<Entry> myEntries;                             // most recently used first
+        std::unordered_multimap<size_t, EntryIterator> myIndex;
+        size_t myBudget;
+        size_t myBytes = 0;
+    };
+}
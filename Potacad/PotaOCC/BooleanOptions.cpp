@@ -0,0 +1,42 @@
+#include "pch.h"
+#include "BooleanOptions.h"
+#include <BRepAlgoAPI_BooleanOperation.hxx>
+#include <TopExp_Explorer.hxx>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        int CountFaces(const TopTools_ListOfShape& shapes)
+        {
+            int nbFaces = 0;
+            for (TopTools_ListOfShape::Iterator it(shapes); it.More(); it.Next())
+                for (TopExp_Explorer exp(it.Value(), TopAbs_FACE); exp.More(); exp.Next())
+                    ++nbFaces;
+            return nbFaces;
+        }
+    }
+
+    BooleanOptions BooleanOptions::ForOperands(const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools)
+    {
+        const int nbFaces = CountFaces(arguments) + CountFaces(tools);
+        const bool isMultiTool = tools.Extent() > 1;
+
+        BooleanOptions options;
+        // Thread start-up only pays off once there are enough face pairs to intersect
+        options.runParallel = nbFaces >= 200 || isMultiTool;
+        // Most tool pairs of a multi-tool cut never touch; OBB rejects them before the face-face stage
+        options.useOBB = nbFaces >= 1000 || isMultiTool;
+        return options;
+    }
+
+    void BooleanOptions::Apply(BRepAlgoAPI_BooleanOperation& op) const
+    {
+        op.SetRunParallel(runParallel);
+        op.SetUseOBB(useOBB);
+        op.SetGlue(glue);
+        op.SetNonDestructive(nonDestructive);
+        if (fuzzyValue > 0.0)
+            op.SetFuzzyValue(fuzzyValue);
+    }
+}
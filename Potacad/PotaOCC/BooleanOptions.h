@@ -0,0 +1,25 @@
+#pragma once
+#include <BOPAlgo_GlueEnum.hxx>
+#include <TopTools_ListOfShape.hxx>
+
+class BRepAlgoAPI_BooleanOperation;
+
+namespace PotaOCC
+{
+    enum class BooleanOperation { Fuse, Cut, Common };
+
+    // Engine settings for BRepAlgoAPI booleans. ForOperands() picks per-operation defaults from
+    // operand size; a viewer can override them through ShapeBooleanOperatorPublic::SetBooleanOptions.
+    struct BooleanOptions
+    {
+        bool runParallel = false;               // parallel intersection of sub-shape pairs
+        double fuzzyValue = 0.0;                // extra tolerance for near-coincident geometry, 0 = exact
+        bool useOBB = false;                    // oriented-box pre-filter of interfering pairs
+        BOPAlgo_GlueEnum glue = BOPAlgo_GlueOff;
+        bool nonDestructive = true;             // never fix operand tolerances in place
+
+        static BooleanOptions ForOperands(const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools);
+
+        void Apply(BRepAlgoAPI_BooleanOperation& op) const;
+    };
+}
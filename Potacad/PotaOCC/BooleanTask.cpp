@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "BooleanTask.h"
+#include <BRepAlgoAPI_Fuse.hxx>
+#include <BRepAlgoAPI_Cut.hxx>
+#include <BRepAlgoAPI_Common.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <Standard_Failure.hxx>
+#include <iostream>
+#include <memory>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        // Shares the curves and surfaces but no TFace, so no triangulation the UI thread writes
+        TopTools_ListOfShape TopologyCopies(const TopTools_ListOfShape& shapes)
+        {
+            TopTools_ListOfShape copies;
+            for (TopTools_ListIteratorOfListOfShape it(shapes); it.More(); it.Next())
+                copies.Append(BRepBuilderAPI_Copy(it.Value(), Standard_False, Standard_False).Shape());
+            return copies;
+        }
+    }
+
+    BooleanTask::BooleanTask(BooleanOperation operation, const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools, const BooleanOptions& options)
+        : myOperation(operation), myArguments(arguments), myTools(tools),
+          myArgumentCopies(TopologyCopies(arguments)), myToolCopies(TopologyCopies(tools)), myOptions(options)
+    {
+    }
+
+    BooleanTask::~BooleanTask()
+    {
+        Cancel();
+        if (myThread.joinable())
+            myThread.join();
+    }
+
+    void BooleanTask::Start()
+    {
+        myThread = std::thread(&BooleanTask::Run, this);
+    }
+
+    bool BooleanTask::Perform(
+        BooleanOperation operation,
+        const TopTools_ListOfShape& arguments,
+        const TopTools_ListOfShape& tools,
+        const BooleanOptions& options,
+        TopoDS_Shape& result,
+        const Message_ProgressRange& range)
+    {
+        std::unique_ptr<BRepAlgoAPI_BooleanOperation> op;
+        switch (operation)
+        {
+        case BooleanOperation::Fuse:   op.reset(new BRepAlgoAPI_Fuse());   break;
+        case BooleanOperation::Cut:    op.reset(new BRepAlgoAPI_Cut());    break;
+        case BooleanOperation::Common: op.reset(new BRepAlgoAPI_Common()); break;
+        }
+
+        op->SetArguments(arguments);
+        op->SetTools(tools);
+        options.Apply(*op);
+
+        try
+        {
+            op->Build(range);
+            if (!op->IsDone() || op->HasErrors() || range.UserBreak())
+                return false;
+            result = op->Shape();
+            return true;
+        }
+        catch (Standard_Failure& e)
+        {
+            std::cerr << "❌ Boolean failed: " << e.GetMessageString() << std::endl;
+            return false;
+        }
+    }
+
+    void BooleanTask::Run()
+    {
+        Handle(BooleanProgress) progress = new BooleanProgress(myPercent, myIsCancelled);
+        mySucceeded = Perform(myOperation, myArgumentCopies, myToolCopies, myOptions, myResult, progress->Start());
+        myIsFinished.store(true);
+    }
+}
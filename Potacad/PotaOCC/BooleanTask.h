@@ -0,0 +1,95 @@
+#pragma once
+#include "BooleanOptions.h"
+#include <TopoDS_Shape.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <Message_ProgressIndicator.hxx>
+#include <Message_ProgressScope.hxx>
+#include <atomic>
+#include <thread>
+
+namespace PotaOCC
+{
+    // Forwards OCCT progress to atomics the UI thread can poll; UserBreak() is how Cancel() reaches the algorithm
+    class BooleanProgress : public Message_ProgressIndicator
+    {
+    public:
+        BooleanProgress(std::atomic<int>& percent, const std::atomic<bool>& isCancelled)
+            : myPercent(percent), myIsCancelled(isCancelled) {}
+
+        virtual Standard_Boolean UserBreak() override { return myIsCancelled.load(); }
+
+    protected:
+        virtual void Show(const Message_ProgressScope& /*theScope*/, const Standard_Boolean /*isForce*/) override
+        {
+            myPercent.store((int)(GetPosition() * 100.0));
+        }
+
+    private:
+        std::atomic<int>& myPercent;
+        const std::atomic<bool>& myIsCancelled;
+    };
+
+    // One boolean running on a worker thread. Operand lists are copied in, the result is only read
+    // by the UI thread once IsFinished() is true, so no AIS object is ever touched off-thread.
+    // The worker runs on topology-only copies of the operands: the UI thread keeps moving meshes
+    // onto the displayed faces (MeshingService) while the boolean reads its own.
+    class BooleanTask
+    {
+    public:
+        BooleanTask(BooleanOperation operation, const TopTools_ListOfShape& arguments, const TopTools_ListOfShape& tools, const BooleanOptions& options);
+        ~BooleanTask();                         // cancels and joins
+
+        BooleanTask(const BooleanTask&) = delete;
+        BooleanTask& operator=(const BooleanTask&) = delete;
+
+        void Start();
+        void Cancel() { myIsCancelled.store(true); }
+
+        BooleanOperation Operation() const { return myOperation; }
+        const TopTools_ListOfShape& Arguments() const { return myArguments; }
+        const TopTools_ListOfShape& Tools() const { return myTools; }
+        const BooleanOptions& Options() const { return myOptions; }
+        bool IsFinished() const { return myIsFinished.load(); }
+        bool IsCancelled() const { return myIsCancelled.load(); }
+        int Percent() const { return myPercent.load(); }
+
+        // Valid once IsFinished() is true
+        bool Succeeded() const { return mySucceeded; }
+        const TopoDS_Shape& Result() const { return myResult; }
+
+        // Called from the UI thread: true when progress advanced a full step since the last call
+        bool TakeProgressStep(int step, int& percent)
+        {
+            percent = Percent();
+            if (percent < myReportedPercent + step) return false;
+            myReportedPercent = percent;
+            return true;
+        }
+
+        // Synchronous boolean of arguments against every tool in one pass (one argument, N tools = one build)
+        static bool Perform(
+            BooleanOperation operation,
+            const TopTools_ListOfShape& arguments,
+            const TopTools_ListOfShape& tools,
+            const BooleanOptions& options,
+            TopoDS_Shape& result,
+            const Message_ProgressRange& range = Message_ProgressRange());
+
+    private:
+        void Run();
+
+        BooleanOperation myOperation;
+        TopTools_ListOfShape myArguments;
+        TopTools_ListOfShape myTools;
+        TopTools_ListOfShape myArgumentCopies;  // what the worker reads
+        TopTools_ListOfShape myToolCopies;
+        BooleanOptions myOptions;
+        TopoDS_Shape myResult;
+        bool mySucceeded = false;
+        int myReportedPercent = 0;
+        std::atomic<bool> myIsCancelled{ false };
+        std::atomic<bool> myIsFinished{ false };
+        std::atomic<int> myPercent{ 0 };
+        std::thread myThread;
+    };
+}
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "CameraAnimator.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "ViewerManager.h"
+#include <V3d_TypeOfOrientation.hxx>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        const double THE_DURATION = 0.35;     // seconds; long enough to follow, short enough not to wait for
+    }
+
+    void CameraAnimatorPublic::FitAll(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->view.IsNull()) return;
+
+        native->cameraAnimation.AnimateTo(native, [](const Handle(V3d_View)& view)
+        {
+            LayerTable::FitAll(view);
+        });
+    }
+
+    void CameraAnimatorPublic::SetViewPreset(System::IntPtr viewerHandlePtr, int orientation)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->view.IsNull()) return;
+        if (orientation < V3d_Xpos || orientation > V3d_XnegYnegZneg) return;
+
+        const V3d_TypeOfOrientation preset = static_cast<V3d_TypeOfOrientation>(orientation);
+        native->cameraAnimation.AnimateTo(native, [preset](const Handle(V3d_View)& view)
+        {
+            view->SetProj(preset);
+            LayerTable::FitAll(view);
+        });
+    }
+
+    bool CameraAnimatorPublic::IsAnimating(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return false;
+
+        return native->cameraAnimation.IsRunning();
+    }
+
+    void CameraAnimator::AnimateTo(NativeViewerHandle* native, const CameraMove& move)
+    {
+        if (native == nullptr || native->view.IsNull()) return;
+        const Handle(V3d_View)& view = native->view;
+
+        // Start from wherever a running transition got to
+        Stop();
+
+        // V3d_View draws after most camera calls; none of the target's frames may reach the screen
+        Handle(Graphic3d_Camera) start = new Graphic3d_Camera(view->Camera());
+        const Standard_Boolean wasImmediate = view->SetImmediateUpdate(Standard_False);
+        move(view);
+        Handle(Graphic3d_Camera) target = new Graphic3d_Camera(view->Camera());
+        view->Camera()->Copy(start);
+        view->SetImmediateUpdate(wasImmediate);
+
+        AnimateTo(native, target);
+    }
+
+    void CameraAnimator::AnimateTo(NativeViewerHandle* native, const Handle(Graphic3d_Camera)& target)
+    {
+        if (native == nullptr || native->view.IsNull() || target.IsNull()) return;
+        const Handle(V3d_View)& view = native->view;
+
+        Stop();
+        if (!native->frames.IsDriven())
+        {
+            // Nothing would advance the animation: jump, never block
+            view->Camera()->Copy(target);
+            FrameScheduler::Redraw(native);
+            return;
+        }
+
+        myAnimation = new AIS_AnimationCamera("CameraAnimator", view);
+        myAnimation->SetCameraStart(new Graphic3d_Camera(view->Camera()));
+        myAnimation->SetCameraEnd(target);
+        myAnimation->SetOwnDuration(THE_DURATION);
+        myAnimation->StartTimer(0.0, 1.0, Standard_True);
+        FrameScheduler::Redraw(native);
+    }
+
+    bool CameraAnimator::Advance(NativeViewerHandle* native)
+    {
+        if (myAnimation.IsNull()) return false;
+        if (native == nullptr || native->view.IsNull())
+        {
+            Stop();
+            return false;
+        }
+
+        // Elapsed time, not frame count, decides the pose: slow frames skip ahead
+        myAnimation->UpdateTimer();
+        if (myAnimation->IsStopped())
+        {
+            native->view->Camera()->Copy(myAnimation->CameraEnd());
+            myAnimation.Nullify();
+        }
+        FrameScheduler::Redraw(native);
+        return true;
+    }
+
+    void CameraAnimator::Stop()
+    {
+        if (myAnimation.IsNull()) return;
+
+        myAnimation->Stop();
+        myAnimation.Nullify();
+    }
+
+    void CameraAnimator::Interrupt(NativeViewerHandle* native)
+    {
+        if (native != nullptr)
+            native->cameraAnimation.Stop();
+    }
+
+    void CameraAnimator::Interrupt(const Handle(V3d_View)& view)
+    {
+        if (view.IsNull()) return;
+
+        Interrupt(ViewerRegistry::FindByView(view.get()));
+    }
+}
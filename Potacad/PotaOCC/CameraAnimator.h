@@ -0,0 +1,49 @@
+#pragma once
+#include <AIS_AnimationCamera.hxx>
+#include <Graphic3d_Camera.hxx>
+#include <V3d_View.hxx>
+#include <functional>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: animated camera moves
+    public ref class CameraAnimatorPublic
+    {
+    public:
+        static void FitAll(System::IntPtr viewerHandlePtr);
+
+        // orientation is a V3d_TypeOfOrientation value (V3d_Xpos, V3d_Zpos, V3d_XposYposZpos, ...)
+        static void SetViewPreset(System::IntPtr viewerHandlePtr, int orientation);
+
+        static bool IsAnimating(System::IntPtr viewerHandlePtr);
+    };
+
+    // Time-based camera transitions of one viewer. AnimateTo captures the target camera without drawing
+    // it and returns at once; the frame source advances the AIS_AnimationCamera to the clock time on each
+    // refresh, so a slow frame skips ahead instead of stretching the move. Any direct camera input
+    // interrupts the transition where it is. Without a frame source the camera jumps to the target.
+    class CameraAnimator
+    {
+    public:
+        typedef std::function<void(const Handle(V3d_View)&)> CameraMove;
+
+        // The move is applied to the view once to find the target, then undone
+        void AnimateTo(NativeViewerHandle* native, const CameraMove& move);
+        void AnimateTo(NativeViewerHandle* native, const Handle(Graphic3d_Camera)& target);
+
+        // Puts the camera where the clock says; returns true while a transition is running
+        bool Advance(NativeViewerHandle* native);
+
+        void Stop();
+        bool IsRunning() const { return !myAnimation.IsNull(); }
+
+        // Call-site entry points for user camera input; the view overload finds its viewer through the registry
+        static void Interrupt(NativeViewerHandle* native);
+        static void Interrupt(const Handle(V3d_View)& view);
+
+    private:
+        Handle(AIS_AnimationCamera) myAnimation;
+    };
+}
@@ -1,7 +1,10 @@
 #include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "CircleDrawer.h"
+#include "SelectionHelper.h"
 #include "ShapeDrawer.h"
+#include "ViewerManager.h"
 #include <AIS_InteractiveContext.hxx>
 #include <GC_MakeSegment.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
@@ -77,18 +80,19 @@ array<int>^ CircleDrawer::DrawCircleBatch(
         return gcnew array<int>(0);
 
     Handle(AIS_InteractiveContext) ctx(rawCtx);
+    NativeViewerHandle* native = ViewerRegistry::FindByContext(rawCtx);
+    if (!native)
+        return gcnew array<int>(0);
+
     int n = x->Length;
     auto ids = gcnew array<int>(n);
+    const uint16_t layer = native->layers.Current();
 
     for (int i = 0; i < n; ++i)
     {
         // Create circle geometry
         gp_Ax2 ax2(gp_Pnt(x[i], y[i], z[i]), gp::DZ());
         Handle(Geom_Circle) geomCircle = new Geom_Circle(ax2, radius[i]);
-        Handle(AIS_Shape) aisCircle = new AIS_Shape(BRepBuilderAPI_MakeEdge(geomCircle));
-
-        // Set display mode (Wireframe or Shaded)
-        aisCircle->SetDisplayMode(AIS_WireFrame);
 
         // Map line type
         Aspect_TypeOfLine occType = Aspect_TOL_SOLID; // default
@@ -108,24 +112,16 @@ array<int>^ CircleDrawer::DrawCircleBatch(
         double db = (b != nullptr && i < b->Length) ? (double)b[i] / 255.0 : 0.5;
         Quantity_Color qcol(dr, dg, db, Quantity_TOC_RGB);
 
-        Handle(Prs3d_Drawer) drawer = aisCircle->Attributes();
-        if (drawer.IsNull()) drawer = new Prs3d_Drawer();
-
-        // Apply color and line type to the circle
-        Handle(Prs3d_LineAspect) lineAsp = new Prs3d_LineAspect(qcol, occType, 1.0);
-        drawer->SetWireAspect(lineAsp);
-        aisCircle->SetAttributes(drawer);
-
-        // Display the circle
-        ctx->Display(aisCircle, Standard_False);
-        ctx->SetColor(aisCircle, qcol, Standard_False);
-
-        // Store ID
-        ids[i] = (int)aisCircle.get();
+        // Store the circle as a document row with its colour and line type
+        EntityStyle style;
+        style.color = qcol;
+        style.lineType = occType;
+        ids[i] = native->document.Create(EntityType::Circle, BRepBuilderAPI_MakeEdge(geomCircle), style, layer);
     }
 
-    // Update viewer to reflect changes
-    ctx->UpdateCurrentViewer();
+    // Derive the presentations, then update viewer to reflect changes
+    native->document.Sync(native);
+    FrameScheduler::Redraw(ctx);
 
     return ids;
 }
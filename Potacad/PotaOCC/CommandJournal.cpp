@@ -0,0 +1,331 @@
+#include "pch.h"
+#include "CommandJournal.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "SelectionHelper.h"
+#include <AIS_Shape.hxx>
+#include <TopExp_Explorer.hxx>
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        template <class T>
+        void DropReleased(std::vector<Handle(T)>& objects, const std::unordered_set<const AIS_InteractiveObject*>& released)
+        {
+            objects.erase(std::remove_if(objects.begin(), objects.end(),
+                [&released](const Handle(T)& obj) { return released.count(obj.get()) > 0; }), objects.end());
+        }
+
+        // Removed entities are still referenced by the drawers' lists, the document, the entity index and the
+        // selection outlines; all of them let go, so the memory the budget accounts for is really returned
+        void Forget(NativeViewerHandle* native, const std::vector<Handle(AIS_InteractiveObject)>& objects)
+        {
+            std::unordered_set<const AIS_InteractiveObject*> released;
+            std::vector<int> ids;
+            for (const Handle(AIS_InteractiveObject)& obj : objects)
+            {
+                released.insert(obj.get());
+                native->document.Release(obj);
+                const int id = native->entityIndex.Find(obj);
+                if (id < 0) continue;
+                native->entityIndex.Remove(id);
+                ids.push_back(id);
+            }
+            if (!ids.empty()) native->tiles.Reindex();
+
+            DropReleased(native->ais2DShapes, released);
+            DropReleased(native->aisLabels, released);
+            DropReleased(native->persistedLines, released);
+            DropReleased(native->persistedCircles, released);
+            DropReleased(native->persistedRectangles, released);
+            DropReleased(native->persistedEllipses, released);
+            DropReleased(native->persistedHatches, released);
+            DropReleased(native->persistedExtrusions, released);
+
+            // Erased entities are not selected; their outlines may still sit in a chunk's buffers
+            std::vector<int>& selected = native->selectedEntities;
+            selected.erase(std::remove_if(selected.begin(), selected.end(),
+                [&ids](int id) { return std::find(ids.begin(), ids.end(), id) != ids.end(); }), selected.end());
+            if (!native->selectionHighlight.IsNull() && native->selectionHighlight->Invalidate(ids) && !native->context.IsNull())
+                native->context->Redisplay(native->selectionHighlight, Standard_False);
+        }
+    }
+
+    bool CommandJournalPublic::Undo(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return false;
+
+        return native->commandJournal.Undo(native);
+    }
+
+    bool CommandJournalPublic::Redo(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return false;
+
+        return native->commandJournal.Redo(native);
+    }
+
+    bool CommandJournalPublic::CanUndo(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        return native && native->commandJournal.CanUndo();
+    }
+
+    bool CommandJournalPublic::CanRedo(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        return native && native->commandJournal.CanRedo();
+    }
+
+    void CommandJournalPublic::SetHistoryBudget(System::IntPtr viewerHandlePtr, int megabytes)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        native->commandJournal.SetBudget(native->context, (size_t)std::max(0, megabytes) * 1024u * 1024u);
+    }
+
+    // Only erased entities cost anything beyond the record: the history alone keeps their
+    // geometry and presentation alive. Weighted like the BooleanCache estimate, doubled for the presentation.
+    size_t CommandJournal::EstimateBytes(const Change& change)
+    {
+        size_t bytes = sizeof(Change);
+        if (change.kind != ChangeKind::Removed) return bytes;
+
+        Handle(AIS_Shape) ais = Handle(AIS_Shape)::DownCast(change.object);
+        if (ais.IsNull() || ais->Shape().IsNull()) return bytes + 1024;
+
+        bytes += 512;
+        for (TopExp_Explorer exp(ais->Shape(), TopAbs_FACE); exp.More(); exp.Next()) bytes += 2 * 2048;
+        for (TopExp_Explorer exp(ais->Shape(), TopAbs_EDGE); exp.More(); exp.Next()) bytes += 2 * 512;
+        for (TopExp_Explorer exp(ais->Shape(), TopAbs_VERTEX); exp.More(); exp.Next()) bytes += 2 * 128;
+        return bytes;
+    }
+
+    void CommandJournal::Begin(const char* name)
+    {
+        if (myDepth++ == 0)
+            myPending.name = name;
+    }
+
+    void CommandJournal::Commit(const Handle(AIS_InteractiveContext)& context)
+    {
+        if (myDepth == 0) return;
+        if (--myDepth == 0)
+            Push(context);
+    }
+
+    void CommandJournal::Added(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj)
+    {
+        if (obj.IsNull()) return;
+        if (myNative)
+        {
+            myNative->document.Register(obj, myNative->layers.Place(myNative, obj));
+            SelectionHelper::NoteDisplayed(myNative, obj);
+        }
+
+        Change change;
+        change.kind = ChangeKind::Added;
+        change.object = obj;
+        Record(context, change);
+    }
+
+    void CommandJournal::Removed(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj)
+    {
+        if (obj.IsNull() || context.IsNull()) return;
+        context->Erase(obj, Standard_False);
+        if (myNative)
+        {
+            myNative->document.Shown(obj, false);
+            myNative->tiles.Invalidate();
+        }
+
+        Change change;
+        change.kind = ChangeKind::Removed;
+        change.object = obj;
+        Record(context, change);
+    }
+
+    void CommandJournal::Moved(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj, const gp_Trsf& delta)
+    {
+        if (obj.IsNull() || delta.Form() == gp_Identity) return;
+        Change change;
+        change.kind = ChangeKind::Moved;
+        change.object = obj;
+        change.delta = delta;
+        Record(context, change);
+    }
+
+    void CommandJournal::Record(const Handle(AIS_InteractiveContext)& context, const Change& change)
+    {
+        myPending.bytes += EstimateBytes(change);
+        myPending.changes.push_back(change);
+        if (myDepth == 0)
+        {
+            myPending.name = "Edit";
+            Push(context);
+        }
+    }
+
+    void CommandJournal::Push(const Handle(AIS_InteractiveContext)& context)
+    {
+        if (myPending.changes.empty())
+        {
+            myPending = Command();
+            return;
+        }
+
+        // A new edit forks the history: whatever was undone can no longer come back
+        for (const Command& undone : myRedo)
+        {
+            Release(context, undone, true);
+            myBytes -= undone.bytes;
+        }
+        myRedo.clear();
+
+        myBytes += myPending.bytes;
+        myUndo.push_back(std::move(myPending));
+        myPending = Command();
+        EvictToBudget(context);
+    }
+
+    void CommandJournal::Apply(NativeViewerHandle* native, const Command& command, bool isForward)
+    {
+        Handle(AIS_InteractiveContext) context = native->context;
+        std::vector<Handle(AIS_InteractiveObject)> moved;
+        bool isShownChanged = false;
+
+        const int count = (int)command.changes.size();
+        for (int k = 0; k < count; ++k)
+        {
+            const Change& change = command.changes[isForward ? k : count - 1 - k];
+            switch (change.kind)
+            {
+            case ChangeKind::Added:
+            case ChangeKind::Removed:
+            {
+                // Erased entities kept their presentation: showing them again computes nothing
+                const bool isShown = (change.kind == ChangeKind::Added) == isForward;
+                if (isShown)
+                {
+                    context->Display(change.object, Standard_False);
+                    SelectionHelper::NoteDisplayed(native, change.object);
+                }
+                else
+                    context->Erase(change.object, Standard_False);
+                native->document.Shown(change.object, isShown);
+                isShownChanged = true;
+                break;
+            }
+            case ChangeKind::Moved:
+            {
+                const gp_Trsf delta = isForward ? change.delta : change.delta.Inverted();
+                context->SetLocation(change.object, TopLoc_Location(delta.Multiplied(change.object->LocalTransformation())));
+                moved.push_back(change.object);
+                break;
+            }
+            }
+        }
+
+        // Proxies may stand for erased entities, or miss displayed ones
+        if (isShownChanged) native->tiles.Invalidate();
+
+        // Selected ids may now point at erased entities
+        SelectionHelper::ClearSelection(native, context);
+        if (!moved.empty())
+            SelectionHelper::RefreshEntities(native, context, moved);
+
+        FrameScheduler::Redraw(native);
+    }
+
+    bool CommandJournal::Undo(NativeViewerHandle* native)
+    {
+        Handle(AIS_InteractiveContext) context = native->context;
+        if (myDepth == 0) Push(context);
+        if (myUndo.empty())
+        {
+            std::cout << "⚠️ Nothing to undo." << std::endl;
+            return false;
+        }
+
+        Command command = std::move(myUndo.back());
+        myUndo.pop_back();
+        Apply(native, command, false);
+        std::cout << "✅ Undo: " << command.name << std::endl;
+        myRedo.push_back(std::move(command));
+        return true;
+    }
+
+    bool CommandJournal::Redo(NativeViewerHandle* native)
+    {
+        if (myRedo.empty())
+        {
+            std::cout << "⚠️ Nothing to redo." << std::endl;
+            return false;
+        }
+
+        Command command = std::move(myRedo.back());
+        myRedo.pop_back();
+        Apply(native, command, true);
+        std::cout << "✅ Redo: " << command.name << std::endl;
+        myUndo.push_back(std::move(command));
+        return true;
+    }
+
+    void CommandJournal::Release(const Handle(AIS_InteractiveContext)& context, const Command& command, bool isUndone)
+    {
+        if (context.IsNull()) return;
+
+        // Undone additions and applied removals are the entities left erased
+        const ChangeKind erasedKind = isUndone ? ChangeKind::Added : ChangeKind::Removed;
+        std::vector<Handle(AIS_InteractiveObject)> released;
+        for (const Change& change : command.changes)
+        {
+            if (change.kind == erasedKind && !context->IsDisplayed(change.object))
+            {
+                context->Remove(change.object, Standard_False);
+                released.push_back(change.object);
+            }
+        }
+        if (myNative != nullptr && !released.empty())
+            Forget(myNative, released);
+    }
+
+    void CommandJournal::EvictToBudget(const Handle(AIS_InteractiveContext)& context)
+    {
+        while (myBytes > myBudget && !myUndo.empty())
+        {
+            Release(context, myUndo.front(), false);
+            myBytes -= myUndo.front().bytes;
+            myUndo.pop_front();
+        }
+    }
+
+    void CommandJournal::SetBudget(const Handle(AIS_InteractiveContext)& context, size_t budgetBytes)
+    {
+        myBudget = budgetBytes;
+        EvictToBudget(context);
+    }
+
+    void CommandJournal::Clear(const Handle(AIS_InteractiveContext)& context)
+    {
+        for (const Command& command : myUndo) Release(context, command, false);
+        for (const Command& command : myRedo) Release(context, command, true);
+        myUndo.clear();
+        myRedo.clear();
+        myPending = Command();
+        myDepth = 0;
+        myBytes = 0;
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <AIS_InteractiveContext.hxx>
+#include <AIS_InteractiveObject.hxx>
+#include <gp_Trsf.hxx>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: undo/redo of scene edits
+    public ref class CommandJournalPublic
+    {
+    public:
+        static bool Undo(System::IntPtr viewerHandlePtr);
+        static bool Redo(System::IntPtr viewerHandlePtr);
+        static bool CanUndo(System::IntPtr viewerHandlePtr);
+        static bool CanRedo(System::IntPtr viewerHandlePtr);
+
+        // Memory the history may hold on to (erased entities, their presentations and geometry)
+        static void SetHistoryBudget(System::IntPtr viewerHandlePtr, int megabytes);
+    };
+
+    // Undo history kept as deltas against the live scene, never as snapshots.
+    // A change references the entity itself: added and removed entities are erased rather than
+    // removed, so their presentation survives and undo/redo is a Display/Erase; moves are stored
+    // as the world transformation they applied and undone through the entity's location. Shapes are
+    // only referenced, so every state shares the same TopoDS data. Oldest steps are dropped
+    // once the estimated footprint exceeds the budget.
+    class CommandJournal
+    {
+    public:
+        static const size_t THE_DEFAULT_BUDGET = 128u * 1024u * 1024u;
+
+        explicit CommandJournal(size_t budgetBytes = THE_DEFAULT_BUDGET) : myBudget(budgetBytes) {}
+
+        // Viewer whose document and layers are kept in step with the entities the history adds, erases and shows again
+        void SetOwner(NativeViewerHandle* native) { myNative = native; }
+
+        // Changes recorded until the matching Commit form one undo step; calls may nest.
+        // Changes recorded outside Begin/Commit are steps of their own.
+        void Begin(const char* name);
+        void Commit(const Handle(AIS_InteractiveContext)& context);
+
+        // Entity already displayed by the caller
+        void Added(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj);
+
+        // Erases the entity (instead of context->Remove) so undo can show it again
+        void Removed(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj);
+
+        // World transformation the entity received (after = delta * before), however it was applied
+        void Moved(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj, const gp_Trsf& delta);
+
+        bool Undo(NativeViewerHandle* native);
+        bool Redo(NativeViewerHandle* native);
+        bool CanUndo() const { return !myUndo.empty() || !myPending.changes.empty(); }
+        bool CanRedo() const { return !myRedo.empty(); }
+
+        void SetBudget(const Handle(AIS_InteractiveContext)& context, size_t budgetBytes);
+
+        // Scene cleared: forget the history and remove entities only it kept alive
+        void Clear(const Handle(AIS_InteractiveContext)& context);
+
+        size_t Bytes() const { return myBytes; }
+
+    private:
+        enum class ChangeKind { Added, Removed, Moved };
+
+        struct Change
+        {
+            ChangeKind kind = ChangeKind::Added;
+            Handle(AIS_InteractiveObject) object;
+            gp_Trsf delta;
+        };
+
+        struct Command
+        {
+            std::string name;
+            std::vector<Change> changes;
+            size_t bytes = 0;
+        };
+
+        static size_t EstimateBytes(const Change& change);
+
+        void Record(const Handle(AIS_InteractiveContext)& context, const Change& change);
+        void Push(const Handle(AIS_InteractiveContext)& context);
+        void Apply(NativeViewerHandle* native, const Command& command, bool isForward);
+
+        // Entities erased by a command that can no longer be replayed leave the context, the document,
+        // the entity index and the drawers' lists
+        void Release(const Handle(AIS_InteractiveContext)& context, const Command& command, bool isUndone);
+        void EvictToBudget(const Handle(AIS_InteractiveContext)& context);
+
+        std::deque<Command> myUndo;             // oldest first
+        std::vector<Command> myRedo;            // most recently undone last
+        Command myPending;
+        int myDepth = 0;
+        size_t myBudget;
+        size_t myBytes = 0;
+        NativeViewerHandle* myNative = nullptr;
+    };
+}
@@ -1,4 +1,5 @@
 #include "pch.h"
+#include "FrameScheduler.h"
 #include <msclr/marshal.h>
 #include "DimensionDrawer.h"
 #include <BRepBuilderAPI_MakeEdge.hxx>
@@ -155,6 +156,6 @@ array<int>^ DimensionDrawer::DrawDimensionBatch(
         ids[i] = reinterpret_cast<int>(dimObj.get());
     }
 
-    ctx->UpdateCurrentViewer();
+    FrameScheduler::Redraw(ctx);
     return ids;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "DimensionHelper.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "TextDrawer.h"
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRepBuilderAPI_MakeWire.hxx>
@@ -41,8 +42,10 @@ void DimensionHelper::DrawExtensionLine(NativeViewerHandle* native, Handle(AIS_I
         BRepBuilderAPI_MakeEdge extEdge(start, end);
         Handle(AIS_Shape) extLine = new AIS_Shape(extEdge.Edge());
         extLine->SetColor(Quantity_NOC_YELLOW);
-        if (isFinal)
-            context->Display(extLine, Standard_True);
+        if (isFinal) {
+            context->Display(extLine, Standard_False);
+            FrameScheduler::Redraw(context);
+        }
         else {
             native->dimExtLine1Temp = extLine;
             context->Display(native->dimExtLine1Temp, Standard_False);
@@ -54,8 +57,10 @@ void DimensionHelper::DrawDimensionLine(NativeViewerHandle* native, Handle(AIS_I
     BRepBuilderAPI_MakeEdge dimEdge(p1, p2);
     Handle(AIS_Shape) dimLineShape = new AIS_Shape(dimEdge.Edge());
     dimLineShape->SetColor(Quantity_NOC_YELLOW);
-    if (isFinal)
-        context->Display(dimLineShape, Standard_True);
+    if (isFinal) {
+        context->Display(dimLineShape, Standard_False);
+        FrameScheduler::Redraw(context);
+    }
     else {
         native->dimLineTemp = dimLineShape;
         context->Display(native->dimLineTemp, Standard_False);
@@ -87,8 +92,9 @@ void DimensionHelper::DrawArrowheads(NativeViewerHandle* native, Handle(AIS_Inte
     Handle(AIS_Shape) arrow2 = MakeArrow(p2, edgeVec);
 
     if (isFinal) {
-        context->Display(arrow1, Standard_True);
-        context->Display(arrow2, Standard_True);
+        context->Display(arrow1, Standard_False);
+        context->Display(arrow2, Standard_False);
+        FrameScheduler::Redraw(context);
     }
     else {
         native->dimArrow1Temp = arrow1;
@@ -123,7 +129,10 @@ void DimensionHelper::DrawLabel(NativeViewerHandle* native, Handle(AIS_Interacti
     );
 
     if (!labelShape.IsNull()) {
-        if (isFinal) context->Display(labelShape, Standard_True);
+        if (isFinal) {
+            context->Display(labelShape, Standard_False);
+            FrameScheduler::Redraw(context);
+        }
         else {
             native->dimLabelTemp = labelShape;
             context->Display(native->dimLabelTemp, Standard_False);
@@ -0,0 +1,329 @@
+#include "pch.h"
+#include "DrawingTiles.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "SceneDocument.h"
+#include <Graphic3d_ArrayOfPoints.hxx>
+#include <Graphic3d_AspectMarker3d.hxx>
+#include <Precision.hxx>
+#include <V3d_Viewer.hxx>
+#include <algorithm>
+#include <cmath>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        const int THE_LEAF_SIZE = 64;       // entities a tile holds before it splits
+        const int THE_MAX_DEPTH = 16;       // stacked duplicates stop splitting here
+        const double THE_UNKNOWN_EXTENT = 1.0e100;
+    }
+
+    void DrawingTilesPublic::GetStats(System::IntPtr viewerHandlePtr, int% tiles, int% visitedTiles, int% proxyTiles, int% proxyPoints)
+    {
+        tiles = 0;
+        visitedTiles = 0;
+        proxyTiles = 0;
+        proxyPoints = 0;
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        tiles = native->tiles.NbTiles();
+        visitedTiles = native->tiles.NbVisited();
+        proxyTiles = native->tiles.NbProxyTiles();
+        proxyPoints = native->tiles.NbProxyPoints();
+    }
+
+    double DrawingTiles::Diagonal(const EntityBounds& b)
+    {
+        return std::sqrt((b.xMax - b.xMin) * (b.xMax - b.xMin) + (b.yMax - b.yMin) * (b.yMax - b.yMin));
+    }
+
+    // Same test the renderer applies to the layer BVH: a box of this diagonal at this place under the context's size
+    bool DrawingTiles::IsBelow(const Pass& pass, const Graphic3d_CullingTool::CullingContext& ctx, const EntityBounds& at, double length)
+    {
+        const double cx = (at.xMin + at.xMax) * 0.5;
+        const double cy = (at.yMin + at.yMax) * 0.5;
+        return pass.culling.IsTooSmall(ctx,
+            Graphic3d_Vec3d(cx - length * 0.5, cy, 0.0),
+            Graphic3d_Vec3d(cx + length * 0.5, cy, 0.0));
+    }
+
+    void DrawingTiles::Invalidate()
+    {
+        for (Tile& tile : myTiles)
+        {
+            tile.proxy.clear();
+            tile.hasProxy = false;
+        }
+        myIsStale = true;
+    }
+
+    void DrawingTiles::Reindex()
+    {
+        myIsMoved = true;
+    }
+
+    bool DrawingTiles::RebuildIfNeeded(NativeViewerHandle* native)
+    {
+        const EntityIndex& index = native->entityIndex;
+        const int total = index.Size();
+        const bool isSettled = total == myLastCount;    // nothing added since the previous frame
+        myLastCount = total;
+        if (total == myIndexedCount && !myIsMoved) return false;
+
+        // While a load streams entities in, rebuild only once they grew by an eighth; a settled count,
+        // a cleared scene or moved entities always rebuild
+        if (!myIsMoved && !isSettled && total > myIndexedCount && total - myIndexedCount <= myIndexedCount / 8)
+            return false;
+
+        myTiles.clear();
+        myIndexedCount = total;
+        myIsMoved = false;
+        myIsStale = true;
+
+        // Entities of unknown extent have no place in a tile. Neither have points and texts: their index box
+        // is only their anchor, which says nothing of their size on screen, and a proxy would add a stray dot.
+        std::vector<int> ids;
+        ids.reserve(total);
+        EntityBounds extent;
+        for (int id = 0; id < total; ++id)
+        {
+            const EntityBounds& b = index.Bounds(id);
+            if (index.Object(id).IsNull()) continue;
+            if (b.xMax - b.xMin > THE_UNKNOWN_EXTENT || b.yMax - b.yMin > THE_UNKNOWN_EXTENT) continue;
+            if (Diagonal(b) <= Precision::Confusion()) continue;
+            if (ids.empty()) extent = b;
+            else extent.Add(b);
+            ids.push_back(id);
+        }
+        if (ids.empty()) return true;
+
+        // Square root cell, so every tile is square and its size alone says how large it is on screen
+        const double half = std::max(std::max(extent.xMax - extent.xMin, extent.yMax - extent.yMin) * 0.5, Precision::Confusion());
+        const double cx = (extent.xMin + extent.xMax) * 0.5;
+        const double cy = (extent.yMin + extent.yMax) * 0.5;
+        EntityBounds root;
+        root.xMin = cx - half; root.xMax = cx + half;
+        root.yMin = cy - half; root.yMax = cy + half;
+        BuildTile(index, root, ids, 0);
+
+        std::cout << "✅ Drawing tiles: " << myTiles.size() << " tiles over " << total << " entities" << std::endl;
+        return true;
+    }
+
+    int DrawingTiles::BuildTile(const EntityIndex& index, const EntityBounds& cell, std::vector<int>& ids, int depth)
+    {
+        const int tileId = (int)myTiles.size();
+        myTiles.push_back(Tile());
+        myTiles[tileId].cell = cell;
+
+        double maxDiagonal = 0.0;
+        if ((int)ids.size() <= THE_LEAF_SIZE || depth >= THE_MAX_DEPTH)
+        {
+            for (int id : ids)
+                maxDiagonal = std::max(maxDiagonal, Diagonal(index.Bounds(id)));
+            myTiles[tileId].members = std::move(ids);
+            myTiles[tileId].maxDiagonal = maxDiagonal;
+            return tileId;
+        }
+
+        // Entities crossing a split line stay in this tile
+        const double cx = (cell.xMin + cell.xMax) * 0.5;
+        const double cy = (cell.yMin + cell.yMax) * 0.5;
+        std::vector<int> quadrants[4];
+        std::vector<int> members;
+        for (int id : ids)
+        {
+            const EntityBounds& b = index.Bounds(id);
+            int quadrant = -1;
+            if (b.xMax <= cx)      quadrant = b.yMax <= cy ? 0 : (b.yMin >= cy ? 2 : -1);
+            else if (b.xMin >= cx) quadrant = b.yMax <= cy ? 1 : (b.yMin >= cy ? 3 : -1);
+
+            if (quadrant >= 0)
+                quadrants[quadrant].push_back(id);
+            else
+            {
+                members.push_back(id);
+                maxDiagonal = std::max(maxDiagonal, Diagonal(b));
+            }
+        }
+        std::vector<int>().swap(ids);
+
+        for (int quadrant = 0; quadrant < 4; ++quadrant)
+        {
+            if (quadrants[quadrant].empty()) continue;
+
+            EntityBounds child;
+            child.xMin = (quadrant & 1) ? cx : cell.xMin;
+            child.xMax = (quadrant & 1) ? cell.xMax : cx;
+            child.yMin = (quadrant & 2) ? cy : cell.yMin;
+            child.yMax = (quadrant & 2) ? cell.yMax : cy;
+
+            const int childId = BuildTile(index, child, quadrants[quadrant], depth + 1);
+            myTiles[tileId].children[quadrant] = childId;
+            maxDiagonal = std::max(maxDiagonal, myTiles[childId].maxDiagonal);
+        }
+
+        myTiles[tileId].members = std::move(members);
+        myTiles[tileId].maxDiagonal = maxDiagonal;
+        return tileId;
+    }
+
+    bool DrawingTiles::IsShown(NativeViewerHandle* native, int id) const
+    {
+        const uint16_t layer = native->entityIndex.Layer(id);
+        if (layer < native->layers.Size())
+        {
+            const LayerInfo& info = native->layers.Info(layer);
+            if (!info.isVisible || info.isFrozen) return false;
+        }
+        return native->context->IsDisplayed(native->entityIndex.Object(id)) == Standard_True;
+    }
+
+    const std::vector<DrawingTiles::ProxyPoint>& DrawingTiles::ProxyOf(NativeViewerHandle* native, int tileId)
+    {
+        Tile& tile = myTiles[tileId];
+        if (tile.hasProxy) return tile.proxy;
+        tile.hasProxy = true;
+
+        // First shown entity of each grid cell, by its centre and colour
+        const int nbCells = THE_PROXY_GRID * THE_PROXY_GRID;
+        std::vector<bool> isTaken(nbCells, false);
+        const double cellSize = (tile.cell.xMax - tile.cell.xMin) / THE_PROXY_GRID;
+
+        std::vector<int> stack(1, tileId);
+        while (!stack.empty() && (int)tile.proxy.size() < nbCells)
+        {
+            const Tile& current = myTiles[stack.back()];
+            stack.pop_back();
+
+            for (int id : current.members)
+            {
+                const EntityBounds& b = native->entityIndex.Bounds(id);
+                const double x = (b.xMin + b.xMax) * 0.5;
+                const double y = (b.yMin + b.yMax) * 0.5;
+                const int gx = std::min(std::max((int)((x - tile.cell.xMin) / cellSize), 0), THE_PROXY_GRID - 1);
+                const int gy = std::min(std::max((int)((y - tile.cell.yMin) / cellSize), 0), THE_PROXY_GRID - 1);
+                if (isTaken[gy * THE_PROXY_GRID + gx] || !IsShown(native, id)) continue;
+
+                isTaken[gy * THE_PROXY_GRID + gx] = true;
+                tile.proxy.push_back({ gp_Pnt(x, y, 0.0), SceneDocument::StyleOf(native->entityIndex.Object(id)).color });
+            }
+            for (int child : current.children)
+            {
+                if (child >= 0) stack.push_back(child);
+            }
+        }
+        return tile.proxy;
+    }
+
+    void DrawingTiles::Walk(NativeViewerHandle* native, const Pass& pass, int tileId, bool isInside, std::vector<ProxyPoint>& points)
+    {
+        const Tile& tile = myTiles[tileId];
+        ++myNbVisited;
+
+        // Flat at Z = 0: 2D drawings only; a tile wrongly culled in a tilted view loses its points, not its entities
+        if (!isInside)
+        {
+            Standard_Boolean isFullyInside = Standard_True;
+            if (pass.culling.IsOutFrustum(Graphic3d_Vec3d(tile.cell.xMin, tile.cell.yMin, 0.0),
+                Graphic3d_Vec3d(tile.cell.xMax, tile.cell.yMax, 0.0), &isFullyInside))
+                return;
+            isInside = isFullyInside == Standard_True;
+        }
+
+        const bool isAllCulled = IsBelow(pass, pass.detail, tile.cell, tile.maxDiagonal);
+        if (isAllCulled && IsBelow(pass, pass.proxy, tile.cell, Diagonal(tile.cell)))
+        {
+            // Nothing below is drawn and the whole tile fits the proxy grid
+            const std::vector<ProxyPoint>& proxy = ProxyOf(native, tileId);
+            points.insert(points.end(), proxy.begin(), proxy.end());
+            ++myNbProxyTiles;
+            return;
+        }
+
+        // Own members the renderer culls show as points; children decide for themselves
+        for (int id : tile.members)
+        {
+            const EntityBounds& b = native->entityIndex.Bounds(id);
+            if (!isAllCulled && !IsBelow(pass, pass.detail, b, Diagonal(b))) continue;
+            if (!IsShown(native, id)) continue;
+
+            points.push_back({ gp_Pnt((b.xMin + b.xMax) * 0.5, (b.yMin + b.yMax) * 0.5, 0.0),
+                SceneDocument::StyleOf(native->entityIndex.Object(id)).color });
+        }
+        for (int child : tile.children)
+        {
+            if (child >= 0)
+                Walk(native, pass, child, isInside, points);
+        }
+    }
+
+    void DrawingTiles::Show(NativeViewerHandle* native, const std::vector<ProxyPoint>& points)
+    {
+        myNbProxyPoints = (int)points.size();
+        if (points.empty())
+        {
+            if (!myStructure.IsNull() && myStructure->IsDisplayed())
+            {
+                myStructure->Erase();
+                FrameScheduler::Redraw(native);
+            }
+            return;
+        }
+
+        if (myStructure.IsNull())
+        {
+            myStructure = new Graphic3d_Structure(native->view->Viewer()->StructureManager());
+            myStructure->SetInfiniteState(Standard_True);   // refilled for the current view; never cull it on a stale box
+            myGroup = myStructure->NewGroup();
+        }
+
+        Handle(Graphic3d_ArrayOfPoints) array = new Graphic3d_ArrayOfPoints((Standard_Integer)points.size(), Standard_True, Standard_False);
+        for (const ProxyPoint& p : points)
+            array->AddVertex(p.point, p.color);
+
+        myGroup->Clear();
+        myGroup->SetGroupPrimitivesAspect(new Graphic3d_AspectMarker3d(Aspect_TOM_POINT, Quantity_NOC_WHITE, 1.0));
+        myGroup->AddPrimitiveArray(array);
+        if (!myStructure->IsDisplayed())
+            myStructure->Display();
+        FrameScheduler::Redraw(native);
+    }
+
+    void DrawingTiles::Update(NativeViewerHandle* native)
+    {
+        if (native == nullptr || native->view.IsNull() || native->view->Window().IsNull() || native->context.IsNull()) return;
+        const Handle(V3d_View)& view = native->view;
+
+        const bool isRebuilt = RebuildIfNeeded(native);
+        Standard_Integer width = 0, height = 0;
+        view->Window()->Size(width, height);
+        const Handle(Graphic3d_Camera)& camera = view->Camera();
+        if (!isRebuilt && !myIsStale && width == myWidth && height == myHeight
+            && myCameraState == camera->WorldViewProjState())
+            return;
+
+        myIsStale = false;
+        myWidth = width;
+        myHeight = height;
+        myCameraState = camera->WorldViewProjState();
+        myNbVisited = 0;
+        myNbProxyTiles = 0;
+
+        std::vector<ProxyPoint> points;
+        if (!myTiles.empty() && width > 0 && height > 0)
+        {
+            Pass pass;
+            pass.culling.SetViewVolume(camera);
+            pass.culling.SetViewportSize(width, height, view->RenderingParams().ResolutionRatio());
+            pass.culling.CacheClipPtsProjections();
+            pass.culling.SetCullingSize(pass.detail, THE_DETAIL_PIXELS);
+            pass.culling.SetCullingSize(pass.proxy, THE_DETAIL_PIXELS * THE_PROXY_GRID);
+            Walk(native, pass, 0, false, points);
+        }
+        Show(native, points);
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "EntityIndex.h"
+#include <Graphic3d_CullingTool.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_Structure.hxx>
+#include <Graphic3d_WorldViewProjState.hxx>
+#include <Quantity_Color.hxx>
+#include <V3d_View.hxx>
+#include <gp_Pnt.hxx>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: what the last tile pass cost
+    public ref class DrawingTilesPublic
+    {
+    public:
+        static void GetStats(System::IntPtr viewerHandlePtr, int% tiles, int% visitedTiles, int% proxyTiles, int% proxyPoints);
+    };
+
+    // Quadtree tiles over the entity index of a 2D drawing.
+    // Every DXF layer culls entities whose box is under THE_DETAIL_PIXELS (Z layer size culling), and the
+    // layer BVH drops entities outside the view, so the renderer's work follows what is on screen. What
+    // size culling drops would leave holes where a drawing is dense; tiles stand in for it. Each tile keeps
+    // a packed buffer of its content as points on a small grid of its cell. On a camera change the tree is
+    // walked from the root, skipping tiles outside the frustum and stopping at tiles whose whole content is
+    // culled; those append their buffer to one point array. The walk visits visible tiles, not entities.
+    class DrawingTiles
+    {
+    public:
+        static const int THE_DETAIL_PIXELS = 2;     // entity boxes with a smaller diagonal are not drawn
+        static const int THE_PROXY_GRID = 4;        // a proxy is at most THE_PROXY_GRID^2 points
+
+        // Rebuilds after the entity index grew, was cleared or was reindexed, then refreshes the proxies if
+        // the camera, the window or what is shown changed since the last pass. Called once per frame by the frame source.
+        void Update(NativeViewerHandle* native);
+
+        // Layer visibility changed or entities were displayed or erased: proxies are rebuilt from what is still shown
+        void Invalidate();
+
+        // Indexed extents changed or entities were released: the tiles are rebuilt on the next frame
+        void Reindex();
+
+        int NbTiles() const { return (int)myTiles.size(); }
+        int NbVisited() const { return myNbVisited; }
+        int NbProxyTiles() const { return myNbProxyTiles; }
+        int NbProxyPoints() const { return myNbProxyPoints; }
+
+    private:
+        struct ProxyPoint
+        {
+            gp_Pnt point;
+            Quantity_Color color;
+        };
+
+        struct Tile
+        {
+            EntityBounds cell;                  // square cell; members lie fully inside it
+            int children[4] = { -1, -1, -1, -1 };
+            std::vector<int> members;           // entity ids that fit no child cell
+            double maxDiagonal = 0.0;           // largest member box diagonal in the subtree
+            std::vector<ProxyPoint> proxy;      // packed on first use
+            bool hasProxy = false;
+        };
+
+        struct Pass
+        {
+            Graphic3d_CullingTool culling;
+            Graphic3d_CullingTool::CullingContext detail;   // THE_DETAIL_PIXELS
+            Graphic3d_CullingTool::CullingContext proxy;    // a whole proxy grid cell under THE_DETAIL_PIXELS
+        };
+
+        bool RebuildIfNeeded(NativeViewerHandle* native);
+        int BuildTile(const EntityIndex& index, const EntityBounds& cell, std::vector<int>& ids, int depth);
+        void Walk(NativeViewerHandle* native, const Pass& pass, int tileId, bool isInside, std::vector<ProxyPoint>& points);
+        const std::vector<ProxyPoint>& ProxyOf(NativeViewerHandle* native, int tileId);
+        bool IsShown(NativeViewerHandle* native, int id) const;
+        void Show(NativeViewerHandle* native, const std::vector<ProxyPoint>& points);
+
+        static double Diagonal(const EntityBounds& b);
+        static bool IsBelow(const Pass& pass, const Graphic3d_CullingTool::CullingContext& ctx, const EntityBounds& at, double length);
+
+        std::vector<Tile> myTiles;
+        int myIndexedCount = 0;                 // entity index size at the last build
+        int myLastCount = 0;                    // entity index size at the previous frame
+        bool myIsMoved = false;                 // entities moved or left the index since the last build
+        bool myIsStale = true;                  // proxies must be collected again
+        Graphic3d_WorldViewProjState myCameraState;
+        int myWidth = 0;
+        int myHeight = 0;
+
+        Handle(Graphic3d_Structure) myStructure;
+        Handle(Graphic3d_Group) myGroup;
+
+        int myNbVisited = 0;
+        int myNbProxyTiles = 0;
+        int myNbProxyPoints = 0;
+    };
+}
@@ -0,0 +1,960 @@
+#include "pch.h"
+#include "DxfWriter.h"
+#include "NativeViewerHandle.h"
+#include "ProjectSaver.h"
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepTools.hxx>
+#include <BRepTools_WireExplorer.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <GCPnts_TangentialDeflection.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Standard_Failure.hxx>
+#include <TCollection_AsciiString.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <msclr/marshal_cppstd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace PotaOCC
+{
+    bool DxfWriterPublic::Export(System::IntPtr viewerHandlePtr, System::String^ path)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || path == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return false;
+
+        msclr::interop::marshal_context ctx;
+        return DxfWriter::ExportScene(native, ctx.marshal_as<std::wstring>(path));
+    }
+
+    namespace
+    {
+        const double THE_POW10[] = { 1.0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9 };
+        const int THE_MAX_FIXED_DECIMALS = 9;
+        const double THE_MAX_EXACT_INTEGER = 9007199254740992.0;    // 2^53
+        const double THE_CURVE_DEFLECTION = 0.002;                  // of the edge's diagonal, as the project format
+        const double THE_CURVE_ANGLE = 0.1;
+        const double THE_PLANE_TOLERANCE = 1.0e-9;
+        const size_t THE_MAX_GROUP_OVERHEAD = 32;                   // code, separators and a formatted number
+        const char* const THE_MODEL_SPACE_RECORD = "1F";            // fixed handles of the two layout block records
+        const char* const THE_PAPER_SPACE_RECORD = "1B";
+
+        double PlanarTolerance(double z)
+        {
+            return 1.0e-7 * std::max(1.0, std::fabs(z));
+        }
+
+        uint32_t TrueColor(const Quantity_Color& color)
+        {
+            auto channel = [](double value) { return (uint32_t)std::lround(std::min(1.0, std::max(0.0, value)) * 255.0); };
+            return (channel(color.Red()) << 16) | (channel(color.Green()) << 8) | channel(color.Blue());
+        }
+
+        // DXF R2000 text is in the drawing code page: anything beyond ASCII goes as \U+XXXX
+        std::string EncodeText(const std::string& utf8)
+        {
+            std::string encoded;
+            encoded.reserve(utf8.size());
+            for (size_t i = 0; i < utf8.size();)
+            {
+                const unsigned char lead = (unsigned char)utf8[i];
+                if (lead < 0x80)
+                {
+                    encoded += (lead == '\r' || lead == '\n') ? ' ' : (char)lead;
+                    ++i;
+                    continue;
+                }
+
+                const int length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+                uint32_t codePoint = length == 1 ? '?' : lead & (0x7F >> length);
+                for (int k = 1; k < length && i + k < utf8.size(); ++k)
+                    codePoint = (codePoint << 6) | ((unsigned char)utf8[i + k] & 0x3F);
+                i += length;
+
+                char escape[16];
+                std::snprintf(escape, sizeof(escape), "\\U+%04X", codePoint);
+                encoded += escape;
+            }
+            return encoded;
+        }
+
+        // Layer names as group 8 and the LAYER table spell them: characters DXF reserves become '_'
+        std::string LayerCode(const std::string& utf8)
+        {
+            std::string name = utf8;
+            for (char& c : name)
+                if (c != '\0' && std::strchr("<>/\\\":;?*|=`", c) != nullptr) c = '_';
+            return name.empty() ? std::string("0") : EncodeText(name);
+        }
+
+        void SampleEdge(const BRepAdaptor_Curve& curve, const TopoDS_Edge& edge, std::vector<gp_Pnt>& points)
+        {
+            Bnd_Box box;
+            BRepBndLib::Add(edge, box, Standard_False);
+            const double deflection = box.IsVoid() ? 1.0e-3 : std::max(std::sqrt(box.SquareExtent()) * THE_CURVE_DEFLECTION, 1.0e-6);
+
+            GCPnts_TangentialDeflection sampler(curve, THE_CURVE_ANGLE, deflection);
+            for (int i = 1; i <= sampler.NbPoints(); ++i)
+                points.push_back(sampler.Value(i));
+            if (edge.Orientation() == TopAbs_REVERSED)
+                std::reverse(points.begin(), points.end());
+        }
+
+        bool IsZAxis(const gp_Dir& direction)
+        {
+            return std::fabs(std::fabs(direction.Z()) - 1.0) < THE_PLANE_TOLERANCE;
+        }
+
+        // Wire as an XY polyline with bulges; false when it leaves the plane z = elevation
+        bool ToBulgeLoop(const TopoDS_Wire& wire, const TopoDS_Face& face, double elevation, std::vector<DxfWriter::BulgeVertex>& loop, bool& isClosed)
+        {
+            const double tolerance = PlanarTolerance(elevation);
+            auto push = [&](const gp_Pnt& p, double bulge)
+            {
+                loop.push_back(DxfWriter::BulgeVertex());
+                loop.back().x = p.X(); loop.back().y = p.Y(); loop.back().bulge = bulge;
+                return std::fabs(p.Z() - elevation) <= tolerance;
+            };
+
+            gp_Pnt first, last;
+            bool hasEdges = false;
+            BRepTools_WireExplorer exp;
+            if (face.IsNull()) exp.Init(wire); else exp.Init(wire, face);
+            for (; exp.More(); exp.Next())
+            {
+                const TopoDS_Edge& edge = exp.Current();
+                if (BRep_Tool::Degenerated(edge)) continue;
+
+                const BRepAdaptor_Curve curve(edge);
+                const bool isReversed = edge.Orientation() == TopAbs_REVERSED;
+                const double f = curve.FirstParameter(), l = curve.LastParameter();
+                const gp_Pnt start = curve.Value(isReversed ? l : f);
+                const gp_Pnt end = curve.Value(isReversed ? f : l);
+                if (!hasEdges) first = start;
+                last = end;
+                hasEdges = true;
+
+                if (curve.GetType() == GeomAbs_Line)
+                {
+                    if (!push(start, 0.0)) return false;
+                }
+                else if (curve.GetType() == GeomAbs_Circle && IsZAxis(curve.Circle().Axis().Direction()))
+                {
+                    // Arcs over a half turn (and full circles) are split so every bulge stays finite
+                    const double sense = (curve.Circle().Axis().Direction().Z() > 0.0 ? 1.0 : -1.0) * (isReversed ? -1.0 : 1.0);
+                    const double angle = l - f;
+                    if (angle > M_PI)
+                    {
+                        const double bulge = sense * std::tan(angle / 8.0);
+                        if (!push(start, bulge) || !push(curve.Value(0.5 * (f + l)), bulge)) return false;
+                    }
+                    else if (!push(start, sense * std::tan(angle / 4.0)))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    std::vector<gp_Pnt> points;
+                    SampleEdge(curve, edge, points);
+                    for (size_t i = 0; i + 1 < points.size(); ++i)
+                        if (!push(points[i], 0.0)) return false;
+                }
+            }
+            if (!hasEdges) return false;
+
+            isClosed = BRep_Tool::IsClosed(wire) || first.Distance(last) <= tolerance;
+            if (!isClosed && !push(last, 0.0)) return false;
+            return true;
+        }
+
+        void WriteEdge(DxfWriter& writer, const TopoDS_Edge& edge, const Quantity_Color& color)
+        {
+            if (BRep_Tool::Degenerated(edge)) return;
+
+            const BRepAdaptor_Curve curve(edge);
+            const double f = curve.FirstParameter(), l = curve.LastParameter();
+            if (curve.GetType() == GeomAbs_Line)
+            {
+                writer.Line(curve.Value(f), curve.Value(l), color);
+                return;
+            }
+
+            if (curve.GetType() == GeomAbs_Circle && IsZAxis(curve.Circle().Axis().Direction()))
+            {
+                const gp_Circ circle = curve.Circle();
+                if (std::fabs(l - f - 2.0 * M_PI) < 1.0e-9)
+                {
+                    writer.Circle(circle.Location(), circle.Radius(), color);
+                    return;
+                }
+
+                // DXF arcs run counter-clockwise about +Z
+                const gp_Pnt& center = circle.Location();
+                gp_Pnt from = curve.Value(f), to = curve.Value(l);
+                if (circle.Axis().Direction().Z() < 0.0) std::swap(from, to);
+                const double startDeg = std::atan2(from.Y() - center.Y(), from.X() - center.X()) * 180.0 / M_PI;
+                const double endDeg = std::atan2(to.Y() - center.Y(), to.X() - center.X()) * 180.0 / M_PI;
+                writer.Arc(center, circle.Radius(), startDeg, endDeg, color);
+                return;
+            }
+
+            std::vector<gp_Pnt> points;
+            SampleEdge(curve, edge, points);
+            if (points.size() < 2) return;
+
+            const double elevation = points.front().Z();
+            const bool isFlat = std::all_of(points.begin(), points.end(),
+                [elevation](const gp_Pnt& p) { return std::fabs(p.Z() - elevation) <= PlanarTolerance(elevation); });
+            if (!isFlat)
+            {
+                writer.Polyline3d(points, false, color);
+                return;
+            }
+
+            std::vector<DxfWriter::BulgeVertex> vertices(points.size());
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                vertices[i].x = points[i].X();
+                vertices[i].y = points[i].Y();
+            }
+            writer.LwPolyline(vertices, elevation, false, color);
+        }
+
+        void WriteWire(DxfWriter& writer, const TopoDS_Wire& wire, const Quantity_Color& color)
+        {
+            TopExp_Explorer edges(wire, TopAbs_EDGE);
+            if (!edges.More()) return;
+            const TopoDS_Edge firstEdge = TopoDS::Edge(edges.Current());
+            edges.Next();
+            if (!edges.More())
+            {
+                WriteEdge(writer, firstEdge, color);
+                return;
+            }
+
+            const double elevation = BRepAdaptor_Curve(firstEdge).Value(BRepAdaptor_Curve(firstEdge).FirstParameter()).Z();
+            std::vector<DxfWriter::BulgeVertex> loop;
+            bool isClosed = false;
+            if (ToBulgeLoop(wire, TopoDS_Face(), elevation, loop, isClosed))
+            {
+                writer.LwPolyline(loop, elevation, isClosed, color);
+                return;
+            }
+
+            for (TopExp_Explorer exp(wire, TopAbs_EDGE); exp.More(); exp.Next())
+                WriteEdge(writer, TopoDS::Edge(exp.Current()), color);
+        }
+
+        // Quads and triangles become 3DFACE, flat XY regions a solid HATCH, anything else its mesh
+        bool WriteFace(DxfWriter& writer, const TopoDS_Face& face, const Quantity_Color& color)
+        {
+            const BRepAdaptor_Surface surface(face, Standard_False);
+            const bool isPlane = surface.GetType() == GeomAbs_Plane;
+
+            if (isPlane)
+            {
+                int nbWires = 0;
+                for (TopExp_Explorer exp(face, TopAbs_WIRE); exp.More(); exp.Next()) ++nbWires;
+
+                std::vector<gp_Pnt> corners;
+                bool isPolygon = nbWires == 1;
+                for (BRepTools_WireExplorer exp(BRepTools::OuterWire(face), face); isPolygon && exp.More(); exp.Next())
+                {
+                    isPolygon = BRepAdaptor_Curve(exp.Current()).GetType() == GeomAbs_Line && corners.size() < 4;
+                    corners.push_back(BRep_Tool::Pnt(exp.CurrentVertex()));
+                }
+                if (isPolygon && corners.size() >= 3)
+                {
+                    writer.Face3d(corners[0], corners[1], corners[2], corners.size() == 4 ? corners[3] : corners[2], color);
+                    return true;
+                }
+
+                const gp_Pln plane = surface.Plane();
+                if (IsZAxis(plane.Axis().Direction()))
+                {
+                    const double elevation = plane.Location().Z();
+                    const TopoDS_Wire outer = BRepTools::OuterWire(face);
+                    std::vector<std::vector<DxfWriter::BulgeVertex>> loops(1);
+                    bool isClosed = false;
+                    bool isFlat = ToBulgeLoop(outer, face, elevation, loops[0], isClosed);
+                    for (TopExp_Explorer exp(face, TopAbs_WIRE); isFlat && exp.More(); exp.Next())
+                    {
+                        if (exp.Current().IsSame(outer)) continue;
+                        loops.push_back(std::vector<DxfWriter::BulgeVertex>());
+                        isFlat = ToBulgeLoop(TopoDS::Wire(exp.Current()), face, elevation, loops.back(), isClosed);
+                    }
+                    if (isFlat)
+                    {
+                        writer.SolidHatch(loops, elevation, color);
+                        return true;
+                    }
+                }
+            }
+
+            // Displayed faces are meshed already (presentation or MeshingService)
+            TopLoc_Location location;
+            const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, location);
+            if (triangulation.IsNull()) return false;
+
+            const gp_Trsf& trsf = location.Transformation();
+            const bool isReversed = face.Orientation() == TopAbs_REVERSED;
+            for (int t = 1; t <= triangulation->NbTriangles(); ++t)
+            {
+                int n1, n2, n3;
+                triangulation->Triangle(t).Get(n1, n2, n3);
+                if (isReversed) std::swap(n2, n3);
+                const gp_Pnt p3 = triangulation->Node(n3).Transformed(trsf);
+                writer.Face3d(triangulation->Node(n1).Transformed(trsf), triangulation->Node(n2).Transformed(trsf), p3, p3, color);
+            }
+            return true;
+        }
+
+        bool WriteShape(DxfWriter& writer, const TopoDS_Shape& shape, const Quantity_Color& color)
+        {
+            const uint64_t before = writer.NbEntities();
+            try
+            {
+                for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next())
+                    WriteFace(writer, TopoDS::Face(exp.Current()), color);
+                for (TopExp_Explorer exp(shape, TopAbs_WIRE, TopAbs_FACE); exp.More(); exp.Next())
+                    WriteWire(writer, TopoDS::Wire(exp.Current()), color);
+                for (TopExp_Explorer exp(shape, TopAbs_EDGE, TopAbs_WIRE); exp.More(); exp.Next())
+                    WriteEdge(writer, TopoDS::Edge(exp.Current()), color);
+                for (TopExp_Explorer exp(shape, TopAbs_VERTEX, TopAbs_EDGE); exp.More(); exp.Next())
+                    writer.Point(BRep_Tool::Pnt(TopoDS::Vertex(exp.Current())), color);
+            }
+            catch (Standard_Failure& e)
+            {
+                std::cerr << "❌ DXF export of a shape failed: " << e.GetMessageString() << std::endl;
+            }
+            return writer.NbEntities() > before;
+        }
+
+        // Live curves of an opened project part, from its exact vertices at the object's placement; index pairs
+        // are joined back into polylines. Detached curves are left to the entities that took their place.
+        void WriteProjectCurves(DxfWriter& writer, const ProjectView& project, const ProjectCurves& curves)
+        {
+            const int p = curves.part;
+            const ProjectPart& part = project.parts[p];
+            const bool isPlaced = curves.object->HasPlacement();
+            const gp_Trsf placement = curves.object->Placement();
+            auto vertex = [&](uint32_t v)
+            {
+                const gp_Pnt point(part.exactVertices[3 * (size_t)v], part.exactVertices[3 * (size_t)v + 1], part.exactVertices[3 * (size_t)v + 2]);
+                return isPlaced ? point.Transformed(placement) : point;
+            };
+            writer.SetLayer(part.LayerName(curves.layer));
+
+            std::vector<gp_Pnt> run;
+            std::vector<DxfWriter::BulgeVertex> vertices;
+
+            auto flush = [&](const Quantity_Color& color)
+            {
+                if (run.size() == 2)
+                {
+                    writer.Line(run[0], run[1], color);
+                }
+                else if (run.size() > 2)
+                {
+                    const bool isClosed = run.front().IsEqual(run.back(), 0.0);
+                    if (isClosed) run.pop_back();
+                    const double elevation = run.front().Z();
+                    const bool isFlat = std::all_of(run.begin(), run.end(),
+                        [elevation](const gp_Pnt& q) { return std::fabs(q.Z() - elevation) <= PlanarTolerance(elevation); });
+                    if (isFlat)
+                    {
+                        vertices.assign(run.size(), DxfWriter::BulgeVertex());
+                        for (size_t i = 0; i < run.size(); ++i)
+                        {
+                            vertices[i].x = run[i].X();
+                            vertices[i].y = run[i].Y();
+                        }
+                        writer.LwPolyline(vertices, elevation, isClosed, color);
+                    }
+                    else
+                    {
+                        writer.Polyline3d(run, isClosed, color);
+                    }
+                }
+                run.clear();
+            };
+
+            for (uint32_t i = 0; i < part.nbCurves; ++i)
+            {
+                const ProjectFormat::Entity& curve = part.entities[i];
+                if (curve.layer != curves.layer || !project.IsLive(p, curve) || curves.object->IsDetached(curve.id) || curve.style >= part.nbStyles
+                    || (uint64_t)curve.firstIndex + curve.nbIndices > part.nbIndices)
+                    continue;
+
+                const ProjectFormat::Style& style = part.styles[curve.style];
+                const Quantity_Color color(style.color[0], style.color[1], style.color[2], Quantity_TOC_RGB);
+                uint32_t previous = UINT32_MAX;
+                for (uint32_t k = 0; k + 1 < curve.nbIndices; k += 2)
+                {
+                    const uint32_t a = part.indices[curve.firstIndex + k];
+                    const uint32_t b = part.indices[curve.firstIndex + k + 1];
+                    if (a != previous) flush(color);
+                    if (run.empty())
+                        run.push_back(vertex(a));
+                    run.push_back(vertex(b));
+                    previous = b;
+                }
+                flush(color);
+            }
+        }
+    }
+
+    DxfWriter::DxfWriter(size_t bufferSize)
+        : myBuffer(std::max(bufferSize, (size_t)4096))
+    {
+    }
+
+    DxfWriter::~DxfWriter()
+    {
+        if (myOut.is_open())
+            FlushBuffer();
+    }
+
+    bool DxfWriter::ExportScene(NativeViewerHandle* native, const std::wstring& path)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Handle(AIS_InteractiveContext) context = native->context;
+
+        // Layers in table order; entities name them by the same UTF-8 names
+        std::vector<DxfWriter::Layer> layers(native->layers.Size());
+        for (int l = 0; l < native->layers.Size(); ++l)
+        {
+            const LayerInfo& info = native->layers.Info((uint16_t)l);
+            layers[l].name = TCollection_AsciiString(TCollection_ExtendedString(info.name.c_str())).ToCString();
+            layers[l].isVisible = info.isVisible;
+            layers[l].isFrozen = info.isFrozen;
+            layers[l].isLocked = info.isLocked;
+        }
+
+        DxfWriter writer;
+        if (!writer.Open(path, layers))
+        {
+            std::cout << "❌ Cannot write DXF file." << std::endl;
+            return false;
+        }
+
+        // Curves of an opened project only exist in its mapping
+        if (native->project)
+        {
+            for (const ProjectCurves& curves : native->project->curves)
+                if (!curves.object.IsNull() && context->IsDisplayed(curves.object))
+                    WriteProjectCurves(writer, *native->project, curves);
+        }
+
+        int nbSkipped = 0;
+        AIS_ListOfInteractive displayed;
+        context->DisplayedObjects(displayed);
+        for (AIS_ListOfInteractive::Iterator it(displayed); it.More(); it.Next())
+        {
+            // Inserts and arrays come out exploded into the entities they stand for
+            std::vector<ProjectItem> items;
+            if (!ProjectSaver::CaptureAll(native, it.Value(), items)) continue;
+
+            bool isWritten = false;
+            for (const ProjectItem& item : items)
+            {
+                writer.SetLayer(item.layer);
+                if (item.isText)
+                {
+                    writer.Text(item.anchor, item.height, item.text, item.color);
+                    isWritten = true;
+                }
+                else if (WriteShape(writer, item.shape, item.color))
+                {
+                    isWritten = true;
+                }
+            }
+            if (!isWritten) ++nbSkipped;
+        }
+
+        if (!writer.Close())
+        {
+            std::cout << "❌ Failed to write DXF file." << std::endl;
+            return false;
+        }
+
+        const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "✅ DXF exported: " << writer.NbEntities() << " entities in " << ms << " ms" << std::endl;
+        if (nbSkipped > 0)
+            std::cout << "⚠️ " << nbSkipped << " objects had nothing DXF can represent and were skipped." << std::endl;
+        return true;
+    }
+
+    char* DxfWriter::FormatDouble(double value, char* out)
+    {
+        if (value == 0.0 || !std::isfinite(value))
+        {
+            *out++ = '0';
+            return out;
+        }
+
+        // Fast path: the fewest decimals whose integer scaling divides back to the value exactly.
+        // Both operands are exact and the quotient is correctly rounded, so strtod reads the same double.
+        const double magnitude = std::fabs(value);
+        for (int decimals = 0; decimals <= THE_MAX_FIXED_DECIMALS; ++decimals)
+        {
+            const double scaled = magnitude * THE_POW10[decimals];
+            if (scaled >= THE_MAX_EXACT_INTEGER) break;
+
+            const double rounded = std::floor(scaled + 0.5);
+            if (rounded / THE_POW10[decimals] != magnitude) continue;
+
+            char digits[24];
+            int length = 0;
+            uint64_t n = (uint64_t)rounded;
+            do
+            {
+                digits[length++] = (char)('0' + n % 10);
+                n /= 10;
+            } while (n != 0);
+            while (length <= decimals)
+                digits[length++] = '0';
+
+            if (value < 0.0) *out++ = '-';
+            for (int i = length - 1; i >= 0; --i)
+            {
+                *out++ = digits[i];
+                if (i == decimals && decimals > 0) *out++ = '.';
+            }
+            return out;
+        }
+
+        // Very large, very small or long fractions: shortest %g precision that reads back
+        for (int precision = 15; precision <= 17; ++precision)
+        {
+            const int length = std::snprintf(out, 26, "%.*g", precision, value);
+            if (precision == 17 || std::strtod(out, nullptr) == value)
+                return out + length;
+        }
+        return out;
+    }
+
+    void DxfWriter::Reserve(size_t bytes)
+    {
+        if (myFill + bytes > myBuffer.size())
+            FlushBuffer();
+    }
+
+    void DxfWriter::FlushBuffer()
+    {
+        if (myFill == 0) return;
+        myOut.write(myBuffer.data(), (std::streamsize)myFill);
+        myWritten += myFill;
+        myFill = 0;
+        if (!myOut) myIsFailed = true;
+    }
+
+    void DxfWriter::Group(int code, const char* text, size_t length)
+    {
+        Reserve(length + THE_MAX_GROUP_OVERHEAD);
+        char* out = myBuffer.data() + myFill;
+        out += std::snprintf(out, THE_MAX_GROUP_OVERHEAD, "%d\n", code);
+        if (length + THE_MAX_GROUP_OVERHEAD > myBuffer.size())
+        {
+            // Longer than the buffer itself: goes out directly
+            myFill = out - myBuffer.data();
+            FlushBuffer();
+            myOut.write(text, (std::streamsize)length);
+            myOut.put('\n');
+            myWritten += length + 1;
+            return;
+        }
+        std::memcpy(out, text, length);
+        out += length;
+        *out++ = '\n';
+        myFill = out - myBuffer.data();
+    }
+
+    void DxfWriter::Group(int code, const char* text)
+    {
+        Group(code, text, std::strlen(text));
+    }
+
+    void DxfWriter::Group(int code, double value)
+    {
+        Reserve(2 * THE_MAX_GROUP_OVERHEAD);
+        char* out = myBuffer.data() + myFill;
+        out += std::snprintf(out, THE_MAX_GROUP_OVERHEAD, "%d\n", code);
+        out = FormatDouble(value, out);
+        *out++ = '\n';
+        myFill = out - myBuffer.data();
+    }
+
+    void DxfWriter::GroupInt(int code, long long value)
+    {
+        Reserve(2 * THE_MAX_GROUP_OVERHEAD);
+        char* out = myBuffer.data() + myFill;
+        out += std::snprintf(out, 2 * THE_MAX_GROUP_OVERHEAD, "%d\n%lld\n", code, value);
+        myFill = out - myBuffer.data();
+    }
+
+    void DxfWriter::GroupPoint(int code, double x, double y, double z)
+    {
+        Group(code, x);
+        Group(code + 10, y);
+        Group(code + 20, z);
+    }
+
+    void DxfWriter::GroupHex(int code, uint64_t value)
+    {
+        char hex[24];
+        const int length = std::snprintf(hex, sizeof(hex), "%llX", (unsigned long long)value);
+        Group(code, hex, (size_t)length);
+    }
+
+    uint64_t DxfWriter::GroupHandle()
+    {
+        const uint64_t handle = myNextHandle++;
+        GroupHex(5, handle);
+        return handle;
+    }
+
+    void DxfWriter::BeginTable(const char* name, const char* handle, int nbRecords)
+    {
+        Group(0, "TABLE");
+        Group(2, name);
+        Group(5, handle);
+        Group(330, "0");
+        Group(100, "AcDbSymbolTable");
+        GroupInt(70, nbRecords);
+    }
+
+    void DxfWriter::BeginRecord(const char* type, const char* handle, const char* table, const char* subclass)
+    {
+        Group(0, type);
+        Group(5, handle);
+        Group(330, table);
+        Group(100, "AcDbSymbolTableRecord");
+        Group(100, subclass);
+    }
+
+    uint64_t DxfWriter::BeginEntity(const char* type, const char* subclass, const Quantity_Color& color)
+    {
+        Group(0, type);
+        const uint64_t handle = GroupHandle();
+        Group(330, THE_MODEL_SPACE_RECORD);
+        Group(100, "AcDbEntity");
+        Group(8, myLayer);
+        GroupInt(420, TrueColor(color));
+        Group(100, subclass);
+        ++myNbEntities;
+        return handle;
+    }
+
+    void DxfWriter::SetLayer(const std::string& utf8)
+    {
+        myLayer = LayerCode(utf8);
+    }
+
+    bool DxfWriter::Open(const std::wstring& path, const std::vector<Layer>& layers)
+    {
+        myOut.open(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!myOut) return false;
+
+        Group(0, "SECTION");
+        Group(2, "HEADER");
+        Group(9, "$ACADVER");
+        Group(1, "AC1015");
+        Group(9, "$DWGCODEPAGE");
+        Group(3, "ANSI_1252");
+        Group(9, "$HANDSEED");
+        Reserve(THE_MAX_GROUP_OVERHEAD + 16);
+        myHandleSeedOffset = myWritten + myFill + 2;    // after "5\n"
+        Group(5, "0000000000000000");
+        Group(0, "ENDSEC");
+
+        Group(0, "SECTION");
+        Group(2, "CLASSES");
+        Group(0, "ENDSEC");
+
+        // The tables AutoCAD expects in any R2000 drawing, each with the records entities refer to
+        Group(0, "SECTION");
+        Group(2, "TABLES");
+
+        BeginTable("VPORT", "8", 0);
+        Group(0, "ENDTAB");
+
+        BeginTable("LTYPE", "5", 3);
+        const char* lineTypes[][2] = { { "13", "ByBlock" }, { "14", "ByLayer" }, { "15", "CONTINUOUS" } };
+        for (int i = 0; i < 3; ++i)
+        {
+            BeginRecord("LTYPE", lineTypes[i][0], "5", "AcDbLinetypeTableRecord");
+            Group(2, lineTypes[i][1]);
+            GroupInt(70, 0);
+            Group(3, i == 2 ? "Solid line" : "");
+            GroupInt(72, 65);
+            GroupInt(73, 0);
+            Group(40, 0.0);
+        }
+        Group(0, "ENDTAB");
+
+        // Layer 0 always exists; hidden layers have a negative colour, frozen and locked are flags
+        std::vector<Layer> table(layers);
+        const bool hasLayer0 = std::any_of(table.begin(), table.end(), [](const Layer& layer) { return LayerCode(layer.name) == "0"; });
+        if (!hasLayer0)
+        {
+            table.insert(table.begin(), Layer());
+            table.front().name = "0";
+        }
+        BeginTable("LAYER", "2", (int)table.size());
+        for (const Layer& layer : table)
+        {
+            Group(0, "LAYER");
+            GroupHandle();
+            Group(330, "2");
+            Group(100, "AcDbSymbolTableRecord");
+            Group(100, "AcDbLayerTableRecord");
+            Group(2, LayerCode(layer.name));
+            GroupInt(70, (layer.isFrozen ? 1 : 0) | (layer.isLocked ? 4 : 0));
+            GroupInt(62, layer.isVisible ? 7 : -7);
+            Group(6, "CONTINUOUS");
+        }
+        Group(0, "ENDTAB");
+
+        BeginTable("STYLE", "3", 1);
+        BeginRecord("STYLE", "11", "3", "AcDbTextStyleTableRecord");
+        Group(2, "Standard");
+        GroupInt(70, 0);
+        Group(40, 0.0);
+        Group(41, 1.0);
+        Group(50, 0.0);
+        GroupInt(71, 0);
+        Group(42, 2.5);
+        Group(3, "txt");
+        Group(4, "");
+        Group(0, "ENDTAB");
+
+        BeginTable("VIEW", "6", 0);
+        Group(0, "ENDTAB");
+        BeginTable("UCS", "7", 0);
+        Group(0, "ENDTAB");
+
+        BeginTable("APPID", "9", 1);
+        BeginRecord("APPID", "12", "9", "AcDbRegAppTableRecord");
+        Group(2, "ACAD");
+        GroupInt(70, 0);
+        Group(0, "ENDTAB");
+
+        // Dimension styles carry their handle in group 105
+        BeginTable("DIMSTYLE", "A", 1);
+        Group(100, "AcDbDimStyleTable");
+        GroupInt(71, 0);
+        Group(0, "DIMSTYLE");
+        Group(105, "27");
+        Group(330, "A");
+        Group(100, "AcDbSymbolTableRecord");
+        Group(100, "AcDbDimStyleTableRecord");
+        Group(2, "Standard");
+        GroupInt(70, 0);
+        Group(0, "ENDTAB");
+
+        BeginTable("BLOCK_RECORD", "1", 2);
+        BeginRecord("BLOCK_RECORD", THE_MODEL_SPACE_RECORD, "1", "AcDbBlockTableRecord");
+        Group(2, "*Model_Space");
+        BeginRecord("BLOCK_RECORD", THE_PAPER_SPACE_RECORD, "1", "AcDbBlockTableRecord");
+        Group(2, "*Paper_Space");
+        Group(0, "ENDTAB");
+        Group(0, "ENDSEC");
+
+        // Both layout blocks are empty: model space entities live in ENTITIES
+        Group(0, "SECTION");
+        Group(2, "BLOCKS");
+        const char* blocks[][4] = {
+            { "20", "21", THE_MODEL_SPACE_RECORD, "*Model_Space" },
+            { "1C", "1D", THE_PAPER_SPACE_RECORD, "*Paper_Space" } };
+        for (int i = 0; i < 2; ++i)
+        {
+            const char* const* block = blocks[i];
+            const bool isPaper = i == 1;
+            Group(0, "BLOCK");
+            Group(5, block[0]);
+            Group(330, block[2]);
+            Group(100, "AcDbEntity");
+            if (isPaper) GroupInt(67, 1);
+            Group(8, "0");
+            Group(100, "AcDbBlockBegin");
+            Group(2, block[3]);
+            GroupInt(70, 0);
+            GroupPoint(10, 0.0, 0.0, 0.0);
+            Group(3, block[3]);
+            Group(1, "");
+            Group(0, "ENDBLK");
+            Group(5, block[1]);
+            Group(330, block[2]);
+            Group(100, "AcDbEntity");
+            if (isPaper) GroupInt(67, 1);
+            Group(8, "0");
+            Group(100, "AcDbBlockEnd");
+        }
+        Group(0, "ENDSEC");
+
+        Group(0, "SECTION");
+        Group(2, "ENTITIES");
+        return !myIsFailed;
+    }
+
+    bool DxfWriter::Close()
+    {
+        Group(0, "ENDSEC");
+
+        // Root dictionary with the group dictionary every drawing has
+        Group(0, "SECTION");
+        Group(2, "OBJECTS");
+        Group(0, "DICTIONARY");
+        Group(5, "C");
+        Group(330, "0");
+        Group(100, "AcDbDictionary");
+        GroupInt(281, 1);
+        Group(3, "ACAD_GROUP");
+        Group(350, "D");
+        Group(0, "DICTIONARY");
+        Group(5, "D");
+        Group(330, "C");
+        Group(100, "AcDbDictionary");
+        GroupInt(281, 1);
+        Group(0, "ENDSEC");
+        Group(0, "EOF");
+        FlushBuffer();
+
+        char seed[24];
+        std::snprintf(seed, sizeof(seed), "%016llX", (unsigned long long)myNextHandle);
+        myOut.seekp((std::streamoff)myHandleSeedOffset);
+        myOut.write(seed, 16);
+        myOut.close();
+        return !myIsFailed && !myOut.fail();
+    }
+
+    void DxfWriter::Point(const gp_Pnt& p, const Quantity_Color& color)
+    {
+        BeginEntity("POINT", "AcDbPoint", color);
+        GroupPoint(10, p.X(), p.Y(), p.Z());
+    }
+
+    void DxfWriter::Line(const gp_Pnt& p1, const gp_Pnt& p2, const Quantity_Color& color)
+    {
+        BeginEntity("LINE", "AcDbLine", color);
+        GroupPoint(10, p1.X(), p1.Y(), p1.Z());
+        GroupPoint(11, p2.X(), p2.Y(), p2.Z());
+    }
+
+    void DxfWriter::Circle(const gp_Pnt& center, double radius, const Quantity_Color& color)
+    {
+        BeginEntity("CIRCLE", "AcDbCircle", color);
+        GroupPoint(10, center.X(), center.Y(), center.Z());
+        Group(40, radius);
+    }
+
+    void DxfWriter::Arc(const gp_Pnt& center, double radius, double startDeg, double endDeg, const Quantity_Color& color)
+    {
+        BeginEntity("ARC", "AcDbCircle", color);
+        GroupPoint(10, center.X(), center.Y(), center.Z());
+        Group(40, radius);
+        Group(100, "AcDbArc");
+        Group(50, startDeg);
+        Group(51, endDeg);
+    }
+
+    void DxfWriter::LwPolyline(const std::vector<BulgeVertex>& vertices, double elevation, bool isClosed, const Quantity_Color& color)
+    {
+        BeginEntity("LWPOLYLINE", "AcDbPolyline", color);
+        GroupInt(90, (long long)vertices.size());
+        GroupInt(70, isClosed ? 1 : 0);
+        if (elevation != 0.0) Group(38, elevation);
+        for (const BulgeVertex& vertex : vertices)
+        {
+            Group(10, vertex.x);
+            Group(20, vertex.y);
+            if (vertex.bulge != 0.0) Group(42, vertex.bulge);
+        }
+    }
+
+    void DxfWriter::Polyline3d(const std::vector<gp_Pnt>& vertices, bool isClosed, const Quantity_Color& color)
+    {
+        // Vertices and the end marker are owned by the polyline
+        const uint64_t polyline = BeginEntity("POLYLINE", "AcDb3dPolyline", color);
+        GroupInt(66, 1);
+        GroupPoint(10, 0.0, 0.0, 0.0);
+        GroupInt(70, isClosed ? 9 : 8);
+        for (const gp_Pnt& p : vertices)
+        {
+            Group(0, "VERTEX");
+            GroupHandle();
+            GroupHex(330, polyline);
+            Group(100, "AcDbEntity");
+            Group(8, myLayer);
+            Group(100, "AcDbVertex");
+            Group(100, "AcDb3dPolylineVertex");
+            GroupPoint(10, p.X(), p.Y(), p.Z());
+            GroupInt(70, 32);
+        }
+        Group(0, "SEQEND");
+        GroupHandle();
+        GroupHex(330, polyline);
+        Group(100, "AcDbEntity");
+        Group(8, myLayer);
+    }
+
+    void DxfWriter::Text(const gp_Pnt& anchor, double height, const std::string& utf8, const Quantity_Color& color)
+    {
+        BeginEntity("TEXT", "AcDbText", color);
+        GroupPoint(10, anchor.X(), anchor.Y(), anchor.Z());
+        Group(40, height > 0.0 ? height : 1.0);
+        Group(1, EncodeText(utf8));
+        Group(100, "AcDbText");
+    }
+
+    void DxfWriter::Face3d(const gp_Pnt& p1, const gp_Pnt& p2, const gp_Pnt& p3, const gp_Pnt& p4, const Quantity_Color& color)
+    {
+        BeginEntity("3DFACE", "AcDbFace", color);
+        GroupPoint(10, p1.X(), p1.Y(), p1.Z());
+        GroupPoint(11, p2.X(), p2.Y(), p2.Z());
+        GroupPoint(12, p3.X(), p3.Y(), p3.Z());
+        GroupPoint(13, p4.X(), p4.Y(), p4.Z());
+    }
+
+    void DxfWriter::SolidHatch(const std::vector<std::vector<BulgeVertex>>& loops, double elevation, const Quantity_Color& color)
+    {
+        BeginEntity("HATCH", "AcDbHatch", color);
+        GroupPoint(10, 0.0, 0.0, elevation);
+        GroupPoint(210, 0.0, 0.0, 1.0);
+        Group(2, "SOLID");
+        GroupInt(70, 1);
+        GroupInt(71, 0);
+        GroupInt(91, (long long)loops.size());
+        for (size_t i = 0; i < loops.size(); ++i)
+        {
+            const std::vector<BulgeVertex>& loop = loops[i];
+            const bool hasBulge = std::any_of(loop.begin(), loop.end(), [](const BulgeVertex& v) { return v.bulge != 0.0; });
+            GroupInt(92, i == 0 ? 2 | 1 : 2);           // polyline path, the first one external
+            GroupInt(72, hasBulge ? 1 : 0);
+            GroupInt(73, 1);
+            GroupInt(93, (long long)loop.size());
+            for (const BulgeVertex& vertex : loop)
+            {
+                Group(10, vertex.x);
+                Group(20, vertex.y);
+                if (hasBulge) Group(42, vertex.bulge);
+            }
+            GroupInt(97, 0);
+        }
+        GroupInt(75, 0);
+        GroupInt(76, 1);
+        GroupInt(98, 0);
+    }
+}
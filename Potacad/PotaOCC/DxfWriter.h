@@ -0,0 +1,108 @@
+#pragma once
+#include <Quantity_Color.hxx>
+#include <gp_Pnt.hxx>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: export the scene as DXF for other CAD tools
+    public ref class DxfWriterPublic
+    {
+    public:
+        static bool Export(System::IntPtr viewerHandlePtr, System::String^ path);
+    };
+
+    // Streams DXF group codes through one preallocated buffer straight to disk.
+    // Entities are written as they are visited; nothing is collected into a document first.
+    // Coordinates use the shortest decimal that reads back to the same double.
+    // The file is a complete R2000 (AC1015) drawing: symbol tables with the block records of model
+    // and paper space, their BLOCKS, and the root dictionary in OBJECTS. Every entity names its
+    // owner (*Model_Space) and its layer.
+    class DxfWriter
+    {
+    public:
+        struct BulgeVertex
+        {
+            double x = 0.0, y = 0.0;
+            double bulge = 0.0;             // tan(included angle / 4) of the arc to the next vertex, CCW positive
+        };
+
+        struct Layer
+        {
+            std::string name;               // UTF-8
+            bool isVisible = true;
+            bool isFrozen = false;
+            bool isLocked = false;
+        };
+
+        explicit DxfWriter(size_t bufferSize = 1 << 20);
+        ~DxfWriter();
+
+        DxfWriter(const DxfWriter&) = delete;
+        DxfWriter& operator=(const DxfWriter&) = delete;
+
+        // Walks the displayed entities of the viewer into a new file
+        static bool ExportScene(NativeViewerHandle* native, const std::wstring& path);
+
+        // Writes the header, the tables with these layers (layer 0 is added when missing) and the
+        // model and paper space blocks, then opens the ENTITIES section
+        bool Open(const std::wstring& path, const std::vector<Layer>& layers);
+
+        // Closes the entities, writes the OBJECTS section, patches the handle seed and flushes
+        bool Close();
+
+        // Layer of the entities written next; must be one of the layers given to Open
+        void SetLayer(const std::string& utf8);
+
+        void Point(const gp_Pnt& p, const Quantity_Color& color);
+        void Line(const gp_Pnt& p1, const gp_Pnt& p2, const Quantity_Color& color);
+        void Circle(const gp_Pnt& center, double radius, const Quantity_Color& color);
+        void Arc(const gp_Pnt& center, double radius, double startDeg, double endDeg, const Quantity_Color& color);
+        void LwPolyline(const std::vector<BulgeVertex>& vertices, double elevation, bool isClosed, const Quantity_Color& color);
+        void Polyline3d(const std::vector<gp_Pnt>& vertices, bool isClosed, const Quantity_Color& color);
+        void Text(const gp_Pnt& anchor, double height, const std::string& utf8, const Quantity_Color& color);
+        void Face3d(const gp_Pnt& p1, const gp_Pnt& p2, const gp_Pnt& p3, const gp_Pnt& p4, const Quantity_Color& color);
+
+        // Solid fill in the XY plane; the first loop is the outer boundary
+        void SolidHatch(const std::vector<std::vector<BulgeVertex>>& loops, double elevation, const Quantity_Color& color);
+
+        uint64_t NbEntities() const { return myNbEntities; }
+
+        // Shortest round-trip decimal; returns the end of the written characters (at most 25)
+        static char* FormatDouble(double value, char* out);
+
+    private:
+        void Group(int code, const char* text, size_t length);
+        void Group(int code, const char* text);
+        void Group(int code, const std::string& text) { Group(code, text.data(), text.size()); }
+        void Group(int code, double value);
+        void GroupInt(int code, long long value);
+        void GroupPoint(int code, double x, double y, double z);
+        void GroupHex(int code, uint64_t value);
+        uint64_t GroupHandle();
+
+        void BeginTable(const char* name, const char* handle, int nbRecords);
+        void BeginRecord(const char* type, const char* handle, const char* table, const char* subclass);
+
+        // Entity type, handle, owner, subclass markers, layer and true colour; returns the handle
+        uint64_t BeginEntity(const char* type, const char* subclass, const Quantity_Color& color);
+
+        void Reserve(size_t bytes);
+        void FlushBuffer();
+
+        std::ofstream myOut;
+        std::vector<char> myBuffer;
+        size_t myFill = 0;
+        uint64_t myHandleSeedOffset = 0;    // file offset of the $HANDSEED value, patched on Close
+        uint64_t myWritten = 0;
+        uint64_t myNextHandle = 0x30;       // below are the tables, block records and dictionaries
+        std::string myLayer = "0";          // as written in group 8
+        uint64_t myNbEntities = 0;
+        bool myIsFailed = false;
+    };
+}
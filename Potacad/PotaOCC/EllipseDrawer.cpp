@@ -1,7 +1,10 @@
 ﻿#include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "EllipseDrawer.h"
+#include "SelectionHelper.h"
 #include "ShapeDrawer.h"
+#include "ViewerManager.h"
 #include <gp_Ax2.hxx>              // For creating a plane in space (gp_Ax2)
 #include <gp_Pnt.hxx>              // For creating points (gp_Pnt)
 #include <gp_Trsf.hxx>             // For transformations (gp_Trsf)
@@ -36,8 +39,13 @@ array<int>^ EllipseDrawer::DrawEllipseBatch(System::IntPtr ctxPtr, array<double>
         return gcnew array<int>(0);
 
     Handle(AIS_InteractiveContext) ctx(rawCtx);
+    NativeViewerHandle* native = ViewerRegistry::FindByContext(rawCtx);
+    if (!native)
+        return gcnew array<int>(0);
+
     int n = x->Length;
     auto ids = gcnew array<int>(n);
+    const uint16_t layer = native->layers.Current();
 
     for (int i = 0; i < n; ++i)
     {
@@ -57,12 +65,6 @@ array<int>^ EllipseDrawer::DrawEllipseBatch(System::IntPtr ctxPtr, array<double>
             geomEllipse->Transform(rotation);
         }
 
-        // Create an edge for the ellipse
-        Handle(AIS_Shape) aisEllipse = new AIS_Shape(BRepBuilderAPI_MakeEdge(geomEllipse));
-
-        // Set display mode (Wireframe or Shaded)
-        aisEllipse->SetDisplayMode(AIS_WireFrame);
-
         // Map line type
         Aspect_TypeOfLine occType = Aspect_TOL_SOLID;  // Default
         if (lineTypes != nullptr && i < lineTypes->Length && lineTypes[i] != nullptr)
@@ -81,24 +83,16 @@ array<int>^ EllipseDrawer::DrawEllipseBatch(System::IntPtr ctxPtr, array<double>
         double db = (b != nullptr && i < b->Length) ? (double)b[i] / 255.0 : 0.5;
         Quantity_Color qcol(dr, dg, db, Quantity_TOC_RGB);
 
-        Handle(Prs3d_Drawer) drawer = aisEllipse->Attributes();
-        if (drawer.IsNull()) drawer = new Prs3d_Drawer();
-
-        // Apply color and line type to the ellipse
-        Handle(Prs3d_LineAspect) lineAsp = new Prs3d_LineAspect(qcol, occType, 1.0);
-        drawer->SetWireAspect(lineAsp);
-        aisEllipse->SetAttributes(drawer);
-
-        // Display the ellipse
-        ctx->Display(aisEllipse, false);
-        ctx->SetColor(aisEllipse, qcol, false);
-
-        // Store ID
-        ids[i] = (int)aisEllipse.get();
+        // Create an edge for the ellipse and store it as a document row
+        EntityStyle style;
+        style.color = qcol;
+        style.lineType = occType;
+        ids[i] = native->document.Create(EntityType::Ellipse, BRepBuilderAPI_MakeEdge(geomEllipse), style, layer);
     }
 
-    // Update viewer to reflect changes
-    ctx->UpdateCurrentViewer();
+    // Derive the presentations, then update viewer to reflect changes
+    native->document.Sync(native);
+    FrameScheduler::Redraw(ctx);
 
     return ids;
 }
@@ -0,0 +1,304 @@
+#include "pch.h"
+#include "EntityIndex.h"
+#include <algorithm>
+#include <limits>
+
+namespace PotaOCC
+{
+    static const int kLeafSize = 8;
+
+    // Refits loosen the tree a little each; past this share of the indexed entities it is rebuilt
+    static const int kRefitShare = 4;
+
+    static EntityBounds EmptyBounds()
+    {
+        EntityBounds bounds;
+        bounds.xMin = bounds.yMin = std::numeric_limits<double>::max();
+        bounds.xMax = bounds.yMax = -std::numeric_limits<double>::max();
+        return bounds;
+    }
+
+    int EntityIndex::Add(const Handle(AIS_InteractiveObject)& obj, const EntityBounds& bounds, uint16_t layer)
+    {
+        const int id = (int)myObjects.size();
+        myObjects.push_back(obj);
+        myBounds.push_back(bounds);
+        myLayers.push_back(layer);
+        myIds[obj.get()] = id;
+
+        // A new layer may bring back a bit that only excluded layers used so far
+        if (layer > myMaxLayer)
+        {
+            myMaxLayer = layer;
+            UpdateLayerMasks();
+        }
+        return id;
+    }
+    void EntityIndex::Update(int id, const EntityBounds& bounds)
+    {
+        myBounds[id] = bounds;
+        Refit(id);
+    }
+    void EntityIndex::Remove(int id)
+    {
+        if (id < 0 || id >= Size() || myObjects[id].IsNull()) return;
+        myIds.erase(myObjects[id].get());
+        myObjects[id].Nullify();
+
+        // Its slot in the leaf stays until the next rebuild; queries skip it
+        Refit(id);
+    }
+    void EntityIndex::SetLayer(int id, uint16_t layer)
+    {
+        if (myLayers[id] == layer) return;
+        myLayers[id] = layer;
+        if (layer > myMaxLayer)
+        {
+            myMaxLayer = layer;
+            UpdateLayerMasks();
+        }
+
+        // Node masks above it no longer cover the new layer
+        Refit(id);
+    }
+    void EntityIndex::Refit(int id)
+    {
+        if (id >= myIndexedCount || myLeaves[id] < 0) return;
+
+        // The leaf is recomputed from its live entities, each ancestor from its two children
+        Node& leaf = myNodes[myLeaves[id]];
+        leaf.bounds = EmptyBounds();
+        leaf.layerBits = 0;
+        for (int i = leaf.first; i < leaf.first + leaf.count; ++i)
+        {
+            const int entity = myOrder[i];
+            if (myObjects[entity].IsNull()) continue;
+            leaf.bounds.Add(myBounds[entity]);
+            leaf.layerBits |= LayerBit(myLayers[entity]);
+        }
+
+        for (int nodeId = myParents[myLeaves[id]]; nodeId >= 0; nodeId = myParents[nodeId])
+        {
+            Node& node = myNodes[nodeId];
+            node.bounds = myNodes[node.left].bounds;
+            node.bounds.Add(myNodes[node.right].bounds);
+            node.layerBits = myNodes[node.left].layerBits | myNodes[node.right].layerBits;
+        }
+        ++myNbRefits;
+    }
+    void EntityIndex::SetLayerExcluded(uint16_t layer, bool isExcluded)
+    {
+        if (layer >= myIsExcluded.size())
+        {
+            if (!isExcluded) return;
+            myIsExcluded.resize((size_t)layer + 1, false);
+        }
+        myIsExcluded[layer] = isExcluded;
+        UpdateLayerMasks();
+    }
+    void EntityIndex::UpdateLayerMasks()
+    {
+        myVisitBits = 0;
+        myMixedBits = 0;
+        const int nbLayers = std::max((int)myMaxLayer + 1, (int)myIsExcluded.size());
+        for (int layer = 0; layer < nbLayers; ++layer)
+        {
+            const bool isExcluded = layer < (int)myIsExcluded.size() && myIsExcluded[layer];
+            (isExcluded ? myMixedBits : myVisitBits) |= LayerBit((uint16_t)layer);
+        }
+    }
+    void EntityIndex::Clear()
+    {
+        myObjects.clear();
+        myIds.clear();
+        myBounds.clear();
+        myLayers.clear();
+        myIsExcluded.clear();
+        myMaxLayer = 0;
+        UpdateLayerMasks();
+        myOrder.clear();
+        myNodes.clear();
+        myParents.clear();
+        myLeaves.clear();
+        myIndexedCount = 0;
+        myNbRefits = 0;
+    }
+    void EntityIndex::RebuildIfNeeded()
+    {
+        const int total = Size();
+        const int tail = total - myIndexedCount;
+
+        // Small tails are scanned linearly and edits are refitted; rebuilding on every change would cost more
+        if (myNbRefits <= std::max(4096, myIndexedCount / kRefitShare) && tail <= std::max(4096, total / 8))
+            return;
+
+        myOrder.clear();
+        myOrder.reserve(total);
+        for (int i = 0; i < total; ++i)
+            if (!myObjects[i].IsNull()) myOrder.push_back(i);
+
+        myNodes.clear();
+        myParents.clear();
+        myLeaves.assign(total, -1);
+        myIndexedCount = total;
+        myNbRefits = 0;
+        if (myOrder.empty())
+            return;
+
+        const int count = (int)myOrder.size();
+        myNodes.reserve(2 * (count / kLeafSize + 1));
+        myParents.reserve(myNodes.capacity());
+        BuildNode(0, count, -1);
+    }
+    int EntityIndex::BuildNode(int first, int count, int parent)
+    {
+        const int nodeId = (int)myNodes.size();
+        myNodes.push_back(Node());
+        myParents.push_back(parent);
+
+        EntityBounds bounds = myBounds[myOrder[first]];
+        uint64_t layerBits = LayerBit(myLayers[myOrder[first]]);
+        double cxMin = (bounds.xMin + bounds.xMax) * 0.5, cxMax = cxMin;
+        double cyMin = (bounds.yMin + bounds.yMax) * 0.5, cyMax = cyMin;
+        for (int i = first + 1; i < first + count; ++i)
+        {
+            const EntityBounds& b = myBounds[myOrder[i]];
+            bounds.Add(b);
+            layerBits |= LayerBit(myLayers[myOrder[i]]);
+            const double cx = (b.xMin + b.xMax) * 0.5;
+            const double cy = (b.yMin + b.yMax) * 0.5;
+            cxMin = std::min(cxMin, cx); cxMax = std::max(cxMax, cx);
+            cyMin = std::min(cyMin, cy); cyMax = std::max(cyMax, cy);
+        }
+
+        myNodes[nodeId].bounds = bounds;
+        myNodes[nodeId].layerBits = layerBits;
+        myNodes[nodeId].first = first;
+        myNodes[nodeId].count = count;
+
+        if (count <= kLeafSize)
+        {
+            for (int i = first; i < first + count; ++i)
+                myLeaves[myOrder[i]] = nodeId;
+            return nodeId;
+        }
+
+        // Median split on the wider spread of entity centres
+        const bool splitX = (cxMax - cxMin) >= (cyMax - cyMin);
+        const int half = count / 2;
+        auto begin = myOrder.begin() + first;
+        std::nth_element(begin, begin + half, begin + count,
+            [this, splitX](int a, int b)
+            {
+                const EntityBounds& ba = myBounds[a];
+                const EntityBounds& bb = myBounds[b];
+                return splitX ? (ba.xMin + ba.xMax) < (bb.xMin + bb.xMax)
+                              : (ba.yMin + ba.yMax) < (bb.yMin + bb.yMax);
+            });
+
+        const int left = BuildNode(first, half, nodeId);
+        const int right = BuildNode(first + half, count - half, nodeId);
+        myNodes[nodeId].left = left;
+        myNodes[nodeId].right = right;
+        return nodeId;
+    }
+    void EntityIndex::AppendRange(const Node& node, std::vector<int>& out) const
+    {
+        // Entities removed since the build still hold their slot
+        for (int i = node.first; i < node.first + node.count; ++i)
+            if (!myObjects[myOrder[i]].IsNull()) out.push_back(myOrder[i]);
+    }
+    void EntityIndex::QueryInside(const EntityBounds& rect, std::vector<int>& inside)
+    {
+        RebuildIfNeeded();
+
+        if (!myNodes.empty())
+        {
+            std::vector<int> stack;
+            stack.push_back(0);
+            while (!stack.empty())
+            {
+                const Node& node = myNodes[stack.back()];
+                stack.pop_back();
+
+                if (!rect.Overlaps(node.bounds) || (node.layerBits & myVisitBits) == 0)
+                    continue;
+
+                // Whole subtree inside: take the contiguous range without visiting children
+                if (rect.Contains(node.bounds) && (node.layerBits & myMixedBits) == 0)
+                {
+                    AppendRange(node, inside);
+                    continue;
+                }
+
+                if (node.left < 0)
+                {
+                    for (int i = node.first; i < node.first + node.count; ++i)
+                    {
+                        if (myObjects[myOrder[i]].IsNull() || IsExcluded(myOrder[i])) continue;
+                        if (rect.Contains(myBounds[myOrder[i]]))
+                            inside.push_back(myOrder[i]);
+                    }
+                    continue;
+                }
+
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+
+        for (int id = myIndexedCount; id < Size(); ++id)
+        {
+            if (myObjects[id].IsNull() || IsExcluded(id)) continue;
+            if (rect.Contains(myBounds[id]))
+                inside.push_back(id);
+        }
+    }
+    void EntityIndex::QueryTouching(const EntityBounds& rect, std::vector<int>& inside, std::vector<int>& boundary)
+    {
+        RebuildIfNeeded();
+
+        if (!myNodes.empty())
+        {
+            std::vector<int> stack;
+            stack.push_back(0);
+            while (!stack.empty())
+            {
+                const Node& node = myNodes[stack.back()];
+                stack.pop_back();
+
+                if (!rect.Overlaps(node.bounds) || (node.layerBits & myVisitBits) == 0)
+                    continue;
+
+                if (rect.Contains(node.bounds) && (node.layerBits & myMixedBits) == 0)
+                {
+                    AppendRange(node, inside);
+                    continue;
+                }
+
+                if (node.left < 0)
+                {
+                    for (int i = node.first; i < node.first + node.count; ++i)
+                    {
+                        if (myObjects[myOrder[i]].IsNull() || IsExcluded(myOrder[i])) continue;
+                        const EntityBounds& b = myBounds[myOrder[i]];
+                        if (rect.Contains(b)) inside.push_back(myOrder[i]);
+                        else if (rect.Overlaps(b)) boundary.push_back(myOrder[i]);
+                    }
+                    continue;
+                }
+
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+
+        for (int id = myIndexedCount; id < Size(); ++id)
+        {
+            if (myObjects[id].IsNull() || IsExcluded(id)) continue;
+            const EntityBounds& b = myBounds[id];
+            if (rect.Contains(b)) inside.push_back(id);
+            else if (rect.Overlaps(b)) boundary.push_back(id);
+        }
+    }
+}
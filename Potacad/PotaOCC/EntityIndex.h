@@ -0,0 +1,104 @@
+#pragma once
+#include <AIS_InteractiveObject.hxx>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+namespace PotaOCC
+{
+    // XY extent of a 2D drafting entity, in world units
+    struct EntityBounds
+    {
+        double xMin = 0.0, yMin = 0.0, xMax = 0.0, yMax = 0.0;
+
+        bool Contains(const EntityBounds& other) const
+        {
+            return other.xMin >= xMin && other.xMax <= xMax && other.yMin >= yMin && other.yMax <= yMax;
+        }
+        bool Overlaps(const EntityBounds& other) const
+        {
+            return other.xMax >= xMin && other.xMin <= xMax && other.yMax >= yMin && other.yMin <= yMax;
+        }
+        void Add(const EntityBounds& other)
+        {
+            xMin = std::min(xMin, other.xMin); yMin = std::min(yMin, other.yMin);
+            xMax = std::max(xMax, other.xMax); yMax = std::max(yMax, other.yMax);
+        }
+    };
+
+    // Bounding-volume hierarchy over entity extents, used for window/crossing selection.
+    // Entities added after the last build sit in a linear tail until enough accumulate for a rebuild.
+    // Moving, removing or relayering an indexed entity refits its leaf and the ancestors' bounds in
+    // place; the tree is only rebuilt once refits have loosened it past a share of its size.
+    // Every node also carries a mask of the layers below it, so subtrees holding only excluded
+    // (locked or hidden) layers are never visited.
+    class EntityIndex
+    {
+    public:
+        int Add(const Handle(AIS_InteractiveObject)& obj, const EntityBounds& bounds, uint16_t layer = 0);
+        void Update(int id, const EntityBounds& bounds);
+        void SetLayer(int id, uint16_t layer);
+        void Clear();
+
+        // Drops the object of id; the id stays taken (Size() counts it) but Object() is null and queries skip it
+        void Remove(int id);
+
+        // Queries skip entities of an excluded layer; toggling costs nothing per entity
+        void SetLayerExcluded(uint16_t layer, bool isExcluded);
+        uint16_t Layer(int id) const { return myLayers[id]; }
+
+        int Size() const { return (int)myObjects.size(); }
+        const Handle(AIS_InteractiveObject)& Object(int id) const { return myObjects[id]; }
+        const EntityBounds& Bounds(int id) const { return myBounds[id]; }
+
+        // Id of an indexed object, or -1
+        int Find(const Handle(AIS_InteractiveObject)& obj) const
+        {
+            auto it = myIds.find(obj.get());
+            return it != myIds.end() ? it->second : -1;
+        }
+
+        // Entities lying fully inside rect (window selection)
+        void QueryInside(const EntityBounds& rect, std::vector<int>& inside);
+
+        // Entities touching rect (crossing selection); extents only partly inside go to boundary
+        void QueryTouching(const EntityBounds& rect, std::vector<int>& inside, std::vector<int>& boundary);
+
+    private:
+        struct Node
+        {
+            EntityBounds bounds;
+            int first = 0;      // range in myOrder
+            int count = 0;
+            int left = -1;      // -1 for leaves
+            int right = -1;
+            uint64_t layerBits = 0; // LayerBit of every entity in the subtree
+        };
+
+        // Layers share the 64 bits modulo 64; entities are still checked exactly at the leaves
+        static uint64_t LayerBit(uint16_t layer) { return (uint64_t)1 << (layer & 63); }
+        bool IsExcluded(int id) const { return myLayers[id] < myIsExcluded.size() && myIsExcluded[myLayers[id]]; }
+        void UpdateLayerMasks();
+
+        void RebuildIfNeeded();
+        int BuildNode(int first, int count, int parent);
+        void Refit(int id);
+        void AppendRange(const Node& node, std::vector<int>& out) const;
+
+        std::vector<Handle(AIS_InteractiveObject)> myObjects;
+        std::unordered_map<const AIS_InteractiveObject*, int> myIds;
+        std::vector<EntityBounds> myBounds;
+        std::vector<uint16_t> myLayers;
+        std::vector<bool> myIsExcluded;         // by layer
+        uint16_t myMaxLayer = 0;
+        uint64_t myVisitBits = ~(uint64_t)0;    // bits shared by at least one included layer
+        uint64_t myMixedBits = 0;               // bits shared by at least one excluded layer
+        std::vector<int> myOrder;
+        std::vector<Node> myNodes;
+        std::vector<int> myParents;             // by node, -1 for the root
+        std::vector<int> myLeaves;              // by indexed id, -1 if it was not live at the build
+        int myIndexedCount = 0;
+        int myNbRefits = 0;                     // edits refitted into the tree since the last build
+    };
+}
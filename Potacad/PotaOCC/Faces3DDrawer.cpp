@@ -1,6 +1,8 @@
 ﻿#include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "Faces3DDrawer.h"
+#include "SelectionHelper.h"
 
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Shape.hxx>
@@ -69,13 +71,13 @@ array<int>^ Faces3DDrawer::DrawFaces3DBatch(
             ctx->SetTransparency(aisFace, tVal, Standard_False);
 
             // ✅ Display the face
-            ctx->Display(aisFace, Standard_False);
+            SelectionHelper::DisplayDeferred(ctx, aisFace);
 
             // ✅ Store ID (for your _dxfShapeDict)
             ids[i] = (int)aisFace.get();
         }
 
-        ctx->UpdateCurrentViewer();
+        FrameScheduler::Redraw(ctx);
         return ids;
     }
     catch (...)
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "FrameScheduler.h"
+#include "NativeViewerHandle.h"
+#include "ViewerManager.h"
+
+namespace PotaOCC
+{
+    bool FrameSchedulerPublic::Present(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->view.IsNull()) return false;
+
+        native->cameraAnimation.Advance(native);
+        native->tiles.Update(native);
+        return native->frames.Present(native->view);
+    }
+
+    void FrameSchedulerPublic::Detach(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        // Whatever is still pending is drawn now rather than lost
+        if (native->frames.IsPending() && !native->view.IsNull())
+            native->frames.Present(native->view);
+        native->frames.Detach();
+    }
+
+    void FrameSchedulerPublic::GetStats(System::IntPtr viewerHandlePtr, int% requests, int% frames)
+    {
+        requests = 0;
+        frames = 0;
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        requests = native->frames.NbRequests();
+        frames = native->frames.NbFrames();
+    }
+
+    void FrameScheduler::Redraw(NativeViewerHandle* native)
+    {
+        if (native == nullptr || native->view.IsNull()) return;
+
+        FrameScheduler& frames = native->frames;
+        ++frames.myNbRequests;
+        if (frames.myIsDriven)
+        {
+            frames.myIsDirty = true;
+            return;
+        }
+        native->view->Redraw();
+        ++frames.myNbFrames;
+    }
+
+    void FrameScheduler::Redraw(const Handle(AIS_InteractiveContext)& context)
+    {
+        if (context.IsNull()) return;
+
+        NativeViewerHandle* native = ViewerRegistry::FindByContext(context.get());
+        if (native != nullptr)
+            Redraw(native);
+        else
+            context->UpdateCurrentViewer();
+    }
+
+    void FrameScheduler::Redraw(const Handle(V3d_View)& view)
+    {
+        if (view.IsNull()) return;
+
+        NativeViewerHandle* native = ViewerRegistry::FindByView(view.get());
+        if (native != nullptr)
+            Redraw(native);
+        else
+            view->Redraw();
+    }
+
+    void FrameScheduler::RedrawImmediate(NativeViewerHandle* native)
+    {
+        if (native == nullptr || native->view.IsNull()) return;
+
+        FrameScheduler& frames = native->frames;
+        ++frames.myNbRequests;
+        if (frames.myIsDriven)
+        {
+            frames.myIsImmediateDirty = true;
+            return;
+        }
+        native->view->RedrawImmediate();
+        ++frames.myNbFrames;
+    }
+
+    void FrameScheduler::RedrawImmediate(const Handle(V3d_View)& view)
+    {
+        if (view.IsNull()) return;
+
+        NativeViewerHandle* native = ViewerRegistry::FindByView(view.get());
+        if (native != nullptr)
+            RedrawImmediate(native);
+        else
+            view->RedrawImmediate();
+    }
+
+    bool FrameScheduler::Present(const Handle(V3d_View)& view)
+    {
+        myIsDriven = true;
+        if (view.IsNull() || !IsPending()) return false;
+
+        // A full redraw draws the immediate layers too
+        if (myIsDirty)
+            view->Redraw();
+        else
+            view->RedrawImmediate();
+
+        myIsDirty = false;
+        myIsImmediateDirty = false;
+        ++myNbFrames;
+        return true;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <AIS_InteractiveContext.hxx>
+#include <V3d_View.hxx>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: the UI calls Present once per display refresh
+    public ref class FrameSchedulerPublic
+    {
+    public:
+        // Draws what changed since the last frame; returns true if a frame was drawn
+        static bool Present(System::IntPtr viewerHandlePtr);
+
+        // No more frames will come (viewer hidden or closing): requests draw at once again
+        static void Detach(System::IntPtr viewerHandlePtr);
+
+        // Redraw requests received and frames actually drawn since the viewer was created
+        static void GetStats(System::IntPtr viewerHandlePtr, int% requests, int% frames);
+    };
+
+    // Per-viewer redraw coalescing. APIs ask for a redraw instead of drawing: a full redraw when scene
+    // structures, the camera or the selection changed, an immediate one when only the immediate layers
+    // (TopOSD overlays, dynamic highlight) did. Once a frame source drives the viewer, requests only set
+    // flags and Present draws at most one frame per display refresh, so a batch of displays or a burst of
+    // mouse moves costs one redraw. Until then requests draw at once, as before.
+    class FrameScheduler
+    {
+    public:
+        // Call-site entry points; the context and view overloads find their viewer through the registry
+        static void Redraw(NativeViewerHandle* native);
+        static void Redraw(const Handle(AIS_InteractiveContext)& context);
+        static void Redraw(const Handle(V3d_View)& view);
+        static void RedrawImmediate(NativeViewerHandle* native);
+        static void RedrawImmediate(const Handle(V3d_View)& view);
+
+        bool Present(const Handle(V3d_View)& view);
+        void Detach() { myIsDriven = false; }
+
+        bool IsDriven() const { return myIsDriven; }
+        bool IsPending() const { return myIsDirty || myIsImmediateDirty; }
+        int NbRequests() const { return myNbRequests; }
+        int NbFrames() const { return myNbFrames; }
+
+    private:
+        bool myIsDriven = false;            // a frame source calls Present
+        bool myIsDirty = false;             // full redraw pending
+        bool myIsImmediateDirty = false;    // immediate layers only
+        int myNbRequests = 0;
+        int myNbFrames = 0;
+    };
+}
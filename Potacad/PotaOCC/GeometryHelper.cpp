@@ -1,6 +1,9 @@
 ﻿#include "pch.h"
 #include "GeometryHelper.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "MeshingService.h"
+#include "ViewerManager.h"
 #include <BRepAdaptor_Surface.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
 #include <GeomLProp_SLProps.hxx>
@@ -16,11 +19,11 @@
 #include <AIS_Shape.hxx>
 #include <AIS_InteractiveObject.hxx>
 #include <TopExp_Explorer.hxx>
-#include <thread>
-#include <chrono>
 #include "ViewHelper.h"
 #include <BRepAdaptor_Curve.hxx>
 #include "MouseCursor.h"
+#include "SelectionHelper.h"
+#include "ShapeBooleanOperator.h"
 using namespace PotaOCC::ViewHelper;
 using namespace PotaOCC::ViewHelper;
 using namespace PotaOCC;
@@ -119,24 +122,44 @@ namespace PotaOCC {
             int xMax = std::max(native->dragStartX, native->dragEndX);
             int yMax = std::max(native->dragStartY, native->dragEndY);
 
-            // Perform selection with AIS
-            context->Select(xMin, yMin, xMax, yMax, view, Standard_False);
-
-            // Collect selected AIS objects
             bool isAnyObjectSelected = false;
             AIS_ListOfInteractive picked;
-            for (context->InitSelected(); context->MoreSelected(); context->NextSelected())
+
+            if (native->entityIndex.Size() > 0)
             {
-                Handle(AIS_InteractiveObject) obj = context->SelectedInteractive();
-                if (!obj.IsNull())
+                // Left-to-right drag = window (fully inside), right-to-left = crossing (touching)
+                const bool crossing = native->dragEndX < native->dragStartX;
+
+                std::vector<int> ids;
+                SelectionHelper::SelectInRectangle(native, context, view, xMin, yMin, xMax, yMax, crossing, ids);
+                for (int id : ids)
+                    picked.Append(native->entityIndex.Object(id));
+                isAnyObjectSelected = !ids.empty();
+
+                // One batched highlight instead of an AddSelect per entity
+                context->ClearSelected(Standard_False);
+                SelectionHelper::SetSelection(native, context, std::move(ids));
+            }
+            else
+            {
+                // Build pending sensitives inside the rectangle, then perform selection with AIS
+                SelectionHelper::ActivateDeferredInRegion(native, context, view, xMin, yMin, xMax, yMax);
+                context->Select(xMin, yMin, xMax, yMax, view, Standard_False);
+
+                // Collect selected AIS objects
+                for (context->InitSelected(); context->MoreSelected(); context->NextSelected())
                 {
-                    picked.Append(obj);
-                    isAnyObjectSelected = true;
+                    Handle(AIS_InteractiveObject) obj = context->SelectedInteractive();
+                    if (!obj.IsNull())
+                    {
+                        picked.Append(obj);
+                        isAnyObjectSelected = true;
+                    }
                 }
-            }
 
-            // Highlight selected objects (existing helper)
-            ShapeDrawer::HighlightSelectedObjects(context, picked);
+                // Highlight selected objects (existing helper)
+                ShapeDrawer::HighlightSelectedObjects(context, picked);
+            }
 
             // --- Extrude handling (same logic as original) ---
             if (isAnyObjectSelected && native->isExtrudeMode)
@@ -271,16 +294,25 @@ namespace PotaOCC {
                     return true;
                 }
 
-                // Perform revolve using the axis stored in native (first selected line)
-                ShapeRevolver revolver(native);
-                revolver.RevolveWireAndDisplayFinal(context, revolveWire, 360.0);
-
-                // Store and reset revolve state as original code did
+                // Start scrubbing: the angle follows the mouse and the exact revolve runs on release
                 native->revolveWire = revolveWire;
+                native->activeWire = revolveWire;
                 native->isRevolveMode = false;
-                native->isRevolveAxisSet = false;
+                native->isRevolvingActive = true;
+                native->currentRevolveAngle = 360.0;
+                native->lastMouseX = native->dragEndX;
+
+                ShapeRevolver revolver(native);
+                if (!revolver.RevolveWireAndDisplayPreview(context))
+                {
+                    native->isRevolvingActive = false;
+                    native->isRevolveAxisSet = false;
+                    native->activeWire.Nullify();
+                    return true;
+                }
+                FrameScheduler::Redraw(view);
 
-                std::cout << "🌀 Revolve complete around first mouse-selected line." << std::endl;
+                std::cout << "🌀 Revolve preview started around first mouse-selected line." << std::endl;
 
                 return true; // processed selection
             }
@@ -288,26 +320,15 @@ namespace PotaOCC {
             // nothing to do
             return false;
         }
-        void AnimateZoomWindow(NativeViewerHandle* native, Handle(V3d_View) view, int xMin, int yMin, int xMax, int yMax, int steps)
+        void AnimateZoomWindow(NativeViewerHandle* native, Handle(V3d_View) view, int xMin, int yMin, int xMax, int yMax)
         {
-            if (view.IsNull()) return;
-            Standard_Real startScale = view->Camera()->Scale();
-            Handle(Graphic3d_Camera) camTarget = new Graphic3d_Camera(*view->Camera());
-            view->WindowFitAll(xMin, yMin, xMax, yMax);
-            Standard_Real targetScale = view->Camera()->Scale();
-            view->Camera()->SetScale(startScale);
-            view->Redraw();
-            for (int i = 1; i <= steps; ++i)
+            if (native == nullptr || view.IsNull()) return;
+
+            // Returns at once; the frame source plays the transition
+            native->cameraAnimation.AnimateTo(native, [=](const Handle(V3d_View)& target)
             {
-                double t = (double)i / (double)steps;
-                t = t * t * (3.0 - 2.0 * t);
-                Standard_Real currentScale = startScale + (targetScale - startScale) * t;
-                view->Camera()->SetScale(currentScale);
-                view->Redraw();
-                std::this_thread::sleep_for(std::chrono::milliseconds(5));
-            }
-            view->Camera()->SetScale(targetScale);
-            view->Redraw();
+                target->WindowFitAll(xMin, yMin, xMax, yMax);
+            });
         }
         void ApplyLocalTransformationToAISShape(Handle(AIS_Shape) aisShape, Handle(AIS_InteractiveContext) context)
         {
@@ -318,23 +339,34 @@ namespace PotaOCC {
 
             if (localTrsf.Form() != gp_Identity)
             {
-                TopoDS_Shape transformedShape = BRepBuilderAPI_Transform(originalShape, localTrsf, true).Shape();
+                // The copy keeps the triangulation: meshed solids have auto-triangulation off and would show nothing
+                TopoDS_Shape transformedShape = BRepBuilderAPI_Transform(originalShape, localTrsf, Standard_True, Standard_True).Shape();
                 aisShape->Set(transformedShape);
                 aisShape->SetLocalTransformation(gp_Trsf());
+
+                // Solids the meshing service looks after are handed back to it under their new shape
+                NativeViewerHandle* native = ViewerRegistry::FindByContext(context.get());
+                if (native != nullptr && !aisShape->Attributes()->IsAutoTriangulation())
+                    MeshingService::Of(native).Submit(aisShape, native->view);
                 context->Redisplay(aisShape, Standard_False);
             }
         }
         void ApplyLocalTransformationToShape(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context)
         {
-            Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(native->rotatingObject);
-            if (aisShape.IsNull())
-                return;
-            TopoDS_Shape originalShape = aisShape->Shape();
-            gp_Trsf localTrsf = aisShape->LocalTransformation();
-            TopoDS_Shape transformedShape = BRepBuilderAPI_Transform(originalShape, localTrsf, true).Shape();
-            aisShape->Set(transformedShape);
-            aisShape->SetLocalTransformation(gp_Trsf());
-            context->Redisplay(aisShape, Standard_False);
+            // Move/rotate drags only touch the local transformation; bake it into the topology once here
+            Handle(AIS_InteractiveObject) objects[2] = { native->movingObject, native->rotatingObject };
+            for (const Handle(AIS_InteractiveObject)& obj : objects)
+            {
+                Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(obj);
+                if (aisShape.IsNull() || !aisShape->HasTransformation())
+                    continue;
+
+                // Recorded as the world delta of the drag, so undo is a location change and bakes nothing
+                native->commandJournal.Moved(context, aisShape,
+                    aisShape->LocalTransformation().Multiplied(native->dragStartTransformation.Inverted()));
+                ApplyLocalTransformationToAISShape(aisShape, context);
+                SelectionHelper::RefreshEntity(native, context, aisShape);
+            }
         }
         Handle(AIS_Shape) CreateHighlightedFace(const TopoDS_Face& face)
         {
@@ -388,9 +420,10 @@ namespace PotaOCC {
         void HandleFaceHover(NativeViewerHandle* native, int x, int y, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view)
         {
             // Activate face detection and move cursor
-            context->Deactivate();
-            context->Activate(TopAbs_FACE);
-            context->MoveTo(x, y, view, Standard_True);
+            SelectionHelper::SetSelectionMode(native, context, TopAbs_FACE);
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
 
             // Get a safe detected shape (only if selectable is AIS_Shape)
             TopoDS_Shape shape = GetSafeDetectedShape(context);
@@ -411,9 +444,10 @@ namespace PotaOCC {
         void HandleEdgeHover(NativeViewerHandle* native, int x, int y, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view)
         {
             // Activate generic shape detection and move cursor
-            context->Deactivate();
-            context->Activate(TopAbs_SHAPE);
-            context->MoveTo(x, y, view, Standard_True);
+            SelectionHelper::SetSelectionMode(native, context, TopAbs_SHAPE);
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
 
             // Default cursor (may be changed below)
             MouseCursor::SetCustomCursor(native, PotaOCC::CursorType::Default);
@@ -477,7 +511,7 @@ namespace PotaOCC {
                 context->Erase(native->hoverHighlightedFace, Standard_False);
                 native->hoverHighlightedFace.Nullify();
                 if (!view.IsNull())
-                    view->Redraw();
+                    FrameScheduler::Redraw(view);
             }
         }
         void ShowHoverHighlightForFace(NativeViewerHandle* native, const TopoDS_Face& face, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view)
@@ -504,7 +538,7 @@ namespace PotaOCC {
             context->Display(native->hoverHighlightedFace, Standard_False);
 
             if (!view.IsNull())
-                view->Redraw();
+                FrameScheduler::Redraw(view);
         }
         void HandleKeyMode(NativeViewerHandle* native, char key)
         {
@@ -529,7 +563,12 @@ namespace PotaOCC {
             case 'U': case 'u': native->isBooleanUnionMode = true; break;
             case 'Q': case 'q': native->isRectangleMode = true; break;
             case 'Z': case 'z': native->isZoomWindowMode = true; break;
-            case 27: ClearCreateEntity(native); break;
+            case 27:
+                ShapeBooleanOperator::CancelBooleanOperation(native);
+                ClearCreateEntity(native);
+                SelectionHelper::ClearSelection(native, native->context);
+                FrameScheduler::Redraw(native);
+                break;
             }
         }
     }
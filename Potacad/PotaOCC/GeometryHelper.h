@@ -21,7 +21,7 @@ namespace PotaOCC
         void ApplyTransformationToShape(TopoDS_Shape& shape, const gp_Trsf& transform);
         void ApplyLocalTransformationToShape(PotaOCC::NativeViewerHandle* native, Handle(AIS_InteractiveContext) context);
         void ApplyLocalTransformationToAISShape(Handle(AIS_Shape) aisShape, Handle(AIS_InteractiveContext) context);
-        void AnimateZoomWindow(PotaOCC::NativeViewerHandle* native, Handle(V3d_View) view, int xMin, int yMin, int xMax, int yMax, int steps);
+        void AnimateZoomWindow(PotaOCC::NativeViewerHandle* native, Handle(V3d_View) view, int xMin, int yMin, int xMax, int yMax);
         bool PerformRectangleSelection(PotaOCC::NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view, int h, int w, int mouseY);
         Handle(AIS_Shape) CreateHighlightedFace(const TopoDS_Face& face);
         TopoDS_Shape GetSafeDetectedShape(const Handle(AIS_InteractiveContext)& context);
@@ -1,5 +1,6 @@
 ﻿#include "pch.h"
 #include "HatchDrawer.h"
+#include "FrameScheduler.h"
 #include <Standard_Type.hxx>
 #include <TopoDS_Face.hxx>
 #include <TopoDS_Wire.hxx>
@@ -104,7 +105,7 @@ array<int>^ HatchDrawer::DrawHatchBatch(
                     Quantity_Color col(r[i] / 255.0, g[i] / 255.0, b[i] / 255.0, Quantity_TOC_RGB);
                     aisFace->SetColor(col);
                     aisFace->SetTransparency(transparency[i]);
-                    context->Display(aisFace, Standard_True);
+                    context->Display(aisFace, Standard_False);
                 }
             }
 
@@ -148,7 +149,7 @@ array<int>^ HatchDrawer::DrawHatchBatch(
                     }
                 }
             }
-            context->UpdateCurrentViewer();
+            FrameScheduler::Redraw(context);
 
 
             ids[i] = nextId++;
@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "ImmediateOverlay.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include <Graphic3d_AspectLine3d.hxx>
+#include <Graphic3d_TransformPers.hxx>
+#include <Graphic3d_ZLayerId.hxx>
+#include <V3d_Viewer.hxx>
+#include <gp_Vec.hxx>
+#include <algorithm>
+#include <cmath>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        const int THE_MAX_VERTICES = 2 * ImmediateOverlay::THE_MAX_SEGMENTS;
+
+        Handle(Graphic3d_AspectLine3d) LineAspect(const Quantity_Color& color)
+        {
+            return new Graphic3d_AspectLine3d(color, Aspect_TOL_SOLID, 1.0f);
+        }
+    }
+
+    void ImmediateOverlay::InitLayer(const Handle(V3d_View)& view, Layer& layer, bool isScreen)
+    {
+        layer.structure = new Graphic3d_Structure(view->Viewer()->StructureManager());
+        layer.structure->SetZLayer(Graphic3d_ZLayerId_TopOSD);
+        layer.structure->SetInfiniteState(Standard_True);   // the buffer moves; never cull it on a stale box
+        if (isScreen)
+            layer.structure->SetTransformPersistence(new Graphic3d_TransformPers(Graphic3d_TMF_2d));
+
+        // Allocated once at full size; unused vertices collapse to a point and draw nothing
+        layer.segments = new Graphic3d_ArrayOfSegments(THE_MAX_VERTICES, 0, Graphic3d_ArrayFlags_AttribsMutable);
+        for (int i = 0; i < THE_MAX_VERTICES; ++i)
+            layer.segments->AddVertex(0.0f, 0.0f, 0.0f);
+
+        layer.color = Quantity_Color(Quantity_NOC_RED);
+        layer.group = layer.structure->NewGroup();
+        layer.group->SetGroupPrimitivesAspect(LineAspect(layer.color));
+        layer.group->AddPrimitiveArray(layer.segments, Standard_False);
+        layer.nbUsed = 0;
+    }
+
+    bool ImmediateOverlay::SetPolyline(NativeViewerHandle* native, const std::vector<gp_Pnt>& points, bool isClosed,
+        bool isScreen, const Quantity_Color& color)
+    {
+        if (native == nullptr || native->view.IsNull() || native->view->Window().IsNull()) return false;
+        if (points.size() < 2) return false;
+
+        Layer& layer = isScreen ? myScreen : myWorld;
+        Layer& other = isScreen ? myWorld : myScreen;
+        if (layer.structure.IsNull())
+            InitLayer(native->view, layer, isScreen);
+
+        // TMF_2d places the origin at the lower-left corner; mouse pixels start at the top
+        Standard_Integer width = 0, height = 0;
+        if (isScreen)
+            native->view->Window()->Size(width, height);
+
+        Handle(Graphic3d_ArrayOfSegments)& segments = layer.segments;
+        auto setVertex = [&](int index, const gp_Pnt& p)
+        {
+            const double y = isScreen ? height - p.Y() : p.Y();
+            segments->SetVertice(index, Standard_ShortReal(p.X()), Standard_ShortReal(y), Standard_ShortReal(p.Z()));
+        };
+
+        const int nbPoints = (int)points.size();
+        const int nbSegments = std::min(isClosed ? nbPoints : nbPoints - 1, THE_MAX_SEGMENTS);
+        int index = 1;
+        for (int i = 0; i < nbSegments; ++i)
+        {
+            setVertex(index++, points[i]);
+            setVertex(index++, points[(i + 1) % nbPoints]);
+        }
+
+        // Only the tail the previous shape used needs collapsing
+        const gp_Pnt& last = points[nbSegments % nbPoints];
+        for (int i = index; i <= layer.nbUsed; ++i)
+            setVertex(i, last);
+        layer.nbUsed = index - 1;
+        segments->Attributes()->Invalidate();
+
+        if (!layer.color.IsEqual(color))
+        {
+            layer.color = color;
+            layer.group->SetGroupPrimitivesAspect(LineAspect(color));
+        }
+
+        if (!other.structure.IsNull() && other.structure->IsDisplayed())
+            other.structure->Erase();
+        if (!layer.structure->IsDisplayed())
+            layer.structure->Display();
+
+        FrameScheduler::RedrawImmediate(native);
+        return true;
+    }
+
+    void ImmediateOverlay::Hide(NativeViewerHandle* native)
+    {
+        if (!IsShown()) return;
+
+        for (Layer* layer : { &myScreen, &myWorld })
+        {
+            if (!layer->structure.IsNull() && layer->structure->IsDisplayed())
+                layer->structure->Erase();
+        }
+        FrameScheduler::RedrawImmediate(native);
+    }
+
+    bool ImmediateOverlay::IsShown() const
+    {
+        return (!myScreen.structure.IsNull() && myScreen.structure->IsDisplayed())
+            || (!myWorld.structure.IsNull() && myWorld.structure->IsDisplayed());
+    }
+
+    void ImmediateOverlay::SampleEllipse(const gp_Pnt& center, const gp_Dir& xDir, const gp_Dir& yDir,
+        double rx, double ry, std::vector<gp_Pnt>& points)
+    {
+        points.clear();
+        points.reserve(THE_CURVE_SEGMENTS);
+        for (int i = 0; i < THE_CURVE_SEGMENTS; ++i)
+        {
+            const double angle = 2.0 * M_PI * i / THE_CURVE_SEGMENTS;
+            points.push_back(center.Translated(gp_Vec(xDir) * (rx * std::cos(angle)) + gp_Vec(yDir) * (ry * std::sin(angle))));
+        }
+    }
+}
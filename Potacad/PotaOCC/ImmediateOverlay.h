@@ -0,0 +1,52 @@
+#pragma once
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Graphic3d_Structure.hxx>
+#include <Quantity_Color.hxx>
+#include <V3d_View.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Pnt.hxx>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // Rubber bands and drag previews of one viewer. Two structures live in the TopOSD layer for the whole
+    // viewer lifetime, one in screen pixels and one in world coordinates, each holding a single mutable
+    // segment buffer. A cursor move rewrites that buffer in place and asks for an immediate redraw only:
+    // no AIS object is recomputed, no structure is created and the scene layers are not redrawn.
+    class ImmediateOverlay
+    {
+    public:
+        static const int THE_MAX_SEGMENTS = 256;
+        static const int THE_CURVE_SEGMENTS = 64;
+
+        // Points in mouse pixels (origin top-left) when isScreen, world coordinates otherwise.
+        // Longer polylines are cut at THE_MAX_SEGMENTS. False when the viewer is not ready.
+        bool SetPolyline(NativeViewerHandle* native, const std::vector<gp_Pnt>& points, bool isClosed,
+            bool isScreen, const Quantity_Color& color);
+
+        void Hide(NativeViewerHandle* native);
+        bool IsShown() const;
+
+        // Closed ellipse sampled with THE_CURVE_SEGMENTS points; rx == ry gives a circle
+        static void SampleEllipse(const gp_Pnt& center, const gp_Dir& xDir, const gp_Dir& yDir,
+            double rx, double ry, std::vector<gp_Pnt>& points);
+
+    private:
+        struct Layer
+        {
+            Handle(Graphic3d_Structure) structure;
+            Handle(Graphic3d_Group) group;
+            Handle(Graphic3d_ArrayOfSegments) segments;
+            Quantity_Color color;
+            int nbUsed = 0;             // vertices written by the last update; the rest collapse to a point
+        };
+
+        static void InitLayer(const Handle(V3d_View)& view, Layer& layer, bool isScreen);
+
+        Layer myScreen;
+        Layer myWorld;
+    };
+}
@@ -0,0 +1,349 @@
+#include "pch.h"
+#include "LayerTable.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "SelectionHelper.h"
+#include "ViewerManager.h"
+#include <Graphic3d_CView.hxx>
+#include <Graphic3d_Layer.hxx>
+#include <Graphic3d_ZLayerSettings.hxx>
+#include <Precision.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <TCollection_AsciiString.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <msclr/marshal_cppstd.h>
+#include <algorithm>
+#include <cwctype>
+#include <iostream>
+
+namespace PotaOCC
+{
+    static void RedrawLayers(NativeViewerHandle* native)
+    {
+        FrameScheduler::Redraw(native);
+    }
+
+    bool LayerTablePublic::SetCurrentLayer(System::IntPtr viewerHandlePtr, System::String^ name)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || name == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull() || native->viewer.IsNull()) return false;
+
+        msclr::interop::marshal_context ctx;
+        native->layers.SetCurrent(native->layers.Ensure(native, ctx.marshal_as<std::wstring>(name)));
+        return true;
+    }
+
+    bool LayerTablePublic::SetLayerVisible(System::IntPtr viewerHandlePtr, System::String^ name, bool isVisible)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || name == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull() || native->viewer.IsNull()) return false;
+
+        msclr::interop::marshal_context ctx;
+        const int layer = native->layers.Find(ctx.marshal_as<std::wstring>(name));
+        if (layer < 0 || !native->layers.SetVisible(native, (uint16_t)layer, isVisible)) return false;
+        RedrawLayers(native);
+        return true;
+    }
+
+    bool LayerTablePublic::SetLayerFrozen(System::IntPtr viewerHandlePtr, System::String^ name, bool isFrozen)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || name == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull() || native->viewer.IsNull()) return false;
+
+        msclr::interop::marshal_context ctx;
+        const int layer = native->layers.Find(ctx.marshal_as<std::wstring>(name));
+        if (layer < 0 || !native->layers.SetFrozen(native, (uint16_t)layer, isFrozen)) return false;
+        RedrawLayers(native);
+        return true;
+    }
+
+    bool LayerTablePublic::SetLayerLocked(System::IntPtr viewerHandlePtr, System::String^ name, bool isLocked)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || name == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull() || native->viewer.IsNull()) return false;
+
+        msclr::interop::marshal_context ctx;
+        const int layer = native->layers.Find(ctx.marshal_as<std::wstring>(name));
+        if (layer < 0 || !native->layers.SetLocked(native, (uint16_t)layer, isLocked)) return false;
+        RedrawLayers(native);
+        return true;
+    }
+
+    bool LayerTablePublic::MoveSelectionToLayer(System::IntPtr viewerHandlePtr, System::String^ name)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || name == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull() || native->viewer.IsNull()) return false;
+        if (native->selectedEntities.empty())
+        {
+            std::cout << "⚠️ MoveSelectionToLayer: nothing selected." << std::endl;
+            return false;
+        }
+
+        msclr::interop::marshal_context ctx;
+        const uint16_t layer = native->layers.Ensure(native, ctx.marshal_as<std::wstring>(name));
+        for (int id : native->selectedEntities)
+            native->layers.Move(native, native->entityIndex.Object(id), layer);
+
+        // The selection may now sit on a layer that cannot be selected
+        if (!native->layers.IsSelectable(layer))
+            SelectionHelper::ClearSelection(native, native->context);
+        RedrawLayers(native);
+        return true;
+    }
+
+    array<System::String^>^ LayerTablePublic::GetLayerNames(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return gcnew array<System::String^>(0);
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return gcnew array<System::String^>(0);
+
+        array<System::String^>^ names = gcnew array<System::String^>(native->layers.Size());
+        for (int i = 0; i < native->layers.Size(); ++i)
+            names[i] = gcnew System::String(native->layers.Info((uint16_t)i).name.c_str());
+        return names;
+    }
+
+    namespace
+    {
+        // A layer hides through its Z layer's culling: with a distance this short and a size this large
+        // the renderer drops the layer's whole BVH at the root, while its presentations stay computed
+        // and displayed. Size culling covers parallel views, where an entity's bounding sphere can hold
+        // the eye; distance culling covers perspective ones.
+        const double THE_HIDDEN_CULLING_DISTANCE = Precision::Confusion();
+        const double THE_HIDDEN_CULLING_SIZE = 1.0e90;                      // pixels, still below Precision::Infinite()
+
+        // Picking counterpart of EntityIndex::SetLayerExcluded: rejects owners on locked, hidden or frozen layers
+        class LayerSelectionFilter : public SelectMgr_Filter
+        {
+        public:
+            explicit LayerSelectionFilter(NativeViewerHandle* native) : myNative(native) {}
+
+            Standard_Boolean IsOk(const Handle(SelectMgr_EntityOwner)& owner) const override
+            {
+                Handle(AIS_InteractiveObject) obj = Handle(AIS_InteractiveObject)::DownCast(owner->Selectable());
+                if (obj.IsNull()) return Standard_True;
+
+                const int id = myNative->document.Find(obj);
+                return id < 0 || myNative->layers.IsSelectable(myNative->document.Layer(id));
+            }
+
+            DEFINE_STANDARD_RTTI_INLINE(LayerSelectionFilter, SelectMgr_Filter)
+
+        private:
+            NativeViewerHandle* myNative;
+        };
+    }
+
+    std::wstring LayerTable::Key(const std::wstring& name)
+    {
+        std::wstring key(name);
+        std::transform(key.begin(), key.end(), key.begin(), [](wchar_t c) { return (wchar_t)std::towupper(c); });
+        return key;
+    }
+
+    int LayerTable::Find(const std::wstring& name) const
+    {
+        auto it = myIndex.find(Key(name.empty() ? L"0" : name));
+        return it == myIndex.end() ? -1 : (int)it->second;
+    }
+
+    uint16_t LayerTable::Ensure(NativeViewerHandle* native, const std::wstring& name)
+    {
+        const std::wstring layerName = name.empty() ? L"0" : name;
+        const int existing = Find(layerName);
+        if (existing >= 0) return (uint16_t)existing;
+
+        if (myLayers.size() >= 0xFFFF)
+        {
+            std::cout << "⚠️ Layer table full; entity kept on the current layer." << std::endl;
+            return myCurrent;
+        }
+
+        LayerInfo info;
+        info.name = layerName;
+        if (native && !native->viewer.IsNull())
+        {
+            // Drafting layers share one depth buffer: the default of clearing depth per Z layer
+            // would draw each layer over the previous ones. Sub-pixel entities are left to the tile proxies.
+            Graphic3d_ZLayerSettings settings;
+            settings.SetName(TCollection_AsciiString(TCollection_ExtendedString(layerName.c_str())));
+            settings.SetClearDepth(Standard_False);
+            settings.SetCullingSize(DrawingTiles::THE_DETAIL_PIXELS);
+
+            Graphic3d_ZLayerId zLayer = Graphic3d_ZLayerId_UNKNOWN;
+            if (native->viewer->AddZLayer(zLayer, settings))
+                info.zLayer = zLayer;
+            else
+                std::wcout << L"⚠️ No Z layer for " << layerName << L"; it cannot be hidden as a batch." << std::endl;
+        }
+
+        if (native && myFilter.IsNull() && !native->context.IsNull())
+        {
+            myFilter = new LayerSelectionFilter(native);
+            native->context->AddFilter(myFilter);
+        }
+
+        const uint16_t layer = (uint16_t)myLayers.size();
+        myLayers.push_back(info);
+        myIndex[Key(layerName)] = layer;
+        return layer;
+    }
+
+    void LayerTable::SetZLayer(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, uint16_t layer)
+    {
+        const Graphic3d_ZLayerId zLayer = myLayers[layer].zLayer;
+        if (obj->ZLayer() == zLayer) return;
+
+        // Shown objects move their presentations; others only remember the layer for Display
+        if (native->context->IsDisplayed(obj))
+            native->context->SetZLayer(obj, zLayer);
+        else
+            obj->SetZLayer(zLayer);
+    }
+
+    uint16_t LayerTable::Place(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj)
+    {
+        if (native == nullptr || obj.IsNull()) return myCurrent;
+
+        const int id = native->document.Find(obj);
+        uint16_t layer = id >= 0 ? native->document.Layer(id) : myCurrent;
+
+        // Nothing assigned yet: entities land on layer "0"
+        if (myLayers.empty()) layer = myCurrent = Ensure(native, L"0");
+        if (layer < myLayers.size()) SetZLayer(native, obj, layer);
+        return layer;
+    }
+
+    void LayerTable::Move(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, uint16_t layer)
+    {
+        if (native == nullptr || obj.IsNull() || layer >= myLayers.size()) return;
+
+        native->document.SetLayer(native->document.Find(obj), layer);
+        const int id = native->entityIndex.Find(obj);
+        if (id >= 0) native->entityIndex.SetLayer(id, layer);
+        SetZLayer(native, obj, layer);
+    }
+
+    void LayerTable::ApplyDisplay(NativeViewerHandle* native, uint16_t layer)
+    {
+        const LayerInfo& info = myLayers[layer];
+        if (info.zLayer == Graphic3d_ZLayerId_Default) return;
+
+        // Z layer culling is skipped altogether while the view's frustum culling is off
+        const bool isShown = IsShown(layer);
+        if (!isShown && !native->view.IsNull())
+            native->view->ChangeRenderingParams().FrustumCullingState = Graphic3d_RenderingParams::FrustumCulling_On;
+
+        Graphic3d_ZLayerSettings settings = native->viewer->ZLayerSettings(info.zLayer);
+        settings.SetCullingDistance(isShown ? Precision::Infinite() : THE_HIDDEN_CULLING_DISTANCE);
+        settings.SetCullingSize(isShown ? (double)DrawingTiles::THE_DETAIL_PIXELS : THE_HIDDEN_CULLING_SIZE);
+        native->viewer->SetZLayerSettings(info.zLayer, settings);
+
+        // Proxies were packed from the layers shown so far
+        native->tiles.Invalidate();
+    }
+
+    void LayerTable::ApplySelection(NativeViewerHandle* native, uint16_t layer)
+    {
+        const bool isSelectable = IsSelectable(layer);
+        native->entityIndex.SetLayerExcluded(layer, !isSelectable);
+
+        // Highlighted entities of the layer would stay selected while they cannot be picked
+        if (!isSelectable && !native->selectedEntities.empty())
+            SelectionHelper::ClearSelection(native, native->context);
+    }
+
+    bool LayerTable::SetVisible(NativeViewerHandle* native, uint16_t layer, bool isVisible)
+    {
+        if (native == nullptr || layer >= myLayers.size()) return false;
+        if (myLayers[layer].isVisible == isVisible) return true;
+
+        myLayers[layer].isVisible = isVisible;
+        ApplyDisplay(native, layer);
+        ApplySelection(native, layer);
+        std::wcout << (isVisible ? L"✅ Layer shown: " : L"✅ Layer hidden: ") << myLayers[layer].name << std::endl;
+        return true;
+    }
+
+    bool LayerTable::SetFrozen(NativeViewerHandle* native, uint16_t layer, bool isFrozen)
+    {
+        if (native == nullptr || layer >= myLayers.size()) return false;
+        if (myLayers[layer].isFrozen == isFrozen) return true;
+
+        myLayers[layer].isFrozen = isFrozen;
+        native->document.SetLayerFrozen(layer, isFrozen);
+        ApplyDisplay(native, layer);
+        ApplySelection(native, layer);
+
+        // Edits held back while frozen reach the presentations now
+        if (!isFrozen) native->document.Sync(native);
+        std::wcout << (isFrozen ? L"✅ Layer frozen: " : L"✅ Layer thawed: ") << myLayers[layer].name << std::endl;
+        return true;
+    }
+
+    bool LayerTable::SetLocked(NativeViewerHandle* native, uint16_t layer, bool isLocked)
+    {
+        if (native == nullptr || layer >= myLayers.size()) return false;
+        if (myLayers[layer].isLocked == isLocked) return true;
+
+        myLayers[layer].isLocked = isLocked;
+        ApplySelection(native, layer);
+        std::wcout << (isLocked ? L"✅ Layer locked: " : L"✅ Layer unlocked: ") << myLayers[layer].name << std::endl;
+        return true;
+    }
+
+    void LayerTable::FitAll(const Handle(V3d_View)& view, double margin)
+    {
+        if (view.IsNull()) return;
+
+        NativeViewerHandle* native = ViewerRegistry::FindByView(view.get());
+        if (native == nullptr || view->Window().IsNull())
+        {
+            view->FitAll(margin, Standard_False);
+            return;
+        }
+
+        std::vector<Graphic3d_ZLayerId> hidden;
+        for (uint16_t layer = 0; layer < native->layers.myLayers.size(); ++layer)
+        {
+            const Graphic3d_ZLayerId zLayer = native->layers.myLayers[layer].zLayer;
+            if (zLayer != Graphic3d_ZLayerId_Default && !native->layers.IsShown(layer)) hidden.push_back(zLayer);
+        }
+
+        // Same bounds as Graphic3d_CView::MinMaxValues, each Z layer's box being cached by the renderer
+        Standard_Integer width = 0, height = 0;
+        view->Window()->Size(width, height);
+        const Handle(Graphic3d_CView)& graphicView = view->View();
+        Bnd_Box box;
+        for (NCollection_List<Handle(Graphic3d_Layer)>::Iterator it(graphicView->Layers()); it.More(); it.Next())
+        {
+            const Handle(Graphic3d_Layer)& zLayer = it.Value();
+            if (std::find(hidden.begin(), hidden.end(), zLayer->LayerId()) != hidden.end()) continue;
+            box.Add(zLayer->BoundingBox(graphicView->Identification(), view->Camera(), width, height, Standard_False));
+        }
+        if (!box.IsVoid())
+            view->FitAll(box, margin, Standard_False);
+    }
+
+    void LayerTable::Clear(NativeViewerHandle* native)
+    {
+        // Structures still in a removed Z layer fall back to the default one
+        if (native && !native->viewer.IsNull())
+        {
+            for (const LayerInfo& info : myLayers)
+                if (info.zLayer != Graphic3d_ZLayerId_Default) native->viewer->RemoveZLayer(info.zLayer);
+        }
+        if (native && !myFilter.IsNull() && !native->context.IsNull())
+            native->context->RemoveFilter(myFilter);
+
+        myFilter.Nullify();
+        myLayers.clear();
+        myIndex.clear();
+        myCurrent = 0;
+    }
+}
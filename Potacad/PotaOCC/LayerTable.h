@@ -0,0 +1,100 @@
+#pragma once
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ZLayerId.hxx>
+#include <SelectMgr_Filter.hxx>
+#include <V3d_View.hxx>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: DXF layers and their visibility, freeze and lock states
+    public ref class LayerTablePublic
+    {
+    public:
+        // Layer new entities are drawn on; created on first use
+        static bool SetCurrentLayer(System::IntPtr viewerHandlePtr, System::String^ name);
+
+        static bool SetLayerVisible(System::IntPtr viewerHandlePtr, System::String^ name, bool isVisible);
+        static bool SetLayerFrozen(System::IntPtr viewerHandlePtr, System::String^ name, bool isFrozen);
+        static bool SetLayerLocked(System::IntPtr viewerHandlePtr, System::String^ name, bool isLocked);
+
+        static bool MoveSelectionToLayer(System::IntPtr viewerHandlePtr, System::String^ name);
+        static array<System::String^>^ GetLayerNames(System::IntPtr viewerHandlePtr);
+    };
+
+    struct LayerInfo
+    {
+        std::wstring name;
+        Graphic3d_ZLayerId zLayer = Graphic3d_ZLayerId_Default;
+        bool isVisible = true;
+        bool isFrozen = false;
+        bool isLocked = false;
+    };
+
+    // Layers of one viewer. Each layer is its own graphic Z layer, so its entities form one batch:
+    // hiding or freezing it changes that Z layer's settings once, whatever the number of entities,
+    // and no AIS object is erased or displayed again. The renderer then culls the layer's BVH at the
+    // root; FitAll below leaves such layers out, since the view's own bounds still count them.
+    // Locked, hidden and frozen layers are excluded from the window-selection BVH and filtered out of picking.
+    class LayerTable
+    {
+    public:
+        // Index of the layer, created with its Z layer on first use. Names match case-insensitively.
+        uint16_t Ensure(NativeViewerHandle* native, const std::wstring& name);
+        int Find(const std::wstring& name) const;
+
+        void SetCurrent(uint16_t layer) { myCurrent = layer; }
+        uint16_t Current() const { return myCurrent; }
+
+        // Layer of an entity about to be shown: its document row's layer, or else the current one.
+        // Puts the presentation into that layer's Z layer.
+        uint16_t Place(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj);
+
+        // Moves an entity that is already shown to another layer
+        void Move(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, uint16_t layer);
+
+        bool SetVisible(NativeViewerHandle* native, uint16_t layer, bool isVisible);
+        bool SetFrozen(NativeViewerHandle* native, uint16_t layer, bool isFrozen);
+        bool SetLocked(NativeViewerHandle* native, uint16_t layer, bool isLocked);
+
+        // False for hidden and frozen layers
+        bool IsShown(uint16_t layer) const
+        {
+            if (layer >= myLayers.size()) return true;
+            return myLayers[layer].isVisible && !myLayers[layer].isFrozen;
+        }
+
+        bool IsSelectable(uint16_t layer) const
+        {
+            if (layer >= myLayers.size()) return true;
+            const LayerInfo& info = myLayers[layer];
+            return info.isVisible && !info.isFrozen && !info.isLocked;
+        }
+
+        int Size() const { return (int)myLayers.size(); }
+        const LayerInfo& Info(uint16_t layer) const { return myLayers[layer]; }
+
+        // Scene cleared: drops the layers and their Z layers
+        void Clear(NativeViewerHandle* native);
+
+        // V3d_View::FitAll over the Z layers that are drawn; views without a viewer handle fit everything
+        static void FitAll(const Handle(V3d_View)& view, double margin = 0.01);
+
+    private:
+        void ApplyDisplay(NativeViewerHandle* native, uint16_t layer);
+        void ApplySelection(NativeViewerHandle* native, uint16_t layer);
+        void SetZLayer(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, uint16_t layer);
+
+        static std::wstring Key(const std::wstring& name);
+
+        std::vector<LayerInfo> myLayers;
+        std::unordered_map<std::wstring, uint16_t> myIndex;
+        uint16_t myCurrent = 0;
+        Handle(SelectMgr_Filter) myFilter;      // installed in the context with the first layer
+    };
+}
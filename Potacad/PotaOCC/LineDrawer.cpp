@@ -1,6 +1,8 @@
 ﻿#include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "LineDrawer.h"
+#include "SelectionHelper.h"
 #include "ShapeDrawer.h"
 #include "ViewHelper.h"
 #include <AIS_InteractiveContext.hxx>
@@ -54,7 +56,7 @@ Handle(AIS_Shape) LineDrawer::DrawLineWithoutSnapping(Handle(V3d_View) view, Sys
     ctx->Display(aisLine, Standard_False);
     ctx->SetColor(aisLine, color, Standard_False);
     ctx->Redisplay(aisLine, Standard_False);
-    ctx->UpdateCurrentViewer();
+    FrameScheduler::Redraw(ctx);
 
     // Persist
     if (!aisLine.IsNull())  // -> to prevent NullReferenceException during trimming.
@@ -233,7 +235,8 @@ Handle(AIS_Shape) LineDrawer::DrawLine(
 
             Handle(AIS_Shape) aisWire = new AIS_Shape(wire);
             aisWire->SetDisplayMode(AIS_WireFrame);
-            native->context->Display(aisWire, Standard_True);
+            native->context->Display(aisWire, Standard_False);
+            FrameScheduler::Redraw(native);
 
             // 🧹 Replace old persisted shapes with the closed wire
             native->persistedLines.clear();
@@ -279,7 +282,7 @@ Handle(AIS_Shape) LineDrawer::DrawLine(
     ctx->Display(aisLine, Standard_False);
     ctx->SetColor(aisLine, color, Standard_False);
     ctx->Redisplay(aisLine, Standard_False);
-    ctx->UpdateCurrentViewer();
+    FrameScheduler::Redraw(ctx);
 
     // ========= PERSIST =========
     if (!aisLine.IsNull()) {
@@ -319,6 +322,7 @@ array<int>^ LineDrawer::DrawLineBatch(
 
     int n = x1->Length;
     auto ids = gcnew array<int>(n);
+    const uint16_t layer = native->layers.Current();
 
     for (int i = 0; i < n; ++i)
     {
@@ -326,14 +330,12 @@ array<int>^ LineDrawer::DrawLineBatch(
         gp_Pnt p2(x2[i], y2[i], z2[i]);*/
         gp_Pnt p1(x1[i], y1[i], 0);
         gp_Pnt p2(x2[i], y2[i], 0);
-        if (p1.IsEqual(p2, 1e-9)) { ids[i] = 0; continue; }
+        if (p1.IsEqual(p2, 1e-9)) { ids[i] = -1; continue; }
 
         GC_MakeSegment seg(p1, p2);
-        if (!seg.IsDone()) { ids[i] = 0; continue; }
+        if (!seg.IsDone()) { ids[i] = -1; continue; }
 
         Handle(Geom_TrimmedCurve) geomLine = seg.Value();
-        Handle(AIS_Shape) aisLine = new AIS_Shape(BRepBuilderAPI_MakeEdge(geomLine));
-        aisLine->SetDisplayMode(AIS_WireFrame);
 
         // Map DXF linetype string to Aspect_TypeOfLine
         Aspect_TypeOfLine occType = Aspect_TOL_SOLID; // default
@@ -356,37 +358,21 @@ array<int>^ LineDrawer::DrawLineBatch(
         double db = (b != nullptr && i < b->Length) ? (double)b[i] / 255.0 : 0.5;
         Quantity_Color qcol(dr, dg, db, Quantity_TOC_RGB);
 
-        // *** get current drawer or create new ***
-        Handle(Prs3d_Drawer) drawer = aisLine->Attributes();
-
-
-        // *** create new LineAspect with our colour + linetype ***
-        Handle(Prs3d_LineAspect) lineAsp =
-            new Prs3d_LineAspect(qcol, occType, 1.0);
-
-        drawer->SetWireAspect(lineAsp);
-        aisLine->SetAttributes(drawer);
-
-        // Display, then still apply colour & transparency via context
-        ctx->Display(aisLine, Standard_False);
-        ctx->SetColor(aisLine, qcol, Standard_False);
-
-        // restore aspect
-        aisLine->Attributes()->SetLineAspect(lineAsp);
-        ctx->Redisplay(aisLine, Standard_False);
-
-
-        /*if (transparency != nullptr && i < transparency->Length)
-            ctx->SetTransparency(aisLine, transparency[i], Standard_False);*/
-
-            //ctx->Activate(aisLine);
-
-        ids[i] = (int)aisLine.get(); // track pointer as ID
+        // The line is a document row; its presentation is derived on Sync below
+        EntityStyle style;
+        style.color = qcol;
+        style.lineType = occType;
+        ids[i] = native->document.Create(EntityType::Line, BRepBuilderAPI_MakeEdge(geomLine), style, layer);
+    }
 
-        native->persistedLines.push_back(aisLine);
+    native->document.Sync(native);
+    for (int i = 0; i < n; ++i)
+    {
+        Handle(AIS_Shape) aisLine = Handle(AIS_Shape)::DownCast(native->document.Presentation(ids[i]));
+        if (!aisLine.IsNull()) native->persistedLines.push_back(aisLine);
     }
 
-    ctx->UpdateCurrentViewer();
+    FrameScheduler::Redraw(ctx);
     return ids;
 }
 
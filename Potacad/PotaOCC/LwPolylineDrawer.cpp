@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "LwPolylineDrawer.h"
+#include "SelectionHelper.h"
+#include "ViewerManager.h"
 #include <AIS_InteractiveContext.hxx>
 #include <V3d_Viewer.hxx>
 #include <V3d_View.hxx>
@@ -34,6 +37,8 @@ array<int>^ LwPolylineDrawer::DrawLwPolylineBatch(
     if (x->Length < 2) return gcnew array<int>(0);
 
     Handle(AIS_InteractiveContext) ctx(rawCtx);
+    NativeViewerHandle* native = ViewerRegistry::FindByContext(rawCtx);
+    if (!native) return gcnew array<int>(0);
 
     try
     {
@@ -85,17 +90,15 @@ array<int>^ LwPolylineDrawer::DrawLwPolylineBatch(
             builder.Add(compound, edge);
         }
 
-        Handle(AIS_Shape) aisShape = new AIS_Shape(compound);
-
-        Quantity_Color col(r[0] / 255.0, g[0] / 255.0, b[0] / 255.0, Quantity_TOC_RGB);
-        ctx->SetColor(aisShape, col, Standard_False);
-        ctx->SetTransparency(aisShape, transparency[0], Standard_False);
-        ctx->Display(aisShape, Standard_False);
+        EntityStyle style;
+        style.color = Quantity_Color(r[0] / 255.0, g[0] / 255.0, b[0] / 255.0, Quantity_TOC_RGB);
+        style.transparency = transparency[0];
 
         array<int>^ ids = gcnew array<int>(1);
-        ids[0] = (int)aisShape.get();
+        ids[0] = native->document.Create(EntityType::Polyline, compound, style, native->layers.Current());
+        native->document.Sync(native);
 
-        ctx->UpdateCurrentViewer();
+        FrameScheduler::Redraw(ctx);
         return ids;
     }
     catch (...)
@@ -0,0 +1,59 @@
+#include "pch.h"
+#pragma managed(push, off)
+#include "MappedFile.h"
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+namespace PotaOCC
+{
+    bool MappedFile::Open(const std::wstring& path)
+    {
+        Close();
+
+        // Write and delete sharing let saves append to the mapped file or move it aside for a new one
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        myFile = file;
+        myMapping = mapping;
+        myData = static_cast<const uint8_t*>(view);
+        mySize = (size_t)size.QuadPart;
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (myData) UnmapViewOfFile(myData);
+        if (myMapping) CloseHandle(myMapping);
+        if (myFile) CloseHandle(myFile);
+        myData = nullptr;
+        mySize = 0;
+        myFile = nullptr;
+        myMapping = nullptr;
+    }
+}
+#pragma managed(pop)
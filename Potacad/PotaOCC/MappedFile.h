@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PotaOCC
+{
+    // Read-only view of a whole file mapped into the address space.
+    // Pages are faulted in on first touch, so opening a large project costs nothing until its
+    // sections are read; the view stays valid for as long as the object lives.
+    class MappedFile
+    {
+    public:
+        MappedFile() {}
+        ~MappedFile() { Close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::wstring& path);
+        void Close();
+
+        bool IsOpen() const { return myData != nullptr; }
+        const uint8_t* Data() const { return myData; }
+        size_t Size() const { return mySize; }
+
+        // Pointer to [offset, offset + bytes) or nullptr when the range falls outside the file
+        const uint8_t* Range(uint64_t offset, uint64_t bytes) const
+        {
+            if (offset > mySize || bytes > mySize - offset) return nullptr;
+            return myData + offset;
+        }
+
+    private:
+        const uint8_t* myData = nullptr;
+        size_t mySize = 0;
+        void* myFile = nullptr;         // HANDLE
+        void* myMapping = nullptr;      // HANDLE
+    };
+}
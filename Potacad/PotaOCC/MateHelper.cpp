@@ -1,6 +1,7 @@
 ﻿#include "pch.h"
 #include "MateHelper.h"
 #include "GeometryHelper.h"
+#include "FrameScheduler.h"
 #include <AIS_Shape.hxx>
 #include <BRepAdaptor_Surface.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
@@ -13,9 +14,9 @@ namespace PotaOCC
 {
     namespace MateHelper
     {
-        void HandleFaceAlignment(Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, Handle(AIS_Shape) aisShape1, const TopoDS_Face& face1, Handle(AIS_Shape) aisShape2, const TopoDS_Face& face2)
+        gp_Trsf HandleFaceAlignment(Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, Handle(AIS_Shape) aisShape1, const TopoDS_Face& face1, Handle(AIS_Shape) aisShape2, const TopoDS_Face& face2)
         {
-            if (aisShape1.IsNull() || aisShape2.IsNull())return;
+            if (aisShape1.IsNull() || aisShape2.IsNull())return gp_Trsf();
             gp_Trsf loc1 = aisShape1->LocalTransformation();
             gp_Trsf loc2 = aisShape2->LocalTransformation();
             TopoDS_Face face1_world = TopoDS::Face(BRepBuilderAPI_Transform(face1, loc1, true).Shape());
@@ -35,7 +36,8 @@ namespace PotaOCC
             aisShape1->Set(newShape);
             aisShape1->SetLocalTransformation(gp_Trsf());
             context->Redisplay(aisShape1, Standard_False);
-            view->Redraw();
+            FrameScheduler::Redraw(view);
+            return mateWorld;   // finalTrsf = mateWorld * loc1: the world delta of the displayed shape
         }
     }
 }
\ No newline at end of file
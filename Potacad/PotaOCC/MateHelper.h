@@ -9,6 +9,7 @@ namespace PotaOCC
     namespace MateHelper
     {
         template <typename T>T ClampValue(T v, T lo, T hi) { return (v < lo) ? lo : (v > hi) ? hi : v; }
-        void HandleFaceAlignment(Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, Handle(AIS_Shape) aisShape1, const TopoDS_Face& face1, Handle(AIS_Shape) aisShape2, const TopoDS_Face& face2);
+        // Moves aisShape1 so face1 mates face2; returns the world transformation applied (identity if none)
+        gp_Trsf HandleFaceAlignment(Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, Handle(AIS_Shape) aisShape1, const TopoDS_Face& face1, Handle(AIS_Shape) aisShape2, const TopoDS_Face& face2);
     }
 }
\ No newline at end of file
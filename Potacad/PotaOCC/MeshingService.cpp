@@ -0,0 +1,339 @@
+#include "pch.h"
+#include "MeshingService.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "TriangulationCache.h"
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepBndLib.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace PotaOCC
+{
+    int MeshingServicePublic::Update(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull() || !native->meshingService) return 0;
+
+        return native->meshingService->Update(native->context, native->view);
+    }
+
+    namespace
+    {
+        const int THE_COARSE_LEVEL = 7;             // diagonal / 128, shown immediately
+        const int THE_FINE_LEVEL = 11;              // diagonal / 2048, never finer however far we zoom
+        const double THE_PIXEL_FRACTION = 0.5;      // target chord error in screen pixels
+        const double THE_ANGLE = 0.5;
+    }
+
+    MeshingService::MeshingService()
+    {
+    }
+
+    MeshingService::~MeshingService()
+    {
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            myIsStopping = true;
+            myQueue.clear();
+        }
+        myWake.notify_all();
+        for (std::thread& worker : myWorkers)
+            if (worker.joinable()) worker.join();
+    }
+
+    MeshingService& MeshingService::Of(NativeViewerHandle* native)
+    {
+        if (!native->meshingService)
+            native->meshingService = std::make_shared<MeshingService>();
+        return *native->meshingService;
+    }
+
+    double MeshingService::RelativeDeflection(const TopoDS_Shape& shape, double fraction)
+    {
+        Bnd_Box box;
+        BRepBndLib::Add(shape, box);
+        if (box.IsVoid())
+            return 0.1;
+        return std::max(std::sqrt(box.SquareExtent()) * fraction, 1.0e-4);
+    }
+
+    double MeshingService::LevelDeflection(const Entry& entry, int level)
+    {
+        return std::max(std::ldexp(entry.diagonal, -level), 1.0e-4);
+    }
+
+    int MeshingService::TargetLevel(const Entry& entry, const Handle(V3d_View)& view)
+    {
+        if (view.IsNull())
+            return THE_COARSE_LEVEL;
+
+        // Smallest level whose deflection is within half a pixel
+        const double target = view->Convert(1) * THE_PIXEL_FRACTION;
+        int level = THE_COARSE_LEVEL;
+        while (level < THE_FINE_LEVEL && LevelDeflection(entry, level) > target)
+            ++level;
+        return level;
+    }
+
+    void MeshingService::Submit(const Handle(AIS_Shape)& ais, const Handle(V3d_View)& view)
+    {
+        if (ais.IsNull() || ais->Shape().IsNull())
+            return;
+
+        Entry entry;
+        entry.ais = ais;
+        entry.shape = ais->Shape();
+
+        Bnd_Box box;
+        BRepBndLib::Add(entry.shape, box);
+        if (box.IsVoid())
+            return;
+        entry.diagonal = std::sqrt(box.SquareExtent());
+
+        // Coarse mesh on the spot so the solid appears immediately; hashing the B-rep for the
+        // cache costs as much as this, so it is left to the worker
+        entry.level = THE_COARSE_LEVEL;
+        try
+        {
+            BRepMesh_IncrementalMesh(entry.shape, LevelDeflection(entry, entry.level), Standard_False, THE_ANGLE, Standard_False);
+        }
+        catch (Standard_Failure& e)
+        {
+            std::cerr << "❌ Coarse meshing failed: " << e.GetMessageString() << std::endl;
+            return;
+        }
+
+        // The presentation must never re-mesh on its own
+        ais->Attributes()->SetAutoTriangulation(Standard_False);
+
+        // Resubmitted: jobs still out for the old shape are dropped when they come back
+        auto known = myEntryIds.find(ais.get());
+        const int id = known != myEntryIds.end() ? known->second : myNextId++;
+        myEntryIds[ais.get()] = id;
+        Entry& stored = myEntries[id] = entry;
+        const int target = TargetLevel(stored, view);
+        if (target > stored.level)
+            Schedule(id, stored, target);
+    }
+
+    void MeshingService::Schedule(int entryId, Entry& entry, int level)
+    {
+        // Topology-only copy: the worker writes triangulations the renderer is not reading
+        std::shared_ptr<Job> job = std::make_shared<Job>();
+        job->entryId = entryId;
+        job->contentHash = entry.contentHash;
+        job->hasHash = entry.hasHash;
+        job->level = level;
+        job->source = entry.shape;
+        job->copier = std::make_shared<BRepBuilderAPI_Copy>(entry.shape, Standard_False, Standard_False);
+        job->copy = job->copier->Shape();
+        job->deflection = LevelDeflection(entry, level);
+        entry.isPending = true;
+
+        StartWorkers();
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            myQueue.push_back(job);
+        }
+        myWake.notify_one();
+    }
+
+    void MeshingService::StartWorkers()
+    {
+        if (!myWorkers.empty())
+            return;
+
+        // BRepMesh already spreads each shape over its own thread pool; two feeders keep it busy
+        const unsigned nbWorkers = std::max(1u, std::min(2u, std::thread::hardware_concurrency() / 2));
+        for (unsigned i = 0; i < nbWorkers; ++i)
+            myWorkers.emplace_back(&MeshingService::WorkerLoop, this);
+    }
+
+    void MeshingService::WorkerLoop()
+    {
+        for (;;)
+        {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(myMutex);
+                myWake.wait(lock, [this] { return myIsStopping || !myQueue.empty(); });
+                if (myIsStopping)
+                    return;
+                job = myQueue.front();
+                myQueue.pop_front();
+                ++myNbRunning;
+            }
+
+            try
+            {
+                // Mesh from an earlier session at this level: no BRepMesh at all
+                TriangulationCache& cache = TriangulationCache::Instance();
+                if (!job->hasHash)
+                {
+                    job->contentHash = TriangulationCache::ContentHash(job->copy);
+                    job->hasHash = true;
+                }
+                if (!cache.Load(job->contentHash, job->level, job->copy))
+                {
+                    BRepMesh_IncrementalMesh(job->copy, job->deflection, Standard_False, THE_ANGLE, Standard_True);
+                    cache.Store(job->contentHash, job->level, job->copy);
+                }
+                job->isDone = true;
+            }
+            catch (Standard_Failure& e)
+            {
+                std::cerr << "❌ Background meshing failed: " << e.GetMessageString() << std::endl;
+            }
+
+            std::lock_guard<std::mutex> lock(myMutex);
+            --myNbRunning;
+            myDone.push_back(job);
+        }
+    }
+
+    void MeshingService::TransferMesh(const Job& job)
+    {
+        BRep_Builder builder;
+        TopTools_MapOfShape visited;
+        for (TopExp_Explorer faceExp(job.source, TopAbs_FACE); faceExp.More(); faceExp.Next())
+        {
+            const TopoDS_Face& face = TopoDS::Face(faceExp.Current());
+            if (!visited.Add(face)) continue;
+
+            const TopTools_ListOfShape& faceCopies = job.copier->Modified(face);
+            if (faceCopies.IsEmpty()) continue;
+            const TopoDS_Face& copyFace = TopoDS::Face(faceCopies.First());
+            TopLoc_Location loc;
+            const Handle(Poly_Triangulation)& tri = BRep_Tool::Triangulation(copyFace, loc);
+            if (tri.IsNull()) continue;
+
+            builder.UpdateFace(face, tri);
+
+            // Boundary polylines keep shaded faces and their edges in step
+            for (TopExp_Explorer edgeExp(face, TopAbs_EDGE); edgeExp.More(); edgeExp.Next())
+            {
+                const TopoDS_Edge& edge = TopoDS::Edge(edgeExp.Current());
+                const TopTools_ListOfShape& edgeCopies = job.copier->Modified(edge);
+                if (edgeCopies.IsEmpty()) continue;
+                const TopoDS_Edge& copyEdge = TopoDS::Edge(edgeCopies.First());
+                const Handle(Poly_PolygonOnTriangulation)& poly = BRep_Tool::PolygonOnTriangulation(copyEdge, tri, loc);
+                if (!poly.IsNull())
+                    builder.UpdateEdge(edge, poly, tri, loc);
+            }
+        }
+    }
+
+    int MeshingService::Update(const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view)
+    {
+        std::vector<std::shared_ptr<Job>> done;
+        int nbQueued = 0;
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            done.swap(myDone);
+            nbQueued = (int)myQueue.size() + myNbRunning;
+        }
+
+        bool isChanged = false;
+        for (const std::shared_ptr<Job>& job : done)
+        {
+            auto it = myEntries.find(job->entryId);
+            if (it == myEntries.end()) continue;
+
+            Entry& entry = it->second;
+            entry.isPending = false;
+            if (job->hasHash && !entry.hasHash)
+            {
+                entry.contentHash = job->contentHash;
+                entry.hasHash = true;
+            }
+            if (!job->isDone || !entry.shape.IsEqual(job->source)) continue;
+
+            TransferMesh(*job);
+            entry.level = job->level;
+            context->Redisplay(entry.ais, Standard_False);
+            isChanged = true;
+        }
+
+        std::vector<Handle(AIS_Shape)> replaced;
+        for (auto it = myEntries.begin(); it != myEntries.end();)
+        {
+            Entry& entry = it->second;
+
+            // Removed from the viewer: stop tracking
+            if (!context->IsDisplayed(entry.ais))
+            {
+                myEntryIds.erase(entry.ais.get());
+                it = myEntries.erase(it);
+                continue;
+            }
+
+            // Shape replaced (transform baked, edited through the document): mesh the new one
+            if (!entry.shape.IsEqual(entry.ais->Shape()))
+            {
+                replaced.push_back(entry.ais);
+                ++it;
+                continue;
+            }
+
+            // Zoomed in past the current mesh: reuse a cached finer level, or sharpen in the background
+            const int target = TargetLevel(entry, view);
+            if (!entry.isPending && target > entry.level)
+            {
+                if (entry.hasHash && TriangulationCache::Instance().Load(entry.contentHash, target, entry.shape))
+                {
+                    entry.level = target;
+                    context->Redisplay(entry.ais, Standard_False);
+                    isChanged = true;
+                }
+                else
+                {
+                    Schedule(it->first, entry, target);
+                    ++nbQueued;
+                }
+            }
+            ++it;
+        }
+
+        for (const Handle(AIS_Shape)& ais : replaced)
+        {
+            // A new entry, so a shape that cannot be meshed is not retried on every update
+            auto known = myEntryIds.find(ais.get());
+            myEntries.erase(known->second);
+            myEntryIds.erase(known);
+            Submit(ais, view);
+            context->Redisplay(ais, Standard_False);
+            isChanged = true;
+        }
+
+        if (isChanged)
+        {
+            FrameScheduler::Redraw(context);
+        }
+        return nbQueued;
+    }
+
+    void MeshingService::Clear()
+    {
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            myQueue.clear();
+            myDone.clear();
+        }
+        myEntries.clear();
+        myEntryIds.clear();
+    }
+}
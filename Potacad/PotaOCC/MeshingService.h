@@ -0,0 +1,104 @@
+#pragma once
+#include <AIS_Shape.hxx>
+#include <AIS_InteractiveContext.hxx>
+#include <V3d_View.hxx>
+#include <TopoDS_Shape.hxx>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class BRepBuilderAPI_Copy;
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: the UI pumps finished meshes into the viewer while the camera settles
+    public ref class MeshingServicePublic
+    {
+    public:
+        // Applies finished meshes and schedules refinement for the current zoom; returns jobs still pending
+        static int Update(System::IntPtr viewerHandlePtr);
+    };
+
+    // Meshes displayed solids on a small worker pool (BRepMesh in parallel mode).
+    // A solid is shown at once with a coarse size-relative mesh; a worker then meshes a topology copy
+    // at a deflection matched to the current view scale, and Update() moves the triangulation onto
+    // the displayed shape on the UI thread. Zooming in schedules further refinement the same way.
+    // Deflections are snapped to levels (diagonal / 2^level) so finished meshes can be reused from
+    // the TriangulationCache in later sessions. The cache key (a hash of the serialized B-rep) is
+    // computed by the first job of a shape, never on the UI thread.
+    class MeshingService
+    {
+    public:
+        MeshingService();
+        ~MeshingService();                      // drops queued jobs and joins the workers
+
+        MeshingService(const MeshingService&) = delete;
+        MeshingService& operator=(const MeshingService&) = delete;
+
+        static MeshingService& Of(NativeViewerHandle* native);
+
+        // Deflection as a fraction of the shape's bounding-box diagonal
+        static double RelativeDeflection(const TopoDS_Shape& shape, double fraction);
+
+        // UI thread, before Display: meshes coarse now and queues the view-matched mesh.
+        // A presentation submitted again (its shape replaced) keeps its entry.
+        void Submit(const Handle(AIS_Shape)& ais, const Handle(V3d_View)& view);
+
+        // UI thread: applies finished jobs, forgets erased shapes, resubmits replaced ones, refines after zooming in
+        int Update(const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view);
+
+        void Clear();
+
+    private:
+        struct Job
+        {
+            int entryId = 0;
+            uint64_t contentHash = 0;
+            bool hasHash = false;               // false: the worker hashes the copy first
+            int level = 0;
+            TopoDS_Shape source;                // displayed shape, only touched on the UI thread
+            std::shared_ptr<BRepBuilderAPI_Copy> copier;
+            TopoDS_Shape copy;                  // meshed by the worker
+            double deflection = 0.0;
+            bool isDone = false;
+        };
+
+        struct Entry
+        {
+            Handle(AIS_Shape) ais;
+            TopoDS_Shape shape;
+            uint64_t contentHash = 0;
+            bool hasHash = false;               // set when the first job comes back
+            double diagonal = 0.0;
+            int level = 0;                      // mesh currently shown, deflection = diagonal / 2^level
+            bool isPending = false;
+        };
+
+        static int TargetLevel(const Entry& entry, const Handle(V3d_View)& view);
+        static double LevelDeflection(const Entry& entry, int level);
+        static void TransferMesh(const Job& job);
+
+        void Schedule(int entryId, Entry& entry, int level);
+        void StartWorkers();
+        void WorkerLoop();
+
+        std::unordered_map<int, Entry> myEntries;
+        std::unordered_map<const AIS_Shape*, int> myEntryIds;   // entry of each submitted presentation
+        int myNextId = 0;
+
+        std::mutex myMutex;
+        std::condition_variable myWake;
+        std::deque<std::shared_ptr<Job>> myQueue;
+        std::vector<std::shared_ptr<Job>> myDone;
+        std::vector<std::thread> myWorkers;
+        bool myIsStopping = false;
+        int myNbRunning = 0;
+    };
+}
@@ -1,5 +1,6 @@
 ﻿#include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "MouseHandler.h"
 #include "MouseHelper.h"
 #include "MouseCursor.h"
@@ -8,6 +9,7 @@
 #include "ShapeExtruder.h"
 #include "ShapeBooleanOperator.h"
 #include "MateHelper.h"
+#include "TransformSession.h"
 #include <V3d_View.hxx>
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Shape.hxx>
@@ -177,15 +179,17 @@ TopoDS_Face createForcedFace(const TopoDS_Wire& wire) {
 void MouseHandler::StartRotation(IntPtr viewPtr, int x, int y) {
     Handle(V3d_View) view = static_cast<V3d_View*>(viewPtr.ToPointer());
     if (view.IsNull()) return;
+    CameraAnimator::Interrupt(view);
     view->StartRotation(x, y);
 }
 void MouseHandler::Rotate(IntPtr viewPtr, int x, int y) {
     Handle(V3d_View) view = static_cast<V3d_View*>(viewPtr.ToPointer());
     if (view.IsNull()) return;
+    CameraAnimator::Interrupt(view);
     view->Rotation(x, y);
-    view->Redraw();
+    FrameScheduler::Redraw(view);
 }
-void MouseHandler::Pan(IntPtr viewPtr, int dx, int dy) { Handle(V3d_View) view = static_cast<V3d_View*>(viewPtr.ToPointer()); view->Pan(dx, dy); view->Redraw(); }
+void MouseHandler::Pan(IntPtr viewPtr, int dx, int dy) { Handle(V3d_View) view = static_cast<V3d_View*>(viewPtr.ToPointer()); CameraAnimator::Interrupt(view); view->Pan(dx, dy); FrameScheduler::Redraw(view); }
 void MouseHandler::Zoom(IntPtr viewPtr, double factor)
 {
     if (!native) return;
@@ -193,10 +197,11 @@ void MouseHandler::Zoom(IntPtr viewPtr, double factor)
     ClearCreateEntity(native);
 
     Handle(V3d_View) view = static_cast<V3d_View*>(viewPtr.ToPointer());
+    CameraAnimator::Interrupt(view);
     view->SetZoom(factor);
-    view->Redraw();
+    FrameScheduler::Redraw(view);
 }
-void MouseHandler::ZoomAt(IntPtr viewPtr, int x, int y, double factor) { Handle(V3d_View) view = static_cast<V3d_View*>(viewPtr.ToPointer()); view->Place(x, y, factor); view->Redraw(); }
+void MouseHandler::ZoomAt(IntPtr viewPtr, int x, int y, double factor) { Handle(V3d_View) view = static_cast<V3d_View*>(viewPtr.ToPointer()); CameraAnimator::Interrupt(view); view->Place(x, y, factor); FrameScheduler::Redraw(view); }
 void MouseHandler::SetMouseControlSettings(IntPtr viewerHandlePtr, MouseControlSettings^ settings)
 {
     if (viewerHandlePtr == IntPtr::Zero || settings == nullptr) return;
@@ -253,7 +258,7 @@ void MouseHandler::ResetViewToAxis(Handle(V3d_View) view, const std::string& axi
     view->SetProj(V3d_Zpos);
 
     // Redraw the view
-    view->Redraw();
+    FrameScheduler::Redraw(view);
 }
 void MouseHandler::ResetView(IntPtr viewerHandlePtr, int x, int y)
 {
@@ -261,11 +266,12 @@ void MouseHandler::ResetView(IntPtr viewerHandlePtr, int x, int y)
     if (!native) return;
     Handle(V3d_View) view = native->view;
 
-    // Redraw the view after the interaction
-    native->view->SetProj(V3d_Zpos);
-    native->context->UpdateCurrentViewer();
-    native->view->FitAll();
-    native->view->Redraw();
+    // Animate back to the top view
+    native->cameraAnimation.AnimateTo(native, [](const Handle(V3d_View)& target)
+    {
+        target->SetProj(V3d_Zpos);
+        LayerTable::FitAll(target);
+    });
 }
 
 void MouseHandler::OnMouseDown(IntPtr viewerHandlePtr, int x, int y, bool multipleselect)
@@ -283,6 +289,9 @@ void MouseHandler::OnMouseDown(IntPtr viewerHandlePtr, int x, int y, bool multip
         std::cout << "AIS_InteractiveContext or V3d_View is null!" << std::endl;
         return;
     }
+    // A click takes over the camera; picking must see the pose on screen
+    CameraAnimator::Interrupt(native);
+
     if (native->isRevolveMode)
     {
         if (!native->isRevolveAxisSet)
@@ -332,13 +341,13 @@ void MouseHandler::OnMouseDown(IntPtr viewerHandlePtr, int x, int y, bool multip
             native->isPlacingDimension = false;
         }
 
-        view->Redraw();
+        FrameScheduler::Redraw(view);
         return;
     }
     if (native->isCircleMode || native->isRectangleMode || native->isEllipseMode)
     {
         HandleShapeSelection(native, context, view, x, y);
-        view->Redraw();
+        FrameScheduler::Redraw(view);
         return;
     }
     HandleMouseDownAction(context, view, x, y, multipleselect);
@@ -364,12 +373,10 @@ void MouseHandler::OnMouseMove(IntPtr viewerHandlePtr, int x, int y, int h)
         else if (native->isCircleMode)
         {
             DrawCircleOverlay(native, view, h, x, y);
-            view->Redraw();
         }
         else if (native->isRectangleMode)
         {
             DrawRectangleOverlay(native, view, h, x, y);
-            view->Redraw();
         }
         else if (native->isTrimMode)
         {
@@ -382,12 +389,10 @@ void MouseHandler::OnMouseMove(IntPtr viewerHandlePtr, int x, int y, int h)
         else if (native->isEllipseMode)
         {
             DrawEllipseOverlay(native, view, h, x, y);
-            view->Redraw();
         }
         else
         {
             DrawSelectionRectangle(native);
-            view->Redraw();
         }
     }
     else if (native->isDrawDimensionMode && native->isPlacingDimension)
@@ -416,12 +421,15 @@ void MouseHandler::OnMouseMove(IntPtr viewerHandlePtr, int x, int y, int h)
     {
         HandleExtrude(native, context, view, y);
     }
+    else if (native->isRevolvingActive)
+    {
+        HandleRevolve(native, context, view, x);
+    }
     else if (native->isZoomWindowMode && native->isDragging)
     {
         native->dragEndX = x;
         native->dragEndY = y;
         DrawSelectionRectangle(native);
-        view->Redraw();
     }
     else
     {
@@ -441,27 +449,27 @@ void MouseHandler::OnMouseUp(IntPtr viewerHandlePtr, int x, int y, int h, int w)
 
     if (native->isLineMode) {
         HandleLineMode(native, context, view, viewerHandlePtr, h, w, x, y);
-        view->Redraw();
+        FrameScheduler::Redraw(view);
         return;
     }
     else if (native->isCircleMode) {
         HandleCircleMode(native, context, view, viewerHandlePtr, h, w, x, y);
-        view->Redraw();
+        FrameScheduler::Redraw(view);
         return;
     }
     else if (native->isEllipseMode) {
         HandleEllipseMode(native, context, view, viewerHandlePtr, h, w, x, y);
-        view->Redraw();
+        FrameScheduler::Redraw(view);
         return;
     }
     else if (native->isRectangleMode) {
         HandleRectangleMode(native, context, view, viewerHandlePtr, h, w, x, y);
-        view->Redraw();
+        FrameScheduler::Redraw(view);
         return;
     }
     else if (native->isTrimMode) {
         HandleTrimMode(native, context);
-        view->Redraw();
+        FrameScheduler::Redraw(view);
         return;
     }
     else if (native->isRadiusMode) {
@@ -470,16 +478,23 @@ void MouseHandler::OnMouseUp(IntPtr viewerHandlePtr, int x, int y, int h, int w)
     else if (native->isExtrudingActive) {
         HandleExtrudingMode(native, context, view);
     }
+    else if (native->isRevolvingActive) {
+        HandleRevolveMode(context, view);
+    }
     else if (native->isBooleanUnionMode || native->isBooleanCutMode || native->isBooleanIntersectMode) {
         HandleBooleanMode(native, context, view, x, y);
-        view->Redraw();
+        FrameScheduler::Redraw(view);
         return;
     }
     else if (native->isMoveMode && native->isMoving) {
+        TransformSession::End(native, context);
+        ApplyLocalTransformationToShape(native, context);
         native->isMoving = false;
         native->movingObject.Nullify();
     }
     else if (native->isRotateMode && native->isRotating) {
+        TransformSession::End(native, context);
+        ApplyLocalTransformationToShape(native, context);
         native->isRotating = false;
         native->rotatingObject.Nullify();
     }
@@ -498,7 +513,7 @@ void MouseHandler::OnMouseUp(IntPtr viewerHandlePtr, int x, int y, int h, int w)
     ResetDragState(native);
     ClearRubberBand(native);
 
-    view->Redraw();
+    FrameScheduler::Redraw(view);
 }
 void MouseHandler::OnKeyDown(IntPtr viewerHandlePtr, char key) {}
 void MouseHandler::OnKeyUp(IntPtr viewerHandlePtr, char key) { native = reinterpret_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer()); if (!native) return; HandleKeyMode(native, key); }
@@ -537,14 +552,15 @@ void MouseHandler::ShowAxisTriad(IntPtr viewerHandlePtr)
         native->axisX->SetColor(Quantity_NOC_RED); native->axisY->SetColor(Quantity_NOC_GREEN); native->axisZ->SetColor(Quantity_NOC_BLUE);
         native->context->Display(native->axisX, Standard_False);
         native->context->Display(native->axisY, Standard_False);
-        native->context->Display(native->axisZ, Standard_True);
+        native->context->Display(native->axisZ, Standard_False);
+        FrameScheduler::Redraw(native);
     }
 
     Standard_Real width = 0, height = 0; native->view->Size(width, height);
     gp_Trsf trsf; trsf.SetTranslation(gp_Vec(width - 50, 50, 0));
     native->axisX->SetLocalTransformation(trsf); native->axisY->SetLocalTransformation(trsf); native->axisZ->SetLocalTransformation(trsf);
 
-    native->context->UpdateCurrentViewer(); native->view->Redraw();
+    FrameScheduler::Redraw(native);
 }
 void MouseHandler::HideAxisTriad(IntPtr viewerHandlePtr)
 {
@@ -555,22 +571,23 @@ void MouseHandler::HideAxisTriad(IntPtr viewerHandlePtr)
 
     if (!native->axisX.IsNull()) native->context->Erase(native->axisX, Standard_False);
     if (!native->axisY.IsNull()) native->context->Erase(native->axisY, Standard_False);
-    if (!native->axisZ.IsNull()) native->context->Erase(native->axisZ, Standard_True);
+    if (!native->axisZ.IsNull()) native->context->Erase(native->axisZ, Standard_False);
 
-    native->context->UpdateCurrentViewer(); native->view->Redraw();
+    FrameScheduler::Redraw(native);
 }
 void MouseHandler::HandleRevolveMode(Handle(AIS_InteractiveContext) context, Handle(V3d_View) view)
 {
     native->isRevolveMode = false;
+    native->isRevolvingActive = false;
 
-    if (!native->revolvePreviewShape.IsNull())
-        context->Remove(native->revolvePreviewShape, Standard_False);
+    if (!native->revolvePreview.IsNull())
+        context->Remove(native->revolvePreview, Standard_False);
 
-    double angleDeg = native->currentRevolveAngle;  // User-defined revolve angle
+    double angleDeg = native->currentRevolveAngle;  // Scrubbed revolve angle
     ShapeRevolver revolver(native);
     revolver.RevolveWireAndDisplayFinal(context, angleDeg);
 
-    view->Redraw();
+    FrameScheduler::Redraw(view);
 }
 TopoDS_Shape MouseHandler::PickShapeAtCursor(const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view, int x, int y)
 {
@@ -584,6 +601,14 @@ TopoDS_Shape MouseHandler::PickShapeAtCursor(const Handle(AIS_InteractiveContext
         return context->SelectedShape();
     }
 
+    // Rectangle selection keeps its set natively rather than in the AIS context
+    if (native != nullptr && !native->selectedEntities.empty())
+    {
+        Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(native->entityIndex.Object(native->selectedEntities.front()));
+        if (!aisShape.IsNull())
+            return aisShape->Shape();
+    }
+
     // Step 2: Nothing is selected
     return TopoDS_Shape();
 }
@@ -7,9 +7,13 @@
 #include "ViewHelper.h"
 #include "ShapeDrawer.h"
 #include "ShapeExtruder.h"
+#include "ShapeRevolver.h"
 #include "ShapeBooleanOperator.h"
 #include "MateHelper.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "SelectionHelper.h"
+#include "TransformSession.h"
 #include "TextDrawer.h"
 #include "DimensionHelper.h"
 #include <TopoDS.hxx>
@@ -94,20 +98,24 @@ namespace PotaOCC
         {
             if (!native) return; // 🛡️ Safety check
 
-            if (!native->rubberBandOverlay.IsNull()) {
-                native->rubberBandOverlay->Erase();
-                native->rubberBandOverlay.Nullify();
-                native->rubberBandGroup.Nullify();
-            }
+            native->overlay.Hide(native);
         }
         void HandleMoveModeMouseDown(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y)
         {
-            context->MoveTo(x, y, view, Standard_True);
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
             if (!context->HasDetected()) return;
 
-            native->movingObject = context->DetectedInteractive();
+            native->movingObject = SelectionHelper::DetectedEntity(native, context);
             if (native->movingObject.IsNull()) return;
 
+            // Grabbing a selected entity moves the whole selection as one group
+            if (SelectionHelper::IsSelected(native, native->movingObject) && TransformSession::Begin(native, context))
+                native->movingObject.Nullify();
+            else
+                native->dragStartTransformation = native->movingObject->LocalTransformation();
+
             Standard_Real X, Y, Z;
             view->Convert(x, y, X, Y, Z);
             native->lastMousePoint = gp_Pnt(X, Y, Z);
@@ -115,20 +123,45 @@ namespace PotaOCC
         }
         void HandleRotateModeMouseDown(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y)
         {
-            context->MoveTo(x, y, view, Standard_True);
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
             if (!context->HasDetected()) return;
 
-            native->rotatingObject = context->DetectedInteractive();
+            native->rotatingObject = SelectionHelper::DetectedEntity(native, context);
             if (native->rotatingObject.IsNull()) return;
 
+            if (SelectionHelper::IsSelected(native, native->rotatingObject) && TransformSession::Begin(native, context))
+            {
+                native->rotatingObject.Nullify();
+                native->lastMouseX = x;
+                native->lastMouseY = y;
+                native->isRotating = true;
+                return;
+            }
+
+            native->dragStartTransformation = native->rotatingObject->LocalTransformation();
+
+            // Pivot is computed once; the drag itself only composes transformations
+            Bnd_Box bbox;
+            native->rotatingObject->BoundingBox(bbox);
+            if (native->rotatingObject->HasTransformation() && !bbox.IsVoid())
+                bbox = bbox.Transformed(native->rotatingObject->Transformation());
+            if (bbox.IsVoid()) return;
+            Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+            bbox.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+            native->rotatePivot = gp_Pnt((xmin + xmax) / 2.0, (ymin + ymax) / 2.0, (zmin + zmax) / 2.0);
+
             native->lastMouseX = x;
             native->lastMouseY = y;
             native->isRotating = true;
         }
         void HandleDefaultMouseDown(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y, bool multipleselect, std::vector<Handle(AIS_InteractiveObject)>& lastHilightedObjects)
         {
-            context->Activate(TopAbs_SHAPE);
-            context->MoveTo(x, y, view, Standard_True);
+            SelectionHelper::SetSelectionMode(native, context, TopAbs_SHAPE);
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
 
 
             if (native->isCircleMode || native->dragStartX == 0) {
@@ -137,24 +170,20 @@ namespace PotaOCC
             }
 
             if (context->HasDetected()) {
-                Handle(AIS_InteractiveObject) detectedIO = context->DetectedInteractive();
+                Handle(AIS_InteractiveObject) detectedIO = SelectionHelper::DetectedEntity(native, context);
                 if (detectedIO.IsNull()) {
                     std::cout << "No interactive object detected!" << std::endl;
                     return;
                 }
 
-                Quantity_Color mySelectColor(Quantity_NOC_GREEN);
-                context->HighlightStyle(Prs3d_TypeOfHighlight_Selected)->SetColor(mySelectColor);
-
+                // Selection set and its highlight live in the viewer's batched overlay
                 auto it = std::find(lastHilightedObjects.begin(), lastHilightedObjects.end(), detectedIO);
-
-                if (it != lastHilightedObjects.end()) {
-                    context->Unhilight(detectedIO, Standard_False);
-                    lastHilightedObjects.erase(it);
+                if (SelectionHelper::ToggleSelected(native, context, detectedIO)) {
+                    if (it == lastHilightedObjects.end())
+                        lastHilightedObjects.push_back(detectedIO);
                 }
-                else {
-                    context->AddOrRemoveSelected(detectedIO, Standard_False);
-                    lastHilightedObjects.push_back(detectedIO);
+                else if (it != lastHilightedObjects.end()) {
+                    lastHilightedObjects.erase(it);
                 }
             }
             else {
@@ -167,10 +196,11 @@ namespace PotaOCC
         }
         void HandleMateModeMouseDown(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y)
         {
-            context->Deactivate();
-            context->Activate(TopAbs_FACE);
+            SelectionHelper::SetSelectionMode(native, context, TopAbs_FACE);
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
 
-            context->MoveTo(x, y, view, Standard_True);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
             if (!context->HasDetected())
             {
                 std::cout << "⚠️ No object detected under cursor!" << std::endl;
@@ -219,7 +249,7 @@ namespace PotaOCC
                 native->highlightedFace = CreateHighlightedFace(clickedFace);
                 context->Display(native->highlightedFace, Standard_False);
 
-                view->Redraw();
+                FrameScheduler::Redraw(view);
                 //std::cout << "✅ First mate face selected & highlighted." << std::endl;
                 return;
             }
@@ -235,7 +265,8 @@ namespace PotaOCC
                 TopoDS_Face face1 = *(native->firstMateFace);
                 TopoDS_Face face2 = clickedFace;
 
-                HandleFaceAlignment(context, view, native->firstMateShape, face1, detected, face2);
+                const gp_Trsf mate = HandleFaceAlignment(context, view, native->firstMateShape, face1, detected, face2);
+                native->commandJournal.Moved(context, native->firstMateShape, mate);
 
                 delete native->firstMateFace;
                 native->firstMateFace = nullptr;
@@ -249,13 +280,16 @@ namespace PotaOCC
                 }
             }
 
-            view->Redraw();
+            FrameScheduler::Redraw(view);
         }
         void HandleLineMode(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, IntPtr viewerHandlePtr, int h, int w, int x, int y)
         {
             Handle(AIS_Shape) aisLine = DrawLine(native, view, viewerHandlePtr, h, w);
-            context->Display(aisLine, Standard_True);
+            context->Display(aisLine, Standard_False);
+            FrameScheduler::Redraw(context);
             native->persistedLines.push_back(aisLine);
+            SelectionHelper::IndexEntity(native, aisLine);
+            native->commandJournal.Added(context, aisLine);
             native->dragStartX = x;
             native->dragStartY = y;
         }
@@ -264,15 +298,21 @@ namespace PotaOCC
             Handle(AIS_Shape) aisCircle = DrawCircle(native, view, viewerHandlePtr, h, w, x, y);
             aisCircle->SetColor(Quantity_NOC_BLACK);  // Or any color
             aisCircle->SetWidth(2.0);                 // Line thickness
-            context->Display(aisCircle, Standard_True);
+            context->Display(aisCircle, Standard_False);
+            FrameScheduler::Redraw(context);
             native->persistedCircles.push_back(aisCircle);
+            SelectionHelper::IndexEntity(native, aisCircle);
+            native->commandJournal.Added(context, aisCircle);
             ClearCreateEntity(native);
         }
         void HandleEllipseMode(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, IntPtr viewerHandlePtr, int h, int w, int x, int y)
         {
             Handle(AIS_Shape) aisEllipse = DrawEllipse(native, view, viewerHandlePtr, h, w, x, y);
-            context->Display(aisEllipse, Standard_True); // Show the ellipse
+            context->Display(aisEllipse, Standard_False); // Show the ellipse
+            FrameScheduler::Redraw(context);
             native->persistedEllipses.push_back(aisEllipse); // Save the ellipse for later use
+            SelectionHelper::IndexEntity(native, aisEllipse);
+            native->commandJournal.Added(context, aisEllipse);
             ClearCreateEntity(native); // Reset state if needed (based on your existing methods)
         }
         void HandleRectangleMode(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, IntPtr viewerHandlePtr, int h, int w, int x, int y)
@@ -281,8 +321,11 @@ namespace PotaOCC
             if (aisRect.IsNull())
                 return;
 
-            context->Display(aisRect, Standard_True);
+            context->Display(aisRect, Standard_False);
+            FrameScheduler::Redraw(context);
             native->persistedRectangles.push_back(aisRect);
+            SelectionHelper::IndexEntity(native, aisRect);
+            native->commandJournal.Added(context, aisRect);
 
             ClearCreateEntity(native);
         }
@@ -295,20 +338,28 @@ namespace PotaOCC
         void HandleExtrudingMode(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view)
         {
             native->isExtrudingActive = false;
-            if (!native->extrudePreviewShape.IsNull())
-                context->Remove(native->extrudePreviewShape, Standard_False);
+            if (!native->extrudePreview.IsNull())
+                context->Remove(native->extrudePreview, Standard_False);
+            native->extrudePreview.Nullify();
 
             double finalHeight = native->currentExtrudeHeight;
             ShapeExtruder extruder(native);
             extruder.ExtrudeWireAndDisplayFinal(context, finalHeight);
 
-            view->Redraw();
+            FrameScheduler::Redraw(view);
         }
         void HandleBooleanMode(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y)
         {
             native->isDragging = false;
-            context->Activate(TopAbs_SHAPE);
-            context->MoveTo(x, y, view, Standard_True);
+            if (native->booleanTask)
+            {
+                std::cout << "⚠️ A boolean operation is still running (Esc to cancel)." << std::endl;
+                return;
+            }
+            SelectionHelper::SetSelectionMode(native, context, TopAbs_SHAPE);
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
 
             if (!context->HasDetected()) return;
 
@@ -316,16 +367,15 @@ namespace PotaOCC
             if (detectedIO.IsNull()) return;
 
             auto it = std::find(native->selectedShapes.begin(), native->selectedShapes.end(), detectedIO);
+            SelectionHelper::ToggleSelected(native, context, detectedIO);
             if (it != native->selectedShapes.end()) {
-                context->AddOrRemoveSelected(detectedIO, Standard_True);
                 native->selectedShapes.erase(it);
             }
             else {
-                context->AddOrRemoveSelected(detectedIO, Standard_True);
                 native->selectedShapes.push_back(detectedIO);
             }
 
-            view->Redraw();
+            FrameScheduler::Redraw(view);
 
             if (native->selectedShapes.size() != 2) return;
 
@@ -341,15 +391,8 @@ namespace PotaOCC
             TopoDS_Shape shape2 = aisShape2->Shape();
             if (shape1.IsNull() || shape2.IsNull()) return;
 
-            bool success;
-            TopoDS_Shape resultShape = ShapeBooleanOperator::PerformBooleanOperation(shape1, shape2, native, context, view, success);
-
-            if (native->isBooleanCutMode)
-                ShapeBooleanOperator::FinalizeBooleanResult(native, context, view, resultShape, "BCut operation succeeded.", "BCut operation failed.", success);
-            else if (native->isBooleanUnionMode)
-                ShapeBooleanOperator::FinalizeBooleanResult(native, context, view, resultShape, "BUnion operation succeeded.", "BUnion operation failed.", success);
-            else if (native->isBooleanIntersectMode)
-                ShapeBooleanOperator::FinalizeBooleanResult(native, context, view, resultShape, "BIntersect operation succeeded.", "BIntersect operation failed.", success);
+            // Runs on a worker thread; the UI polls ShapeBooleanOperatorPublic::PollBoolean to display the result
+            ShapeBooleanOperator::StartBooleanOperation(shape1, shape2, native);
         }
         void HandleObjectDetection(Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y)
         {
@@ -380,28 +423,15 @@ namespace PotaOCC
         }
         void DrawLineOverlay(NativeViewerHandle* native, int height)
         {
-            if (native->lineOverlay.IsNull())
-                native->lineOverlay = new AIS_OverlayLine();
-
-            int startYFlipped = height - native->dragStartY;
-            int endYFlipped = height - native->dragEndY;
-
-            native->lineOverlay->SetEndpoints(
-                native->dragStartX,
-                startYFlipped,
-                native->dragEndX,
-                endYFlipped);
-
-            native->context->Display(native->lineOverlay, Standard_True);
+            std::vector<gp_Pnt> points = {
+                gp_Pnt(native->dragStartX, native->dragStartY, 0.0),
+                gp_Pnt(native->dragEndX, native->dragEndY, 0.0) };
+            native->overlay.SetPolyline(native, points, false, true, Quantity_NOC_RED);
         }
         void DrawCircleOverlay(NativeViewerHandle* native, Handle(V3d_View) view, int height, int mouseX, int mouseY)
         {
-            if (native->circleOverlay.IsNull())
-                native->circleOverlay = new AIS_OverlayCircle();
-
+            std::vector<gp_Pnt> points;
             if (native->isPlaneMode) {
-                native->circleOverlay->SetTransformPersistence(nullptr);
-
                 // Step 1: Get 3D point on the plane under current mouse
                 gp_Pnt cursor3D = MouseHelper::Get3DPntOnPlane(
                     view,
@@ -415,33 +445,24 @@ namespace PotaOCC
                 gp_Vec radiusVec(native->dragStartPoint, cursor3D);
                 double radius = radiusVec.Magnitude();
 
-                // Step 3: Set the circle overlay on the correct plane
+                // Step 3: Sample the circle on the correct plane
                 gp_Ax2 circleAxis(native->dragStartPoint, native->planeNormal);
-                native->circleOverlay->SetCircle(circleAxis, radius);
+                ImmediateOverlay::SampleEllipse(circleAxis.Location(), circleAxis.XDirection(), circleAxis.YDirection(), radius, radius, points);
+                native->overlay.SetPolyline(native, points, true, false, Quantity_NOC_RED);
             }
             else {
-                if (!native->circleOverlay->TransformPersistence())
-                {
-                    Handle(Graphic3d_TransformPers) trpers = new Graphic3d_TransformPers(Graphic3d_TMF_2d);
-                    native->circleOverlay->SetTransformPersistence(trpers);
-                }
                 double dx = native->dragEndX - native->dragStartX;
                 double dy = native->dragEndY - native->dragStartY;
                 double radius = std::sqrt(dx * dx + dy * dy);
 
-                int centerYFlipped = height - native->dragStartY;
-
-                native->circleOverlay->SetCircle(
-                    gp_Pnt(native->dragStartX, centerYFlipped, 0.0),
-                    radius);
+                ImmediateOverlay::SampleEllipse(gp_Pnt(native->dragStartX, native->dragStartY, 0.0),
+                    gp::DX(), gp::DY(), radius, radius, points);
+                native->overlay.SetPolyline(native, points, true, true, Quantity_NOC_RED);
             }
-            native->context->Display(native->circleOverlay, Standard_True);
         }
         void DrawEllipseOverlay(NativeViewerHandle* native, Handle(V3d_View) view, int height, int mouseX, int mouseY)
         {
-            if (native->ellipseOverlay.IsNull())
-                native->ellipseOverlay = new AIS_OverlayEllipse();
-
+            std::vector<gp_Pnt> points;
             if (native->isPlaneMode)
             {
                 // --- Plane-based ellipse drawing ---
@@ -470,7 +491,8 @@ namespace PotaOCC
                     gp_Vec(uDir) * (u * 0.5) + gp_Vec(vDir) * (v * 0.5)
                 );
 
-                native->ellipseOverlay->SetEllipseOnPlane(center, uDir, vDir, radiusX, radiusY);
+                ImmediateOverlay::SampleEllipse(center, uDir, vDir, radiusX, radiusY, points);
+                native->overlay.SetPolyline(native, points, true, false, Quantity_NOC_GREEN);
             }
             else
             {
@@ -480,27 +502,16 @@ namespace PotaOCC
                 double radiusX = std::abs(dx) * 0.5;
                 double radiusY = std::abs(dy) * 0.5;
 
-                int centerX = native->dragStartX + dx * 0.5;
-                int centerYFlipped = height - (native->dragStartY + dy * 0.5);
+                gp_Pnt center(native->dragStartX + dx * 0.5, native->dragStartY + dy * 0.5, 0.0);
 
-                native->ellipseOverlay->SetEllipse(
-                    gp_Pnt(centerX, centerYFlipped, 0.0),
-                    radiusX,
-                    radiusY
-                );
+                ImmediateOverlay::SampleEllipse(center, gp::DX(), gp::DY(), radiusX, radiusY, points);
+                native->overlay.SetPolyline(native, points, true, true, Quantity_NOC_GREEN);
             }
-
-            native->context->Display(native->ellipseOverlay, Standard_True);
         }
         void DrawRectangleOverlay(NativeViewerHandle* native, Handle(V3d_View) view, int height, int mouseX, int mouseY)
         {
-            if (native->rectangleOverlay.IsNull())
-                native->rectangleOverlay = new AIS_OverlayRectangle();
-
             if (native->isPlaneMode)
             {
-                native->rectangleOverlay->SetTransformPersistence(nullptr);
-
                 // 3D point on plane
                 gp_Pnt cursor3D = MouseHelper::Get3DPntOnPlane(
                     view,
@@ -510,8 +521,6 @@ namespace PotaOCC
                     mouseY
                 );
 
-                gp_Pnt endPnt = cursor3D; // <-- use local variable
-
                 gp_Pnt startPnt = native->dragStartPoint;
                 gp_Ax2 planeAxis(native->planeOrigin, native->planeNormal);
                 gp_Dir uDir = planeAxis.XDirection();
@@ -521,26 +530,23 @@ namespace PotaOCC
                 double u = dragVec.Dot(gp_Vec(uDir));
                 double v = dragVec.Dot(gp_Vec(vDir));
 
-                gp_Pnt p1 = startPnt;
-                gp_Pnt p2 = startPnt.Translated(gp_Vec(uDir) * u);
-                gp_Pnt p3 = startPnt.Translated(gp_Vec(uDir) * u + gp_Vec(vDir) * v);
-                gp_Pnt p4 = startPnt.Translated(gp_Vec(vDir) * v);
-
-                native->rectangleOverlay->SetRectangle(p1, p2, p3, p4);
+                std::vector<gp_Pnt> corners = {
+                    startPnt,
+                    startPnt.Translated(gp_Vec(uDir) * u),
+                    startPnt.Translated(gp_Vec(uDir) * u + gp_Vec(vDir) * v),
+                    startPnt.Translated(gp_Vec(vDir) * v) };
+                native->overlay.SetPolyline(native, corners, true, false, Quantity_NOC_RED);
             }
             else
             {
                 // 2D screen-space fallback
-                int startYFlipped = height - native->dragStartY;
-                int endYFlipped = height - native->dragEndY;
-
-                gp_Pnt p1(native->dragStartX, startYFlipped, 0.0);
-                gp_Pnt p2(native->dragEndX, endYFlipped, 0.0);
-
-                native->rectangleOverlay->SetRectangle(p1, p2);
+                std::vector<gp_Pnt> corners = {
+                    gp_Pnt(native->dragStartX, native->dragStartY, 0.0),
+                    gp_Pnt(native->dragEndX, native->dragStartY, 0.0),
+                    gp_Pnt(native->dragEndX, native->dragEndY, 0.0),
+                    gp_Pnt(native->dragStartX, native->dragEndY, 0.0) };
+                native->overlay.SetPolyline(native, corners, true, true, Quantity_NOC_RED);
             }
-
-            native->context->Display(native->rectangleOverlay, Standard_True);
         }
         void DrawDimensionOverlay(NativeViewerHandle* native, Handle(V3d_View) view, const gp_Pnt& p1, const gp_Pnt& p2, const gp_Pnt& cursor, bool isFinal)
         {
@@ -568,7 +574,7 @@ namespace PotaOCC
             DimensionHelper::DrawArrowheads(native, context, dimLineP1, dimLineP2, edgeVec, isFinal);
             DimensionHelper::DrawLabel(native, context, dimLineP1, dimLineP2, p1, p2, edgeVec, isFinal);
 
-            view->Redraw();
+            FrameScheduler::Redraw(view);
         }
         void DrawSelectionRectangle(NativeViewerHandle* native)
         {
@@ -582,9 +588,10 @@ namespace PotaOCC
         }
         void HighlightHoveredShape(NativeViewerHandle* native, int x, int y, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view)
         {
-            context->Deactivate();
-            context->Activate(TopAbs_SHAPE);
-            context->MoveTo(x, y, view, Standard_True);
+            SelectionHelper::SetSelectionMode(native, context, TopAbs_SHAPE);
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
 
             if (context->HasDetected())
             {
@@ -598,8 +605,6 @@ namespace PotaOCC
             }
             else
             {
-                context->Deactivate();
-                context->Activate(TopAbs_SHAPE);
                 MouseCursor::SetCustomCursor(native, PotaOCC::CursorType::Default);
             }
         }
@@ -613,26 +618,26 @@ namespace PotaOCC
             if (moveVec.Magnitude() < 1e-6)
                 return;
 
+            if (TransformSession::IsActive(native))
+            {
+                gp_Trsf moveTrsf;
+                moveTrsf.SetTranslation(moveVec);
+                TransformSession::Compose(native, context, moveTrsf);
+                FrameScheduler::Redraw(view);
+                native->lastMousePoint = currentPoint;
+                return;
+            }
+
             Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(native->movingObject);
             if (aisShape.IsNull())
                 return;
 
-            TopoDS_Shape originalShape = aisShape->Shape();
-            gp_Trsf trsf;
-            trsf.SetTranslation(moveVec);
-            TopoDS_Shape movedShape = BRepBuilderAPI_Transform(originalShape, trsf).Shape();
-            aisShape->Set(movedShape);
-
-            // ✅ Use LocalTransformation instead of replacing the shape
-            /*gp_Trsf currentTrsf = aisShape->LocalTransformation();
+            // ✅ Use LocalTransformation instead of replacing the shape; baked on mouse-up
             gp_Trsf moveTrsf;
             moveTrsf.SetTranslation(moveVec);
-            gp_Trsf newTrsf = currentTrsf.Multiplied(moveTrsf);
-            aisShape->SetLocalTransformation(newTrsf);*/
-
-            context->MoveTo(x, y, view, Standard_True);
-            context->Redisplay(aisShape, Standard_False);
-            view->Redraw();
+            gp_Trsf newTrsf = moveTrsf.Multiplied(aisShape->LocalTransformation());
+            context->SetLocation(aisShape, TopLoc_Location(newTrsf));
+            FrameScheduler::Redraw(view);
 
             native->lastMousePoint = currentPoint;
         }
@@ -645,39 +650,29 @@ namespace PotaOCC
             double angleX = deltaY * sensitivity * (M_PI / 180.0);  // rotate around X-axis
             double angleZ = deltaX * sensitivity * (M_PI / 180.0);  // rotate around Z-axis
 
-            Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(native->rotatingObject);
-            if (aisShape.IsNull())
-                return;
-
-            TopoDS_Shape originalShape = aisShape->Shape();
-
-            // Compute bounding box center for rotation pivot
-            Bnd_Box bbox;
-            BRepBndLib::Add(originalShape, bbox);
-            Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
-            bbox.Get(xmin, ymin, zmin, xmax, ymax, zmax);
-            gp_Pnt center((xmin + xmax) / 2.0, (ymin + ymax) / 2.0, (zmin + zmax) / 2.0);
-
-            gp_Ax1 axisX(center, gp::DX());
-            gp_Ax1 axisZ(center, gp::DZ());
+            gp_Ax1 axisX(native->rotatePivot, gp::DX());
+            gp_Ax1 axisZ(native->rotatePivot, gp::DZ());
 
             gp_Trsf trsfX, trsfZ;
             trsfX.SetRotation(axisX, angleX);
             trsfZ.SetRotation(axisZ, angleZ);
 
+            // World-space rotation about the fixed pivot, composed onto the local transformation
             gp_Trsf combinedTrsf = trsfX.Multiplied(trsfZ);
-            gp_Trsf currentTrsf = aisShape->LocalTransformation();
-            gp_Trsf newTrsf = currentTrsf.Multiplied(combinedTrsf);
-
-            TopoDS_Shape oldShape = aisShape->Shape();
-            BRepBuilderAPI_Transform trsfBuilder(oldShape, newTrsf, true);
-            TopoDS_Shape newShape = trsfBuilder.Shape();
-            aisShape->Set(newShape);
-            aisShape->SetLocalTransformation(gp_Trsf());
+            if (TransformSession::IsActive(native))
+            {
+                TransformSession::Compose(native, context, combinedTrsf);
+            }
+            else
+            {
+                Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(native->rotatingObject);
+                if (aisShape.IsNull())
+                    return;
 
-            context->MoveTo(x, y, view, Standard_True);
-            context->Redisplay(aisShape, Standard_False);
-            view->Redraw();
+                gp_Trsf newTrsf = combinedTrsf.Multiplied(aisShape->LocalTransformation());
+                context->SetLocation(aisShape, TopLoc_Location(newTrsf));
+            }
+            FrameScheduler::Redraw(view);
 
             native->lastMouseX = x;
             native->lastMouseY = y;
@@ -710,19 +705,30 @@ namespace PotaOCC
             // Stop if no movement
             if (native->currentExtrudeHeight == 0)
             {
-                view->Redraw();
+                FrameScheduler::Redraw(view);
                 return;
             }
 
-            // Remove previous preview
-            if (!native->extrudePreviewShape.IsNull())
-                context->Remove(native->extrudePreviewShape, Standard_False);
-
-            // Rebuild preview
+            // Update preview height in place (profile mesh is built once per wire)
             ShapeExtruder extruder(native);
             extruder.ExtrudeWireAndDisplayPreview(context);
 
-            view->Redraw();
+            FrameScheduler::Redraw(view);
+        }
+        void HandleRevolve(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x)
+        {
+            // Horizontal drag scrubs the angle, half a degree per pixel
+            int dx = x - native->lastMouseX;
+            native->lastMouseX = x;
+            if (dx == 0) return;
+
+            native->currentRevolveAngle = std::max(1.0, std::min(360.0, native->currentRevolveAngle + dx * 0.5));
+
+            // Only band indices and the end ring change; the profile sweep is packed once per wire
+            ShapeRevolver revolver(native);
+            revolver.RevolveWireAndDisplayPreview(context);
+
+            FrameScheduler::Redraw(view);
         }
         void HandleZoomWindow(NativeViewerHandle* native, Handle(V3d_View) view)
         {
@@ -748,13 +754,13 @@ namespace PotaOCC
 
                 // Perform zoom window
                 //view->WindowFitAll(xMin, yMin, xMax, yMax);
-                AnimateZoomWindow(native, view, xMin, yMin, xMax, yMax, 30);
+                AnimateZoomWindow(native, view, xMin, yMin, xMax, yMax);
 
                 // First clear overlays before redrawing
                 MouseHelper::ClearRubberBand(native);
 
                 // Redraw view after clearing overlays
-                view->Redraw();
+                FrameScheduler::Redraw(view);
 
                 // Finally reset drag state
                 MouseHelper::ResetDragState(native);
@@ -774,11 +780,12 @@ namespace PotaOCC
                 HandleEdgeHover(native, x, y, context, view);
             }
         }
-        void PrepareFaceDetection(Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y)
+        void PrepareFaceDetection(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y)
         {
-            context->Deactivate();
-            context->Activate(TopAbs_FACE); // Only detect faces
-            context->MoveTo(x, y, view, Standard_True);
+            SelectionHelper::SetSelectionMode(native, context, TopAbs_FACE); // Only detect faces
+            SelectionHelper::ActivateDeferredAt(native, context, view, x, y);
+            context->MoveTo(x, y, view, Standard_False);
+            FrameScheduler::RedrawImmediate(view);
         }
         TopoDS_Shape GetDetectedShapeOrOwner(Handle(AIS_InteractiveContext) context)
         {
@@ -828,7 +835,7 @@ namespace PotaOCC
         }
         void HandleShapeSelection(NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int mouseX, int mouseY)
         {
-            PrepareFaceDetection(context, view, mouseX, mouseY);
+            PrepareFaceDetection(native, context, view, mouseX, mouseY);
 
             if (!context->HasDetected())
             {
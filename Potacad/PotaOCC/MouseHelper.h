@@ -46,12 +46,13 @@ namespace PotaOCC {
         void HandleMove(PotaOCC::NativeViewerHandle* native, int x, int y, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view);
         void HandleRotate(PotaOCC::NativeViewerHandle* native, int x, int y, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view);
         void HandleExtrude(PotaOCC::NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int y);
+        void HandleRevolve(PotaOCC::NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x);
         void UpdateHoverDetection(PotaOCC::NativeViewerHandle* native, int x, int y, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view);
         void DrawDimensionOverlay(PotaOCC::NativeViewerHandle* native, Handle(V3d_View) view, const gp_Pnt& p1, const gp_Pnt& p2, const gp_Pnt& cursor, bool isFinal = false);
         gp_Pnt Get3DPntFromScreen(Handle(V3d_View) view, int x, int y);
         gp_Pnt Get3DPntOnPlane(const Handle(V3d_View)& view, const gp_Pnt& planeOrigin, const gp_Dir& planeNormal, int xPixel, int yPixel);
         void HandleZoomWindow(PotaOCC::NativeViewerHandle* native, Handle(V3d_View) view);
-        void PrepareFaceDetection(Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y);
+        void PrepareFaceDetection(PotaOCC::NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y);
         TopoDS_Shape GetDetectedShapeOrOwner(Handle(AIS_InteractiveContext) context);
         void SetupPlaneForFace(PotaOCC::NativeViewerHandle* native, Handle(V3d_View) view, const TopoDS_Face& face, int x, int y);
         void HandleDetectedShape(PotaOCC::NativeViewerHandle* native, Handle(AIS_InteractiveContext) context, Handle(V3d_View) view, int x, int y);
@@ -7,12 +7,32 @@
 #include <AIS_TextLabel.hxx>
 #include <gp_Pnt2d.hxx>
 #include <vector>
+#include <memory>
 #include <vcclr.h>
 #include "AIS_OverlayLine.h"
 #include "AIS_OverlayRectangle.h"
 #include "AIS_OverlayCircle.h"
 #include "AIS_OverlayEllipse.h"
+#include "AIS_SelectionHighlight.h"
+#include "AIS_ExtrudePreview.h"
+#include "AIS_RevolvePreview.h"
+#include "EntityIndex.h"
+#include "BooleanTask.h"
+#include "BooleanCache.h"
+#include "MeshingService.h"
+#include "ProjectFile.h"
+#include "ProjectSaver.h"
+#include "CommandJournal.h"
+#include "SceneDocument.h"
+#include "LayerTable.h"
+#include "BlockTable.h"
+#include "ArrayTable.h"
+#include "FrameScheduler.h"
+#include "ImmediateOverlay.h"
+#include "CameraAnimator.h"
+#include "DrawingTiles.h"
 #include <BRepLib_MakeFace.hxx>
+#include <AIS_MultipleConnectedInteractive.hxx>
 #include <AIS_Plane.hxx>   // ✅ Added for workplane visualization
 #include <gp_Ax3.hxx>      // ✅ Added for workplane coordinate system
 
@@ -21,6 +41,12 @@
 using namespace System::Windows::Forms;
 
 namespace PotaOCC {
+    // Imported entity displayed without selection primitives; its footprint lives in the entity index
+    struct DeferredSelectionEntry {
+        Handle(AIS_InteractiveObject) object;
+        int entityId = -1;                      // id into NativeViewerHandle::entityIndex
+    };
+
     struct NativeViewerHandle {
         // ✅ The OCCT Viewer
         Handle(V3d_Viewer) viewer;
@@ -32,10 +58,7 @@ namespace PotaOCC {
         Handle(AIS_Shape) axisY;
         Handle(AIS_Shape) axisZ;
 
-        Handle(AIS_OverlayLine) lineOverlay;
-        Handle(AIS_OverlayCircle) circleOverlay;
-        Handle(AIS_OverlayRectangle) rectangleOverlay;
-        Handle(AIS_OverlayEllipse) ellipseOverlay;
+        ImmediateOverlay overlay;                 // ✅ Rubber bands and drag previews, updated in place
         Handle(AIS_InteractiveObject) centerMarker;
         Handle(AIS_InteractiveObject) centerOverlay;
 
@@ -61,10 +84,6 @@ namespace PotaOCC {
         int dragEndX = 0;
         int dragEndY = 0;
 
-
-        Handle(Graphic3d_Structure) rubberBandOverlay;
-        Handle(Graphic3d_Group) rubberBandGroup;
-
         bool isLineMode = false;
         std::vector<Handle(AIS_Shape)> persistedLines;
 
@@ -91,7 +110,7 @@ namespace PotaOCC {
 
         bool isExtrudingActive = false;
         gp_Pnt extrudeBasePoint;
-        Handle(AIS_Shape) extrudePreviewShape;
+        Handle(AIS_ExtrudePreview) extrudePreview;  // cached profile mesh for the active wire
         TopoDS_Wire activeWire;
         double currentExtrudeHeight = 0.0;
 
@@ -112,6 +131,12 @@ namespace PotaOCC {
         int lastMouseX = 0;
         int lastMouseY = 0;
         Handle(AIS_InteractiveObject) rotatingObject;
+        gp_Pnt rotatePivot;                       // world pivot fixed at drag start
+        gp_Trsf dragStartTransformation;          // ✅ location of the dragged object at mouse down, for undo
+
+        // ✅ Transform session: the selection is instanced under one group while it is dragged
+        Handle(AIS_MultipleConnectedInteractive) transformGroup;
+        std::vector<Handle(AIS_InteractiveObject)> transformMembers;
 
         bool isMateAlignmentMode = false;
         bool hasFirstMateSelected;
@@ -120,7 +145,8 @@ namespace PotaOCC {
         TopoDS_Face* firstMateFace;
 
         bool isRevolveMode = false;
-        Handle(AIS_Shape) revolvePreviewShape;
+        bool isRevolvingActive = false;           // profile picked, angle follows the mouse until release
+        Handle(AIS_RevolvePreview) revolvePreview;  // cached profile sweep for the active wire
         gp_Ax1 revolveAxis;
         bool isRevolveAxisSet = false;
         TopoDS_Wire revolveWire;
@@ -157,12 +183,52 @@ namespace PotaOCC {
 
         bool isPlaneMode = false;
 
+        // ✅ Lazy selection: sensitives are built on first hover/pick or in idle slices
+        std::vector<DeferredSelectionEntry> deferredSelection;
+        std::vector<int> deferredSlots;           // by entity id: position in deferredSelection, -1 once active
+        int activeSelectionMode = -1;             // -1 = not yet forced by SelectionHelper
+        std::vector<Handle(AIS_InteractiveObject)> selectionModeQueue;  // shown since the mode was last applied
+
+        // ✅ Native window/crossing selection over 2D entity extents
+        EntityIndex entityIndex;
+        std::vector<int> selectedEntities;        // ids into entityIndex
+        Handle(AIS_OutlinePages) entityOutlines;  // packed once per entity, indexed by the highlight
+        Handle(AIS_SelectionHighlight) selectionHighlight;
+
+        // ✅ Boolean running on a worker thread; finalized by ShapeBooleanOperator::PollBooleanOperation
+        std::shared_ptr<BooleanTask> booleanTask;
+        BooleanOptions booleanOptions;            // used instead of size-based defaults when overridden
+        bool isBooleanOptionsOverridden = false;
+        BooleanCache booleanCache;                // results of earlier booleans on unchanged operands
+
+        // ✅ Background meshing of displayed solids (created on first use)
+        std::shared_ptr<MeshingService> meshingService;
+
+        // ✅ Project opened from disk; its curves are drawn straight from the mapped file
+        std::shared_ptr<ProjectView> project;
+
+        // ✅ Incremental saves written on a worker thread (created on first use)
+        std::shared_ptr<ProjectSaver> projectSaver;
+
+        // ✅ Entity document (rows, revisions); the AIS presentations of its rows are derived by Sync
+        SceneDocument document;
+        LayerTable layers;                        // ✅ DXF layers, one Z layer each
+        BlockTable blocks;                        // ✅ DXF block definitions shared by INSERT instances
+        ArrayTable arrays;                        // ✅ Associative rectangular / polar / path arrays
+        FrameScheduler frames;                    // ✅ Coalesces redraw requests into one frame per refresh
+        CameraAnimator cameraAnimation;           // ✅ Time-based camera transitions, advanced per frame
+        DrawingTiles tiles;                       // ✅ Quadtree tiles; sub-pixel content drawn as packed proxies
+
+        // ✅ Undo/redo history of scene edits
+        CommandJournal commandJournal;
+
         NativeViewerHandle()
         {
             hasFirstMateSelected = false;
             firstMateFace = nullptr;
             isRevolveMode = false;
             currentRevolveAngle = 360.0;
+            commandJournal.SetOwner(this);
         }
     };
 }
\ No newline at end of file
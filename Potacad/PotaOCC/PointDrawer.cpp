@@ -1,6 +1,10 @@
 #include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "PointDrawer.h"
+#include "SelectionHelper.h"
+#include "ViewerManager.h"
+#include <BRepBuilderAPI_MakeVertex.hxx>
 
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Point.hxx>
@@ -33,7 +37,7 @@ void PointDrawer::DrawPoint(
     ctx->SetTransparency(aisPoint, transparency, Standard_False);
     ctx->Display(aisPoint, Standard_False);
 
-    ctx->UpdateCurrentViewer();
+    FrameScheduler::Redraw(ctx);
 }
 
 array<int>^ PointDrawer::DrawPointBatch(
@@ -52,34 +56,33 @@ array<int>^ PointDrawer::DrawPointBatch(
     if (!rawCtx) return gcnew array<int>(0);
 
     Handle(AIS_InteractiveContext) ctx(rawCtx);
+    NativeViewerHandle* native = ViewerRegistry::FindByContext(rawCtx);
+    if (!native) return gcnew array<int>(0);
 
     int n = x->Length;
     auto ids = gcnew array<int>(n);
+    const uint16_t layer = native->layers.Current();
 
     for (int i = 0; i < n; ++i)
     {
         gp_Pnt p(x[i], y[i], z[i]);
-        Handle(Geom_CartesianPoint) geomPoint = new Geom_CartesianPoint(p);
-        Handle(AIS_Point) aisPoint = new AIS_Point(geomPoint);
-
-        aisPoint->SetWidth(4.0);
 
         double dr = (r != nullptr && i < r->Length) ? r[i] / 255.0 : 0.5;
         double dg = (g != nullptr && i < g->Length) ? g[i] / 255.0 : 0.5;
         double db = (b != nullptr && i < b->Length) ? b[i] / 255.0 : 0.5;
         Quantity_Color qcol(dr, dg, db, Quantity_TOC_RGB);
 
-        ctx->SetColor(aisPoint, qcol, Standard_False);
-
+        // The row keeps the point as a vertex; Sync derives an AIS_Point for it
+        EntityStyle style;
+        style.color = qcol;
+        style.width = 4.0;
         if (transparency != nullptr && i < transparency->Length)
-            ctx->SetTransparency(aisPoint, transparency[i], Standard_False);
-
-        ctx->Display(aisPoint, Standard_False);
-
-        ids[i] = (int)aisPoint.get();
+            style.transparency = transparency[i];
+        ids[i] = native->document.Create(EntityType::Point, BRepBuilderAPI_MakeVertex(p), style, layer);
     }
 
-    ctx->UpdateCurrentViewer();
+    native->document.Sync(native);
+    FrameScheduler::Redraw(ctx);
     return ids;
 }
 
@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "PolylineDrawer.h"
+#include "SelectionHelper.h"
+#include "ViewerManager.h"
 #include <AIS_InteractiveContext.hxx>
 #include <V3d_Viewer.hxx>
 #include <V3d_View.hxx>
@@ -27,6 +30,8 @@ array<int>^ PolylineDrawer::DrawPolylineBatch(
     if (x->Length < 2) return gcnew array<int>(0); // at least 2 points
 
     Handle(AIS_InteractiveContext) ctx(rawCtx);
+    NativeViewerHandle* native = ViewerRegistry::FindByContext(rawCtx);
+    if (!native) return gcnew array<int>(0);
 
     try
     {
@@ -42,18 +47,16 @@ array<int>^ PolylineDrawer::DrawPolylineBatch(
 
         polylineBuilder.Build();
 
-        Handle(AIS_Shape) aisShape = new AIS_Shape(polylineBuilder.Shape());
-
-        Quantity_Color col(r[0] / 255.0, g[0] / 255.0, b[0] / 255.0, Quantity_TOC_RGB);
-        ctx->SetColor(aisShape, col, Standard_False);
-        ctx->SetTransparency(aisShape, transparency[0], Standard_False);
-        ctx->Display(aisShape, Standard_False);
+        EntityStyle style;
+        style.color = Quantity_Color(r[0] / 255.0, g[0] / 255.0, b[0] / 255.0, Quantity_TOC_RGB);
+        style.transparency = transparency[0];
 
         array<int>^ ids = gcnew array<int>(1);
 
-        ids[0] = (int)aisShape.get();
+        ids[0] = native->document.Create(EntityType::Polyline, polylineBuilder.Shape(), style, native->layers.Current());
+        native->document.Sync(native);
 
-        ctx->UpdateCurrentViewer();
+        FrameScheduler::Redraw(ctx);
         return ids;
     }
     catch (...)
@@ -0,0 +1,74 @@
+#pragma once
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepBndLib.hxx>
+#include <BRep_Tool.hxx>
+#include <Bnd_Box.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+#include <gp_Pnt.hxx>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Tessellation of a planar sketch profile, shared by the extrude and revolve previews.
+// Boundary segments index the cap nodes, so swept walls and caps stay watertight.
+struct ProfileMesh
+{
+    std::vector<gp_Pnt> nodes;          // cap nodes in world space
+    std::vector<int> triangles;         // 0-based node triples
+    std::vector<int> segments;          // boundary node pairs
+
+    bool IsEmpty() const { return nodes.empty() || triangles.empty(); }
+
+    bool Build(const TopoDS_Face& face)
+    {
+        nodes.clear(); triangles.clear(); segments.clear();
+
+        Bnd_Box box;
+        BRepBndLib::Add(face, box);
+        if (box.IsVoid())
+            return false;
+        const double deflection = std::max(std::sqrt(box.SquareExtent()) * 0.002, 1.0e-4);
+        BRepMesh_IncrementalMesh mesher(face, deflection, Standard_False, 0.5);
+
+        TopLoc_Location loc;
+        const Handle(Poly_Triangulation)& tri = BRep_Tool::Triangulation(face, loc);
+        if (tri.IsNull() || tri->NbTriangles() == 0)
+            return false;
+
+        const gp_Trsf& trsf = loc.Transformation();
+        nodes.reserve(tri->NbNodes());
+        for (Standard_Integer i = 1; i <= tri->NbNodes(); ++i)
+            nodes.push_back(tri->Node(i).Transformed(trsf));
+
+        const bool isReversed = face.Orientation() == TopAbs_REVERSED;
+        triangles.reserve(3 * tri->NbTriangles());
+        for (Standard_Integer i = 1; i <= tri->NbTriangles(); ++i)
+        {
+            Standard_Integer n1, n2, n3;
+            tri->Triangle(i).Get(n1, n2, n3);
+            if (isReversed) std::swap(n2, n3);
+            triangles.push_back(n1 - 1);
+            triangles.push_back(n2 - 1);
+            triangles.push_back(n3 - 1);
+        }
+
+        for (TopExp_Explorer exp(face, TopAbs_EDGE); exp.More(); exp.Next())
+        {
+            const TopoDS_Edge& edge = TopoDS::Edge(exp.Current());
+            const Handle(Poly_PolygonOnTriangulation)& poly = BRep_Tool::PolygonOnTriangulation(edge, tri, loc);
+            if (poly.IsNull()) continue;
+
+            const TColStd_Array1OfInteger& polyNodes = poly->Nodes();
+            for (Standard_Integer i = polyNodes.Lower(); i < polyNodes.Upper(); ++i)
+            {
+                segments.push_back(polyNodes(i) - 1);
+                segments.push_back(polyNodes(i + 1) - 1);
+            }
+        }
+        return true;
+    }
+};
@@ -0,0 +1,1225 @@
+#include "pch.h"
+#include "ProjectFile.h"
+#include "ProjectSaver.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "MeshingService.h"
+#include "SelectionHelper.h"
+#include "ShapeDrawer.h"
+#include <AIS_TextLabel.hxx>
+#include <BinTools.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_MakeEdge.hxx>
+#include <BRepBuilderAPI_MakeWire.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <GCPnts_TangentialDeflection.hxx>
+#include <Precision.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <msclr/marshal_cppstd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <streambuf>
+#include <tuple>
+#include <vector>
+
+namespace PotaOCC
+{
+    using namespace ProjectFormat;
+
+    bool ProjectFilePublic::Save(System::IntPtr viewerHandlePtr, System::String^ path)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || path == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return false;
+
+        msclr::interop::marshal_context ctx;
+        return ProjectSaver::Of(native).Save(native, ctx.marshal_as<std::wstring>(path));
+    }
+
+    bool ProjectFilePublic::Open(System::IntPtr viewerHandlePtr, System::String^ path)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero || path == nullptr) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull() || native->view.IsNull()) return false;
+
+        msclr::interop::marshal_context ctx;
+        ShapeDrawer::ClearAllShapes(viewerHandlePtr);
+        return ProjectFile::Open(native, ctx.marshal_as<std::wstring>(path));
+    }
+
+    bool ProjectFilePublic::IsSaving(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return false;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        return native && native->projectSaver && native->projectSaver->IsBusy();
+    }
+
+    namespace
+    {
+        const uint64_t THE_ALIGNMENT = 16;
+        const double THE_CURVE_DEFLECTION = 0.002;  // of the entity's diagonal, as ProfileMesh
+        const double THE_CURVE_ANGLE = 0.1;
+        const int THE_MAX_ASIDE_FILES = 8;
+
+        struct StyleKey
+        {
+            uint32_t layer;
+            float r, g, b, width;
+            uint32_t lineType;
+
+            bool operator<(const StyleKey& other) const
+            {
+                return std::tie(layer, r, g, b, width, lineType) < std::tie(other.layer, other.r, other.g, other.b, other.width, other.lineType);
+            }
+        };
+
+        struct PendingEntity
+        {
+            Entity record;
+            std::vector<uint32_t> segments;     // curves only: vertex pairs, global ids
+            EntityBounds bounds;                // exact, world
+        };
+
+        // Everything gathered for one base file or journal segment before it is laid out
+        struct SceneData
+        {
+            std::map<StyleKey, uint16_t> styleIds;
+            std::vector<StyleKey> styles;
+            std::map<std::string, uint32_t> layerIds;
+            std::vector<ProjectLayer> layers;
+            std::vector<gp_Pnt> vertices;
+            std::vector<PendingEntity> curves, texts, shapes;
+            std::vector<uint32_t> removed;
+            std::string strings;
+            std::string blobs;
+            Bnd_Box box;
+            uint32_t maxId = 0;
+
+            uint32_t LayerOf(const std::string& name, uint32_t flags = 0)
+            {
+                const std::string layerName = name.empty() ? std::string("0") : name;
+                auto it = layerIds.find(layerName);
+                if (it != layerIds.end()) return it->second;
+
+                ProjectLayer layer;
+                layer.name = layerName;
+                layer.flags = flags;
+                const uint32_t id = (uint32_t)layers.size();
+                layers.push_back(layer);
+                layerIds.emplace(layerName, id);
+                return id;
+            }
+
+            uint16_t StyleOf(const Quantity_Color& color, double width, Aspect_TypeOfLine lineType, uint32_t layer)
+            {
+                const StyleKey key = { layer, (float)color.Red(), (float)color.Green(), (float)color.Blue(), (float)width, (uint32_t)lineType };
+                auto it = styleIds.find(key);
+                if (it != styleIds.end()) return it->second;
+                if (styles.size() >= 0xFFFF) return 0;
+
+                const uint16_t id = (uint16_t)styles.size();
+                styles.push_back(key);
+                styleIds.emplace(key, id);
+                return id;
+            }
+
+            void AddBounds(PendingEntity& entity, const Bnd_Box& entityBox)
+            {
+                maxId = std::max(maxId, entity.record.id);
+                if (entityBox.IsVoid()) return;
+                Standard_Real zMin, zMax;
+                entityBox.Get(entity.bounds.xMin, entity.bounds.yMin, zMin, entity.bounds.xMax, entity.bounds.yMax, zMax);
+                box.Add(entityBox);
+            }
+        };
+
+        // Flat arrays in file order
+        struct LaidOut
+        {
+            std::vector<Entity> entities;
+            std::vector<Style> styles;
+            std::vector<Layer> layers;
+            std::vector<uint32_t> indices;
+            std::vector<Graphic3d_Vec3> vertices;
+            std::vector<double> exactVertices;
+        };
+
+        // std::istream over bytes of the mapping, so BinTools reads a blob without copying it
+        class MemoryBuffer : public std::streambuf
+        {
+        public:
+            MemoryBuffer(const uint8_t* data, size_t size)
+            {
+                char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+                setg(begin, begin, begin + size);
+            }
+        };
+
+        uint64_t Fnv1a(const uint8_t* data, size_t size)
+        {
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= data[i];
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        Entity EmptyRecord(uint8_t kind, uint32_t id)
+        {
+            Entity record;
+            std::memset(&record, 0, sizeof(record));
+            record.kind = kind;
+            record.id = id;
+            return record;
+        }
+
+        // Faces keep their triangulations, so a project opens without meshing on any machine. Shapes
+        // with faces arrive as the saver's snapshot, which the MeshingService does not touch.
+        bool AddBlob(SceneData& scene, const TopoDS_Shape& shape, Entity& record)
+        {
+            std::ostringstream blob;
+            try
+            {
+                const Standard_Boolean withTriangles = TopExp_Explorer(shape, TopAbs_FACE).More();
+                BinTools::Write(shape, blob, withTriangles, Standard_False, BinTools_FormatVersion_CURRENT);
+            }
+            catch (Standard_Failure& e)
+            {
+                std::cerr << "❌ Could not serialize shape: " << e.GetMessageString() << std::endl;
+                return false;
+            }
+
+            const std::string bytes = blob.str();
+            record.blobOffset = scene.blobs.size();
+            record.blobSize = bytes.size();
+            scene.blobs += bytes;
+            return true;
+        }
+
+        bool AddCurve(SceneData& scene, const ProjectItem& item)
+        {
+            Bnd_Box shapeBox;
+            BRepBndLib::Add(item.shape, shapeBox, Standard_False);
+            if (shapeBox.IsVoid()) return false;
+            const double deflection = std::max(std::sqrt(shapeBox.SquareExtent()) * THE_CURVE_DEFLECTION, 1.0e-6);
+
+            PendingEntity entity;
+            entity.record = EmptyRecord(Entity_Curve, item.id);
+            entity.record.firstVertex = (uint32_t)scene.vertices.size();
+            bool isStraight = true;
+
+            for (TopExp_Explorer exp(item.shape, TopAbs_EDGE); exp.More(); exp.Next())
+            {
+                const TopoDS_Edge& edge = TopoDS::Edge(exp.Current());
+                if (BRep_Tool::Degenerated(edge)) continue;
+
+                std::vector<gp_Pnt> points;
+                try
+                {
+                    BRepAdaptor_Curve curve(edge);
+                    if (curve.GetType() == GeomAbs_Line)
+                    {
+                        points.push_back(curve.Value(curve.FirstParameter()));
+                        points.push_back(curve.Value(curve.LastParameter()));
+                    }
+                    else
+                    {
+                        isStraight = false;
+                        GCPnts_TangentialDeflection sampler(curve, THE_CURVE_ANGLE, deflection);
+                        for (int i = 1; i <= sampler.NbPoints(); ++i)
+                            points.push_back(sampler.Value(i));
+                    }
+                }
+                catch (Standard_Failure&)
+                {
+                    continue;
+                }
+                if (points.size() < 2) continue;
+
+                const uint32_t base = (uint32_t)scene.vertices.size();
+                scene.vertices.insert(scene.vertices.end(), points.begin(), points.end());
+                for (uint32_t i = 0; i + 1 < (uint32_t)points.size(); ++i)
+                {
+                    entity.segments.push_back(base + i);
+                    entity.segments.push_back(base + i + 1);
+                }
+            }
+
+            // The tessellation only draws the curve; arcs and splines keep their exact edges
+            if (entity.segments.empty() || (!isStraight && !AddBlob(scene, item.shape, entity.record)))
+            {
+                scene.vertices.resize(entity.record.firstVertex);
+                return false;
+            }
+
+            entity.record.nbVertices = (uint32_t)scene.vertices.size() - entity.record.firstVertex;
+            entity.record.layer = scene.LayerOf(item.layer);
+            entity.record.style = scene.StyleOf(item.color, item.width, item.lineType, entity.record.layer);
+            scene.AddBounds(entity, shapeBox);
+            scene.curves.push_back(std::move(entity));
+            return true;
+        }
+
+        void AddText(SceneData& scene, const ProjectItem& item)
+        {
+            PendingEntity entity;
+            entity.record = EmptyRecord(Entity_Text, item.id);
+            entity.record.firstVertex = (uint32_t)scene.vertices.size();
+            entity.record.nbVertices = 1;
+            entity.record.param = (float)item.height;
+            entity.record.layer = scene.LayerOf(item.layer);
+            entity.record.style = scene.StyleOf(item.color, 1.0, Aspect_TOL_SOLID, entity.record.layer);
+            entity.record.blobOffset = scene.strings.size();
+            entity.record.blobSize = item.text.size();
+            scene.strings.append(item.text.c_str(), item.text.size() + 1);
+            scene.vertices.push_back(item.anchor);
+
+            Bnd_Box anchorBox;
+            anchorBox.Add(item.anchor);
+            scene.AddBounds(entity, anchorBox);
+            scene.texts.push_back(std::move(entity));
+        }
+
+        bool AddShape(SceneData& scene, const ProjectItem& item)
+        {
+            PendingEntity entity;
+            entity.record = EmptyRecord(Entity_Shape, item.id);
+            entity.record.layer = scene.LayerOf(item.layer);
+            entity.record.style = scene.StyleOf(item.color, item.width, Aspect_TOL_SOLID, entity.record.layer);
+            entity.record.param = (float)item.transparency;
+            if (item.isShaded) entity.record.flags |= Flag_Shaded;
+            if (TopExp_Explorer(item.shape, TopAbs_SOLID).More()) entity.record.flags |= Flag_Solid;
+            if (!AddBlob(scene, item.shape, entity.record)) return false;
+
+            Bnd_Box shapeBox;
+            BRepBndLib::Add(item.shape, shapeBox, Standard_False);
+            scene.AddBounds(entity, shapeBox);
+            scene.shapes.push_back(std::move(entity));
+            return true;
+        }
+
+        void AddItem(SceneData& scene, const ProjectItem& item)
+        {
+            if (item.isText)
+            {
+                AddText(scene, item);
+                return;
+            }
+            const bool hasFaces = TopExp_Explorer(item.shape, TopAbs_FACE).More() == Standard_True;
+            if (hasFaces || !AddCurve(scene, item))
+                AddShape(scene, item);
+        }
+
+        // Copies a record of an existing project without decoding its geometry
+        void AddPartRecord(SceneData& scene, const ProjectView& project, const ProjectPart& part, const Entity& source)
+        {
+            if (source.style >= part.nbStyles
+                || (uint64_t)source.firstVertex + source.nbVertices > part.nbVertices
+                || (uint64_t)source.firstIndex + source.nbIndices > part.nbIndices)
+                return;
+
+            const Style& style = part.styles[source.style];
+            PendingEntity entity;
+            entity.record = source;
+            entity.record.layer = scene.LayerOf(part.LayerName(source.layer), source.layer < part.nbLayers ? part.layers[source.layer].flags : 0);
+            entity.record.style = scene.StyleOf(Quantity_Color(style.color[0], style.color[1], style.color[2], Quantity_TOC_RGB),
+                style.width, (Aspect_TypeOfLine)style.lineType, entity.record.layer);
+            entity.record.firstVertex = (uint32_t)scene.vertices.size();
+            for (uint32_t v = 0; v < source.nbVertices; ++v)
+            {
+                const double* p = part.exactVertices + 3 * (size_t)(source.firstVertex + v);
+                scene.vertices.push_back(gp_Pnt(p[0], p[1], p[2]));
+            }
+
+            if (source.kind == Entity_Text)
+            {
+                if (source.blobOffset > part.stringsSize || source.blobSize >= part.stringsSize - source.blobOffset) return;
+                entity.record.blobOffset = scene.strings.size();
+                scene.strings.append(part.strings + source.blobOffset, (size_t)source.blobSize + 1);
+            }
+            else if (source.kind == Entity_Shape || source.blobSize > 0)
+            {
+                if (source.blobOffset > part.blobsSize || source.blobSize > part.blobsSize - source.blobOffset) return;
+                entity.record.blobOffset = scene.blobs.size();
+                scene.blobs.append(reinterpret_cast<const char*>(part.blobs + source.blobOffset), (size_t)source.blobSize);
+            }
+
+            if (source.kind == Entity_Curve)
+            {
+                entity.segments.reserve(source.nbIndices);
+                for (uint32_t k = 0; k < source.nbIndices; ++k)
+                    entity.segments.push_back(part.indices[source.firstIndex + k] - source.firstVertex + entity.record.firstVertex);
+            }
+
+            const double* origin = project.header->origin;
+            Bnd_Box entityBox;
+            entityBox.Add(gp_Pnt(origin[0] + source.bounds[0], origin[1] + source.bounds[1], origin[2]));
+            entityBox.Add(gp_Pnt(origin[0] + source.bounds[2], origin[1] + source.bounds[3], origin[2]));
+            scene.AddBounds(entity, entityBox);
+
+            std::vector<PendingEntity>& group = source.kind == Entity_Curve ? scene.curves : source.kind == Entity_Text ? scene.texts : scene.shapes;
+            group.push_back(std::move(entity));
+        }
+
+        void LayOut(SceneData& scene, const gp_XYZ& origin, LaidOut& out)
+        {
+            // Curves sorted by style so every style, and so every layer, owns one contiguous index range
+            std::stable_sort(scene.curves.begin(), scene.curves.end(),
+                [](const PendingEntity& a, const PendingEntity& b) { return a.record.style < b.record.style; });
+
+            out.styles.resize(scene.styles.size());
+            for (size_t s = 0; s < out.styles.size(); ++s)
+            {
+                const StyleKey& key = scene.styles[s];
+                Style& style = out.styles[s];
+                std::memset(&style, 0, sizeof(Style));
+                style.color[0] = key.r; style.color[1] = key.g; style.color[2] = key.b;
+                style.width = key.width;
+                style.lineType = key.lineType;
+                style.layer = key.layer;
+            }
+
+            out.layers.resize(scene.layers.size());
+            for (size_t l = 0; l < out.layers.size(); ++l)
+            {
+                Layer& layer = out.layers[l];
+                std::memset(&layer, 0, sizeof(Layer));
+                layer.nameOffset = (uint32_t)scene.strings.size();
+                layer.nameLength = (uint32_t)scene.layers[l].name.size();
+                layer.flags = scene.layers[l].flags;
+                scene.strings.append(scene.layers[l].name.c_str(), scene.layers[l].name.size() + 1);
+            }
+
+            for (PendingEntity& curve : scene.curves)
+            {
+                Style& style = out.styles[curve.record.style];
+                if (style.nbIndices == 0) style.firstIndex = (uint32_t)out.indices.size();
+                curve.record.firstIndex = (uint32_t)out.indices.size();
+                curve.record.nbIndices = (uint32_t)curve.segments.size();
+                style.nbIndices += curve.record.nbIndices;
+                out.indices.insert(out.indices.end(), curve.segments.begin(), curve.segments.end());
+            }
+
+            out.entities.reserve(scene.curves.size() + scene.texts.size() + scene.shapes.size());
+            for (std::vector<PendingEntity>* group : { &scene.curves, &scene.texts, &scene.shapes })
+            {
+                for (PendingEntity& entity : *group)
+                {
+                    entity.record.bounds[0] = (float)(entity.bounds.xMin - origin.X());
+                    entity.record.bounds[1] = (float)(entity.bounds.yMin - origin.Y());
+                    entity.record.bounds[2] = (float)(entity.bounds.xMax - origin.X());
+                    entity.record.bounds[3] = (float)(entity.bounds.yMax - origin.Y());
+                    out.entities.push_back(entity.record);
+                }
+            }
+
+            out.vertices.resize(scene.vertices.size());
+            out.exactVertices.resize(3 * scene.vertices.size());
+            for (size_t v = 0; v < scene.vertices.size(); ++v)
+            {
+                const gp_XYZ& p = scene.vertices[v].XYZ();
+                out.vertices[v] = Graphic3d_Vec3((float)(p.X() - origin.X()), (float)(p.Y() - origin.Y()), (float)(p.Z() - origin.Z()));
+                out.exactVertices[3 * v] = p.X(); out.exactVertices[3 * v + 1] = p.Y(); out.exactVertices[3 * v + 2] = p.Z();
+            }
+        }
+
+        void WritePadding(std::ostream& out, uint64_t start)
+        {
+            static const char zeros[THE_ALIGNMENT] = {};
+            const uint64_t position = (uint64_t)out.tellp() - start;
+            const uint64_t padding = (THE_ALIGNMENT - position % THE_ALIGNMENT) % THE_ALIGNMENT;
+            out.write(zeros, (std::streamsize)padding);
+        }
+
+        // Sections with offsets relative to start (the file for the base, the segment for the journal)
+        std::vector<Section> WriteSections(std::ostream& out, uint64_t start, const LaidOut& laidOut, const SceneData& scene, bool isBase)
+        {
+            std::vector<Section> sections;
+            auto writeSection = [&](uint32_t kind, const void* data, size_t bytes, const void* tail, size_t tailBytes)
+            {
+                WritePadding(out, start);
+                Section section = { kind, 0, (uint64_t)out.tellp() - start, (uint64_t)(bytes + tailBytes) };
+                if (bytes) out.write(static_cast<const char*>(data), (std::streamsize)bytes);
+                if (tailBytes) out.write(static_cast<const char*>(tail), (std::streamsize)tailBytes);
+                sections.push_back(section);
+            };
+
+            const Graphic3d_Attribute vertexAttribute = { Graphic3d_TOA_POS, Graphic3d_TOD_VEC3 };
+            writeSection(Section_Entities, laidOut.entities.data(), laidOut.entities.size() * sizeof(Entity), nullptr, 0);
+            writeSection(Section_Styles, laidOut.styles.data(), laidOut.styles.size() * sizeof(Style), nullptr, 0);
+            writeSection(Section_Layers, laidOut.layers.data(), laidOut.layers.size() * sizeof(Layer), nullptr, 0);
+            writeSection(Section_Vertices, laidOut.vertices.data(), laidOut.vertices.size() * sizeof(Graphic3d_Vec3), &vertexAttribute, sizeof(vertexAttribute));
+            writeSection(Section_ExactVertices, laidOut.exactVertices.data(), laidOut.exactVertices.size() * sizeof(double), nullptr, 0);
+            writeSection(Section_Indices, laidOut.indices.data(), laidOut.indices.size() * sizeof(uint32_t), nullptr, 0);
+            writeSection(Section_Strings, scene.strings.data(), scene.strings.size(), nullptr, 0);
+            writeSection(Section_Blobs, scene.blobs.data(), scene.blobs.size(), nullptr, 0);
+            if (!isBase) writeSection(Section_Removed, scene.removed.data(), scene.removed.size() * sizeof(uint32_t), nullptr, 0);
+            WritePadding(out, start);
+            return sections;
+        }
+
+        // An open project keeps its file mapped: move it aside (the mapping survives) and rename the new file in.
+        // Aside files still mapped cannot be deleted yet; they are retried on the next replace.
+        bool ReplaceFile(const std::wstring& written, const std::wstring& path)
+        {
+            std::wstring aside;
+            for (int i = 0; i < THE_MAX_ASIDE_FILES; ++i)
+            {
+                const std::wstring candidate = path + L".old" + (i ? std::to_wstring(i) : std::wstring());
+                _wremove(candidate.c_str());
+                if (aside.empty() && _waccess(candidate.c_str(), 0) != 0) aside = candidate;
+            }
+
+            const bool hasOld = !aside.empty() && _wrename(path.c_str(), aside.c_str()) == 0;
+            if (_wrename(written.c_str(), path.c_str()) != 0)
+            {
+                if (hasOld) _wrename(aside.c_str(), path.c_str());
+                return false;
+            }
+            if (hasOld) _wremove(aside.c_str());
+            return true;
+        }
+
+        bool ParsePart(const MappedFile& file, uint64_t start, const Section* sections, uint32_t nbSections, ProjectPart& part)
+        {
+            uint64_t nbExactVertices = 0;
+            for (uint32_t s = 0; s < nbSections; ++s)
+            {
+                const Section& section = sections[s];
+                const uint8_t* data = file.Range(start + section.offset, section.size);
+                if (!data) return false;
+
+                switch (section.kind)
+                {
+                case Section_Entities:
+                    if (section.size % sizeof(Entity)) return false;
+                    part.entities = reinterpret_cast<const Entity*>(data);
+                    part.nbEntities = (uint32_t)(section.size / sizeof(Entity));
+                    break;
+                case Section_Styles:
+                    if (section.size % sizeof(Style)) return false;
+                    part.styles = reinterpret_cast<const Style*>(data);
+                    part.nbStyles = (uint32_t)(section.size / sizeof(Style));
+                    break;
+                case Section_Layers:
+                    if (section.size % sizeof(Layer)) return false;
+                    part.layers = reinterpret_cast<const Layer*>(data);
+                    part.nbLayers = (uint32_t)(section.size / sizeof(Layer));
+                    break;
+                case Section_Vertices:
+                {
+                    // Positions followed by the attribute descriptor the renderer reads after them
+                    if (section.size < sizeof(Graphic3d_Attribute)) return false;
+                    const uint64_t bytes = section.size - sizeof(Graphic3d_Attribute);
+                    const Graphic3d_Attribute* attribute = reinterpret_cast<const Graphic3d_Attribute*>(data + bytes);
+                    if (bytes % sizeof(Graphic3d_Vec3) || attribute->Id != Graphic3d_TOA_POS || attribute->DataType != Graphic3d_TOD_VEC3)
+                        return false;
+                    part.vertices = data;
+                    part.nbVertices = (uint32_t)(bytes / sizeof(Graphic3d_Vec3));
+                    break;
+                }
+                case Section_ExactVertices:
+                    if (section.size % (3 * sizeof(double))) return false;
+                    part.exactVertices = reinterpret_cast<const double*>(data);
+                    nbExactVertices = section.size / (3 * sizeof(double));
+                    break;
+                case Section_Indices:
+                    if (section.size % (2 * sizeof(uint32_t))) return false;
+                    part.indices = reinterpret_cast<const uint32_t*>(data);
+                    part.nbIndices = (uint32_t)(section.size / sizeof(uint32_t));
+                    break;
+                case Section_Strings:
+                    part.strings = reinterpret_cast<const char*>(data);
+                    part.stringsSize = section.size;
+                    break;
+                case Section_Blobs:
+                    part.blobs = data;
+                    part.blobsSize = section.size;
+                    break;
+                case Section_Removed:
+                    if (section.size % sizeof(uint32_t)) return false;
+                    part.removed = reinterpret_cast<const uint32_t*>(data);
+                    part.nbRemoved = (uint32_t)(section.size / sizeof(uint32_t));
+                    break;
+                default:
+                    break;                      // newer sections are skipped
+                }
+            }
+
+            if (nbExactVertices != part.nbVertices || (uint64_t)part.nbCurves + part.nbTexts > part.nbEntities)
+                return false;
+
+            for (uint32_t s = 0; s < part.nbStyles; ++s)
+            {
+                const Style& style = part.styles[s];
+                if ((uint64_t)style.firstIndex + style.nbIndices > part.nbIndices || style.nbIndices % 2) return false;
+            }
+
+            for (uint32_t l = 0; l < part.nbLayers; ++l)
+            {
+                const Layer& layer = part.layers[l];
+                if ((uint64_t)layer.nameOffset + layer.nameLength > part.stringsSize) return false;
+            }
+
+            // A corrupt index would make the GPU read past the vertex buffer
+            uint32_t maxIndex = 0;
+            for (uint32_t i = 0; i < part.nbIndices; ++i)
+                maxIndex = std::max(maxIndex, part.indices[i]);
+            return part.nbIndices == 0 || maxIndex < part.nbVertices;
+        }
+
+        bool ReadHeader(std::istream& in, Header& header)
+        {
+            in.seekg(0);
+            return in.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == THE_MAGIC && header.version == THE_VERSION;
+        }
+
+        // End of the last intact journal segment; a torn tail is overwritten by the next append
+        uint64_t JournalEnd(std::istream& in, const Header& header, uint64_t fileSize)
+        {
+            uint64_t offset = header.journalOffset;
+            std::vector<uint8_t> bytes;
+            while (offset + sizeof(SegmentHeader) <= fileSize)
+            {
+                SegmentHeader segment;
+                in.seekg((std::streamoff)offset);
+                if (!in.read(reinterpret_cast<char*>(&segment), sizeof(segment))) break;
+                if (segment.magic != THE_SEGMENT_MAGIC || segment.size < sizeof(segment) || segment.size > fileSize - offset) break;
+
+                bytes.resize((size_t)(segment.size - sizeof(segment)));
+                if (!bytes.empty() && !in.read(reinterpret_cast<char*>(bytes.data()), (std::streamsize)bytes.size())) break;
+                if (Fnv1a(bytes.data(), bytes.size()) != segment.checksum) break;
+                offset += segment.size;
+            }
+            in.clear();
+            return offset;
+        }
+
+        // Every part carries the whole table; the last one is the newest
+        std::vector<ProjectLayer> SavedLayers(const ProjectView& project)
+        {
+            std::vector<ProjectLayer> layers;
+            const ProjectPart& part = project.parts.back();
+            for (uint32_t l = 0; l < part.nbLayers; ++l)
+            {
+                ProjectLayer layer;
+                layer.name = part.LayerName(l);
+                layer.flags = part.layers[l].flags;
+                layers.push_back(layer);
+            }
+            return layers;
+        }
+    }
+
+    uint64_t ProjectFile::WriteFull(const std::wstring& path, const std::vector<ProjectItem>& items,
+        const ProjectView* carried, const std::vector<int>& carriedCurves, const std::vector<uint32_t>& detached, bool carryAll, uint32_t nextId,
+        const std::vector<ProjectLayer>& layers)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        SceneData scene;
+        for (const ProjectLayer& layer : layers)
+            scene.LayerOf(layer.name, layer.flags);
+
+        if (carried)
+        {
+            std::set<std::pair<int, uint32_t>> curveLayers;
+            for (int c : carriedCurves)
+                if (c >= 0 && c < (int)carried->curves.size())
+                    curveLayers.emplace(carried->curves[c].part, carried->curves[c].layer);
+
+            for (int p = 0; p < (int)carried->parts.size(); ++p)
+            {
+                const ProjectPart& part = carried->parts[p];
+                const uint32_t last = carryAll ? part.nbEntities : part.nbCurves;
+                for (uint32_t i = 0; i < last; ++i)
+                {
+                    const Entity& record = part.entities[i];
+                    const bool isCarried = carryAll || (curveLayers.count(std::make_pair(p, record.layer)) > 0
+                        && std::find(detached.begin(), detached.end(), record.id) == detached.end());
+                    if (isCarried && carried->IsLive(p, record))
+                        AddPartRecord(scene, *carried, part, record);
+                }
+            }
+        }
+        for (const ProjectItem& item : items)
+            AddItem(scene, item);
+
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = THE_MAGIC;
+        header.version = THE_VERSION;
+        header.nbCurves = (uint32_t)scene.curves.size();
+        header.nbTexts = (uint32_t)scene.texts.size();
+        header.nbShapes = (uint32_t)scene.shapes.size();
+        header.nextId = std::max(nextId, scene.maxId + 1);
+        if (!scene.box.IsVoid())
+        {
+            scene.box.Get(header.boxMin[0], header.boxMin[1], header.boxMin[2], header.boxMax[0], header.boxMax[1], header.boxMax[2]);
+            for (int i = 0; i < 3; ++i)
+                header.origin[i] = 0.5 * (header.boxMin[i] + header.boxMax[i]);
+        }
+
+        LaidOut laidOut;
+        LayOut(scene, gp_XYZ(header.origin[0], header.origin[1], header.origin[2]), laidOut);
+        header.nbLayers = (uint32_t)laidOut.layers.size();
+
+        // Header and directory first, patched once the section offsets are known
+        const std::wstring written = path + L".tmp";
+        std::ofstream out(written.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            std::cout << "❌ Cannot write project file." << std::endl;
+            return 0;
+        }
+
+        const uint32_t nbSections = 8;
+        header.nbSections = nbSections;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(std::string(nbSections * sizeof(Section), '\0').data(), nbSections * sizeof(Section));
+        const std::vector<Section> sections = WriteSections(out, 0, laidOut, scene, true);
+        header.journalOffset = (uint64_t)out.tellp();
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(Section));
+        out.close();
+        if (!out || !ReplaceFile(written, path))
+        {
+            _wremove(written.c_str());
+            std::cout << "❌ Failed to save project." << std::endl;
+            return 0;
+        }
+
+        const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "✅ Project saved: " << header.nbCurves << " curves, " << header.nbTexts << " texts, "
+            << header.nbShapes << " shapes in " << ms << " ms" << std::endl;
+        return header.journalOffset;
+    }
+
+    uint64_t ProjectFile::AppendSegment(const std::wstring& path, const std::vector<ProjectItem>& items,
+        const std::vector<uint32_t>& removed, const std::vector<ProjectLayer>& layers)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::fstream file(path.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+        Header header;
+        if (!file || !ReadHeader(file, header))
+        {
+            std::cout << "❌ Cannot append to project: not a Potacad project." << std::endl;
+            return 0;
+        }
+        file.seekg(0, std::ios::end);
+        const uint64_t fileSize = (uint64_t)file.tellg();
+        const uint64_t offset = JournalEnd(file, header, fileSize);
+
+        SceneData scene;
+        for (const ProjectLayer& layer : layers)
+            scene.LayerOf(layer.name, layer.flags);
+        for (const ProjectItem& item : items)
+            AddItem(scene, item);
+        scene.removed = removed;
+
+        // Same origin as the base, so every part's floats line up
+        LaidOut laidOut;
+        LayOut(scene, gp_XYZ(header.origin[0], header.origin[1], header.origin[2]), laidOut);
+
+        SegmentHeader segment;
+        std::memset(&segment, 0, sizeof(segment));
+        segment.magic = THE_SEGMENT_MAGIC;
+        segment.nbSections = 9;
+        segment.nbCurves = (uint32_t)scene.curves.size();
+        segment.nbTexts = (uint32_t)scene.texts.size();
+        segment.nbShapes = (uint32_t)scene.shapes.size();
+        if (!scene.box.IsVoid())
+            scene.box.Get(segment.boxMin[0], segment.boxMin[1], segment.boxMin[2], segment.boxMax[0], segment.boxMax[1], segment.boxMax[2]);
+
+        // Built in memory so the checksum covers exactly what lands on disk
+        std::ostringstream body;
+        body.write(reinterpret_cast<const char*>(&segment), sizeof(segment));
+        body.write(std::string(segment.nbSections * sizeof(Section), '\0').data(), segment.nbSections * sizeof(Section));
+        const std::vector<Section> sections = WriteSections(body, 0, laidOut, scene, false);
+        std::string bytes = body.str();
+        std::memcpy(&bytes[sizeof(segment)], sections.data(), sections.size() * sizeof(Section));
+
+        segment.size = bytes.size();
+        segment.checksum = Fnv1a(reinterpret_cast<const uint8_t*>(bytes.data()) + sizeof(segment), bytes.size() - sizeof(segment));
+        std::memcpy(&bytes[0], &segment, sizeof(segment));
+
+        file.seekp((std::streamoff)offset);
+        file.write(bytes.data(), (std::streamsize)bytes.size());
+        file.flush();
+        if (!file)
+        {
+            std::cout << "❌ Failed to append project journal." << std::endl;
+            return 0;
+        }
+
+        const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "✅ Project journal: " << laidOut.entities.size() << " changed, " << removed.size() << " removed in " << ms << " ms" << std::endl;
+        return segment.size;
+    }
+
+    uint64_t ProjectFile::Compact(const std::wstring& path)
+    {
+        std::shared_ptr<ProjectView> project = Map(path);
+        if (!project)
+        {
+            std::cout << "❌ Cannot compact project: file unreadable." << std::endl;
+            return 0;
+        }
+        return WriteFull(path, std::vector<ProjectItem>(), project.get(), std::vector<int>(), std::vector<uint32_t>(), true, project->nextId, SavedLayers(*project));
+    }
+
+    TopoDS_Shape ProjectFile::CurveGeometry(const ProjectPart& part, const Entity& record)
+    {
+        if (record.kind != Entity_Curve) return TopoDS_Shape();
+
+        if (record.blobSize > 0)
+        {
+            if (record.blobOffset > part.blobsSize || record.blobSize > part.blobsSize - record.blobOffset) return TopoDS_Shape();
+            TopoDS_Shape shape;
+            try
+            {
+                MemoryBuffer buffer(part.blobs + record.blobOffset, (size_t)record.blobSize);
+                std::istream in(&buffer);
+                BinTools::Read(shape, in);
+            }
+            catch (Standard_Failure&)
+            {
+                return TopoDS_Shape();
+            }
+            return shape;
+        }
+
+        if ((uint64_t)record.firstIndex + record.nbIndices > part.nbIndices) return TopoDS_Shape();
+        std::vector<TopoDS_Edge> edges;
+        for (uint32_t k = 0; k + 1 < record.nbIndices; k += 2)
+        {
+            const double* a = part.exactVertices + 3 * (size_t)part.indices[record.firstIndex + k];
+            const double* b = part.exactVertices + 3 * (size_t)part.indices[record.firstIndex + k + 1];
+            const gp_Pnt p1(a[0], a[1], a[2]), p2(b[0], b[1], b[2]);
+            if (p1.Distance(p2) > Precision::Confusion())
+                edges.push_back(BRepBuilderAPI_MakeEdge(p1, p2).Edge());
+        }
+        if (edges.empty()) return TopoDS_Shape();
+        if (edges.size() == 1) return edges.front();
+
+        // Segments that chain come back as the wire they were saved from
+        BRepBuilderAPI_MakeWire wire;
+        for (const TopoDS_Edge& edge : edges)
+        {
+            wire.Add(edge);
+            if (!wire.IsDone()) break;
+        }
+        if (wire.IsDone()) return wire.Wire();
+
+        TopoDS_Compound compound;
+        BRep_Builder builder;
+        builder.MakeCompound(compound);
+        for (const TopoDS_Edge& edge : edges)
+            builder.Add(compound, edge);
+        return compound;
+    }
+
+    void ProjectFile::CurveItems(const ProjectView& project, const ProjectCurves& curves, const gp_Trsf& placement,
+        const std::vector<uint32_t>& detached, std::vector<ProjectItem>& items)
+    {
+        if (curves.part < 0 || curves.part >= (int)project.parts.size()) return;
+        const ProjectPart& part = project.parts[curves.part];
+        const TopLoc_Location location(placement);
+
+        for (uint32_t i = 0; i < part.nbCurves; ++i)
+        {
+            const Entity& record = part.entities[i];
+            if (record.layer != curves.layer || record.style >= part.nbStyles || !project.IsLive(curves.part, record)
+                || std::find(detached.begin(), detached.end(), record.id) != detached.end())
+                continue;
+
+            const TopoDS_Shape shape = CurveGeometry(part, record);
+            if (shape.IsNull()) continue;
+
+            const Style& style = part.styles[record.style];
+            ProjectItem item;
+            item.id = record.id;
+            item.shape = shape.Moved(location);
+            item.color = Quantity_Color(style.color[0], style.color[1], style.color[2], Quantity_TOC_RGB);
+            item.width = style.width;
+            item.lineType = (Aspect_TypeOfLine)style.lineType;
+            item.layer = part.LayerName(record.layer);
+            items.push_back(item);
+        }
+    }
+
+    Handle(AIS_InteractiveObject) ProjectFile::Materialize(NativeViewerHandle* native, const Handle(AIS_PackedCurveOwner)& owner)
+    {
+        Handle(AIS_PackedCurves) packed = owner.IsNull() ? Handle(AIS_PackedCurves)() : Handle(AIS_PackedCurves)::DownCast(owner->Selectable());
+        if (packed.IsNull() || owner->IsDetached() || !native->project) return nullptr;
+
+        const ProjectView& project = *native->project;
+        auto curves = std::find_if(project.curves.begin(), project.curves.end(),
+            [&packed](const ProjectCurves& candidate) { return candidate.object == packed; });
+        if (curves == project.curves.end()) return nullptr;
+
+        const ProjectPart& part = project.parts[curves->part];
+        const Entity* record = nullptr;
+        for (uint32_t i = 0; i < part.nbCurves && record == nullptr; ++i)
+            if (part.entities[i].id == owner->Key()) record = &part.entities[i];
+
+        const TopoDS_Shape shape = record != nullptr ? CurveGeometry(part, *record) : TopoDS_Shape();
+        if (shape.IsNull() || record->style >= part.nbStyles)
+        {
+            std::cout << "⚠️ Curve could not be read from the project; it stays part of the drawing." << std::endl;
+            return nullptr;
+        }
+
+        const Style& style = part.styles[record->style];
+        const Quantity_Color color(style.color[0], style.color[1], style.color[2], Quantity_TOC_RGB);
+        Handle(AIS_Shape) ais = new AIS_Shape(shape);
+        ais->SetDisplayMode(AIS_WireFrame);
+        ais->Attributes()->SetWireAspect(new Prs3d_LineAspect(color, (Aspect_TypeOfLine)style.lineType, style.width));
+        if (packed->HasPlacement()) ais->SetLocalTransformation(packed->Placement());
+
+        // Same layer as the packed curves, placed the way the DXF import places entities
+        LayerTable& layers = native->layers;
+        const uint16_t previousLayer = layers.Current();
+        const int row = native->document.Find(packed);
+        if (row >= 0) layers.SetCurrent(native->document.Layer(row));
+        SelectionHelper::DisplayDeferred(native, native->context, ais);
+        layers.SetCurrent(previousLayer);
+        native->ais2DShapes.push_back(ais);
+
+        packed->Detach(owner);
+        native->context->Redisplay(packed, Standard_False);
+        ProjectSaver::Of(native).Track(native, ais, record->id);
+        return ais;
+    }
+
+    std::shared_ptr<ProjectView> ProjectFile::Map(const std::wstring& path)
+    {
+        std::shared_ptr<ProjectView> project = std::make_shared<ProjectView>();
+        project->path = path;
+        project->file = std::make_shared<MappedFile>();
+        if (!project->file->Open(path))
+            return nullptr;
+
+        const MappedFile& file = *project->file;
+        const Header* header = reinterpret_cast<const Header*>(file.Range(0, sizeof(Header)));
+        if (!header || header->magic != THE_MAGIC || header->version != THE_VERSION)
+            return nullptr;
+        project->header = header;
+        project->nextId = header->nextId;
+
+        const Section* sections = reinterpret_cast<const Section*>(file.Range(sizeof(Header), (uint64_t)header->nbSections * sizeof(Section)));
+        if (!sections)
+            return nullptr;
+
+        ProjectPart base;
+        base.nbCurves = header->nbCurves;
+        base.nbTexts = header->nbTexts;
+        std::copy(header->boxMin, header->boxMin + 3, base.boxMin);
+        std::copy(header->boxMax, header->boxMax + 3, base.boxMax);
+        if (!ParsePart(file, 0, sections, header->nbSections, base) || base.nbLayers != header->nbLayers
+            || (uint64_t)header->nbCurves + header->nbTexts + header->nbShapes != base.nbEntities)
+            return nullptr;
+        project->parts.push_back(base);
+
+        // Journal: later segments override earlier parts entity by entity
+        uint64_t offset = header->journalOffset;
+        while (offset + sizeof(SegmentHeader) <= file.Size())
+        {
+            const SegmentHeader* segment = reinterpret_cast<const SegmentHeader*>(file.Range(offset, sizeof(SegmentHeader)));
+            if (segment->magic != THE_SEGMENT_MAGIC || segment->size < sizeof(SegmentHeader) || segment->size > file.Size() - offset)
+                break;
+
+            const uint8_t* body = file.Data() + offset + sizeof(SegmentHeader);
+            if (Fnv1a(body, (size_t)(segment->size - sizeof(SegmentHeader))) != segment->checksum)
+            {
+                std::cout << "⚠️ Project journal ends in an incomplete save; it was ignored." << std::endl;
+                break;
+            }
+
+            const Section* segmentSections = reinterpret_cast<const Section*>(file.Range(offset + sizeof(SegmentHeader), (uint64_t)segment->nbSections * sizeof(Section)));
+            ProjectPart part;
+            part.nbCurves = segment->nbCurves;
+            part.nbTexts = segment->nbTexts;
+            std::copy(segment->boxMin, segment->boxMin + 3, part.boxMin);
+            std::copy(segment->boxMax, segment->boxMax + 3, part.boxMax);
+            if (!segmentSections || !ParsePart(file, offset, segmentSections, segment->nbSections, part)
+                || (uint64_t)segment->nbCurves + segment->nbTexts + segment->nbShapes != part.nbEntities)
+                break;
+
+            const int partIndex = (int)project->parts.size();
+            for (uint32_t i = 0; i < part.nbRemoved; ++i)
+                project->journaled[part.removed[i]] = -1;
+            for (uint32_t i = 0; i < part.nbEntities; ++i)
+            {
+                project->journaled[part.entities[i].id] = partIndex;
+                project->nextId = std::max(project->nextId, part.entities[i].id + 1);
+            }
+
+            project->parts.push_back(part);
+            project->journalBytes += segment->size;
+            offset += segment->size;
+        }
+
+        return project;
+    }
+
+    bool ProjectFile::Open(NativeViewerHandle* native, const std::wstring& path)
+    {
+        // Saves still queued for this viewer may target the same file
+        ProjectSaver::Of(native).Flush();
+
+        const auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<ProjectView> project = Map(path);
+        if (!project)
+        {
+            std::cout << "❌ Not a readable Potacad project." << std::endl;
+            return false;
+        }
+
+        Handle(AIS_InteractiveContext) context = native->context;
+        const gp_Pnt origin(project->header->origin[0], project->header->origin[1], project->header->origin[2]);
+        const std::shared_ptr<const void> owner = project->file;
+
+        std::vector<std::pair<Handle(AIS_InteractiveObject), uint32_t>> loaded;
+        uint32_t nbCurves = 0, nbTexts = 0, nbShapes = 0;
+        int nbFailed = 0;
+
+        // Entities are placed on their layer the way the DXF import does: as the current layer
+        LayerTable& layers = native->layers;
+        const uint16_t previousLayer = layers.Current();
+        std::map<uint16_t, uint32_t> layerFlags;
+
+        for (int p = 0; p < (int)project->parts.size(); ++p)
+        {
+            const ProjectPart& part = project->parts[p];
+
+            // A later part's table holds the newer layer states
+            std::vector<uint16_t> layerMap(part.nbLayers);
+            for (uint32_t l = 0; l < part.nbLayers; ++l)
+            {
+                const std::string name = part.LayerName(l);
+                layerMap[l] = layers.Ensure(native, TCollection_ExtendedString(name.c_str(), Standard_True).ToWideString());
+                layerFlags[layerMap[l]] = part.layers[l].flags;
+            }
+            auto useLayer = [&](uint32_t layer)
+            {
+                layers.SetCurrent(layer < layerMap.size() ? layerMap[layer] : layers.Ensure(native, L"0"));
+            };
+
+            auto styleColor = [&part](uint16_t style)
+            {
+                if (style >= part.nbStyles) return Quantity_Color(Quantity_NOC_WHITE);
+                const Style& s = part.styles[style];
+                return Quantity_Color(s.color[0], s.color[1], s.color[2], Quantity_TOC_RGB);
+            };
+
+            // Curves: buffers point into the mapping, nothing is decoded per entity. Every layer gets
+            // its own object over the shared nodes, so it lands in that layer's Z layer.
+            if (part.nbVertices > 0 && part.nbIndices > 0)
+            {
+                // Curves replaced or removed by a later segment are left out of copied index buffers
+                bool isAllLive = true;
+                for (uint32_t i = 0; i < part.nbCurves && isAllLive; ++i)
+                    isAllLive = project->IsLive(p, part.entities[i]);
+
+                // Each curve's range in its style's indices, so picking resolves single curves
+                std::vector<std::vector<uint32_t>> liveIndices(isAllLive ? 0 : part.nbStyles);
+                std::vector<std::vector<int>> curveStarts(part.nbStyles);
+                std::vector<std::vector<uint32_t>> curveKeys(part.nbStyles);
+                for (uint32_t i = 0; i < part.nbCurves; ++i)
+                {
+                    const Entity& curve = part.entities[i];
+                    if (!project->IsLive(p, curve) || curve.style >= part.nbStyles
+                        || (uint64_t)curve.firstIndex + curve.nbIndices > part.nbIndices) continue;
+
+                    const Style& style = part.styles[curve.style];
+                    if (isAllLive)
+                    {
+                        if (curve.firstIndex < style.firstIndex || curve.firstIndex + curve.nbIndices > style.firstIndex + style.nbIndices) continue;
+                        curveStarts[curve.style].push_back((int)(curve.firstIndex - style.firstIndex));
+                    }
+                    else
+                    {
+                        std::vector<uint32_t>& live = liveIndices[curve.style];
+                        curveStarts[curve.style].push_back((int)live.size());
+                        live.insert(live.end(), part.indices + curve.firstIndex, part.indices + curve.firstIndex + curve.nbIndices);
+                    }
+                    curveKeys[curve.style].push_back(curve.id);
+                }
+
+                Handle(Graphic3d_Buffer) nodes = new PackedBufferView<Graphic3d_Buffer>(owner, part.vertices,
+                    (size_t)part.nbVertices * sizeof(Graphic3d_Vec3), (int)sizeof(Graphic3d_Vec3), (int)part.nbVertices, 1);
+
+                std::map<uint32_t, std::vector<AIS_PackedCurves::Style>> layerStyles;
+                for (uint32_t s = 0; s < part.nbStyles; ++s)
+                {
+                    const Style& source = part.styles[s];
+                    AIS_PackedCurves::Style style;
+                    style.color = styleColor((uint16_t)s);
+                    style.lineType = (Aspect_TypeOfLine)source.lineType;
+                    style.width = source.width;
+                    if (!liveIndices.empty())
+                    {
+                        const std::vector<uint32_t>& live = liveIndices[s];
+                        if (live.empty()) continue;
+                        Handle(Graphic3d_IndexBuffer) indices = new Graphic3d_IndexBuffer(Graphic3d_Buffer::DefaultAllocator());
+                        indices->InitInt32((int)live.size());
+                        std::memcpy(indices->ChangeData(), live.data(), live.size() * sizeof(uint32_t));
+                        style.indices = indices;
+                    }
+                    else if (source.nbIndices > 0)
+                    {
+                        style.indices = new PackedBufferView<Graphic3d_IndexBuffer>(owner,
+                            reinterpret_cast<const uint8_t*>(part.indices + source.firstIndex),
+                            (size_t)source.nbIndices * sizeof(uint32_t), (int)sizeof(uint32_t), (int)source.nbIndices, 0);
+                    }
+                    if (style.indices.IsNull()) continue;
+                    style.curveStarts.swap(curveStarts[s]);
+                    style.curveKeys.swap(curveKeys[s]);
+                    layerStyles[source.layer].push_back(style);
+                }
+
+                // Extents of each layer's live curves, so a hidden layer does not widen FitAll
+                std::map<uint32_t, Bnd_Box> layerBoxes;
+                for (uint32_t i = 0; i < part.nbCurves; ++i)
+                {
+                    const Entity& curve = part.entities[i];
+                    if (!project->IsLive(p, curve)) continue;
+                    layerBoxes[curve.layer].Update(curve.bounds[0], curve.bounds[1], part.boxMin[2] - origin.Z(),
+                        curve.bounds[2], curve.bounds[3], part.boxMax[2] - origin.Z());
+                }
+
+                for (const auto& entry : layerStyles)
+                {
+                    auto box = layerBoxes.find(entry.first);
+                    if (box == layerBoxes.end()) continue;
+
+                    ProjectCurves curves;
+                    curves.part = p;
+                    curves.layer = entry.first;
+                    curves.object = new AIS_PackedCurves(nodes, entry.second, origin, box->second);
+                    useLayer(entry.first);
+                    SelectionHelper::DisplayDeferred(native, context, curves.object);
+                    project->curves.push_back(curves);
+                }
+                nbCurves += part.nbCurves;
+            }
+
+            for (uint32_t i = part.nbCurves; i < part.nbCurves + part.nbTexts; ++i)
+            {
+                const Entity& text = part.entities[i];
+                if (!project->IsLive(p, text)) continue;
+                if (text.nbVertices < 1 || text.firstVertex >= part.nbVertices
+                    || text.blobOffset > part.stringsSize || text.blobSize > part.stringsSize - text.blobOffset)
+                    continue;
+
+                const double* anchor = part.exactVertices + 3 * (size_t)text.firstVertex;
+                const std::string utf8(part.strings + text.blobOffset, (size_t)text.blobSize);
+
+                Handle(AIS_TextLabel) label = new AIS_TextLabel();
+                label->SetPosition(gp_Pnt(anchor[0], anchor[1], anchor[2]));
+                label->SetText(TCollection_ExtendedString(utf8.c_str(), Standard_True));
+                label->SetColor(styleColor(text.style));
+                if (text.param > 0.0f) label->SetHeight(text.param);
+                useLayer(text.layer);
+                const uint16_t layer = layers.Place(native, label);
+                context->Display(label, Standard_False);
+                native->aisLabels.push_back(label);
+                native->document.Register(label, layer);
+                loaded.emplace_back(label, text.id);
+                ++nbTexts;
+            }
+
+            for (uint32_t i = part.nbCurves + part.nbTexts; i < part.nbEntities; ++i)
+            {
+                const Entity& record = part.entities[i];
+                if (!project->IsLive(p, record)) continue;
+                if (record.blobOffset > part.blobsSize || record.blobSize > part.blobsSize - record.blobOffset)
+                {
+                    ++nbFailed;
+                    continue;
+                }
+
+                TopoDS_Shape shape;
+                try
+                {
+                    MemoryBuffer buffer(part.blobs + record.blobOffset, (size_t)record.blobSize);
+                    std::istream in(&buffer);
+                    BinTools::Read(shape, in);
+                }
+                catch (Standard_Failure&)
+                {
+                }
+                if (shape.IsNull())
+                {
+                    ++nbFailed;
+                    continue;
+                }
+
+                Handle(AIS_Shape) ais = new AIS_Shape(shape);
+                ais->SetColor(styleColor(record.style));
+                ais->SetDisplayMode((record.flags & Flag_Shaded) ? AIS_Shaded : AIS_WireFrame);
+                if (record.param > 0.0f) ais->SetTransparency(record.param);
+                useLayer(record.layer);
+
+                if (record.flags & Flag_Solid)
+                {
+                    // Meshes come back with the blob; the service only refines them
+                    MeshingService::Of(native).Submit(ais, native->view);
+                    const uint16_t layer = layers.Place(native, ais);
+                    context->Display(ais, Standard_False);
+                    native->document.Register(ais, layer);
+                    native->persistedExtrusions.push_back(ais);
+                }
+                else
+                {
+                    SelectionHelper::DisplayDeferred(native, context, ais);
+                    native->ais2DShapes.push_back(ais);
+                }
+                loaded.emplace_back(ais, record.id);
+                ++nbShapes;
+            }
+        }
+
+        layers.SetCurrent(previousLayer < layers.Size() ? previousLayer : 0);
+        for (const auto& entry : layerFlags)
+        {
+            layers.SetVisible(native, entry.first, (entry.second & Layer_Hidden) == 0);
+            layers.SetFrozen(native, entry.first, (entry.second & Layer_Frozen) != 0);
+            layers.SetLocked(native, entry.first, (entry.second & Layer_Locked) != 0);
+        }
+
+        native->project = project;
+        ProjectSaver::Of(native).Adopt(native, project, loaded);
+
+        LayerTable::FitAll(native->view);
+        native->view->ZFitAll();
+        FrameScheduler::Redraw(native);
+
+        const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "✅ Project opened: " << nbCurves << " curves, " << nbTexts << " texts, " << nbShapes << " shapes, "
+            << project->parts.size() - 1 << " journal segments in " << ms << " ms" << std::endl;
+        if (nbFailed > 0)
+            std::cout << "⚠️ " << nbFailed << " shapes could not be read." << std::endl;
+        return true;
+    }
+}
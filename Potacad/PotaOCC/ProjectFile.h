@@ -0,0 +1,283 @@
+#pragma once
+#include "MappedFile.h"
+#include "AIS_PackedCurves.h"
+#include <AIS_InteractiveObject.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: save the scene as a native project and reopen it without re-parsing DXF
+    public ref class ProjectFilePublic
+    {
+    public:
+        // Queues the save and returns at once; only entities changed since the last save are written
+        static bool Save(System::IntPtr viewerHandlePtr, System::String^ path);
+
+        // Replaces the current scene with the project's contents
+        static bool Open(System::IntPtr viewerHandlePtr, System::String^ path);
+
+        // True while saves or a compaction are still being written
+        static bool IsSaving(System::IntPtr viewerHandlePtr);
+    };
+
+    // On-disk layout of a .pota project. All sections are plain arrays at 16-byte aligned offsets,
+    // listed in a directory after the header, so a reader maps the file and points into it.
+    // Curve vertices are floats relative to Header::origin, followed by the Graphic3d_Attribute
+    // descriptor Graphic3d_Buffer expects after its data; curve segment indices are grouped by style.
+    // Both go to the renderer as they are; the polyline is only a display cache of the curve. Exact
+    // coordinates and B-rep blobs are only read on demand: a curve made of straight edges is exactly
+    // its segments, any other curve keeps its edges as a blob.
+    // Every entity and style names a row of the Layers table; a style's curves are all on one layer.
+    // Incremental saves append journal segments after the base: a SegmentHeader followed by the
+    // same kind of sections (offsets relative to the segment), which add or replace entities by id
+    // and list removed ids. Each segment carries the whole layer table as it was at that save.
+    // A torn segment at the tail fails its checksum and is ignored.
+    namespace ProjectFormat
+    {
+        const uint32_t THE_MAGIC = 0x41544F50;      // "POTA"
+        const uint32_t THE_VERSION = 3;
+
+        enum SectionKind : uint32_t
+        {
+            Section_Entities = 1,   // Entity[], curves first, then texts, then shapes
+            Section_Styles,         // Style[]
+            Section_Layers,         // Layer[], names in Strings
+            Section_Vertices,       // float[3] per vertex + Graphic3d_Attribute
+            Section_ExactVertices,  // double[3] per vertex, world coordinates
+            Section_Indices,        // uint32 segment pairs, one range per style
+            Section_Strings,        // UTF-8, each string zero-terminated
+            Section_Blobs,          // BinTools shapes with their meshes, and curved edges
+            Section_Removed         // journal only: uint32 ids of entities dropped by the segment
+        };
+
+        enum EntityKind : uint8_t
+        {
+            Entity_Curve = 1,       // vertices + index range, blob = edges unless all are straight
+            Entity_Text,            // one vertex (anchor), string, param = height
+            Entity_Shape            // blob, param = transparency
+        };
+
+        enum EntityFlags : uint8_t
+        {
+            Flag_Shaded = 1,        // shapes displayed AIS_Shaded
+            Flag_Solid = 2          // shape contains solids
+        };
+
+        enum LayerFlags : uint32_t
+        {
+            Layer_Hidden = 1,
+            Layer_Frozen = 2,
+            Layer_Locked = 4
+        };
+
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t nbSections;
+            uint32_t nbLayers;
+            double origin[3];
+            double boxMin[3];       // world extents of everything in the file
+            double boxMax[3];
+            uint32_t nbCurves;
+            uint32_t nbTexts;
+            uint32_t nbShapes;
+            uint32_t nextId;        // entity ids below this are taken
+            uint64_t journalOffset; // first journal segment, = end of the base sections
+        };
+
+        const uint32_t THE_SEGMENT_MAGIC = 0x4C4E4A50;  // "PJNL"
+
+        struct SegmentHeader
+        {
+            uint32_t magic;
+            uint32_t nbSections;
+            uint64_t size;          // header included
+            uint64_t checksum;      // FNV-1a of the bytes after the header
+            double boxMin[3];       // extents of the entities added by the segment
+            double boxMax[3];
+            uint32_t nbCurves;
+            uint32_t nbTexts;
+            uint32_t nbShapes;
+            uint32_t reserved;
+        };
+
+        struct Section
+        {
+            uint32_t kind;
+            uint32_t reserved;
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct Entity
+        {
+            uint8_t kind;
+            uint8_t flags;
+            uint16_t style;
+            uint32_t layer;         // into Layers
+            uint32_t firstVertex;
+            uint32_t nbVertices;
+            uint32_t firstIndex;
+            uint32_t nbIndices;
+            float param;
+            uint32_t id;            // stable across saves; journal segments refer to it
+            float bounds[4];        // xMin, yMin, xMax, yMax relative to origin
+            uint64_t blobOffset;    // into Strings for texts, Blobs for shapes and curves
+            uint64_t blobSize;
+        };
+
+        struct Style
+        {
+            float color[3];
+            float width;
+            uint32_t lineType;      // Aspect_TypeOfLine
+            uint32_t firstIndex;
+            uint32_t nbIndices;
+            uint32_t layer;         // into Layers, shared by every curve of the style
+        };
+
+        struct Layer
+        {
+            uint32_t nameOffset;    // into Strings, UTF-8
+            uint32_t nameLength;
+            uint32_t flags;         // LayerFlags
+            uint32_t reserved;
+        };
+    }
+
+    // Sections of the base file or of one journal segment, pointing into the mapping
+    struct ProjectPart
+    {
+        const ProjectFormat::Entity* entities = nullptr;
+        const ProjectFormat::Style* styles = nullptr;
+        const ProjectFormat::Layer* layers = nullptr;
+        const uint8_t* vertices = nullptr;          // float[3] + trailing attribute descriptor
+        const double* exactVertices = nullptr;
+        const uint32_t* indices = nullptr;
+        const char* strings = nullptr;
+        const uint8_t* blobs = nullptr;
+        const uint32_t* removed = nullptr;
+        uint32_t nbEntities = 0;
+        uint32_t nbCurves = 0;
+        uint32_t nbTexts = 0;
+        uint32_t nbStyles = 0;
+        uint32_t nbLayers = 0;
+        uint32_t nbVertices = 0;
+        uint32_t nbIndices = 0;
+        uint32_t nbRemoved = 0;
+        uint64_t stringsSize = 0;
+        uint64_t blobsSize = 0;
+        double boxMin[3] = {};
+        double boxMax[3] = {};
+
+        std::string LayerName(uint32_t layer) const
+        {
+            if (layer >= nbLayers) return std::string();
+            return std::string(strings + layers[layer].nameOffset, layers[layer].nameLength);
+        }
+    };
+
+    // Packed curves of one part on one layer
+    struct ProjectCurves
+    {
+        int part = -1;
+        uint32_t layer = 0;                         // into the part's layers
+        Handle(AIS_PackedCurves) object;
+    };
+
+    // A project opened from disk: the base part followed by its journal segments
+    struct ProjectView
+    {
+        std::wstring path;
+        std::shared_ptr<MappedFile> file;
+        const ProjectFormat::Header* header = nullptr;
+        std::vector<ProjectPart> parts;
+        uint32_t nextId = 0;
+        uint64_t journalBytes = 0;
+
+        // Ids the journal touched: last part defining them, or -1 when removed. Others live where they are.
+        std::unordered_map<uint32_t, int> journaled;
+
+        std::vector<ProjectCurves> curves;          // live curves of each part and layer, drawn from the mapping
+
+        bool IsLive(int part, const ProjectFormat::Entity& record) const
+        {
+            auto it = journaled.find(record.id);
+            return it == journaled.end() || it->second == part;
+        }
+    };
+
+    // Layer as saved: UTF-8 name and ProjectFormat::LayerFlags
+    struct ProjectLayer
+    {
+        std::string name;
+        uint32_t flags = 0;
+
+        bool operator==(const ProjectLayer& other) const { return name == other.name && flags == other.flags; }
+    };
+
+    // Entity captured from the scene on the UI thread; serialized later on the save worker
+    struct ProjectItem
+    {
+        uint32_t id = 0;
+        bool isText = false;
+        TopoDS_Shape shape;                         // placed (local transformation applied); a mesh snapshot once queued
+        Quantity_Color color;
+        double width = 1.0;
+        Aspect_TypeOfLine lineType = Aspect_TOL_SOLID;
+        double transparency = 0.0;
+        bool isShaded = false;
+        std::string text;                           // UTF-8
+        gp_Pnt anchor;
+        double height = 0.0;
+        std::string layer;                          // UTF-8 layer name
+
+        bool IsSameContent(const ProjectItem& other) const;
+    };
+
+    class ProjectFile
+    {
+    public:
+        // Maps the file and displays it; the scene is expected to be empty
+        static bool Open(NativeViewerHandle* native, const std::wstring& path);
+
+        // Base file + valid journal segments; nullptr when the file is not a readable project
+        static std::shared_ptr<ProjectView> Map(const std::wstring& path);
+
+        // Rewrites path as a base file without journal: the items plus the live records of carried
+        // (curves of the listed carried->curves but the detached ids, or every live record when carryAll). The layer table
+        // starts with layers, then whatever else the entities name. Returns the file size.
+        static uint64_t WriteFull(const std::wstring& path, const std::vector<ProjectItem>& items,
+            const ProjectView* carried, const std::vector<int>& carriedCurves, const std::vector<uint32_t>& detached, bool carryAll, uint32_t nextId,
+            const std::vector<ProjectLayer>& layers);
+
+        // Appends a journal segment to an existing project. Returns the segment size, 0 on failure.
+        static uint64_t AppendSegment(const std::wstring& path, const std::vector<ProjectItem>& items,
+            const std::vector<uint32_t>& removed, const std::vector<ProjectLayer>& layers);
+
+        // Folds the journal back into the base
+        static uint64_t Compact(const std::wstring& path);
+
+        // Exact edges of a curve record: its blob, or its segments when every edge was straight
+        static TopoDS_Shape CurveGeometry(const ProjectPart& part, const ProjectFormat::Entity& record);
+
+        // Live curves of one packed-curves object as items (same ids), moved by placement and
+        // leaving out the detached ones; written instead of the records once the object was moved
+        static void CurveItems(const ProjectView& project, const ProjectCurves& curves, const gp_Trsf& placement,
+            const std::vector<uint32_t>& detached, std::vector<ProjectItem>& items);
+
+        // First edit of a packed curve: an AIS_Shape of its exact geometry takes its place on the same
+        // layer and is saved under the record's id. Null when the curve cannot be read.
+        static Handle(AIS_InteractiveObject) Materialize(NativeViewerHandle* native, const Handle(AIS_PackedCurveOwner)& owner);
+    };
+}
@@ -0,0 +1,553 @@
+#include "pch.h"
+#include "ProjectSaver.h"
+#include "NativeViewerHandle.h"
+#include <AIS_ColoredDrawer.hxx>
+#include <AIS_ColoredShape.hxx>
+#include <AIS_ConnectedInteractive.hxx>
+#include <AIS_TextLabel.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <Prs3d_TextAspect.hxx>
+#include <TCollection_AsciiString.hxx>
+#include <TCollection_ExtendedString.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        const uint64_t THE_MIN_COMPACT_BYTES = 1 << 20;     // journals below 1 MB are never worth a rewrite
+        const int THE_MAX_SEGMENTS = 64;                    // bounds the work Open does per segment
+
+        bool IsHelperObject(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj)
+        {
+            const AIS_InteractiveObject* helpers[] = {
+                native->box3D.get(), native->axisX.get(), native->axisY.get(), native->axisZ.get(),
+                native->centerMarker.get(), native->centerOverlay.get(), native->extrudePreview.get(), native->revolvePreview.get(),
+                native->revolveAxisObj.get(), native->revolveAxisShape.get(),
+                native->dimExtLine1Temp.get(), native->dimExtLine2Temp.get(), native->dimLineTemp.get(),
+                native->dimLabelTemp.get(), native->dimArrow1Temp.get(), native->dimArrow2Temp.get(),
+                native->highlightedFace.get(), native->hoverHighlightedFace.get(),
+                native->workingPlaneVisual.get(), native->workingPlaneAxis.get(),
+                native->selectionHighlight.get(), native->transformGroup.get() };
+            for (const AIS_InteractiveObject* helper : helpers)
+                if (helper != nullptr && helper == obj.get()) return true;
+            return false;
+        }
+
+        bool IsSameTrsf(const gp_Trsf& ta, const gp_Trsf& tb)
+        {
+            for (int row = 1; row <= 3; ++row)
+                for (int col = 1; col <= 4; ++col)
+                    if (ta.Value(row, col) != tb.Value(row, col)) return false;
+            return true;
+        }
+
+        // Topology-only copy carrying the faces' current triangulations. The MeshingService swaps
+        // refined meshes into the displayed shape on the UI thread while the worker serializes.
+        TopoDS_Shape MeshSnapshot(const TopoDS_Shape& shape)
+        {
+            if (!TopExp_Explorer(shape, TopAbs_FACE).More()) return shape;
+
+            BRepBuilderAPI_Copy copier(shape, Standard_False, Standard_False);
+            BRep_Builder builder;
+            TopTools_MapOfShape visited;
+            for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next())
+            {
+                const TopoDS_Face& face = TopoDS::Face(exp.Current());
+                if (!visited.Add(face)) continue;
+
+                TopLoc_Location location;
+                const Handle(Poly_Triangulation)& triangulation = BRep_Tool::Triangulation(face, location);
+                const TopTools_ListOfShape& copies = copier.Modified(face);
+                if (!triangulation.IsNull() && !copies.IsEmpty())
+                    builder.UpdateFace(TopoDS::Face(copies.First()), triangulation);
+            }
+            return copier.Shape();
+        }
+
+        // Locations are rebuilt from the object's transformation on every capture, so compare values
+        bool IsSamePlacement(const TopoDS_Shape& a, const TopoDS_Shape& b)
+        {
+            if (a.TShape() != b.TShape() || a.Orientation() != b.Orientation()) return false;
+            return IsSameTrsf(a.Location().Transformation(), b.Location().Transformation());
+        }
+
+        std::string Utf8(const std::wstring& name)
+        {
+            return TCollection_AsciiString(TCollection_ExtendedString(name.c_str())).ToCString();
+        }
+
+        std::string LayerOf(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj)
+        {
+            const int row = native->document.Find(obj);
+            const uint16_t layer = row >= 0 ? native->document.Layer(row) : 0;
+            return layer < native->layers.Size() ? Utf8(native->layers.Info(layer).name) : std::string("0");
+        }
+
+        std::vector<ProjectLayer> CaptureLayers(NativeViewerHandle* native)
+        {
+            std::vector<ProjectLayer> layers(native->layers.Size());
+            for (int l = 0; l < native->layers.Size(); ++l)
+            {
+                const LayerInfo& info = native->layers.Info((uint16_t)l);
+                layers[l].name = Utf8(info.name);
+                layers[l].flags = (info.isVisible ? 0 : ProjectFormat::Layer_Hidden)
+                    | (info.isFrozen ? ProjectFormat::Layer_Frozen : 0) | (info.isLocked ? ProjectFormat::Layer_Locked : 0);
+            }
+            return layers;
+        }
+    }
+
+    bool ProjectItem::IsSameContent(const ProjectItem& other) const
+    {
+        if (isText != other.isText || color != other.color || layer != other.layer) return false;
+        if (isText)
+            return text == other.text && anchor.IsEqual(other.anchor, 0.0) && height == other.height;
+        return width == other.width && lineType == other.lineType && transparency == other.transparency
+            && isShaded == other.isShaded && IsSamePlacement(shape, other.shape);
+    }
+
+    ProjectSaver::ProjectSaver()
+        : myNbQueued(0), myNeedsFullSave(false)
+    {
+    }
+
+    ProjectSaver::~ProjectSaver()
+    {
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            myIsStopping = true;
+        }
+        myWake.notify_all();
+        if (myWorker.joinable()) myWorker.join();
+    }
+
+    ProjectSaver& ProjectSaver::Of(NativeViewerHandle* native)
+    {
+        if (!native->projectSaver)
+            native->projectSaver = std::make_shared<ProjectSaver>();
+        return *native->projectSaver;
+    }
+
+    bool ProjectSaver::Capture(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, ProjectItem& item)
+    {
+        if (obj.IsNull() || IsHelperObject(native, obj) || !Handle(AIS_PackedCurves)::DownCast(obj).IsNull())
+            return false;
+
+        item.layer = LayerOf(native, obj);
+
+        if (Handle(AIS_TextLabel) label = Handle(AIS_TextLabel)::DownCast(obj))
+        {
+            const Handle(Prs3d_TextAspect)& aspect = label->Attributes()->TextAspect();
+            item.isText = true;
+            item.text = TCollection_AsciiString(label->Text()).ToCString();
+            item.color = aspect->Aspect()->Color();
+            item.height = aspect->Height();
+            item.anchor = label->Position();
+            if (label->HasTransformation())
+                item.anchor.Transform(label->LocalTransformation());
+            return true;
+        }
+
+        // Entities with geometry in the document are written from their row, not from the presentation
+        const int id = native->document.Find(obj);
+        const TopoDS_Shape geometry = id >= 0 ? native->document.Geometry(id) : TopoDS_Shape();
+        if (!geometry.IsNull())
+        {
+            const EntityStyle style = native->document.Style(id);
+            item.shape = geometry;
+            item.color = style.color;
+            item.width = style.width;
+            item.lineType = style.lineType;
+            item.transparency = style.transparency;
+            item.isShaded = style.isShaded;
+            return true;
+        }
+
+        Handle(AIS_Shape) ais = Handle(AIS_Shape)::DownCast(obj);
+        if (ais.IsNull() || ais->Shape().IsNull())
+            return false;
+
+        item.shape = ais->Shape();
+        if (ais->HasTransformation())
+            item.shape = item.shape.Moved(TopLoc_Location(ais->LocalTransformation()));
+
+        if (TopExp_Explorer(item.shape, TopAbs_FACE).More())
+        {
+            ais->Color(item.color);
+            item.width = ais->HasWidth() ? ais->Width() : 1.0;
+        }
+        else
+        {
+            const Handle(Prs3d_LineAspect)& aspect = ais->Attributes()->WireAspect();
+            item.color = aspect->Aspect()->Color();
+            item.width = aspect->Aspect()->Width();
+            item.lineType = aspect->Aspect()->Type();
+        }
+        item.transparency = ais->Transparency();
+        item.isShaded = ais->DisplayMode() == AIS_Shaded;
+        return true;
+    }
+
+    bool ProjectSaver::CaptureAll(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, std::vector<ProjectItem>& items)
+    {
+        if (obj.IsNull() || IsHelperObject(native, obj)) return false;
+        const size_t nbBefore = items.size();
+
+        // Arrays keep their template entities: each copy is written as those, moved by the instance
+        if (Handle(AIS_InstancedArray) array = Handle(AIS_InstancedArray)::DownCast(obj))
+        {
+            const std::vector<Handle(AIS_InteractiveObject)>* sources = native->arrays.Sources(array.get());
+            if (sources == nullptr) return false;
+
+            gp_Trsf shift;
+            shift.SetTranslation(gp_Vec(array->Origin().XYZ()));
+            const gp_Trsf placement = array->LocalTransformation() * shift.Inverted();
+            const std::string layer = LayerOf(native, obj);
+            for (const Handle(AIS_InteractiveObject)& source : *sources)
+            {
+                ProjectItem item;
+                if (!Capture(native, source, item) || item.isText) continue;
+                item.layer = layer;
+                for (const gp_Trsf& instance : array->Instances())
+                {
+                    items.push_back(item);
+                    items.back().shape = item.shape.Moved(TopLoc_Location(placement * instance));
+                }
+            }
+            return items.size() > nbBefore;
+        }
+
+        // Block inserts are drawn from their definition's prototype at the insert's placement
+        Handle(AIS_InteractiveObject) target = obj;
+        gp_Trsf placement;
+        if (Handle(AIS_ConnectedInteractive) connected = Handle(AIS_ConnectedInteractive)::DownCast(obj))
+        {
+            if (!connected->HasConnection()) return false;
+            target = connected->ConnectedTo();
+            placement = connected->LocalTransformation();
+        }
+
+        ProjectItem item;
+        if (!Capture(native, target, item)) return false;
+        item.layer = LayerOf(native, obj);
+
+        // A block's colours are sub-shapes with their own aspects; each becomes an entity
+        Handle(AIS_ColoredShape) colored = Handle(AIS_ColoredShape)::DownCast(target);
+        if (colored.IsNull() || colored->CustomAspectsMap().IsEmpty())
+        {
+            if (target != obj && item.isText) item.anchor.Transform(placement);
+            else if (target != obj) item.shape = item.shape.Moved(TopLoc_Location(placement));
+            items.push_back(item);
+            return true;
+        }
+
+        placement = placement * colored->LocalTransformation();
+        for (AIS_DataMapOfShapeDrawer::Iterator group(colored->CustomAspectsMap()); group.More(); group.Next())
+        {
+            const Handle(AIS_ColoredDrawer)& drawer = group.Value();
+            if (drawer->IsHidden()) continue;
+
+            items.push_back(item);
+            ProjectItem& part = items.back();
+            part.shape = group.Key().Moved(TopLoc_Location(placement));
+            if (TopExp_Explorer(part.shape, TopAbs_FACE).More())
+                part.color = drawer->ShadingAspect()->Color();
+            else
+                part.color = drawer->WireAspect()->Aspect()->Color();
+        }
+        return items.size() > nbBefore;
+    }
+
+    bool ProjectSaver::Save(NativeViewerHandle* native, const std::wstring& path)
+    {
+        Handle(AIS_InteractiveContext) context = native->context;
+
+        // Anything but appending to the file we last wrote is a full write
+        const bool isFull = myNeedsFullSave.exchange(false) || path != myPath
+            || !std::ifstream(path.c_str(), std::ios::binary).good();
+
+        std::unique_ptr<Job> job(new Job());
+        job->kind = isFull ? JobKind::Full : JobKind::Segment;
+        job->path = path;
+        job->project = myProject;
+        job->layers = CaptureLayers(native);
+
+        // Mark: every displayed entity either matches what was written or is captured again
+        std::unordered_map<const AIS_InteractiveObject*, Tracked> tracked;
+        int nbSkipped = 0;
+        AIS_ListOfInteractive displayed;
+        context->DisplayedObjects(displayed);
+        for (AIS_ListOfInteractive::Iterator it(displayed); it.More(); it.Next())
+        {
+            const Handle(AIS_InteractiveObject)& obj = it.Value();
+            auto previous = myTracked.find(obj.get());
+
+            if (Handle(AIS_PackedCurves) curves = Handle(AIS_PackedCurves)::DownCast(obj))
+            {
+                if (previous == myTracked.end() || previous->second.curves < 0) continue;
+                const std::vector<uint32_t> detached = curves->DetachedKeys();
+                job->detached.insert(job->detached.end(), detached.begin(), detached.end());
+
+                // The records hold the curves as loaded: once moved, they are rewritten at the placement
+                Tracked entry = std::move(previous->second);
+                myTracked.erase(previous);
+                const gp_Trsf placement = curves->Placement();
+                if (isFull ? curves->HasPlacement() : !IsSameTrsf(placement, entry.placement))
+                    job->movedCurves.emplace_back(entry.curves, placement);
+                else if (isFull)
+                    job->carriedCurves.push_back(entry.curves);
+                entry.placement = placement;
+                tracked.emplace(obj.get(), std::move(entry));
+                continue;
+            }
+
+            std::vector<ProjectItem> items;
+            if (!CaptureAll(native, obj, items))
+            {
+                if (!IsHelperObject(native, obj)) ++nbSkipped;
+                continue;
+            }
+
+            // Entities keep their ids by position; an object that now stands for fewer drops the rest
+            bool isSame = false;
+            if (previous != myTracked.end())
+            {
+                const std::vector<ProjectItem>& written = previous->second.items;
+                isSame = written.size() == items.size();
+                for (size_t i = 0; i < items.size(); ++i)
+                {
+                    if (i >= written.size())
+                    {
+                        items[i].id = myNextId++;
+                        continue;
+                    }
+                    items[i].id = written[i].id;
+                    isSame = isSame && written[i].IsSameContent(items[i]);
+                }
+                for (size_t i = items.size(); i < written.size() && !isFull; ++i)
+                    job->removed.push_back(written[i].id);
+                myTracked.erase(previous);
+            }
+            else
+            {
+                for (ProjectItem& item : items)
+                    item.id = myNextId++;
+            }
+
+            if (!isSame || isFull)
+            {
+                for (const ProjectItem& item : items)
+                {
+                    job->items.push_back(item);
+                    if (!item.isText) job->items.back().shape = MeshSnapshot(item.shape);
+                }
+            }
+            tracked.emplace(obj.get(), Tracked{ obj, std::move(items), -1 });
+        }
+
+        // Sweep: whatever was written but is no longer displayed leaves the file
+        if (!isFull)
+        {
+            for (const auto& entry : myTracked)
+            {
+                if (entry.second.curves >= 0)
+                {
+                    job->removedCurves.push_back(entry.second.curves);
+                    const std::vector<uint32_t> detached = Handle(AIS_PackedCurves)::DownCast(entry.second.object)->DetachedKeys();
+                    job->detached.insert(job->detached.end(), detached.begin(), detached.end());
+                }
+                else
+                {
+                    for (const ProjectItem& item : entry.second.items)
+                        job->removed.push_back(item.id);
+                }
+            }
+        }
+        myTracked.swap(tracked);
+        myPath = path;
+        job->nextId = myNextId;
+
+        // Layer states alone are worth a segment: it carries the whole table
+        const bool hasLayerChanges = !(job->layers == myLayers);
+        myLayers = job->layers;
+
+        if (nbSkipped > 0)
+            std::cout << "⚠️ " << nbSkipped << " objects are not supported by the project format and were skipped." << std::endl;
+
+        if (!isFull && job->items.empty() && job->removed.empty() && job->removedCurves.empty() && job->movedCurves.empty() && !hasLayerChanges)
+        {
+            std::cout << "✅ Project is up to date." << std::endl;
+            return true;
+        }
+
+        std::cout << "⏳ Saving project: " << job->items.size() + job->movedCurves.size() << " changed, "
+            << job->removed.size() + job->removedCurves.size() << " removed..." << std::endl;
+        Enqueue(std::move(job));
+        return true;
+    }
+
+    void ProjectSaver::Adopt(NativeViewerHandle* native, const std::shared_ptr<ProjectView>& project,
+        const std::vector<std::pair<Handle(AIS_InteractiveObject), uint32_t>>& objects)
+    {
+        myPath = project->path;
+        myProject = project;
+        myNextId = std::max<uint32_t>(project->nextId, 1);
+        myNeedsFullSave = false;
+
+        myLayers = CaptureLayers(native);
+
+        myTracked.clear();
+        for (int c = 0; c < (int)project->curves.size(); ++c)
+        {
+            const Handle(AIS_PackedCurves)& curves = project->curves[c].object;
+            if (!curves.IsNull())
+                myTracked.emplace(curves.get(), Tracked{ curves, std::vector<ProjectItem>(), c, curves->Placement() });
+        }
+        for (const auto& object : objects)
+        {
+            ProjectItem item;
+            if (!Capture(native, object.first, item)) continue;
+            item.id = object.second;
+            myTracked.emplace(object.first.get(), Tracked{ object.first, std::vector<ProjectItem>(1, item), -1 });
+        }
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        myBaseBytes = project->header->journalOffset;
+        myJournalBytes = project->journalBytes;
+        myNbSegments = (int)project->parts.size() - 1;
+    }
+
+    void ProjectSaver::Track(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, uint32_t id)
+    {
+        if (!myProject || myProject != native->project) return;
+
+        ProjectItem item;
+        if (!Capture(native, obj, item)) return;
+        item.id = id;
+        myTracked[obj.get()] = Tracked{ obj, std::vector<ProjectItem>(1, item), -1 };
+    }
+
+    void ProjectSaver::Flush()
+    {
+        std::unique_lock<std::mutex> lock(myMutex);
+        myIdle.wait(lock, [this] { return myNbQueued.load() == 0; });
+    }
+
+    void ProjectSaver::Enqueue(std::unique_ptr<Job> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            myQueue.push_back(std::move(job));
+            ++myNbQueued;
+        }
+        if (!myWorker.joinable())
+            myWorker = std::thread(&ProjectSaver::WorkerLoop, this);
+        myWake.notify_one();
+    }
+
+    void ProjectSaver::WorkerLoop()
+    {
+        for (;;)
+        {
+            std::unique_ptr<Job> job;
+            {
+                // Queued saves are finished even when stopping: the user asked for them
+                std::unique_lock<std::mutex> lock(myMutex);
+                myWake.wait(lock, [this] { return myIsStopping || !myQueue.empty(); });
+                if (myQueue.empty())
+                    return;
+                job = std::move(myQueue.front());
+                myQueue.pop_front();
+            }
+
+            Run(*job);
+
+            {
+                std::lock_guard<std::mutex> lock(myMutex);
+                --myNbQueued;
+            }
+            myIdle.notify_all();
+        }
+    }
+
+    void ProjectSaver::Run(Job& job)
+    {
+        if (job.project)
+        {
+            for (const auto& moved : job.movedCurves)
+                if (moved.first >= 0 && moved.first < (int)job.project->curves.size())
+                    ProjectFile::CurveItems(*job.project, job.project->curves[moved.first], moved.second, job.detached, job.items);
+        }
+
+        if (job.kind == JobKind::Full)
+        {
+            const uint64_t bytes = ProjectFile::WriteFull(job.path, job.items, job.project.get(), job.carriedCurves, job.detached, false, job.nextId, job.layers);
+            if (bytes == 0)
+            {
+                myNeedsFullSave = true;
+                return;
+            }
+            std::lock_guard<std::mutex> lock(myMutex);
+            myBaseBytes = bytes;
+            myJournalBytes = 0;
+            myNbSegments = 0;
+            return;
+        }
+
+        // Packed curves of the opened project are removed by the ids of their live records
+        if (job.project)
+        {
+            for (int c : job.removedCurves)
+            {
+                if (c < 0 || c >= (int)job.project->curves.size()) continue;
+                const ProjectCurves& curves = job.project->curves[c];
+                const ProjectPart& part = job.project->parts[curves.part];
+                for (uint32_t i = 0; i < part.nbCurves; ++i)
+                {
+                    const ProjectFormat::Entity& record = part.entities[i];
+                    if (record.layer == curves.layer && job.project->IsLive(curves.part, record)
+                        && std::find(job.detached.begin(), job.detached.end(), record.id) == job.detached.end())
+                        job.removed.push_back(record.id);
+                }
+            }
+        }
+
+        const uint64_t bytes = ProjectFile::AppendSegment(job.path, job.items, job.removed, job.layers);
+        if (bytes == 0)
+        {
+            myNeedsFullSave = true;
+            return;
+        }
+
+        bool isCompactDue = false;
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            myJournalBytes += bytes;
+            ++myNbSegments;
+            isCompactDue = (myJournalBytes > myBaseBytes / 2 && myJournalBytes > THE_MIN_COMPACT_BYTES)
+                || myNbSegments >= THE_MAX_SEGMENTS;
+        }
+        if (!isCompactDue)
+            return;
+
+        std::cout << "⏳ Compacting project journal..." << std::endl;
+        const uint64_t baseBytes = ProjectFile::Compact(job.path);
+        if (baseBytes == 0)
+            return;                             // the journal is still valid; retried after the next save
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        myBaseBytes = baseBytes;
+        myJournalBytes = 0;
+        myNbSegments = 0;
+    }
+}
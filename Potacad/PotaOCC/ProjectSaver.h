@@ -0,0 +1,105 @@
+#pragma once
+#include "ProjectFile.h"
+#include <AIS_InteractiveObject.hxx>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // Incremental project saving for one viewer.
+    // Save() runs on the UI thread but only diffs the scene against what was last written and
+    // captures the changed entities; tessellation, serialization and disk I/O happen on a worker.
+    // Saves to the file the project lives in append a journal segment; a new path gets a full write.
+    // Once the journal outgrows half the base, the worker compacts the file in place.
+    class ProjectSaver
+    {
+    public:
+        ProjectSaver();
+        ~ProjectSaver();                        // finishes queued saves, then joins the worker
+
+        ProjectSaver(const ProjectSaver&) = delete;
+        ProjectSaver& operator=(const ProjectSaver&) = delete;
+
+        static ProjectSaver& Of(NativeViewerHandle* native);
+
+        bool Save(NativeViewerHandle* native, const std::wstring& path);
+
+        // After Open: loaded objects are what the file already holds
+        void Adopt(NativeViewerHandle* native, const std::shared_ptr<ProjectView>& project,
+            const std::vector<std::pair<Handle(AIS_InteractiveObject), uint32_t>>& objects);
+
+        // A new object stands for record id of the project (a detached packed curve)
+        void Track(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, uint32_t id);
+
+        bool IsBusy() const { return myNbQueued.load() > 0; }
+
+        // Blocks until every queued job is on disk (before the file is mapped again)
+        void Flush();
+
+        // Entity as it would be saved; false for helpers and unsupported objects
+        static bool Capture(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, ProjectItem& item);
+
+        // Every entity an object stands for: block inserts become one item per colour of the block,
+        // arrays one item per template entity and copy. Appends to items; false when none is saved.
+        static bool CaptureAll(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, std::vector<ProjectItem>& items);
+
+    private:
+        enum class JobKind { Full, Segment };
+
+        struct Job
+        {
+            JobKind kind = JobKind::Full;
+            std::wstring path;
+            std::vector<ProjectItem> items;
+            std::vector<uint32_t> removed;
+            std::vector<int> removedCurves;     // packed curves of an opened project that left the scene
+            std::vector<int> carriedCurves;     // packed curves copied into a full write
+            std::vector<uint32_t> detached;     // ids of those curves that real entities stand for
+            std::vector<std::pair<int, gp_Trsf>> movedCurves;   // packed curves rewritten as items at their placement
+            std::vector<ProjectLayer> layers;
+            std::shared_ptr<ProjectView> project;
+            uint32_t nextId = 0;
+        };
+
+        struct Tracked
+        {
+            Handle(AIS_InteractiveObject) object;   // keeps the pointer key from being reused
+            std::vector<ProjectItem> items;         // content as written; one per entity the object stands for
+            int curves = -1;                        // index into ProjectView::curves, else -1
+            gp_Trsf placement;                      // packed curves: placement as written
+        };
+
+        void Enqueue(std::unique_ptr<Job> job);
+        void WorkerLoop();
+        void Run(Job& job);
+
+        // UI-thread state: what the file at myPath holds
+        std::wstring myPath;
+        std::shared_ptr<ProjectView> myProject;
+        std::unordered_map<const AIS_InteractiveObject*, Tracked> myTracked;
+        std::vector<ProjectLayer> myLayers;
+        uint32_t myNextId = 1;
+
+        // Worker state
+        std::mutex myMutex;
+        std::condition_variable myWake;
+        std::condition_variable myIdle;
+        std::deque<std::unique_ptr<Job>> myQueue;
+        std::thread myWorker;
+        bool myIsStopping = false;
+        std::atomic<int> myNbQueued;
+        std::atomic<bool> myNeedsFullSave;      // a write failed: the file no longer matches myTracked
+        uint64_t myBaseBytes = 0;
+        uint64_t myJournalBytes = 0;
+        int myNbSegments = 0;
+    };
+}
@@ -111,18 +111,7 @@ Handle(AIS_Shape) RectangleDrawer::DrawRectangle(
     aisRect->SetTransparency(0.2);
 
     // Remove previous overlay
-    if (!native->rectangleOverlay.IsNull())
-    {
-        try
-        {
-            context->Remove(native->rectangleOverlay, Standard_False);
-        }
-        catch (Standard_Failure& e)
-        {
-            std::cerr << "⚠️ Failed to remove previous overlay: " << e.GetMessageString() << std::endl;
-        }
-        native->rectangleOverlay.Nullify();
-    }
+    native->overlay.Hide(native);
 
     std::cout << "✅ Rectangle created successfully." << std::endl;
     return aisRect;
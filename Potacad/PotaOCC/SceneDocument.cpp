@@ -0,0 +1,663 @@
+#include "pch.h"
+#include "SceneDocument.h"
+#include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "SelectionHelper.h"
+#include "AIS_InstancedArray.h"
+#include "AIS_PackedCurves.h"
+#include <AIS_ConnectedInteractive.hxx>
+#include <AIS_Point.hxx>
+#include <AIS_Shape.hxx>
+#include <AIS_TextLabel.hxx>
+#include <Bnd_Box.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepBndLib.hxx>
+#include <BRep_Tool.hxx>
+#include <Geom_CartesianPoint.hxx>
+#include <OSD_Parallel.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <Prs3d_TextAspect.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace PotaOCC
+{
+    int SceneDocumentPublic::EntityCount(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        return native ? native->document.NbAlive() : 0;
+    }
+
+    int SceneDocumentPublic::Revision(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        return native ? (int)native->document.Revision() : 0;
+    }
+
+    int SceneDocumentPublic::Sync(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return 0;
+
+        const int nbChanged = native->document.Sync(native);
+        if (nbChanged > 0)
+        {
+            FrameScheduler::Redraw(native);
+        }
+        return nbChanged;
+    }
+
+    // Below this many rows a region query is not worth spreading over threads
+    static const int kParallelThreshold = 65536;
+    static const int kChunkSize = 16384;
+
+    static EntityBounds Unbounded()
+    {
+        EntityBounds bounds;
+        bounds.xMin = bounds.yMin = -std::numeric_limits<double>::max();
+        bounds.xMax = bounds.yMax = std::numeric_limits<double>::max();
+        return bounds;
+    }
+
+    EntityType SceneDocument::Classify(const Handle(AIS_InteractiveObject)& obj)
+    {
+        if (obj.IsNull()) return EntityType::Other;
+        if (!Handle(AIS_TextLabel)::DownCast(obj).IsNull()) return EntityType::Text;
+        if (!Handle(AIS_PackedCurves)::DownCast(obj).IsNull()) return EntityType::Batch;
+        if (!Handle(AIS_ConnectedInteractive)::DownCast(obj).IsNull()) return EntityType::Insert;
+        if (!Handle(AIS_InstancedArray)::DownCast(obj).IsNull()) return EntityType::Array;
+
+        Handle(AIS_Shape) ais = Handle(AIS_Shape)::DownCast(obj);
+        if (ais.IsNull() || ais->Shape().IsNull()) return EntityType::Other;
+        const TopoDS_Shape& shape = ais->Shape();
+
+        if (TopExp_Explorer(shape, TopAbs_SOLID).More()) return EntityType::Solid;
+        if (TopExp_Explorer(shape, TopAbs_FACE).More()) return EntityType::Face;
+
+        TopExp_Explorer edges(shape, TopAbs_EDGE);
+        if (!edges.More())
+            return TopExp_Explorer(shape, TopAbs_VERTEX).More() ? EntityType::Point : EntityType::Other;
+
+        const TopoDS_Edge edge = TopoDS::Edge(edges.Current());
+        edges.Next();
+        if (edges.More()) return EntityType::Polyline;
+
+        BRepAdaptor_Curve curve(edge);
+        switch (curve.GetType())
+        {
+        case GeomAbs_Line:
+            return EntityType::Line;
+        case GeomAbs_Circle:
+        {
+            TopoDS_Vertex first, last;
+            TopExp::Vertices(edge, first, last);
+            return (!first.IsNull() && first.IsSame(last)) ? EntityType::Circle : EntityType::Arc;
+        }
+        case GeomAbs_Ellipse:
+            return EntityType::Ellipse;
+        case GeomAbs_BSplineCurve:
+        case GeomAbs_BezierCurve:
+            return EntityType::Spline;
+        default:
+            return EntityType::Other;
+        }
+    }
+
+    EntityStyle SceneDocument::StyleOf(const Handle(AIS_InteractiveObject)& obj)
+    {
+        EntityStyle style;
+        if (obj.IsNull()) return style;
+
+        const Handle(Prs3d_Drawer)& drawer = obj->Attributes();
+        Handle(AIS_TextLabel) label = Handle(AIS_TextLabel)::DownCast(obj);
+        if (!label.IsNull())
+        {
+            if (!drawer.IsNull() && !drawer->TextAspect().IsNull())
+                style.color = drawer->TextAspect()->Aspect()->Color();
+            return style;
+        }
+
+        const Handle(Prs3d_LineAspect) wire = drawer.IsNull() ? Handle(Prs3d_LineAspect)() : drawer->WireAspect();
+        if (obj->HasColor())
+            obj->Color(style.color);
+        else if (!wire.IsNull())
+            style.color = wire->Aspect()->Color();
+
+        if (obj->HasWidth())
+            style.width = obj->Width();
+        else if (!wire.IsNull())
+            style.width = wire->Aspect()->Width();
+
+        if (!wire.IsNull())
+            style.lineType = wire->Aspect()->Type();
+        style.transparency = obj->Transparency();
+        style.isShaded = obj->DisplayMode() == AIS_Shaded;
+        return style;
+    }
+
+    Handle(AIS_InteractiveObject) SceneDocument::Derive(EntityType type, const TopoDS_Shape& shape, const EntityStyle& style)
+    {
+        if (shape.IsNull()) return Handle(AIS_InteractiveObject)();
+
+        // Points keep the marker of AIS_Point rather than the vertex cross of AIS_Shape
+        if (type == EntityType::Point && shape.ShapeType() == TopAbs_VERTEX)
+        {
+            Handle(AIS_Point) point = new AIS_Point(new Geom_CartesianPoint(BRep_Tool::Pnt(TopoDS::Vertex(shape))));
+            point->SetColor(style.color);
+            point->SetWidth(style.width);
+            if (style.transparency > 0.0)
+                point->SetTransparency(style.transparency);
+            return point;
+        }
+
+        // SetColor gives the shape its own line and wire aspects, so the line type stays on this object
+        Handle(AIS_Shape) ais = new AIS_Shape(shape);
+        ais->SetColor(style.color);
+        ais->SetWidth(style.width);
+        ais->Attributes()->LineAspect()->SetTypeOfLine(style.lineType);
+        ais->Attributes()->WireAspect()->SetTypeOfLine(style.lineType);
+        if (style.transparency > 0.0)
+            ais->SetTransparency(style.transparency);
+        ais->SetDisplayMode(style.isShaded ? AIS_Shaded : AIS_WireFrame);
+        return ais;
+    }
+
+    // Shape as placed in the world: the presentation's location folded into the TopoDS location
+    TopoDS_Shape SceneDocument::WorldGeometry(const Handle(AIS_InteractiveObject)& obj)
+    {
+        Handle(AIS_Shape) ais = Handle(AIS_Shape)::DownCast(obj);
+        if (ais.IsNull() || ais->Shape().IsNull()) return TopoDS_Shape();
+        if (!ais->HasTransformation()) return ais->Shape();
+        return ais->Shape().Moved(TopLoc_Location(ais->LocalTransformation()));
+    }
+
+    // Safe off the UI thread: bounds from the exact geometry, never from a triangulation being built
+    EntityBounds SceneDocument::BoundsOf(const TopoDS_Shape& shape)
+    {
+        if (shape.IsNull()) return Unbounded();
+
+        Bnd_Box box;
+        BRepBndLib::Add(shape, box, Standard_False);
+        if (box.IsVoid()) return Unbounded();
+
+        EntityBounds bounds;
+        Standard_Real zMin, zMax;
+        box.Get(bounds.xMin, bounds.yMin, zMin, bounds.xMax, bounds.yMax, zMax);
+        return bounds;
+    }
+
+    uint32_t SceneDocument::Intern(const EntityStyle& style)
+    {
+        const StyleKey key(style.color.Red(), style.color.Green(), style.color.Blue(),
+            style.width, (int)style.lineType, style.transparency, style.isShaded);
+
+        auto it = myStyleIndex.find(key);
+        if (it != myStyleIndex.end()) return it->second;
+
+        const uint32_t index = (uint32_t)myStyles.size();
+        myStyles.push_back(style);
+        myStyleIndex.emplace(key, index);
+        return index;
+    }
+
+    SceneDocument::EntityId SceneDocument::AddRow(EntityType type, uint16_t layer, uint32_t style, const TopoDS_Shape& shape,
+        const EntityBounds& bounds, const Handle(AIS_InteractiveObject)& presentation, uint8_t flags)
+    {
+        const EntityId id = (EntityId)myTypes.size();
+        myTypes.push_back(type);
+        myLayers.push_back(layer);
+        myStyleIds.push_back(style);
+        myShapes.push_back(shape);
+        myBounds.push_back(bounds);
+        myRevisions.push_back(++myRevision);
+        myFlags.push_back(flags);
+        myPresentations.push_back(presentation);
+
+        if (!presentation.IsNull()) myIds[presentation.get()] = id;
+        if (flags & Flag_Alive) ++myNbAlive;
+        if (flags & Flag_AnyDirty) myDirty.push_back(id);
+        return id;
+    }
+
+    void SceneDocument::Touch(EntityId id, uint8_t dirtyBits)
+    {
+        myRevisions[id] = ++myRevision;
+        if (dirtyBits == 0) return;
+
+        // Queued once until Sync picks it up, however many edits pile up on it
+        if ((myFlags[id] & Flag_AnyDirty) == 0) myDirty.push_back(id);
+        myFlags[id] |= dirtyBits;
+    }
+
+    SceneDocument::EntityId SceneDocument::Register(const Handle(AIS_InteractiveObject)& obj, const EntityBounds& bounds, uint16_t layer)
+    {
+        if (obj.IsNull()) return -1;
+
+        // Everything read from the presentation is gathered before taking the lock
+        const TopoDS_Shape shape = WorldGeometry(obj);
+        std::lock_guard<std::mutex> lock(myMutex);
+
+        auto it = myIds.find(obj.get());
+        if (it != myIds.end())
+        {
+            const EntityId id = it->second;
+            if (!shape.IsNull()) myShapes[id] = shape;      // a derived point presentation carries no shape
+            myBounds[id] = bounds;
+            if ((myFlags[id] & Flag_Alive) == 0) { myFlags[id] |= Flag_Alive; ++myNbAlive; }
+            Touch(id, 0);
+            return id;
+        }
+
+        return AddRow(Classify(obj), layer, Intern(StyleOf(obj)), shape, bounds, obj, Flag_Alive);
+    }
+
+    SceneDocument::EntityId SceneDocument::Register(const Handle(AIS_InteractiveObject)& obj, uint16_t layer)
+    {
+        if (obj.IsNull()) return -1;
+
+        Handle(AIS_TextLabel) label = Handle(AIS_TextLabel)::DownCast(obj);
+        if (!label.IsNull())
+        {
+            const gp_Pnt& anchor = label->Position();
+            EntityBounds bounds;
+            bounds.xMin = bounds.xMax = anchor.X();
+            bounds.yMin = bounds.yMax = anchor.Y();
+            return Register(obj, bounds, layer);
+        }
+
+        const TopoDS_Shape shape = WorldGeometry(obj);
+        if (!shape.IsNull()) return Register(obj, BoundsOf(shape), layer);
+
+        Bnd_Box box;
+        obj->BoundingBox(box);
+        if (box.IsVoid()) return Register(obj, Unbounded(), layer);
+        if (obj->HasTransformation()) box = box.Transformed(obj->Transformation());
+
+        EntityBounds bounds;
+        Standard_Real zMin, zMax;
+        box.Get(bounds.xMin, bounds.yMin, zMin, bounds.xMax, bounds.yMax, zMax);
+        return Register(obj, bounds, layer);
+    }
+
+    void SceneDocument::Refresh(const Handle(AIS_InteractiveObject)& obj, const EntityBounds& bounds)
+    {
+        if (obj.IsNull()) return;
+        const TopoDS_Shape shape = WorldGeometry(obj);
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        auto it = myIds.find(obj.get());
+        if (it == myIds.end()) return;
+
+        if (!shape.IsNull()) myShapes[it->second] = shape;
+        myBounds[it->second] = bounds;
+        Touch(it->second, 0);
+    }
+
+    void SceneDocument::Shown(const Handle(AIS_InteractiveObject)& obj, bool isShown)
+    {
+        if (obj.IsNull()) return;
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        auto it = myIds.find(obj.get());
+        if (it == myIds.end()) return;
+
+        const EntityId id = it->second;
+        if (((myFlags[id] & Flag_Alive) != 0) == isShown) return;
+        myFlags[id] ^= Flag_Alive;
+        myNbAlive += isShown ? 1 : -1;
+        Touch(id, 0);
+    }
+
+    void SceneDocument::Release(const Handle(AIS_InteractiveObject)& obj)
+    {
+        if (obj.IsNull()) return;
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        auto it = myIds.find(obj.get());
+        if (it == myIds.end()) return;
+
+        const EntityId id = it->second;
+        myIds.erase(it);
+        if ((myFlags[id] & Flag_Alive) != 0) --myNbAlive;
+        myFlags[id] = 0;
+        myPresentations[id].Nullify();
+        myShapes[id].Nullify();
+        Touch(id, 0);
+    }
+
+    SceneDocument::EntityId SceneDocument::Create(EntityType type, const TopoDS_Shape& shape, const EntityStyle& style, uint16_t layer)
+    {
+        if (shape.IsNull()) return -1;
+        const EntityBounds bounds = BoundsOf(shape);
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        return AddRow(type, layer, Intern(style), shape, bounds, Handle(AIS_InteractiveObject)(), Flag_Alive | Flag_GeometryDirty);
+    }
+
+    bool SceneDocument::SetGeometry(EntityId id, const TopoDS_Shape& shape)
+    {
+        if (shape.IsNull()) return false;
+        const EntityBounds bounds = BoundsOf(shape);
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        if (!IsValid(id)) return false;
+
+        myShapes[id] = shape;
+        myBounds[id] = bounds;
+        Touch(id, Flag_GeometryDirty);
+        return true;
+    }
+
+    bool SceneDocument::SetStyle(EntityId id, const EntityStyle& style)
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        if (!IsValid(id)) return false;
+
+        const uint32_t index = Intern(style);
+        if (myStyleIds[id] == index) return true;
+        myStyleIds[id] = index;
+        Touch(id, Flag_StyleDirty);
+        return true;
+    }
+
+    bool SceneDocument::SetLayer(EntityId id, uint16_t layer)
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        if (!IsValid(id)) return false;
+
+        if (myLayers[id] == layer) return true;
+        myLayers[id] = layer;
+        Touch(id, 0);
+        return true;
+    }
+
+    bool SceneDocument::SetAlive(EntityId id, bool isAlive)
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        if (!IsValid(id)) return false;
+        if (myPresentations[id].IsNull() && myShapes[id].IsNull()) return false;     // released
+
+        if (((myFlags[id] & Flag_Alive) != 0) == isAlive) return true;
+        myFlags[id] ^= Flag_Alive;
+        myNbAlive += isAlive ? 1 : -1;
+        Touch(id, Flag_ShownDirty);
+        return true;
+    }
+
+    static void ApplyStyle(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj, const EntityStyle& style)
+    {
+        Handle(AIS_TextLabel) label = Handle(AIS_TextLabel)::DownCast(obj);
+        if (!label.IsNull())
+        {
+            label->SetColor(style.color);
+            context->Redisplay(label, Standard_False);
+            return;
+        }
+
+        // SetColor gives the object its own wire aspect, so the line type below does not leak into the defaults
+        context->SetColor(obj, style.color, Standard_False);
+        context->SetWidth(obj, style.width, Standard_False);
+        if (obj->Attributes()->HasOwnWireAspect())
+            obj->Attributes()->WireAspect()->SetTypeOfLine(style.lineType);
+        context->SetTransparency(obj, style.transparency, Standard_False);
+        context->SetDisplayMode(obj, style.isShaded ? AIS_Shaded : AIS_WireFrame, Standard_False);
+        context->Redisplay(obj, Standard_False);
+    }
+
+    int SceneDocument::Sync(NativeViewerHandle* native)
+    {
+        if (native == nullptr || native->context.IsNull()) return 0;
+        Handle(AIS_InteractiveContext) context = native->context;
+
+        struct Pending
+        {
+            EntityId id = -1;
+            uint8_t flags = 0;
+            EntityType type = EntityType::Other;
+            Handle(AIS_InteractiveObject) presentation;
+            TopoDS_Shape shape;
+            EntityStyle style;
+        };
+
+        // Snapshot the edits; the context is only touched once the lock is released
+        std::vector<Pending> pending;
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            pending.reserve(myDirty.size());
+            std::vector<EntityId> held;
+            for (EntityId id : myDirty)
+            {
+                if (IsFrozen(myLayers[id]))
+                {
+                    held.push_back(id);
+                    continue;
+                }
+
+                Pending item;
+                item.id = id;
+                item.flags = myFlags[id];
+                item.type = myTypes[id];
+                item.presentation = myPresentations[id];
+                item.shape = myShapes[id];
+                item.style = myStyles[myStyleIds[id]];
+                pending.push_back(item);
+                myFlags[id] &= (uint8_t)~Flag_AnyDirty;
+            }
+            myDirty.swap(held);
+        }
+        if (pending.empty()) return 0;
+
+        std::vector<Handle(AIS_InteractiveObject)> moved;
+        int nbCreated = 0;
+        for (Pending& item : pending)
+        {
+            const bool isAlive = (item.flags & Flag_Alive) != 0;
+
+            // Created through the document: the presentation is derived from the row
+            if (item.presentation.IsNull())
+            {
+                if (!isAlive || item.shape.IsNull()) continue;
+                Handle(AIS_InteractiveObject) presentation = Derive(item.type, item.shape, item.style);
+                {
+                    std::lock_guard<std::mutex> lock(myMutex);
+                    myPresentations[item.id] = presentation;
+                    myIds[presentation.get()] = item.id;
+                }
+                SelectionHelper::DisplayDeferred(native, context, presentation);
+                Handle(AIS_Shape) shape = Handle(AIS_Shape)::DownCast(presentation);
+                if (!shape.IsNull()) native->ais2DShapes.push_back(shape);
+                ++nbCreated;
+                continue;
+            }
+
+            Handle(AIS_Point) point = Handle(AIS_Point)::DownCast(item.presentation);
+            if ((item.flags & Flag_GeometryDirty) && !point.IsNull() && item.shape.ShapeType() == TopAbs_VERTEX)
+            {
+                point->SetComponent(new Geom_CartesianPoint(BRep_Tool::Pnt(TopoDS::Vertex(item.shape))));
+                context->Redisplay(point, Standard_False);
+                moved.push_back(point);
+            }
+
+            Handle(AIS_Shape) ais = Handle(AIS_Shape)::DownCast(item.presentation);
+            if ((item.flags & Flag_GeometryDirty) && !ais.IsNull() && !item.shape.IsNull())
+            {
+                // The presentation keeps its own location; its shape is the world geometry moved back under it
+                TopoDS_Shape local = item.shape;
+                if (ais->HasTransformation())
+                    local = item.shape.Moved(TopLoc_Location(ais->LocalTransformation()).Inverted());
+                ais->SetShape(local);
+                context->Redisplay(ais, Standard_False);
+                moved.push_back(ais);
+            }
+
+            if (item.flags & Flag_StyleDirty)
+                ApplyStyle(context, item.presentation, item.style);
+
+            if ((item.flags & Flag_ShownDirty) && isAlive != (bool)context->IsDisplayed(item.presentation))
+            {
+                if (isAlive)
+                    context->Display(item.presentation, Standard_False);
+                else
+                    context->Erase(item.presentation, Standard_False);
+            }
+        }
+
+        if (!moved.empty())
+            SelectionHelper::RefreshEntities(native, context, moved);
+
+        if ((int)pending.size() > nbCreated)
+            std::cout << "✅ Document: " << pending.size() - nbCreated << " edited entities applied to the scene." << std::endl;
+        return (int)pending.size();
+    }
+
+    void SceneDocument::SetLayerFrozen(uint16_t layer, bool isFrozen)
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        if (layer >= myIsLayerFrozen.size())
+        {
+            if (!isFrozen) return;
+            myIsLayerFrozen.resize((size_t)layer + 1, false);
+        }
+        myIsLayerFrozen[layer] = isFrozen;
+    }
+
+    SceneDocument::EntityId SceneDocument::Find(const Handle(AIS_InteractiveObject)& obj) const
+    {
+        if (obj.IsNull()) return -1;
+        std::lock_guard<std::mutex> lock(myMutex);
+        auto it = myIds.find(obj.get());
+        return it == myIds.end() ? -1 : it->second;
+    }
+
+    Handle(AIS_InteractiveObject) SceneDocument::Presentation(EntityId id) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return IsValid(id) ? myPresentations[id] : Handle(AIS_InteractiveObject)();
+    }
+
+    TopoDS_Shape SceneDocument::Geometry(EntityId id) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return IsValid(id) ? myShapes[id] : TopoDS_Shape();
+    }
+
+    EntityType SceneDocument::Type(EntityId id) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return IsValid(id) ? myTypes[id] : EntityType::Other;
+    }
+
+    uint16_t SceneDocument::Layer(EntityId id) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return IsValid(id) ? myLayers[id] : 0;
+    }
+
+    EntityStyle SceneDocument::Style(EntityId id) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return IsValid(id) ? myStyles[myStyleIds[id]] : EntityStyle();
+    }
+
+    bool SceneDocument::IsAlive(EntityId id) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return IsValid(id) && (myFlags[id] & Flag_Alive) != 0;
+    }
+
+    int SceneDocument::Size() const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return (int)myTypes.size();
+    }
+
+    int SceneDocument::NbAlive() const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return myNbAlive;
+    }
+
+    uint32_t SceneDocument::Revision() const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        return myRevision;
+    }
+
+    // Called with the lock held. Only the flag, type and bounds columns are read, so a scan stays in a few arrays.
+    void SceneDocument::Scan(const EntityBounds& region, int type, std::vector<EntityId>& ids) const
+    {
+        const int size = (int)myTypes.size();
+        auto scanRange = [&](int begin, int end, std::vector<EntityId>& out)
+        {
+            for (int id = begin; id < end; ++id)
+            {
+                if ((myFlags[id] & Flag_Alive) == 0) continue;
+                if (type >= 0 && (int)myTypes[id] != type) continue;
+                if (region.Overlaps(myBounds[id])) out.push_back(id);
+            }
+        };
+
+        if (size < kParallelThreshold)
+        {
+            scanRange(0, size, ids);
+            return;
+        }
+
+        const int nbChunks = (size + kChunkSize - 1) / kChunkSize;
+        std::vector<std::vector<EntityId>> chunks(nbChunks);
+        OSD_Parallel::For(0, nbChunks, [&](int chunk)
+        {
+            scanRange(chunk * kChunkSize, std::min(size, (chunk + 1) * kChunkSize), chunks[chunk]);
+        });
+
+        for (const std::vector<EntityId>& chunk : chunks)
+            ids.insert(ids.end(), chunk.begin(), chunk.end());
+    }
+
+    void SceneDocument::Query(const EntityBounds& region, std::vector<EntityId>& ids) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        Scan(region, -1, ids);
+    }
+
+    void SceneDocument::Query(const EntityBounds& region, EntityType type, std::vector<EntityId>& ids) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        Scan(region, (int)type, ids);
+    }
+
+    void SceneDocument::ChangedSince(uint32_t revision, std::vector<EntityId>& ids) const
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        for (int id = 0; id < (int)myRevisions.size(); ++id)
+            if (myRevisions[id] > revision) ids.push_back(id);
+    }
+
+    void SceneDocument::Clear()
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        myTypes.clear();
+        myLayers.clear();
+        myStyleIds.clear();
+        myShapes.clear();
+        myBounds.clear();
+        myRevisions.clear();
+        myFlags.clear();
+        myPresentations.clear();
+        myIds.clear();
+        myDirty.clear();
+        myIsLayerFrozen.clear();
+        myNbAlive = 0;
+
+        // Revisions keep counting so a consumer holding an old one sees the new rows as changed
+        ++myRevision;
+    }
+}
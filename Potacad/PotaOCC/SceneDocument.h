@@ -0,0 +1,159 @@
+#pragma once
+#include "EntityIndex.h"
+#include <AIS_InteractiveObject.hxx>
+#include <Aspect_TypeOfLine.hxx>
+#include <Quantity_Color.hxx>
+#include <TopoDS_Shape.hxx>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper: the viewer's entity document
+    public ref class SceneDocumentPublic
+    {
+    public:
+        static int EntityCount(System::IntPtr viewerHandlePtr);
+        static int Revision(System::IntPtr viewerHandlePtr);
+
+        // Applies edits made off the UI thread to the presentations; returns how many entities changed
+        static int Sync(System::IntPtr viewerHandlePtr);
+    };
+
+    enum class EntityType : uint8_t
+    {
+        Point, Line, Arc, Circle, Ellipse, Spline, Polyline, Face, Solid, Text, Batch, Insert, Array, Other
+    };
+
+    // Display attributes shared by many entities; the document stores an index into a table of these
+    struct EntityStyle
+    {
+        Quantity_Color color = Quantity_Color(Quantity_NOC_WHITE);
+        double width = 1.0;
+        Aspect_TypeOfLine lineType = Aspect_TOL_SOLID;
+        double transparency = 0.0;
+        bool isShaded = false;
+    };
+
+    // The scene's entities as parallel columns (type, layer, style, geometry, extent, revision).
+    // A row is the entity: the DXF batch drawers Create rows and Sync derives their AIS presentations,
+    // and edits made through the document (from any thread) reach the presentations on the next Sync.
+    // Saving, export and picking read a row's geometry and style rather than its presentation.
+    // Objects the document cannot describe (text, inserts, arrays, packed batches) and those still
+    // drawn directly by the interactive tools are registered through the display, index, refresh and
+    // journal funnels; their rows carry the world geometry and style the object showed.
+    // Each change stamps the row with a new revision, so a consumer that remembers the revision it
+    // last saw gets the changed rows without walking the scene.
+    class SceneDocument
+    {
+    public:
+        typedef int EntityId;
+
+        static EntityType Classify(const Handle(AIS_InteractiveObject)& obj);
+        static EntityStyle StyleOf(const Handle(AIS_InteractiveObject)& obj);
+
+        // Presentation of a row created through the document, styled on its own attributes; no context involved
+        static Handle(AIS_InteractiveObject) Derive(EntityType type, const TopoDS_Shape& shape, const EntityStyle& style);
+
+        // --- Presentation side (UI thread): drawers report what they displayed or changed ---
+
+        // Binds a displayed presentation to a new row on the given layer; an already bound presentation is refreshed
+        EntityId Register(const Handle(AIS_InteractiveObject)& obj, const EntityBounds& bounds, uint16_t layer = 0);
+        EntityId Register(const Handle(AIS_InteractiveObject)& obj, uint16_t layer = 0);
+
+        // Geometry or placement of the presentation changed
+        void Refresh(const Handle(AIS_InteractiveObject)& obj, const EntityBounds& bounds);
+
+        // Presentation erased (removed, undone) or shown again; nothing to apply on Sync
+        void Shown(const Handle(AIS_InteractiveObject)& obj, bool isShown);
+
+        // Erased presentation the history let go of: the row keeps its id, dead and without geometry
+        void Release(const Handle(AIS_InteractiveObject)& obj);
+
+        // --- Document side (any thread): applied to the presentations on the next Sync ---
+
+        EntityId Create(EntityType type, const TopoDS_Shape& shape, const EntityStyle& style, uint16_t layer = 0);
+        bool SetGeometry(EntityId id, const TopoDS_Shape& shape);
+        bool SetStyle(EntityId id, const EntityStyle& style);
+        bool SetLayer(EntityId id, uint16_t layer);
+        bool SetAlive(EntityId id, bool isAlive);
+
+        // UI thread: derives missing presentations and pushes pending edits to the context
+        int Sync(NativeViewerHandle* native);
+
+        // Rows on a frozen layer keep their edits pending until the layer is thawed
+        void SetLayerFrozen(uint16_t layer, bool isFrozen);
+
+        // --- Queries (any thread) ---
+
+        EntityId Find(const Handle(AIS_InteractiveObject)& obj) const;
+        Handle(AIS_InteractiveObject) Presentation(EntityId id) const;
+        TopoDS_Shape Geometry(EntityId id) const;
+        EntityType Type(EntityId id) const;
+        uint16_t Layer(EntityId id) const;
+        EntityStyle Style(EntityId id) const;
+        bool IsAlive(EntityId id) const;
+
+        int Size() const;
+        int NbAlive() const;
+        uint32_t Revision() const;
+
+        // Live rows overlapping the region, optionally of one type; large documents are scanned in parallel
+        void Query(const EntityBounds& region, std::vector<EntityId>& ids) const;
+        void Query(const EntityBounds& region, EntityType type, std::vector<EntityId>& ids) const;
+
+        // Rows (live or not) changed after the given revision, in id order
+        void ChangedSince(uint32_t revision, std::vector<EntityId>& ids) const;
+
+        void Clear();
+
+    private:
+        // Flag_Alive plus what Sync still has to push to the presentation
+        enum : uint8_t
+        {
+            Flag_Alive = 1, Flag_GeometryDirty = 2, Flag_StyleDirty = 4, Flag_ShownDirty = 8,
+            Flag_AnyDirty = Flag_GeometryDirty | Flag_StyleDirty | Flag_ShownDirty
+        };
+
+        typedef std::tuple<double, double, double, double, int, double, bool> StyleKey;
+
+        EntityId AddRow(EntityType type, uint16_t layer, uint32_t style, const TopoDS_Shape& shape,
+            const EntityBounds& bounds, const Handle(AIS_InteractiveObject)& presentation, uint8_t flags);
+        uint32_t Intern(const EntityStyle& style);
+        void Touch(EntityId id, uint8_t dirtyBits);
+        bool IsValid(EntityId id) const { return id >= 0 && id < (EntityId)myTypes.size(); }
+        bool IsFrozen(uint16_t layer) const { return layer < myIsLayerFrozen.size() && myIsLayerFrozen[layer]; }
+        void Scan(const EntityBounds& region, int type, std::vector<EntityId>& ids) const;
+
+        static TopoDS_Shape WorldGeometry(const Handle(AIS_InteractiveObject)& obj);
+        static EntityBounds BoundsOf(const TopoDS_Shape& shape);
+
+        mutable std::mutex myMutex;
+
+        // One entry per entity, indexed by EntityId
+        std::vector<EntityType> myTypes;
+        std::vector<uint16_t> myLayers;
+        std::vector<uint32_t> myStyleIds;
+        std::vector<TopoDS_Shape> myShapes;         // world geometry; null for rows without B-Rep
+        std::vector<EntityBounds> myBounds;
+        std::vector<uint32_t> myRevisions;
+        std::vector<uint8_t> myFlags;
+        std::vector<Handle(AIS_InteractiveObject)> myPresentations;
+
+        std::unordered_map<const AIS_InteractiveObject*, EntityId> myIds;
+        std::vector<EntityId> myDirty;              // rows edited since the last Sync
+        std::vector<bool> myIsLayerFrozen;
+
+        std::vector<EntityStyle> myStyles;
+        std::map<StyleKey, uint32_t> myStyleIndex;
+
+        uint32_t myRevision = 0;
+        int myNbAlive = 0;
+    };
+}
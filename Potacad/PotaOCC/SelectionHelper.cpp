@@ -0,0 +1,618 @@
+#include "pch.h"
+#include "SelectionHelper.h"
+#include "NativeViewerHandle.h"
+#include "ViewerManager.h"
+#include "ProjectFile.h"
+#include <AIS_Shape.hxx>
+#include <Bnd_Box.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <GCPnts_TangentialDeflection.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <Precision.hxx>
+#include <AIS_DataMapIteratorOfDataMapOfIOStatus.hxx>
+#include <Graphic3d_CView.hxx>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <limits>
+
+using namespace PotaOCC;
+
+namespace PotaOCC
+{
+    int SelectionHelperPublic::ActivatePendingSelection(System::IntPtr viewerHandlePtr, int budgetMs)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return 0;
+
+        return SelectionHelper::ActivateDeferredChunk(native, native->context, budgetMs);
+    }
+    int SelectionHelperPublic::PendingSelectionCount(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return 0;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return 0;
+
+        return (int)native->deferredSelection.size();
+    }
+
+    namespace SelectionHelper
+    {
+        static int CurrentMode(NativeViewerHandle* native)
+        {
+            return native->activeSelectionMode >= 0 ? native->activeSelectionMode : 0;
+        }
+        // False while the entity is erased: it stays pending until it is shown again. Removed ones are dropped.
+        static bool ActivateEntry(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const DeferredSelectionEntry& entry)
+        {
+            if (entry.object.IsNull()) return true;
+
+            const PrsMgr_DisplayStatus status = context->DisplayStatus(entry.object);
+            if (status == PrsMgr_DisplayStatus_Erased) return false;
+            if (status == PrsMgr_DisplayStatus_Displayed)
+                context->Activate(entry.object, CurrentMode(native));
+            return true;
+        }
+        static bool IsDeferred(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj)
+        {
+            // Pending entities are found through their index id; unindexed objects are never pending
+            const int id = native->entityIndex.Find(obj);
+            return id >= 0 && id < (int)native->deferredSlots.size() && native->deferredSlots[id] >= 0;
+        }
+        static EntityBounds ComputeBounds(const Handle(AIS_InteractiveObject)& obj)
+        {
+            EntityBounds bounds;
+
+            Bnd_Box box;
+            obj->BoundingBox(box);
+            if (box.IsVoid())
+            {
+                // Unknown extent: let any region query pick it up
+                bounds.xMin = bounds.yMin = -std::numeric_limits<double>::max();
+                bounds.xMax = bounds.yMax = std::numeric_limits<double>::max();
+                return bounds;
+            }
+
+            if (obj->HasTransformation())
+                box = box.Transformed(obj->Transformation());
+
+            Standard_Real zMin, zMax;
+            box.Get(bounds.xMin, bounds.yMin, zMin, bounds.xMax, bounds.yMax, zMax);
+            return bounds;
+        }
+        void DisplayDeferred(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj)
+        {
+            if (context.IsNull() || obj.IsNull()) return;
+            if (native == nullptr)
+            {
+                context->Display(obj, Standard_False);
+                return;
+            }
+
+            // Selection mode -1 = displayed but no sensitive entities computed
+            const uint16_t layer = native->layers.Place(native, obj);
+            const int dispMode = obj->HasDisplayMode() ? obj->DisplayMode() : context->DisplayMode();
+            context->Display(obj, dispMode, -1, Standard_False);
+
+            const EntityBounds bounds = ComputeBounds(obj);
+            const int id = native->entityIndex.Add(obj, bounds, layer);
+            native->document.Register(obj, bounds, layer);
+
+            DeferredSelectionEntry entry;
+            entry.object = obj;
+            entry.entityId = id;
+            if (id >= (int)native->deferredSlots.size())
+                native->deferredSlots.resize(id + 1, -1);
+            native->deferredSlots[id] = (int)native->deferredSelection.size();
+            native->deferredSelection.push_back(entry);
+        }
+        void DisplayDeferred(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj)
+        {
+            DisplayDeferred(ViewerRegistry::FindByContext(context.get()), context, obj);
+        }
+        void IndexEntity(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj)
+        {
+            if (native == nullptr || obj.IsNull()) return;
+            const uint16_t layer = native->layers.Place(native, obj);
+            const EntityBounds bounds = ComputeBounds(obj);
+            native->entityIndex.Add(obj, bounds, layer);
+            native->document.Register(obj, bounds, layer);
+            NoteDisplayed(native, obj);
+        }
+        void NoteDisplayed(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj)
+        {
+            if (native == nullptr || obj.IsNull() || native->activeSelectionMode < 0) return;
+            native->selectionModeQueue.push_back(obj);
+        }
+        static void ApplySelectionMode(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj, int mode)
+        {
+            if (IsDeferred(native, obj) || !context->IsDisplayed(obj)) return;
+
+            // Objects already in exactly this mode keep their sensitives
+            TColStd_ListOfInteger modes;
+            context->ActivatedModes(obj, modes);
+            if (modes.Extent() == 1 && modes.First() == mode) return;
+
+            context->Deactivate(obj);
+            context->Activate(obj, mode);
+        }
+        void SetSelectionMode(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, TopAbs_ShapeEnum shapeType)
+        {
+            if (context.IsNull()) return;
+
+            const int mode = AIS_Shape::SelectionMode(shapeType);
+            if (native == nullptr)
+            {
+                context->Deactivate();
+                context->Activate(mode);
+                return;
+            }
+
+            // Same mode: only the objects shown since the last pass can be in another one
+            std::vector<Handle(AIS_InteractiveObject)> shown;
+            shown.swap(native->selectionModeQueue);
+            if (native->activeSelectionMode == mode)
+            {
+                for (const Handle(AIS_InteractiveObject)& obj : shown)
+                    ApplySelectionMode(native, context, obj, mode);
+                return;
+            }
+
+            // The mode itself changed (or was never applied): every shown object switches
+            native->activeSelectionMode = mode;
+            for (AIS_DataMapIteratorOfDataMapOfIOStatus it = context->ObjectIterator(); it.More(); it.Next())
+                ApplySelectionMode(native, context, it.Key(), mode);
+        }
+        // View-volume footprint of a pixel rectangle on the XY plane: the 12 edges of the rectangle's
+        // frustum, clipped to the depth slab the scene occupies, bound the region any camera can pick there
+        static bool RegionFootprint(const Handle(V3d_View)& view, int xMin, int yMin, int xMax, int yMax, EntityBounds& rect)
+        {
+            if (view->Window().IsNull()) return false;
+            Standard_Integer width = 0, height = 0;
+            view->Window()->Size(width, height);
+            if (width <= 0 || height <= 0) return false;
+
+            const Bnd_Box scene = view->View()->MinMaxValues();
+            if (scene.IsVoid()) return false;
+            Standard_Real sxMin, syMin, szMin, sxMax, syMax, szMax;
+            scene.Get(sxMin, syMin, szMin, sxMax, syMax, szMax);
+
+            // Near plane corners 0-3, far plane corners 4-7
+            const Handle(Graphic3d_Camera)& camera = view->Camera();
+            const int px[4] = { xMin, xMax, xMax, xMin };
+            const int py[4] = { yMin, yMin, yMax, yMax };
+            gp_Pnt corners[8];
+            for (int i = 0; i < 4; ++i)
+            {
+                const double ndcX = 2.0 * px[i] / width - 1.0;
+                const double ndcY = 1.0 - 2.0 * py[i] / height;
+                corners[i] = camera->UnProject(gp_Pnt(ndcX, ndcY, -1.0));
+                corners[i + 4] = camera->UnProject(gp_Pnt(ndcX, ndcY, 1.0));
+            }
+
+            static const int THE_EDGES[12][2] = {
+                { 0, 1 }, { 1, 2 }, { 2, 3 }, { 3, 0 },
+                { 4, 5 }, { 5, 6 }, { 6, 7 }, { 7, 4 },
+                { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+
+            bool hasPoint = false;
+            rect.xMin = rect.yMin = std::numeric_limits<double>::max();
+            rect.xMax = rect.yMax = -std::numeric_limits<double>::max();
+            for (int e = 0; e < 12; ++e)
+            {
+                const gp_Pnt& a = corners[THE_EDGES[e][0]];
+                const gp_Pnt& b = corners[THE_EDGES[e][1]];
+
+                double t0 = 0.0, t1 = 1.0;
+                const double dz = b.Z() - a.Z();
+                if (std::abs(dz) <= Precision::Confusion())
+                {
+                    if (a.Z() < szMin || a.Z() > szMax) continue;
+                }
+                else
+                {
+                    double ta = (szMin - a.Z()) / dz, tb = (szMax - a.Z()) / dz;
+                    if (ta > tb) std::swap(ta, tb);
+                    t0 = std::max(t0, ta);
+                    t1 = std::min(t1, tb);
+                    if (t0 > t1) continue;
+                }
+
+                const double ts[2] = { t0, t1 };
+                for (double t : ts)
+                {
+                    const double x = a.X() + (b.X() - a.X()) * t;
+                    const double y = a.Y() + (b.Y() - a.Y()) * t;
+                    rect.xMin = std::min(rect.xMin, x); rect.xMax = std::max(rect.xMax, x);
+                    rect.yMin = std::min(rect.yMin, y); rect.yMax = std::max(rect.yMax, y);
+                    hasPoint = true;
+                }
+            }
+            return hasPoint;
+        }
+        static void RemoveDeferred(NativeViewerHandle* native, int slot)
+        {
+            std::vector<DeferredSelectionEntry>& pending = native->deferredSelection;
+            native->deferredSlots[pending[slot].entityId] = -1;
+
+            // Swap-remove; the moved entry's slot follows it
+            if (slot + 1 != (int)pending.size())
+            {
+                pending[slot] = pending.back();
+                native->deferredSlots[pending[slot].entityId] = slot;
+            }
+            pending.pop_back();
+        }
+        void ActivateDeferredAt(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view, int x, int y)
+        {
+            if (native == nullptr || native->deferredSelection.empty()) return;
+
+            // A few pixels more than the picking tolerance so neighbours are ready for the next move
+            const int margin = context->PixelTolerance() + 8;
+            ActivateDeferredInRegion(native, context, view, x - margin, y - margin, x + margin, y + margin);
+        }
+        void ActivateDeferredInRegion(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view, int xMin, int yMin, int xMax, int yMax)
+        {
+            if (native == nullptr || context.IsNull() || view.IsNull()) return;
+            if (native->deferredSelection.empty()) return;
+
+            EntityBounds rect;
+            if (!RegionFootprint(view, xMin, yMin, xMax, yMax, rect)) return;
+
+            // The index returns the few entities near the cursor; only those still pending are activated
+            std::vector<int> ids, boundary;
+            native->entityIndex.QueryTouching(rect, ids, boundary);
+            ids.insert(ids.end(), boundary.begin(), boundary.end());
+            for (int id : ids)
+            {
+                if (id >= (int)native->deferredSlots.size()) continue;
+                const int slot = native->deferredSlots[id];
+                if (slot < 0) continue;
+
+                if (ActivateEntry(native, context, native->deferredSelection[slot]))
+                    RemoveDeferred(native, slot);
+            }
+        }
+        int ActivateDeferredChunk(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, int budgetMs)
+        {
+            if (native == nullptr || context.IsNull()) return 0;
+
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(budgetMs, 1));
+            std::vector<DeferredSelectionEntry>& pending = native->deferredSelection;
+
+            // Back to front, so the entry a removal swaps into a slot has been visited already
+            int processed = 0;
+            int nbErased = 0;
+            for (int slot = (int)pending.size() - 1; slot >= 0; --slot)
+            {
+                if (ActivateEntry(native, context, pending[slot]))
+                    RemoveDeferred(native, slot);
+                else
+                    ++nbErased;
+
+                // Checking the clock every entity costs more than activating a line
+                if ((++processed & 127) == 0 && std::chrono::steady_clock::now() >= deadline)
+                    break;
+            }
+
+            // Erased entities wait for the hover or undo that shows them again; the idle pump stops for them
+            return (int)pending.size() - nbErased;
+        }
+        void ClearDeferred(NativeViewerHandle* native)
+        {
+            if (native == nullptr) return;
+            native->deferredSelection.clear();
+            native->deferredSelection.shrink_to_fit();
+            native->deferredSlots.clear();
+            native->deferredSlots.shrink_to_fit();
+            native->selectionModeQueue.clear();
+            native->activeSelectionMode = -1;
+        }
+        static void TessellateShape(const TopoDS_Shape& shape, const gp_Trsf* trsf, std::vector<gp_Pnt>& points, std::vector<int>& starts)
+        {
+            for (TopExp_Explorer exp(shape, TopAbs_EDGE); exp.More(); exp.Next())
+            {
+                const TopoDS_Edge& edge = TopoDS::Edge(exp.Current());
+                BRepAdaptor_Curve curve(edge);
+                const size_t first = points.size();
+                starts.push_back((int)first);
+
+                if (curve.GetType() == GeomAbs_Line)
+                {
+                    points.push_back(curve.Value(curve.FirstParameter()));
+                    points.push_back(curve.Value(curve.LastParameter()));
+                }
+                else
+                {
+                    // Deflection relative to the edge so small arcs stay round and large ones stay cheap
+                    const gp_Pnt p1 = curve.Value(curve.FirstParameter());
+                    const gp_Pnt p2 = curve.Value(0.5 * (curve.FirstParameter() + curve.LastParameter()));
+                    const double deflection = std::max(p1.Distance(p2) * 0.01, Precision::Confusion());
+
+                    GCPnts_TangentialDeflection discretizer(curve, 0.1, deflection);
+                    for (Standard_Integer i = 1; i <= discretizer.NbPoints(); ++i)
+                        points.push_back(discretizer.Value(i));
+                }
+
+                if (trsf != nullptr)
+                {
+                    for (size_t i = first; i < points.size(); ++i)
+                        points[i].Transform(*trsf);
+                }
+            }
+        }
+        // World geometry of the entity's document row; null for rows without B-Rep (text, inserts, arrays)
+        static TopoDS_Shape DocumentGeometry(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj)
+        {
+            if (native == nullptr) return TopoDS_Shape();
+            const int id = native->document.Find(obj);
+            return id >= 0 ? native->document.Geometry(id) : TopoDS_Shape();
+        }
+        void TessellateEntity(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, std::vector<gp_Pnt>& points, std::vector<int>& starts)
+        {
+            const TopoDS_Shape shape = DocumentGeometry(native, obj);
+            if (shape.IsNull())
+            {
+                TessellateEntity(obj, points, starts);
+                return;
+            }
+            TessellateShape(shape, nullptr, points, starts);
+        }
+        void TessellateEntity(const Handle(AIS_InteractiveObject)& obj, std::vector<gp_Pnt>& points, std::vector<int>& starts)
+        {
+            Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(obj);
+            if (aisShape.IsNull() || aisShape->Shape().IsNull())
+            {
+                // Text and other non-B-Rep entities are outlined by their extent
+                const EntityBounds b = ComputeBounds(obj);
+                if (b.xMax - b.xMin > 1.0e100) return;
+
+                starts.push_back((int)points.size());
+                points.push_back(gp_Pnt(b.xMin, b.yMin, 0.0));
+                points.push_back(gp_Pnt(b.xMax, b.yMin, 0.0));
+                points.push_back(gp_Pnt(b.xMax, b.yMax, 0.0));
+                points.push_back(gp_Pnt(b.xMin, b.yMax, 0.0));
+                points.push_back(gp_Pnt(b.xMin, b.yMin, 0.0));
+                return;
+            }
+
+            const gp_Trsf& trsf = obj->Transformation();
+            TessellateShape(aisShape->Shape(), obj->HasTransformation() ? &trsf : nullptr, points, starts);
+        }
+        // Liang-Barsky: does segment p-q touch the axis-aligned rectangle?
+        static bool SegmentTouchesRect(const gp_Pnt& p, const gp_Pnt& q, const EntityBounds& r)
+        {
+            double t0 = 0.0, t1 = 1.0;
+            const double dx = q.X() - p.X(), dy = q.Y() - p.Y();
+            const double pp[4] = { -dx, dx, -dy, dy };
+            const double qq[4] = { p.X() - r.xMin, r.xMax - p.X(), p.Y() - r.yMin, r.yMax - p.Y() };
+            for (int i = 0; i < 4; ++i)
+            {
+                if (pp[i] == 0.0)
+                {
+                    if (qq[i] < 0.0) return false;
+                    continue;
+                }
+                const double t = qq[i] / pp[i];
+                if (pp[i] < 0.0) t0 = std::max(t0, t);
+                else t1 = std::min(t1, t);
+                if (t0 > t1) return false;
+            }
+            return true;
+        }
+        static bool EntityTouchesRect(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, const EntityBounds& rect)
+        {
+            // Filled entities (solids, hatches, faces) cover their interior: extent overlap is enough
+            TopoDS_Shape shape = DocumentGeometry(native, obj);
+            Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(obj);
+            if (shape.IsNull() && !aisShape.IsNull())
+                shape = aisShape->Shape();
+            if (shape.IsNull())
+            {
+                const EntityBounds b = ComputeBounds(obj);
+                return b.xMax - b.xMin < 1.0e100;   // unknown extent: never selected by crossing
+            }
+            TopExp_Explorer faceExp(shape, TopAbs_FACE);
+            if (faceExp.More())
+                return true;
+
+            std::vector<gp_Pnt> points;
+            std::vector<int> starts;
+            TessellateEntity(native, obj, points, starts);
+            for (size_t s = 0; s < starts.size(); ++s)
+            {
+                const size_t last = (s + 1 < starts.size()) ? (size_t)starts[s + 1] : points.size();
+                for (size_t i = (size_t)starts[s]; i + 1 < last; ++i)
+                {
+                    if (SegmentTouchesRect(points[i], points[i + 1], rect))
+                        return true;
+                }
+            }
+            return false;
+        }
+        void SelectInRectangle(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view,
+            int xMin, int yMin, int xMax, int yMax, bool crossing, std::vector<int>& result)
+        {
+            if (native == nullptr || context.IsNull() || view.IsNull()) return;
+
+            EntityBounds rect;
+            rect.xMin = rect.yMin = std::numeric_limits<double>::max();
+            rect.xMax = rect.yMax = -std::numeric_limits<double>::max();
+            const int px[4] = { xMin, xMax, xMax, xMin };
+            const int py[4] = { yMin, yMin, yMax, yMax };
+            for (int i = 0; i < 4; ++i)
+            {
+                Standard_Real X, Y, Z;
+                view->Convert(px[i], py[i], X, Y, Z);
+                rect.xMin = std::min(rect.xMin, X); rect.xMax = std::max(rect.xMax, X);
+                rect.yMin = std::min(rect.yMin, Y); rect.yMax = std::max(rect.yMax, Y);
+            }
+
+            std::vector<int> candidates;
+            if (crossing)
+            {
+                std::vector<int> boundary;
+                native->entityIndex.QueryTouching(rect, candidates, boundary);
+
+                // Only extents straddling the rectangle need an exact geometric test
+                for (int id : boundary)
+                {
+                    if (EntityTouchesRect(native, native->entityIndex.Object(id), rect))
+                        candidates.push_back(id);
+                }
+            }
+            else
+            {
+                native->entityIndex.QueryInside(rect, candidates);
+            }
+
+            // Entities erased since they were indexed are skipped
+            result.reserve(result.size() + candidates.size());
+            for (int id : candidates)
+            {
+                if (context->IsDisplayed(native->entityIndex.Object(id)))
+                    result.push_back(id);
+            }
+        }
+        static Handle(AIS_SelectionHighlight) EnsureHighlight(NativeViewerHandle* native)
+        {
+            if (native->entityOutlines.IsNull())
+            {
+                native->entityOutlines = new AIS_OutlinePages(
+                    [native](int id, std::vector<gp_Pnt>& points, std::vector<int>& starts)
+                    {
+                        TessellateEntity(native, native->entityIndex.Object(id), points, starts);
+                    });
+            }
+            if (native->selectionHighlight.IsNull())
+                native->selectionHighlight = new AIS_SelectionHighlight(native->entityOutlines);
+            return native->selectionHighlight;
+        }
+        static void RefreshHighlight(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, bool needsCompute)
+        {
+            const Handle(AIS_SelectionHighlight)& highlight = native->selectionHighlight;
+            if (!context->IsDisplayed(highlight))
+                context->Display(highlight, 0, -1, Standard_False);
+            else if (needsCompute)
+                context->Redisplay(highlight, Standard_False);
+            else if (!native->view.IsNull())
+                native->view->Invalidate();     // index buffers changed in place
+        }
+        void SetSelection(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, std::vector<int>&& ids)
+        {
+            if (native == nullptr || context.IsNull()) return;
+            Handle(AIS_SelectionHighlight) highlight = EnsureHighlight(native);
+
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+            std::vector<int>& current = native->selectedEntities;
+            std::sort(current.begin(), current.end());
+
+            // Only entities entering or leaving the set touch the highlight
+            bool needsCompute = false;
+            std::vector<int> changed;
+            std::set_difference(current.begin(), current.end(), ids.begin(), ids.end(), std::back_inserter(changed));
+            for (int id : changed)
+                needsCompute |= highlight->SetSelected(id, false);
+
+            changed.clear();
+            std::set_difference(ids.begin(), ids.end(), current.begin(), current.end(), std::back_inserter(changed));
+            for (int id : changed)
+                needsCompute |= highlight->SetSelected(id, true);
+
+            current = std::move(ids);
+            RefreshHighlight(native, context, needsCompute);
+        }
+        void RefreshEntities(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const std::vector<Handle(AIS_InteractiveObject)>& objects)
+        {
+            if (native == nullptr) return;
+
+            std::vector<int> ids;
+            ids.reserve(objects.size());
+            for (const Handle(AIS_InteractiveObject)& obj : objects)
+            {
+                if (obj.IsNull()) continue;
+                const EntityBounds bounds = ComputeBounds(obj);
+                native->document.Refresh(obj, bounds);
+
+                const int id = native->entityIndex.Find(obj);
+                if (id < 0) continue;
+                native->entityIndex.Update(id, bounds);
+                ids.push_back(id);
+            }
+            if (!ids.empty()) native->tiles.Reindex();
+
+            if (!native->selectionHighlight.IsNull() && native->selectionHighlight->Invalidate(ids) && !context.IsNull())
+                context->Redisplay(native->selectionHighlight, Standard_False);
+        }
+        void RefreshEntity(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj)
+        {
+            RefreshEntities(native, context, std::vector<Handle(AIS_InteractiveObject)>(1, obj));
+        }
+        bool IsSelected(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj)
+        {
+            if (native == nullptr || obj.IsNull() || native->selectionHighlight.IsNull()) return false;
+            const int id = native->entityIndex.Find(obj);
+            return id >= 0 && native->selectionHighlight->IsSelected(id);
+        }
+        Handle(AIS_InteractiveObject) DetectedEntity(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context)
+        {
+            if (context.IsNull() || !context->HasDetected()) return Handle(AIS_InteractiveObject)();
+
+            Handle(AIS_PackedCurveOwner) owner = Handle(AIS_PackedCurveOwner)::DownCast(context->DetectedOwner());
+            if (native == nullptr || owner.IsNull()) return context->DetectedInteractive();
+
+            Handle(AIS_InteractiveObject) entity = ProjectFile::Materialize(native, owner);
+            return entity.IsNull() ? context->DetectedInteractive() : entity;
+        }
+        bool ToggleSelected(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj)
+        {
+            if (native == nullptr || context.IsNull() || obj.IsNull()) return false;
+            Handle(AIS_SelectionHighlight) highlight = EnsureHighlight(native);
+
+            // Solids and other results created outside the drafting tools are indexed on first pick
+            int id = native->entityIndex.Find(obj);
+            if (id < 0)
+            {
+                IndexEntity(native, obj);
+                id = native->entityIndex.Size() - 1;
+            }
+
+            const bool isSelected = !highlight->IsSelected(id);
+            const bool needsCompute = highlight->SetSelected(id, isSelected);
+
+            std::vector<int>& current = native->selectedEntities;
+            if (isSelected)
+                current.push_back(id);
+            else
+                current.erase(std::remove(current.begin(), current.end(), id), current.end());
+
+            RefreshHighlight(native, context, needsCompute);
+            return isSelected;
+        }
+        void ClearSelection(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context)
+        {
+            if (native == nullptr) return;
+            native->selectedEntities.clear();
+            if (native->selectionHighlight.IsNull()) return;
+
+            // Index buffers are released with the set; packed outlines stay for the next selection
+            if (native->selectionHighlight->Clear() && !context.IsNull())
+                context->Redisplay(native->selectionHighlight, Standard_False);
+        }
+        void ResetSelection(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context)
+        {
+            if (native == nullptr) return;
+            native->selectedEntities.clear();
+            native->entityIndex.Clear();
+
+            // Packed outlines refer to entity ids that no longer exist
+            if (!native->selectionHighlight.IsNull() && !context.IsNull())
+                context->Remove(native->selectionHighlight, Standard_False);
+            native->selectionHighlight.Nullify();
+            native->entityOutlines.Nullify();
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "NativeViewerHandle.h"
+#include <AIS_InteractiveContext.hxx>
+#include <AIS_InteractiveObject.hxx>
+#include <V3d_View.hxx>
+#include <TopAbs_ShapeEnum.hxx>
+#include <gp_Pnt.hxx>
+#include <vector>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // ✅ C#-visible wrapper used by the loader once the first frame is shown
+    public ref class SelectionHelperPublic
+    {
+    public:
+        // Builds sensitives for pending imported entities for up to budgetMs; returns how many remain
+        static int ActivatePendingSelection(System::IntPtr viewerHandlePtr, int budgetMs);
+        static int PendingSelectionCount(System::IntPtr viewerHandlePtr);
+    };
+
+    namespace SelectionHelper
+    {
+        // Display without building selection primitives; the entity becomes selectable on demand
+        void DisplayDeferred(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj);
+        void DisplayDeferred(const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj);
+
+        // Register an interactively drawn entity for rectangle selection
+        void IndexEntity(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj);
+
+        // Object shown outside DisplayDeferred (drawn, or brought back by undo): the next SetSelectionMode
+        // gives it the active mode, and only the objects queued this way are visited when the mode is unchanged
+        void NoteDisplayed(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj);
+
+        // Entity geometry or placement changed: refresh its extent and packed highlight outline
+        void RefreshEntity(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj);
+        void RefreshEntities(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const std::vector<Handle(AIS_InteractiveObject)>& objects);
+
+        bool IsSelected(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj);
+
+        // Object a click acts on: the detected interactive, except that a curve of the packed project
+        // curves is first materialized into an entity of its own
+        Handle(AIS_InteractiveObject) DetectedEntity(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context);
+
+        // Replacement for context->Deactivate() + context->Activate(mode) that leaves deferred entities alone
+        void SetSelectionMode(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, TopAbs_ShapeEnum shapeType);
+
+        // Activate deferred entities under the cursor / inside a pixel rectangle before MoveTo or Select
+        void ActivateDeferredAt(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view, int x, int y);
+        void ActivateDeferredInRegion(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view, int xMin, int yMin, int xMax, int yMax);
+
+        int ActivateDeferredChunk(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, int budgetMs);
+        void ClearDeferred(NativeViewerHandle* native);
+
+        // Window (fully inside) or crossing (touching) selection against the entity index; returns entity ids
+        void SelectInRectangle(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(V3d_View)& view,
+            int xMin, int yMin, int xMax, int yMax, bool crossing, std::vector<int>& result);
+
+        // Replace the selection set; only entities entering or leaving it update the highlight
+        void SetSelection(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, std::vector<int>&& ids);
+
+        // Click selection: flips one object in the set, returns true if it is now selected
+        bool ToggleSelected(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const Handle(AIS_InteractiveObject)& obj);
+        void ClearSelection(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context);
+
+        // Scene cleared: drop the entity index together with the highlight built over it
+        void ResetSelection(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context);
+
+        // Entity edges as XY polylines, in world coordinates: from the document row's geometry when it has one,
+        // else from the presentation (the second form, for objects outside any viewer's document)
+        void TessellateEntity(NativeViewerHandle* native, const Handle(AIS_InteractiveObject)& obj, std::vector<gp_Pnt>& points, std::vector<int>& starts);
+        void TessellateEntity(const Handle(AIS_InteractiveObject)& obj, std::vector<gp_Pnt>& points, std::vector<int>& starts);
+    }
+}
@@ -1,15 +1,120 @@
 ﻿#include "pch.h"
 #include "ShapeBooleanOperator.h"
 #include "ViewHelper.h"
+#include "SelectionHelper.h"
+#include "FrameScheduler.h"
+#include <algorithm>
 
 using namespace PotaOCC;
 
+namespace PotaOCC
+{
+    int ShapeBooleanOperatorPublic::PollBoolean(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return -1;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native || native->context.IsNull()) return -1;
+
+        return ShapeBooleanOperator::PollBooleanOperation(native, native->context, native->view);
+    }
+    void ShapeBooleanOperatorPublic::CancelBoolean(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        ShapeBooleanOperator::CancelBooleanOperation(native);
+    }
+    void ShapeBooleanOperatorPublic::SetBooleanOptions(System::IntPtr viewerHandlePtr, bool runParallel, double fuzzyValue, bool useOBB, int glue)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        native->booleanOptions.runParallel = runParallel;
+        native->booleanOptions.fuzzyValue = fuzzyValue > 0.0 ? fuzzyValue : 0.0;
+        native->booleanOptions.useOBB = useOBB;
+        native->booleanOptions.glue = glue == 2 ? BOPAlgo_GlueFull : (glue == 1 ? BOPAlgo_GlueShift : BOPAlgo_GlueOff);
+        native->isBooleanOptionsOverridden = true;
+    }
+    void ShapeBooleanOperatorPublic::ResetBooleanOptions(System::IntPtr viewerHandlePtr)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        native->booleanOptions = BooleanOptions();
+        native->isBooleanOptionsOverridden = false;
+    }
+    void ShapeBooleanOperatorPublic::SetBooleanCacheBudget(System::IntPtr viewerHandlePtr, int megabytes)
+    {
+        if (viewerHandlePtr == System::IntPtr::Zero) return;
+        NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
+        if (!native) return;
+
+        native->booleanCache.SetBudget((size_t)std::max(0, megabytes) * 1024u * 1024u);
+    }
+}
+
 // Constructor
 ShapeBooleanOperator::ShapeBooleanOperator(NativeViewerHandle* nativeHandle)
     : native(nativeHandle)
 {
 }
 
+BooleanOptions ShapeBooleanOperator::OptionsFor(
+    NativeViewerHandle* native,
+    const TopTools_ListOfShape& arguments,
+    const TopTools_ListOfShape& tools)
+{
+    if (native && native->isBooleanOptionsOverridden)
+        return native->booleanOptions;
+    return BooleanOptions::ForOperands(arguments, tools);
+}
+
+bool ShapeBooleanOperator::RunBoolean(
+    NativeViewerHandle* native,
+    BooleanOperation operation,
+    const TopTools_ListOfShape& arguments,
+    const TopTools_ListOfShape& tools,
+    TopoDS_Shape& result)
+{
+    const BooleanOptions options = OptionsFor(native, arguments, tools);
+    if (native->booleanCache.Find(operation, arguments, tools, options, result))
+    {
+        std::cout << "⚡ Boolean result reused from cache." << std::endl;
+        return true;
+    }
+
+    if (!BooleanTask::Perform(operation, arguments, tools, options, result))
+        return false;
+
+    native->booleanCache.Insert(operation, arguments, tools, options, result);
+    return true;
+}
+
+bool ShapeBooleanOperator::PerformAndDisplay(const Handle(AIS_InteractiveContext)& context,
+    BooleanOperation operation,
+    const TopTools_ListOfShape& arguments,
+    const TopTools_ListOfShape& tools,
+    Quantity_NameOfColor color)
+{
+    TopoDS_Shape result;
+    if (!RunBoolean(native, operation, arguments, tools, result))
+        return false;
+
+    Handle(AIS_Shape) aisResult = new AIS_Shape(result);
+    aisResult->SetColor(color);
+    aisResult->SetDisplayMode(AIS_Shaded);
+
+    MeshingService::Of(native).Submit(aisResult, native->view);
+    context->Display(aisResult, Standard_False);
+    FrameScheduler::Redraw(context);
+    native->persistedExtrusions.push_back(aisResult);
+    native->commandJournal.Added(context, aisResult);
+    return true;
+}
+
 // ---------------------------------------------------------------------------
 // 🧱 Union (A + B)
 // ---------------------------------------------------------------------------
@@ -19,23 +124,15 @@ bool ShapeBooleanOperator::Fuse(const Handle(AIS_InteractiveContext)& context,
 {
     std::cout << "Performing Boolean Fuse (Union)..." << std::endl;
 
-    BRepAlgoAPI_Fuse fuseOp(shapeA, shapeB);
-    fuseOp.Build();
-    if (!fuseOp.IsDone())
+    TopTools_ListOfShape arguments, tools;
+    arguments.Append(shapeA);
+    tools.Append(shapeB);
+    if (!PerformAndDisplay(context, BooleanOperation::Fuse, arguments, tools, Quantity_NOC_GREEN))  // 🎨 Green for Union
     {
         std::cout << "❌ Boolean Fuse failed!" << std::endl;
         return false;
     }
 
-    TopoDS_Shape result = fuseOp.Shape();
-
-    Handle(AIS_Shape) aisResult = new AIS_Shape(result);
-    aisResult->SetColor(Quantity_NOC_GREEN);  // 🎨 Green for Union
-    aisResult->SetDisplayMode(AIS_Shaded);
-
-    context->Display(aisResult, Standard_True);
-    native->persistedExtrusions.push_back(aisResult);
-
     std::cout << "✅ Fuse completed successfully.\n";
     return true;
 }
@@ -47,25 +144,27 @@ bool ShapeBooleanOperator::Cut(const Handle(AIS_InteractiveContext)& context,
     const TopoDS_Shape& shapeA,
     const TopoDS_Shape& shapeB)
 {
-    std::cout << "Performing Boolean Cut (Subtraction)..." << std::endl;
+    return CutMany(context, shapeA, std::vector<TopoDS_Shape>{ shapeB });
+}
+
+bool ShapeBooleanOperator::CutMany(const Handle(AIS_InteractiveContext)& context,
+    const TopoDS_Shape& shapeA,
+    const std::vector<TopoDS_Shape>& tools)
+{
+    std::cout << "Performing Boolean Cut (Subtraction) with " << tools.size() << " tool(s)..." << std::endl;
+
+    // All tools go into one builder: the argument is intersected once instead of once per tool
+    TopTools_ListOfShape arguments, toolList;
+    arguments.Append(shapeA);
+    for (const TopoDS_Shape& tool : tools)
+        if (!tool.IsNull()) toolList.Append(tool);
 
-    BRepAlgoAPI_Cut cutOp(shapeA, shapeB);
-    cutOp.Build();
-    if (!cutOp.IsDone())
+    if (!PerformAndDisplay(context, BooleanOperation::Cut, arguments, toolList, Quantity_NOC_RED))  // 🎨 Red for Subtraction
     {
         std::cout << "❌ Boolean Cut failed!" << std::endl;
         return false;
     }
 
-    TopoDS_Shape result = cutOp.Shape();
-
-    Handle(AIS_Shape) aisResult = new AIS_Shape(result);
-    aisResult->SetColor(Quantity_NOC_RED);  // 🎨 Red for Subtraction
-    aisResult->SetDisplayMode(AIS_Shaded);
-
-    context->Display(aisResult, Standard_True);
-    native->persistedExtrusions.push_back(aisResult);
-
     std::cout << "✅ Cut completed successfully.\n";
     return true;
 }
@@ -79,23 +178,15 @@ bool ShapeBooleanOperator::Common(const Handle(AIS_InteractiveContext)& context,
 {
     std::cout << "Performing Boolean Common (Intersection)..." << std::endl;
 
-    BRepAlgoAPI_Common commonOp(shapeA, shapeB);
-    commonOp.Build();
-    if (!commonOp.IsDone())
+    TopTools_ListOfShape arguments, tools;
+    arguments.Append(shapeA);
+    tools.Append(shapeB);
+    if (!PerformAndDisplay(context, BooleanOperation::Common, arguments, tools, Quantity_NOC_YELLOW))  // 🎨 Yellow for intersection
     {
         std::cout << "❌ Boolean Common failed!" << std::endl;
         return false;
     }
 
-    TopoDS_Shape result = commonOp.Shape();
-
-    Handle(AIS_Shape) aisResult = new AIS_Shape(result);
-    aisResult->SetColor(Quantity_NOC_YELLOW);  // 🎨 Yellow for intersection
-    aisResult->SetDisplayMode(AIS_Shaded);
-
-    context->Display(aisResult, Standard_True);
-    native->persistedExtrusions.push_back(aisResult);
-
     std::cout << "✅ Common completed successfully.\n";
     return true;
 }
@@ -112,27 +203,26 @@ void ShapeBooleanOperator::FinalizeBooleanResult(
     if (success) {
         Handle(AIS_Shape) aisResult = new AIS_Shape(resultShape);
 
-        // Remove original selected shapes from context
+        // Operands are erased, not removed, so undo brings them back as they were
+        native->commandJournal.Begin("Boolean");
+        SelectionHelper::ClearSelection(native, context);
         for (auto& selectedObj : native->selectedShapes) {
-            context->Remove(selectedObj, Standard_False);
+            native->commandJournal.Removed(context, selectedObj);
         }
         native->selectedShapes.clear();
 
         // Remove overlays/helper objects
-        if (!native->lineOverlay.IsNull()) {
-            context->Remove(native->lineOverlay, Standard_False);
-            native->lineOverlay.Nullify();
-        }
-        if (!native->circleOverlay.IsNull()) {
-            context->Remove(native->circleOverlay, Standard_False);
-            native->circleOverlay.Nullify();
-        }
+        native->overlay.Hide(native);
 
         ViewHelper::ClearCenterMarker(native);
 
         aisResult->SetColor(Quantity_NOC_ORANGE);
         aisResult->SetDisplayMode(AIS_Shaded);
-        context->Display(aisResult, Standard_True);
+        MeshingService::Of(native).Submit(aisResult, view);
+        context->Display(aisResult, Standard_False);
+        FrameScheduler::Redraw(context);
+        native->commandJournal.Added(context, aisResult);
+        native->commandJournal.Commit(context);
 
         std::cout << successMsg << std::endl;
     }
@@ -141,6 +231,108 @@ void ShapeBooleanOperator::FinalizeBooleanResult(
     }
 }
 
+static void FinalizeOperation(
+    NativeViewerHandle* native,
+    const Handle(AIS_InteractiveContext)& context,
+    const Handle(V3d_View)& view,
+    BooleanOperation operation,
+    const TopoDS_Shape& result,
+    bool success)
+{
+    switch (operation)
+    {
+    case BooleanOperation::Cut:
+        ShapeBooleanOperator::FinalizeBooleanResult(native, context, view, result, "BCut operation succeeded.", "BCut operation failed.", success);
+        break;
+    case BooleanOperation::Fuse:
+        ShapeBooleanOperator::FinalizeBooleanResult(native, context, view, result, "BUnion operation succeeded.", "BUnion operation failed.", success);
+        break;
+    case BooleanOperation::Common:
+        ShapeBooleanOperator::FinalizeBooleanResult(native, context, view, result, "BIntersect operation succeeded.", "BIntersect operation failed.", success);
+        break;
+    }
+}
+
+bool ShapeBooleanOperator::StartBooleanOperation(
+    const TopoDS_Shape& shape1,
+    const TopoDS_Shape& shape2,
+    NativeViewerHandle* native)
+{
+    if (native->booleanTask)
+    {
+        std::cout << "⚠️ A boolean operation is still running (Esc to cancel)." << std::endl;
+        return false;
+    }
+
+    BooleanOperation operation;
+    if (native->isBooleanCutMode) operation = BooleanOperation::Cut;
+    else if (native->isBooleanUnionMode) operation = BooleanOperation::Fuse;
+    else if (native->isBooleanIntersectMode) operation = BooleanOperation::Common;
+    else return false;
+
+    TopTools_ListOfShape arguments, tools;
+    arguments.Append(shape1);
+    tools.Append(shape2);
+    const BooleanOptions options = OptionsFor(native, arguments, tools);
+
+    // Same operation on untouched operands (re-run, redo): swap the memoized result in right away
+    TopoDS_Shape cached;
+    if (native->booleanCache.Find(operation, arguments, tools, options, cached))
+    {
+        std::cout << "⚡ Boolean result reused from cache." << std::endl;
+        FinalizeOperation(native, native->context, native->view, operation, cached, true);
+        return true;
+    }
+
+    native->booleanTask = std::make_shared<BooleanTask>(operation, arguments, tools, options);
+    native->booleanTask->Start();
+
+    std::cout << "⏳ Boolean operation started..." << std::endl;
+    return true;
+}
+
+int ShapeBooleanOperator::PollBooleanOperation(
+    NativeViewerHandle* native,
+    const Handle(AIS_InteractiveContext)& context,
+    const Handle(V3d_View)& view)
+{
+    std::shared_ptr<BooleanTask> task = native->booleanTask;
+    if (!task) return -1;
+
+    if (!task->IsFinished())
+    {
+        int percent = 0;
+        if (task->TakeProgressStep(10, percent))
+            std::cout << "⏳ Boolean " << percent << "%" << std::endl;
+        return percent;
+    }
+
+    // Worker is done: release it before touching the context so a new boolean can start from the result
+    native->booleanTask.reset();
+
+    if (task->IsCancelled())
+    {
+        SelectionHelper::ClearSelection(native, context);
+        native->selectedShapes.clear();
+        FrameScheduler::Redraw(view);
+        std::cout << "⚠️ Boolean operation cancelled." << std::endl;
+        return -1;
+    }
+
+    if (task->Succeeded())
+        native->booleanCache.Insert(task->Operation(), task->Arguments(), task->Tools(), task->Options(), task->Result());
+
+    // Operands are removed and the result displayed in one viewer update
+    FinalizeOperation(native, context, view, task->Operation(), task->Result(), task->Succeeded());
+    return -1;
+}
+
+void ShapeBooleanOperator::CancelBooleanOperation(NativeViewerHandle* native)
+{
+    if (native->booleanTask)
+        native->booleanTask->Cancel();
+}
+
 TopoDS_Shape ShapeBooleanOperator::PerformBooleanOperation(
     const TopoDS_Shape& shape1,
     const TopoDS_Shape& shape2,
@@ -152,27 +344,16 @@ TopoDS_Shape ShapeBooleanOperator::PerformBooleanOperation(
     success = false;
     TopoDS_Shape result;
 
-    if (native->isBooleanCutMode) {
-        BRepAlgoAPI_Cut booleanCut(shape1, shape2);
-        booleanCut.Build();
-        success = booleanCut.IsDone();
-        if (success)
-            result = booleanCut.Shape();
-    }
-    else if (native->isBooleanUnionMode) {
-        BRepAlgoAPI_Fuse booleanFuse(shape1, shape2);
-        booleanFuse.Build();
-        success = booleanFuse.IsDone();
-        if (success)
-            result = booleanFuse.Shape();
-    }
-    else if (native->isBooleanIntersectMode) {
-        BRepAlgoAPI_Common booleanCommon(shape1, shape2);
-        booleanCommon.Build();
-        success = booleanCommon.IsDone();
-        if (success)
-            result = booleanCommon.Shape();
-    }
+    BooleanOperation operation;
+    if (native->isBooleanCutMode) operation = BooleanOperation::Cut;
+    else if (native->isBooleanUnionMode) operation = BooleanOperation::Fuse;
+    else if (native->isBooleanIntersectMode) operation = BooleanOperation::Common;
+    else return result;
+
+    TopTools_ListOfShape arguments, tools;
+    arguments.Append(shape1);
+    tools.Append(shape2);
+    success = RunBoolean(native, operation, arguments, tools, result);
 
     return result;
 }
\ No newline at end of file
@@ -7,9 +7,30 @@
 #include <BRepAlgoAPI_Fuse.hxx>       // Union
 #include <BRepAlgoAPI_Cut.hxx>        // Subtraction
 #include <BRepAlgoAPI_Common.hxx>     // Intersection
+#include <TopTools_ListOfShape.hxx>
 #include <iostream>
+#include <vector>
 #include "NativeViewerHandle.h"
 
+namespace PotaOCC
+{
+    // ✅ C#-visible wrapper: the UI polls a running boolean until it is swapped into the context
+    public ref class ShapeBooleanOperatorPublic
+    {
+    public:
+        // Finalizes a finished boolean on the calling (UI) thread. Returns its percent while running, -1 when idle
+        static int PollBoolean(System::IntPtr viewerHandlePtr);
+        static void CancelBoolean(System::IntPtr viewerHandlePtr);
+
+        // Overrides the size-based engine defaults for this viewer; glue: 0 = off, 1 = shift, 2 = full
+        static void SetBooleanOptions(System::IntPtr viewerHandlePtr, bool runParallel, double fuzzyValue, bool useOBB, int glue);
+        static void ResetBooleanOptions(System::IntPtr viewerHandlePtr);
+
+        // Memory budget of the per-viewer boolean result cache; 0 disables caching
+        static void SetBooleanCacheBudget(System::IntPtr viewerHandlePtr, int megabytes);
+    };
+}
+
 
 // ---------------------------------------------------------------------------
 // 🧠 CLASS: ShapeBooleanOperator
@@ -37,6 +58,17 @@ public:
         const TopoDS_Shape& shapeA,
         const TopoDS_Shape& shapeB);
 
+    // Perform Subtraction of every tool in one boolean (A - B1 - ... - Bn)
+    bool CutMany(const Handle(AIS_InteractiveContext)& context,
+        const TopoDS_Shape& shapeA,
+        const std::vector<TopoDS_Shape>& tools);
+
+    // Viewer override if set, otherwise defaults chosen from operand size
+    static PotaOCC::BooleanOptions OptionsFor(
+        PotaOCC::NativeViewerHandle* native,
+        const TopTools_ListOfShape& arguments,
+        const TopTools_ListOfShape& tools);
+
     static void FinalizeBooleanResult(
         PotaOCC::NativeViewerHandle* native,
         const Handle(AIS_InteractiveContext)& context,
@@ -46,6 +78,20 @@ public:
         const char* failMsg,
         bool success);
 
+    // Starts the boolean selected by the current mode on a worker thread; false if one is already running
+    static bool StartBooleanOperation(
+        const TopoDS_Shape& shape1,
+        const TopoDS_Shape& shape2,
+        PotaOCC::NativeViewerHandle* native);
+
+    // Must run on the UI thread. Returns the running task's percent, or -1 once idle (result already displayed)
+    static int PollBooleanOperation(
+        PotaOCC::NativeViewerHandle* native,
+        const Handle(AIS_InteractiveContext)& context,
+        const Handle(V3d_View)& view);
+
+    static void CancelBooleanOperation(PotaOCC::NativeViewerHandle* native);
+
     static TopoDS_Shape PerformBooleanOperation(
         const TopoDS_Shape& shape1,
         const TopoDS_Shape& shape2,
@@ -54,6 +100,20 @@ public:
         const Handle(V3d_View)& view,
         bool& success);
 
+    // Cached result if the same operation already ran on these operands, otherwise builds and memoizes it
+    static bool RunBoolean(
+        PotaOCC::NativeViewerHandle* native,
+        PotaOCC::BooleanOperation operation,
+        const TopTools_ListOfShape& arguments,
+        const TopTools_ListOfShape& tools,
+        TopoDS_Shape& result);
+
 private:
+    bool PerformAndDisplay(const Handle(AIS_InteractiveContext)& context,
+        PotaOCC::BooleanOperation operation,
+        const TopTools_ListOfShape& arguments,
+        const TopTools_ListOfShape& tools,
+        Quantity_NameOfColor color);
+
     PotaOCC::NativeViewerHandle* native;
 };
\ No newline at end of file
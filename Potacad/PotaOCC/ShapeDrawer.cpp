@@ -1,7 +1,9 @@
 ﻿#include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "Utils.h"
 #include "ShapeDrawer.h"
+#include "SelectionHelper.h"
 #include <WNT_Window.hxx>
 #include <V3d_Viewer.hxx>
 #include <V3d_View.hxx>
@@ -63,7 +65,8 @@ void ShapeDrawer::DrawBox(
     // -----------------------------
     if (!native->box3D.IsNull())
     {
-        context->Remove(native->box3D, Standard_True);
+        context->Remove(native->box3D, Standard_False);
+        FrameScheduler::Redraw(context);
         native->box3D.Nullify();
     }
 
@@ -104,9 +107,8 @@ void ShapeDrawer::DrawBox(
     // -----------------------------
     // 6️⃣ Display the box
     // -----------------------------
-    context->Display(native->box3D, Standard_True);
-    context->UpdateCurrentViewer();
-    view->Redraw();
+    context->Display(native->box3D, Standard_False);
+    FrameScheduler::Redraw(context);
 
     // -----------------------------
     // 7️⃣ Keep track in map for thread safety
@@ -126,11 +128,12 @@ void ShapeDrawer::SetWireframe(IntPtr viewerHandlePtr)
     { std::lock_guard<std::mutex> lock(boxMapMutex); auto it = boxMap.find(native); if (it == boxMap.end()) return; box = it->second; }
 
     native->context->SetDisplayMode(box, AIS_WireFrame, Standard_True);
-    native->context->Update(box, Standard_True);
+    native->context->Update(box, Standard_False);
+    FrameScheduler::Redraw(native);
 
     native->context->Activate(box);  // Enable interaction/selection
 
-    native->view->Redraw();
+    FrameScheduler::Redraw(native);
 }
 
 void ShapeDrawer::SetShaded(IntPtr viewerHandlePtr)
@@ -148,7 +151,7 @@ void ShapeDrawer::SetShaded(IntPtr viewerHandlePtr)
 
     native->context->Activate(box);  // Enable interaction/selection
 
-    native->view->Redraw();
+    FrameScheduler::Redraw(native);
 }
 
 void ShapeDrawer::RotateBoxAroundCenter(IntPtr viewerHandlePtr, double angleX, double angleY)
@@ -161,7 +164,7 @@ void ShapeDrawer::RotateBoxAroundCenter(IntPtr viewerHandlePtr, double angleX, d
     gp_Trsf trX; trX.SetRotation(gp_Ax1(center, gp_Dir(0, 1, 0)), angleX); native->box3D->SetLocalTransformation(trX);
     gp_Trsf trY; trY.SetRotation(gp_Ax1(center, gp_Dir(1, 0, 0)), angleY); native->box3D->SetLocalTransformation(trY);
 
-    native->context->Update(native->box3D, Standard_True); native->view->Redraw();
+    native->context->Update(native->box3D, Standard_False); FrameScheduler::Redraw(native);
 }
 
 void ShapeDrawer::ActivateFaceSelection(System::IntPtr viewerHandlePtr)
@@ -172,17 +175,19 @@ void ShapeDrawer::ActivateFaceSelection(System::IntPtr viewerHandlePtr)
 
     // Activate face selection mode
     native->context->Deactivate(); // clear any previous modes
+    native->activeSelectionMode = -1;
     native->context->Activate(native->box3D, AIS_Shape::SelectionMode(TopAbs_FACE));
 
     // Make sure shape is displayed
     if (!native->context->IsDisplayed(native->box3D))
     {
-        native->context->Display(native->box3D, Standard_True);
+        native->context->Display(native->box3D, Standard_False);
+        FrameScheduler::Redraw(native);
     }
 
     // Redraw so the selection is visually enabled
     if (!native->view.IsNull())
-        native->view->Redraw();
+        FrameScheduler::Redraw(native);
 }
 void ShapeDrawer::UpdateSelection(IntPtr viewerHandlePtr, int x, int y)
 {
@@ -239,7 +244,8 @@ void ShapeDrawer::UpdateSelection(System::IntPtr viewerHandlePtr, int x, int y,
     if (isClick)
     {
         // Only select if it's a click, not on mouse move
-        context->Select(Standard_True);
+        context->Select(Standard_False);
+        FrameScheduler::Redraw(context);
         redrawRequired = true;  // Mark that a redraw is needed
     }
 
@@ -249,7 +255,7 @@ void ShapeDrawer::UpdateSelection(System::IntPtr viewerHandlePtr, int x, int y,
     if (redrawRequired)
     {
         // Redraw the view only after selection or relevant changes
-        view->Redraw();
+        FrameScheduler::Redraw(view);
     }
 }
 
@@ -259,13 +265,27 @@ void ShapeDrawer::AlignViewToSelectedFace(System::IntPtr viewerHandlePtr)
     NativeViewerHandle* native = static_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
     if (!native || native->context.IsNull() || native->view.IsNull()) return;
 
-    // First try selected list
+    // First try selected list; rectangle selection keeps its set natively rather than in the AIS context
+    TopoDS_Shape selShape;
+    const bool hasSelection = native->context->NbSelected() > 0 || !native->selectedEntities.empty();
     native->context->InitSelected();
     if (native->context->MoreSelected())
     {
         std::cout << "[PotaOCC] AlignViewToSelectedFace: using SelectedShape()" << std::endl;
+        selShape = native->context->SelectedShape();
+    }
+    else if (!native->selectedEntities.empty())
+    {
+        std::cout << "[PotaOCC] AlignViewToSelectedFace: using rectangle selection" << std::endl;
+        Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(native->entityIndex.Object(native->selectedEntities.front()));
+        if (!aisShape.IsNull() && !aisShape->Shape().IsNull())
+            selShape = aisShape->HasTransformation()
+                ? aisShape->Shape().Moved(TopLoc_Location(aisShape->Transformation()))
+                : aisShape->Shape();
+    }
 
-        TopoDS_Shape selShape = native->context->SelectedShape();
+    if (hasSelection)
+    {
         if (!selShape.IsNull() && selShape.ShapeType() == TopAbs_FACE)
         {
             TopoDS_Face face = TopoDS::Face(selShape);
@@ -284,9 +304,11 @@ void ShapeDrawer::AlignViewToSelectedFace(System::IntPtr viewerHandlePtr)
             if (nvec.Magnitude() > Precision::Confusion())
             {
                 gp_Dir normal(nvec);
-                native->view->SetProj(normal.X(), normal.Y(), normal.Z());
-                native->view->FitAll();
-                native->view->Redraw();
+                native->cameraAnimation.AnimateTo(native, [normal](const Handle(V3d_View)& target)
+                {
+                    target->SetProj(normal.X(), normal.Y(), normal.Z());
+                    LayerTable::FitAll(target);
+                });
                 std::cout << "[PotaOCC] AlignViewToSelectedFace: aligned to selected face." << std::endl;
                 return;
             }
@@ -320,9 +342,11 @@ void ShapeDrawer::AlignViewToSelectedFace(System::IntPtr viewerHandlePtr)
             if (nvec.Magnitude() > Precision::Confusion())
             {
                 gp_Dir normal(nvec);
-                native->view->SetProj(normal.X(), normal.Y(), normal.Z());
-                native->view->FitAll();
-                native->view->Redraw();
+                native->cameraAnimation.AnimateTo(native, [normal](const Handle(V3d_View)& target)
+                {
+                    target->SetProj(normal.X(), normal.Y(), normal.Z());
+                    LayerTable::FitAll(target);
+                });
                 std::cout << "[PotaOCC] AlignViewToSelectedFace: aligned to detected face." << std::endl;
                 return;
             }
@@ -350,8 +374,30 @@ void ShapeDrawer::ClearAllShapes(IntPtr viewerHandlePtr)
 
     if (!native->box3D.IsNull()) native->context->Remove(native->box3D, Standard_False);
 
-    native->context->EraseAll(Standard_True);
-    native->context->UpdateCurrentViewer(); native->view->Redraw();
+    native->commandJournal.Clear(native->context);
+    native->document.Clear();
+    native->layers.Clear(native);
+    native->blocks.Clear();
+    native->arrays.Clear();
+
+    // Removing the packed curves releases the last buffers pointing into the mapped project
+    if (native->project)
+    {
+        for (const ProjectCurves& curves : native->project->curves)
+            if (!curves.object.IsNull()) native->context->Remove(curves.object, Standard_False);
+    }
+    native->project.reset();
+
+    native->context->EraseAll(Standard_False);
+    FrameScheduler::Redraw(native);
+
+    // Cancels and joins a running boolean; its result would refer to shapes that are gone
+    native->booleanTask.reset();
+    native->booleanCache.Clear();
+    if (native->meshingService) native->meshingService->Clear();
+
+    SelectionHelper::ClearDeferred(native);
+    SelectionHelper::ResetSelection(native, native->context);
 
     std::lock_guard<std::mutex> lock(boxMapMutex);
     boxMap.erase(native);
@@ -470,16 +516,14 @@ void ShapeDrawer::Draw2DBoxWithLabel(
     native->ais2DShapes.push_back(aisWire);
     native->aisLabels.push_back(textLabel);
 
-    context->UpdateCurrentViewer();
-    view->Redraw();
+    FrameScheduler::Redraw(context);
 }
 
 void ShapeDrawer::ResetView(IntPtr viewerHandlePtr)
 {
     NativeViewerHandle* native = reinterpret_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
     if (!native) return;
-    native->context->UpdateCurrentViewer();
-    native->view->Redraw();
+    FrameScheduler::Redraw(native);
 }
 
 static double ComputeModelTextHeight(const Handle(V3d_View)& view, double pixelHeight)
@@ -609,8 +653,9 @@ bool ShapeDrawer::findIntersectionPoints(const gp_Pnt& intersectionPoint, const
 
 
         // Update the context with the trimmed shape
-        context->Remove(detectedIO, Standard_True);
-        context->Display(trimmedAIS, Standard_True);
+        context->Remove(detectedIO, Standard_False);
+        context->Display(trimmedAIS, Standard_False);
+        FrameScheduler::Redraw(context);
 
         return true;
     }
@@ -880,7 +925,8 @@ void ShapeDrawer::ConvertLineToCenterLine(
 
     // Optional: name or color coding
     context->Erase(aisCenterLine, Standard_False);
-    context->Display(aisCenterLine, Standard_True);
+    context->Display(aisCenterLine, Standard_False);
+    FrameScheduler::Redraw(context);
 
     std::cout << "✅ Converted selected line to center line." << std::endl;
 }
@@ -904,7 +950,8 @@ Handle(AIS_Shape) ShapeDrawer::DisplayCenterLine(
     drawer->SetTransparency(0.4);
     aisCenterLine->SetAttributes(drawer);
 
-    context->Display(aisCenterLine, Standard_True);
+    context->Display(aisCenterLine, Standard_False);
+    FrameScheduler::Redraw(context);
     std::cout << "✅ Center line displayed (dashed gray)." << std::endl;
 
     return aisCenterLine;
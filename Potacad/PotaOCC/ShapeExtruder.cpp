@@ -1,6 +1,7 @@
 ﻿#include "pch.h"
 #include "ShapeExtruder.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include <Quantity_Color.hxx>
 #include <AIS_Shape.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
@@ -21,6 +22,14 @@ ShapeExtruder::ShapeExtruder(NativeViewerHandle* nativeHandle)
 
 bool ShapeExtruder::ExtrudeWireAndDisplayPreview(const Handle(AIS_InteractiveContext)& context)
 {
+    // Profile already meshed for this wire: only the height changes
+    if (!native->extrudePreview.IsNull())
+    {
+        if (native->extrudePreview->SetHeight(native->currentExtrudeHeight))
+            context->Redisplay(native->extrudePreview, Standard_False);
+        return true;
+    }
+
     // Build planar face from wire
     BRepBuilderAPI_MakeFace makeFace(native->activeWire);
     if (!makeFace.IsDone()) {
@@ -40,25 +49,17 @@ bool ShapeExtruder::ExtrudeWireAndDisplayPreview(const Handle(AIS_InteractiveCon
 
     // Correct world-space normal
     gp_Pln plane = geomPlane->Pln();
-    gp_Vec extrudeDir(plane.Axis().Direction());
-    extrudeDir *= native->currentExtrudeHeight; // Apply height (positive or negative)
 
-    // Extrude
-    TopoDS_Shape previewSolid = BRepPrimAPI_MakePrism(face, extrudeDir);
-    if (previewSolid.IsNull()) {
-        std::cout << "❌ Extrusion failed." << std::endl;
+    // Mesh the profile once; the real prism is only built in ExtrudeWireAndDisplayFinal
+    Handle(AIS_ExtrudePreview) preview = new AIS_ExtrudePreview(face, plane.Axis().Direction());
+    if (!preview->IsValid()) {
+        std::cout << "❌ Failed to mesh extrusion profile." << std::endl;
         return false;
     }
 
-    // Display preview shape
-    if (!native->extrudePreviewShape.IsNull())
-        context->Remove(native->extrudePreviewShape, Standard_False);
-
-    native->extrudePreviewShape = new AIS_Shape(previewSolid);
-    native->extrudePreviewShape->SetColor(Quantity_NOC_PINK);
-    native->extrudePreviewShape->SetTransparency(0.0);
-    native->extrudePreviewShape->SetDisplayMode(AIS_Shaded);
-    context->Display(native->extrudePreviewShape, Standard_False);
+    preview->SetHeight(native->currentExtrudeHeight);
+    native->extrudePreview = preview;
+    context->Display(native->extrudePreview, 0, -1, Standard_False);
 
     return true;
 }
@@ -98,11 +99,14 @@ bool ShapeExtruder::ExtrudeWireAndDisplayFinal(const Handle(AIS_InteractiveConte
     Handle(AIS_Shape) aisSolid = new AIS_Shape(solid);
     aisSolid->SetColor(Quantity_NOC_ORANGE);
     aisSolid->SetDisplayMode(AIS_Shaded);
-    context->Display(aisSolid, Standard_True);
+    MeshingService::Of(native).Submit(aisSolid, native->view);
+    context->Display(aisSolid, Standard_False);
+    FrameScheduler::Redraw(context);
+    native->commandJournal.Added(context, aisSolid);
 
     //std::cout << "✅ Extrusion finalized. Height: " << finalHeight << std::endl;
 
-    native->extrudePreviewShape.Nullify();
+    native->extrudePreview.Nullify();
     native->activeWire.Nullify();
 
     return true;
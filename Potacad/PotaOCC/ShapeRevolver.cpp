@@ -1,11 +1,47 @@
 ﻿#include "pch.h"
 #include "ShapeRevolver.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include <BRepBuilderAPI_MakeFace.hxx>
 
 using namespace PotaOCC;
 
 ShapeRevolver::ShapeRevolver(NativeViewerHandle* nativeHandle) : native(nativeHandle) {}
+bool ShapeRevolver::RevolveWireAndDisplayPreview(const Handle(AIS_InteractiveContext)& context)
+{
+    // Profile already meshed for this wire: only the angle changes
+    if (!native->revolvePreview.IsNull())
+    {
+        native->revolvePreview->SetAngle(native->currentRevolveAngle);
+        return true;
+    }
+
+    if (native->activeWire.IsNull() || !native->isRevolveAxisSet)
+    {
+        std::cout << "⚠️ No wire or axis selected for revolve." << std::endl;
+        return false;
+    }
+    BRepBuilderAPI_MakeFace makeFace(native->activeWire);
+    if (!makeFace.IsDone())
+    {
+        std::cout << "❌ Failed to build face from wire." << std::endl;
+        return false;
+    }
+
+    // Mesh the profile once; the real revolution is only built in RevolveWireAndDisplayFinal
+    Handle(AIS_RevolvePreview) preview = new AIS_RevolvePreview(makeFace.Face(), native->revolveAxis);
+    if (!preview->IsValid())
+    {
+        std::cout << "❌ Failed to mesh revolve profile." << std::endl;
+        return false;
+    }
+
+    preview->SetAngle(native->currentRevolveAngle);
+    native->revolvePreview = preview;
+    context->Display(native->revolvePreview, 0, -1, Standard_False);
+
+    return true;
+}
 bool ShapeRevolver::RevolveWireAndDisplayFinal(const Handle(AIS_InteractiveContext)& context, double angleDeg)
 {
     if (native->activeWire.IsNull() || !native->isRevolveAxisSet)
@@ -23,9 +59,12 @@ bool ShapeRevolver::RevolveWireAndDisplayFinal(const Handle(AIS_InteractiveConte
     Handle(AIS_Shape) aisSolid = new AIS_Shape(solid);
     aisSolid->SetColor(Quantity_NOC_ORANGE);
     aisSolid->SetDisplayMode(AIS_Shaded);
-    context->Display(aisSolid, Standard_True);
+    MeshingService::Of(native).Submit(aisSolid, native->view);
+    context->Display(aisSolid, Standard_False);
+    FrameScheduler::Redraw(context);
+    native->commandJournal.Added(context, aisSolid);
     //std::cout << "✅ Revolve finalized. Angle: " << angleDeg << "°" << std::endl;
-    native->revolvePreviewShape.Nullify();
+    native->revolvePreview.Nullify();
     native->activeWire.Nullify();
     native->isRevolveAxisSet = false;
 
@@ -60,7 +99,10 @@ bool ShapeRevolver::RevolveWireAndDisplayFinal(const Handle(AIS_InteractiveConte
     Handle(AIS_Shape) aisRevolved = new AIS_Shape(revolved);
     aisRevolved->SetColor(Quantity_NOC_YELLOW);
     aisRevolved->SetDisplayMode(AIS_Shaded);
-    context->Display(aisRevolved, Standard_True);
+    MeshingService::Of(native).Submit(aisRevolved, native->view);
+    context->Display(aisRevolved, Standard_False);
+    FrameScheduler::Redraw(context);
+    native->commandJournal.Added(context, aisRevolved);
     //std::cout << "✅ Revolve completed successfully around the first selected line axis." << std::endl;
     return true;
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ class ShapeRevolver
 {
 public:
     explicit ShapeRevolver(PotaOCC::NativeViewerHandle* nativeHandle);
+    bool RevolveWireAndDisplayPreview(const Handle(AIS_InteractiveContext)& context);
     bool RevolveWireAndDisplayFinal(const Handle(AIS_InteractiveContext)& context, double angleDeg);
     bool RevolveWireAndDisplayFinal(const Handle(AIS_InteractiveContext)& context, const TopoDS_Wire& wire, double angle);
 private:
@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "SolidDrawer.h"
+#include "SelectionHelper.h"
 #include <AIS_InteractiveContext.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
 #include <BRepBuilderAPI_MakeWire.hxx>
@@ -53,7 +55,7 @@ void SolidDrawer::DrawSolid(IntPtr ctxPtr,
     ctx->SetColor(aisFace, Quantity_Color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB), Standard_False);
     ctx->SetTransparency(aisFace, transparency, Standard_False);
 
-    ctx->UpdateCurrentViewer();
+    FrameScheduler::Redraw(ctx);
 }
 
 array<int>^ SolidDrawer::DrawSolidBatch(
@@ -98,7 +100,7 @@ array<int>^ SolidDrawer::DrawSolidBatch(
             if (transparency != nullptr && i < transparency->Length)
                 ctx->SetTransparency(aisShape, transparency[i], Standard_False);
 
-            ctx->Display(aisShape, Standard_False);
+            SelectionHelper::DisplayDeferred(ctx, aisShape);
             ids[i] = (int)aisShape.get();
         }
         catch (...)
@@ -108,6 +110,6 @@ array<int>^ SolidDrawer::DrawSolidBatch(
     }
 
 
-    ctx->UpdateCurrentViewer();
+    FrameScheduler::Redraw(ctx);
     return ids;
 }
\ No newline at end of file
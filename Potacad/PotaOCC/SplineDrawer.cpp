@@ -1,6 +1,9 @@
 ﻿#include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "SplineDrawer.h"
+#include "SelectionHelper.h"
+#include "ViewerManager.h"
 #include <AIS_InteractiveContext.hxx>
 #include <Geom_BSplineCurve.hxx>
 #include <TColgp_HArray1OfPnt.hxx>
@@ -36,6 +39,8 @@ array<int>^ SplineDrawer::DrawSplineBatch(
     if (!rawCtx) return gcnew array<int>(0);
 
     Handle(AIS_InteractiveContext) ctx(rawCtx);
+    NativeViewerHandle* native = ViewerRegistry::FindByContext(rawCtx);
+    if (!native) return gcnew array<int>(0);
     int nSplines = x->Length;
 
     // Create a list to store the IDs of the drawn splines
@@ -111,24 +116,13 @@ array<int>^ SplineDrawer::DrawSplineBatch(
                 true
             );
 
-            // Wrap the spline into an AIS_Shape for visualization
-            Handle(AIS_Shape) aisSpline = new AIS_Shape(BRepBuilderAPI_MakeEdge(spline));
-
             // Apply color and transparency
-            Quantity_Color qcol(rVal / 255.0, gVal / 255.0, bVal / 255.0, Quantity_TOC_RGB);  // Convert to RGB (normalized)
-
-            ctx->Display(aisSpline, Standard_False);
-            ctx->SetColor(aisSpline, qcol, Standard_False);
-            ctx->SetTransparency(aisSpline, transparencyVal, Standard_False);
-
-            ctx->Activate(aisSpline, TopAbs_SHAPE, Standard_False);
-
-            // Ensure the shape is properly activated and displayed
-            ctx->Redisplay(aisSpline, Standard_False); // Redraw the shape in the viewer
+            EntityStyle style;
+            style.color = Quantity_Color(rVal / 255.0, gVal / 255.0, bVal / 255.0, Quantity_TOC_RGB);  // Convert to RGB (normalized)
+            style.transparency = transparencyVal;
 
-            // Store the ID of the AIS_Shape
-            int shapeId = (int)aisSpline.get();  // Get the ID of the drawn spline
-            ids->Add(shapeId);
+            // Store the spline as a document row; its presentation is derived on Sync below
+            ids->Add(native->document.Create(EntityType::Spline, BRepBuilderAPI_MakeEdge(spline), style, native->layers.Current()));
         }
         catch (const Standard_Failure& e) {
             // If an error occurs during spline creation, log the error and continue with the next spline
@@ -138,7 +132,8 @@ array<int>^ SplineDrawer::DrawSplineBatch(
     }
 
     // Return the IDs of the drawn splines
-    ctx->UpdateCurrentViewer();
+    native->document.Sync(native);
+    FrameScheduler::Redraw(ctx);
     return ids->ToArray();
 }
 
@@ -239,8 +234,8 @@ void AddShapeToViewer(const Handle(AIS_Shape)& shape, const Quantity_Color& col)
     }
 
     shape->SetColor(col);
-    globalViewerContext->Display(shape, true); // true = immediate redraw
-    globalViewerContext->UpdateCurrentViewer();  // Refresh the viewer
+    globalViewerContext->Display(shape, Standard_False);
+    FrameScheduler::Redraw(globalViewerContext);  // Refresh the viewer
     //std::cout << "Shape added to the viewer!" << std::endl;
 }
 array<int>^ SplineDrawer::DrawSplineWithKnotsBatch(
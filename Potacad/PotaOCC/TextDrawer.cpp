@@ -3,12 +3,20 @@
 #include <Windows.h>
 #include <winnls.h>
 #include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepBndLib.hxx>
+#include <Bnd_Box.hxx>
+#include <algorithm>
+#include <cmath>
 
 void PerformUnmanagedMeshOperations(const TopoDS_Shape& shape)
 {
     try
     {
-        BRepMesh_IncrementalMesh(shape, 0.1);
+        // Deflection follows the outline size instead of a fixed 0.1 model units
+        Bnd_Box box;
+        BRepBndLib::Add(shape, box);
+        const double deflection = box.IsVoid() ? 0.1 : (std::max)(std::sqrt(box.SquareExtent()) * 0.001, 1.0e-4);
+        BRepMesh_IncrementalMesh(shape, deflection, Standard_False, 0.5, Standard_True);
     }
     catch (Standard_Failure& e)
     {
@@ -21,6 +29,8 @@ void PerformUnmanagedMeshOperations(const TopoDS_Shape& shape)
 
 #include "TextDrawer.h"
 #include "NativeViewerHandle.h"
+#include "SelectionHelper.h"
+#include "FrameScheduler.h"
 #include <gp_Dir.hxx>
 #include <TopoDS_Shape.hxx>
 #include <AIS_Shape.hxx>
@@ -199,13 +209,12 @@ void TextDrawer::DrawTextBatch(
         aisText->SetLocalTransformation(transform);
 
         //aisText->SetDisplayMode(AIS_Shaded); // This can shade the text but the output is very terrible so better dont use it, just keep it outline
-        context->Display(aisText, Standard_False);
+        SelectionHelper::DisplayDeferred(native, context, aisText);
 
         native->ais2DShapes.push_back(aisText);
     }
 
-    context->UpdateCurrentViewer();
-    view->Redraw();
+    FrameScheduler::Redraw(context);
 
 }
 
@@ -0,0 +1,100 @@
+#include "pch.h"
+#include "TransformSession.h"
+#include "GeometryHelper.h"
+#include "SelectionHelper.h"
+#include <AIS_Shape.hxx>
+#include <limits>
+#include <iostream>
+
+namespace PotaOCC
+{
+    namespace TransformSession
+    {
+        bool Begin(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context)
+        {
+            if (native == nullptr || context.IsNull() || native->selectedEntities.empty())
+                return false;
+            if (IsActive(native))
+                End(native, context);
+
+            Handle(AIS_MultipleConnectedInteractive) group = new AIS_MultipleConnectedInteractive();
+            EntityBounds extent;
+            extent.xMin = extent.yMin = std::numeric_limits<double>::max();
+            extent.xMax = extent.yMax = -std::numeric_limits<double>::max();
+
+            for (int id : native->selectedEntities)
+            {
+                const Handle(AIS_InteractiveObject)& obj = native->entityIndex.Object(id);
+                if (obj.IsNull() || !context->IsDisplayed(obj))
+                    continue;
+
+                // Instances share the member's presentation; nothing is copied or re-tessellated
+                group->Connect(obj);
+                native->transformMembers.push_back(obj);
+                extent.Add(native->entityIndex.Bounds(id));
+            }
+            if (native->transformMembers.empty())
+                return false;
+
+            for (const Handle(AIS_InteractiveObject)& obj : native->transformMembers)
+                context->Erase(obj, Standard_False);
+
+            native->transformGroup = group;
+            context->Display(group, 0, -1, Standard_False);
+
+            // Rotation pivots about the centre of the selection in the drawing plane
+            native->rotatePivot = gp_Pnt((extent.xMin + extent.xMax) / 2.0, (extent.yMin + extent.yMax) / 2.0, 0.0);
+
+            std::cout << "✅ Transform session started with " << native->transformMembers.size() << " objects." << std::endl;
+            return true;
+        }
+        bool IsActive(NativeViewerHandle* native)
+        {
+            return native != nullptr && !native->transformGroup.IsNull();
+        }
+        void Compose(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const gp_Trsf& delta)
+        {
+            if (!IsActive(native)) return;
+
+            gp_Trsf newTrsf = delta.Multiplied(native->transformGroup->LocalTransformation());
+            context->SetLocation(native->transformGroup, TopLoc_Location(newTrsf));
+
+            // The batched selection highlight follows the group instead of being repacked every frame
+            if (!native->selectionHighlight.IsNull() && context->IsDisplayed(native->selectionHighlight))
+                context->SetLocation(native->selectionHighlight, TopLoc_Location(newTrsf.Multiplied(native->selectionHighlight->OriginShift())));
+        }
+        void End(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context)
+        {
+            if (!IsActive(native)) return;
+
+            const gp_Trsf sessionTrsf = native->transformGroup->LocalTransformation();
+            context->Remove(native->transformGroup, Standard_False);
+            native->transformGroup.Nullify();
+
+            const bool isMoved = sessionTrsf.Form() != gp_Identity;
+            native->commandJournal.Begin("Transform");
+            for (const Handle(AIS_InteractiveObject)& obj : native->transformMembers)
+            {
+                if (isMoved)
+                {
+                    native->commandJournal.Moved(context, obj, sessionTrsf);
+                    context->SetLocation(obj, TopLoc_Location(sessionTrsf.Multiplied(obj->LocalTransformation())));
+
+                    // B-rep entities get the transformation baked in; others keep it as their location
+                    Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(obj);
+                    if (!aisShape.IsNull())
+                        GeometryHelper::ApplyLocalTransformationToAISShape(aisShape, context);
+                }
+                context->Display(obj, Standard_False);
+            }
+            native->commandJournal.Commit(context);
+
+            if (isMoved)
+                SelectionHelper::RefreshEntities(native, context, native->transformMembers);
+            if (!native->selectionHighlight.IsNull())
+                context->SetLocation(native->selectionHighlight, TopLoc_Location(native->selectionHighlight->OriginShift()));
+
+            native->transformMembers.clear();
+        }
+    }
+}
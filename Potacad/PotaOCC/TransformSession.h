@@ -0,0 +1,24 @@
+#pragma once
+#include "NativeViewerHandle.h"
+#include <AIS_InteractiveContext.hxx>
+#include <gp_Trsf.hxx>
+
+namespace PotaOCC
+{
+    struct NativeViewerHandle;
+
+    // Move/rotate of the whole selection: members are shown through one AIS_MultipleConnectedInteractive
+    // whose location carries the shared gp_Trsf, so each frame is a single location update.
+    namespace TransformSession
+    {
+        // Starts a session over the current selection; returns false if there is nothing to transform
+        bool Begin(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context);
+        bool IsActive(NativeViewerHandle* native);
+
+        // Pre-multiplies delta (world space) onto the session transformation
+        void Compose(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context, const gp_Trsf& delta);
+
+        // Bakes the accumulated transformation into every member and restores them
+        void End(NativeViewerHandle* native, const Handle(AIS_InteractiveContext)& context);
+    }
+}
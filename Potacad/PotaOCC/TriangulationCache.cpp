@@ -0,0 +1,334 @@
+#include "pch.h"
+#include "TriangulationCache.h"
+#include <BinTools.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Directory.hxx>
+#include <OSD_File.hxx>
+#include <OSD_FileIterator.hxx>
+#include <OSD_Path.hxx>
+#include <OSD_Process.hxx>
+#include <OSD_Protection.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Quantity_Date.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <streambuf>
+#include <vector>
+
+namespace PotaOCC
+{
+    namespace
+    {
+        const uint32_t THE_MAGIC = 0x49525450;      // "PTRI"
+        const uint32_t THE_VERSION = 1;
+#ifdef _WIN32
+        const char* const THE_SEPARATOR = "\\";
+#else
+        const char* const THE_SEPARATOR = "/";
+#endif
+
+        // FNV-1a over everything written to it, so hashing never materializes the serialized shape
+        class HashingBuffer : public std::streambuf
+        {
+        public:
+            uint64_t hash = 0xcbf29ce484222325ull;
+
+        protected:
+            int_type overflow(int_type ch) override
+            {
+                if (ch != traits_type::eof()) Add((unsigned char)ch);
+                return traits_type::not_eof(ch);
+            }
+            std::streamsize xsputn(const char* data, std::streamsize count) override
+            {
+                for (std::streamsize i = 0; i < count; ++i) Add((unsigned char)data[i]);
+                return count;
+            }
+
+        private:
+            void Add(unsigned char byte)
+            {
+                hash ^= byte;
+                hash *= 0x100000001b3ull;
+            }
+        };
+
+        bool EnsureDirectory(const std::string& path)
+        {
+            OSD_Directory dir(OSD_Path(TCollection_AsciiString(path.c_str())));
+            if (!dir.Exists())
+                dir.Build(OSD_Protection());
+            return dir.Exists() == Standard_True;
+        }
+
+        template <typename T>
+        void Put(std::ofstream& out, const T& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+        template <typename T>
+        bool Get(std::istream& in, T& value) { return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T)); }
+
+        // Per-user cache roots first, then places that exist on any machine
+        std::vector<std::string> CandidateRoots()
+        {
+            std::vector<std::string> roots;
+            const char* const vars[] = { "LOCALAPPDATA", "XDG_CACHE_HOME", "TEMP", "TMP", "TMPDIR" };
+            for (const char* var : vars)
+            {
+                const char* value = std::getenv(var);
+                if (value != nullptr && *value != '\0')
+                    roots.push_back(value);
+            }
+
+            TCollection_AsciiString current;
+            OSD_Process().CurrentDirectory().SystemName(current);
+            if (!current.IsEmpty())
+                roots.push_back(current.ToCString());
+            return roots;
+        }
+    }
+
+    TriangulationCache& TriangulationCache::Instance()
+    {
+        static TriangulationCache instance;
+        return instance;
+    }
+
+    TriangulationCache::TriangulationCache()
+    {
+        for (const std::string& root : CandidateRoots())
+        {
+            const std::string app = root + THE_SEPARATOR + "Potacad";
+            const std::string cache = app + THE_SEPARATOR + "MeshCache";
+            if (EnsureDirectory(app) && EnsureDirectory(cache))
+            {
+                myDirectory = cache;
+                break;
+            }
+            std::cout << "⚠️ Mesh cache: cannot create " << cache << ", trying the next location" << std::endl;
+        }
+
+        if (myDirectory.empty())
+        {
+            std::cout << "⚠️ Mesh cache disabled: no writable location" << std::endl;
+            return;
+        }
+        ScanDirectory();
+    }
+
+    void TriangulationCache::ScanDirectory()
+    {
+        // Files from earlier sessions start in their last access order; a session then ranks by its own hits
+        struct Found
+        {
+            std::string name;
+            uint64_t size;
+            Quantity_Date accessed;
+        };
+        std::vector<Found> found;
+        for (OSD_FileIterator it(OSD_Path(TCollection_AsciiString(myDirectory.c_str())), "*.ptri"); it.More(); it.Next())
+        {
+            OSD_Path path;
+            it.Values().Path(path);
+            const std::string name = (path.Name() + path.Extension()).ToCString();
+
+            OSD_File file(OSD_Path(TCollection_AsciiString(PathFor(name).c_str())));
+            Found entry;
+            entry.name = name;
+            entry.size = (uint64_t)file.Size();
+            entry.accessed = file.AccessMoment();
+            found.push_back(entry);
+        }
+        std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.accessed < b.accessed; });
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        for (const Found& entry : found)
+            Touch(entry.name, entry.size);
+        EvictToBudget();
+    }
+
+    void TriangulationCache::Touch(const std::string& name, uint64_t size)
+    {
+        auto it = myRecords.find(name);
+        if (it != myRecords.end())
+        {
+            myByUse.erase(it->second.lastUse);
+            myTotalBytes -= it->second.size;
+        }
+
+        Record& record = myRecords[name];
+        record.size = size;
+        record.lastUse = ++myUseClock;
+        myByUse[record.lastUse] = name;
+        myTotalBytes += size;
+    }
+
+    void TriangulationCache::EvictToBudget()
+    {
+        // The newest file always stays, even when it alone is over the budget
+        while (myTotalBytes > THE_MAX_BYTES && myByUse.size() > 1)
+        {
+            auto oldest = myByUse.begin();
+            const std::string name = oldest->second;
+            myByUse.erase(oldest);
+
+            auto it = myRecords.find(name);
+            myTotalBytes -= it->second.size;
+            myRecords.erase(it);
+            std::remove(PathFor(name).c_str());
+        }
+    }
+
+    uint64_t TriangulationCache::ContentHash(const TopoDS_Shape& shape)
+    {
+        HashingBuffer buffer;
+        std::ostream stream(&buffer);
+        BinTools::Write(shape, stream, Standard_False, Standard_False, BinTools_FormatVersion_CURRENT);
+        return buffer.hash;
+    }
+
+    std::string TriangulationCache::NameFor(uint64_t hash, int level) const
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%016llx_L%d.ptri", (unsigned long long)hash, level);
+        return name;
+    }
+
+    std::string TriangulationCache::PathFor(const std::string& name) const
+    {
+        return myDirectory + THE_SEPARATOR + name;
+    }
+
+    bool TriangulationCache::Load(uint64_t hash, int level, const TopoDS_Shape& shape)
+    {
+        if (!IsEnabled()) return false;
+
+        // The file is read whole under the lock, so Store and eviction never replace it mid-read
+        const std::string name = NameFor(hash, level);
+        std::string bytes;
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            std::ifstream file(PathFor(name), std::ios::binary);
+            if (!file) return false;
+            bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            Touch(name, bytes.size());
+        }
+        std::istringstream in(bytes);
+
+        uint32_t magic = 0, version = 0, nbFaces = 0;
+        if (!Get(in, magic) || !Get(in, version) || !Get(in, nbFaces)) return false;
+
+        TopTools_IndexedMapOfShape faces;
+        TopExp::MapShapes(shape, TopAbs_FACE, faces);
+        if (magic != THE_MAGIC || version != THE_VERSION || (int)nbFaces != faces.Extent()) return false;
+
+        // Read everything before touching the shape, so a truncated file leaves it untouched
+        std::vector<Handle(Poly_Triangulation)> triangulations(nbFaces);
+        for (uint32_t f = 0; f < nbFaces; ++f)
+        {
+            uint32_t nbNodes = 0, nbTriangles = 0;
+            double deflection = 0.0;
+            if (!Get(in, nbNodes) || !Get(in, nbTriangles) || !Get(in, deflection)) return false;
+            if (nbTriangles == 0) continue;
+
+            Handle(Poly_Triangulation) tri = new Poly_Triangulation((Standard_Integer)nbNodes, (Standard_Integer)nbTriangles, Standard_False);
+            for (uint32_t n = 1; n <= nbNodes; ++n)
+            {
+                double xyz[3];
+                if (!in.read(reinterpret_cast<char*>(xyz), sizeof(xyz))) return false;
+                tri->SetNode((Standard_Integer)n, gp_Pnt(xyz[0], xyz[1], xyz[2]));
+            }
+            for (uint32_t t = 1; t <= nbTriangles; ++t)
+            {
+                int32_t idx[3];
+                if (!in.read(reinterpret_cast<char*>(idx), sizeof(idx))) return false;
+                for (int32_t i : idx)
+                    if (i < 1 || i > (int32_t)nbNodes) return false;
+                tri->SetTriangle((Standard_Integer)t, Poly_Triangle(idx[0], idx[1], idx[2]));
+            }
+            tri->Deflection(deflection);
+            triangulations[f] = tri;
+        }
+
+        BRep_Builder builder;
+        for (uint32_t f = 0; f < nbFaces; ++f)
+        {
+            if (!triangulations[f].IsNull())
+                builder.UpdateFace(TopoDS::Face(faces((int)f + 1)), triangulations[f]);
+        }
+        return true;
+    }
+
+    void TriangulationCache::Store(uint64_t hash, int level, const TopoDS_Shape& meshedShape)
+    {
+        if (!IsEnabled()) return;
+
+        TopTools_IndexedMapOfShape faces;
+        TopExp::MapShapes(meshedShape, TopAbs_FACE, faces);
+
+        const std::string name = NameFor(hash, level);
+        const std::string path = PathFor(name);
+
+        // Workers can finish the same key concurrently: each writes its own temp file, published by rename
+        std::string temp;
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            temp = path + "." + std::to_string(++myTempCounter) + ".tmp";
+        }
+        uint64_t size = 0;
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out) return;
+
+            Put(out, THE_MAGIC);
+            Put(out, THE_VERSION);
+            Put(out, (uint32_t)faces.Extent());
+            for (int f = 1; f <= faces.Extent(); ++f)
+            {
+                TopLoc_Location loc;
+                const Handle(Poly_Triangulation)& tri = BRep_Tool::Triangulation(TopoDS::Face(faces(f)), loc);
+                const uint32_t nbNodes = tri.IsNull() ? 0 : (uint32_t)tri->NbNodes();
+                const uint32_t nbTriangles = tri.IsNull() ? 0 : (uint32_t)tri->NbTriangles();
+                Put(out, nbNodes);
+                Put(out, nbTriangles);
+                Put(out, tri.IsNull() ? 0.0 : tri->Deflection());
+                if (tri.IsNull()) continue;
+
+                // Nodes stay in the face's own frame, like the triangulation itself
+                for (Standard_Integer n = 1; n <= tri->NbNodes(); ++n)
+                {
+                    const gp_Pnt p = tri->Node(n);
+                    const double xyz[3] = { p.X(), p.Y(), p.Z() };
+                    out.write(reinterpret_cast<const char*>(xyz), sizeof(xyz));
+                }
+                for (Standard_Integer t = 1; t <= tri->NbTriangles(); ++t)
+                {
+                    Standard_Integer n1, n2, n3;
+                    tri->Triangle(t).Get(n1, n2, n3);
+                    const int32_t idx[3] = { (int32_t)n1, (int32_t)n2, (int32_t)n3 };
+                    out.write(reinterpret_cast<const char*>(idx), sizeof(idx));
+                }
+            }
+            if (!out) { out.close(); std::remove(temp.c_str()); return; }
+            size = (uint64_t)out.tellp();
+        }
+
+        std::lock_guard<std::mutex> lock(myMutex);
+        std::remove(path.c_str());
+        if (std::rename(temp.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temp.c_str());
+            return;
+        }
+        Touch(name, size);
+        EvictToBudget();
+    }
+}
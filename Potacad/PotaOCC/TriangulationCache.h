@@ -0,0 +1,61 @@
+#pragma once
+#include <TopoDS_Shape.hxx>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace PotaOCC
+{
+    // On-disk store of face triangulations keyed by shape content hash and mesh level
+    // (deflection = bounding-box diagonal / 2^level), shared by every viewer of the process.
+    // Files live under Potacad/MeshCache in the first usable of %LOCALAPPDATA%, $XDG_CACHE_HOME,
+    // the temp directory and the working directory, so refinement levels meshed in an earlier
+    // session come back without running BRepMesh (projects carry their saved meshes themselves).
+    // The directory is kept under
+    // THE_MAX_BYTES by dropping the least recently used files.
+    class TriangulationCache
+    {
+    public:
+        static const uint64_t THE_MAX_BYTES = 512ull * 1024 * 1024;
+
+        static TriangulationCache& Instance();
+
+        // Hash of the serialized geometry and topology (triangulations excluded)
+        static uint64_t ContentHash(const TopoDS_Shape& shape);
+
+        // Applies a cached mesh to shape's faces; false when missing or not matching
+        bool Load(uint64_t hash, int level, const TopoDS_Shape& shape);
+
+        // Safe to call from worker threads
+        void Store(uint64_t hash, int level, const TopoDS_Shape& meshedShape);
+
+        bool IsEnabled() const { return !myDirectory.empty(); }
+
+    private:
+        struct Record
+        {
+            uint64_t size = 0;
+            uint64_t lastUse = 0;
+        };
+
+        TriangulationCache();
+        std::string NameFor(uint64_t hash, int level) const;
+        std::string PathFor(const std::string& name) const;
+        void ScanDirectory();
+        void Touch(const std::string& name, uint64_t size);   // myMutex held
+        void EvictToBudget();                                   // myMutex held
+
+        std::string myDirectory;
+
+        // Guards the file index and every open, remove and rename of a published file, so a
+        // reader never sees a file while a writer replaces or evicts it
+        std::mutex myMutex;
+        std::unordered_map<std::string, Record> myRecords;
+        std::map<uint64_t, std::string> myByUse;                // lastUse -> name, oldest first
+        uint64_t myTotalBytes = 0;
+        uint64_t myUseClock = 0;
+        uint64_t myTempCounter = 0;
+    };
+}
@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "VertexDrawer.h"
+#include "SelectionHelper.h"
+#include "ViewerManager.h"
 #include <AIS_InteractiveContext.hxx>
 #include <V3d_Viewer.hxx>
 #include <V3d_View.hxx>
@@ -26,6 +29,9 @@ array<int>^ VertexDrawer::DrawVertexBatch(
     auto ids = gcnew array<int>(n);
 
     Handle(AIS_InteractiveContext) ctx(rawCtx);
+    NativeViewerHandle* native = ViewerRegistry::FindByContext(rawCtx);
+    if (!native) return gcnew array<int>(0);
+    const uint16_t layer = native->layers.Current();
 
     // Loop through the input data (vertices)
     for (int i = 0; i < n; i++)
@@ -38,26 +44,23 @@ array<int>^ VertexDrawer::DrawVertexBatch(
             // Create the vertex
             TopoDS_Vertex vertex = BRepBuilderAPI_MakeVertex(point);
 
-            // Create a shape for displaying
-            Handle(AIS_Shape) aisShape = new AIS_Shape(vertex);
-
             // Set color based on the input data
-            Quantity_Color col(r[i] / 255.0, g[i] / 255.0, b[i] / 255.0, Quantity_TOC_RGB);
-            ctx->SetColor(aisShape, col, Standard_False);
-            ctx->SetTransparency(aisShape, transparency[i], Standard_False);
-
-            // Display the shape in the viewer
-            ctx->Display(aisShape, Standard_False);
+            EntityStyle style;
+            style.color = Quantity_Color(r[i] / 255.0, g[i] / 255.0, b[i] / 255.0, Quantity_TOC_RGB);
+            style.transparency = transparency[i];
 
-            ids[i] = (int)aisShape.get();
+            // Store the vertex as a document row; it is displayed once Sync derives its presentation
+            ids[i] = native->document.Create(EntityType::Point, vertex, style, layer);
         }
         catch (...)
         {
-            ids[i] = 0; // Mark failed vertex creation
+            ids[i] = -1; // Mark failed vertex creation
         }
     }
 
+    native->document.Sync(native);
+
     // Update the viewer to display all the newly created shapes
-    ctx->UpdateCurrentViewer();
+    FrameScheduler::Redraw(ctx);
     return ids;
 }
\ No newline at end of file
@@ -2,7 +2,10 @@
 #include "ViewHelper.h"
 #include <V3d_View.hxx>
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
+#include "ViewerManager.h"
 #include <AIS_InteractiveContext.hxx>
+#include <Bnd_Box.hxx>
 #include <Graphic3d_ArrayOfSegments.hxx>
 #include <Prs3d_LineAspect.hxx>
 #include <Quantity_Color.hxx>
@@ -19,10 +22,40 @@ namespace PotaOCC
 
         if (view.IsNull()) return;
 
+        auto resetCamera = [](const Handle(V3d_View)& target)
+        {
+            target->SetProj(V3d_Zpos);
+            target->SetTwist(0.0);
+            LayerTable::FitAll(target);
+        };
+        NativeViewerHandle* native = ViewerRegistry::FindByView(view.get());
+        if (native != nullptr)
+        {
+            native->cameraAnimation.AnimateTo(native, resetCamera);
+            return;
+        }
+        resetCamera(view);
+        FrameScheduler::Redraw(view);
+    }
+
+    void ViewHelperPublic::FrameExtents(System::IntPtr viewPtr, double xMin, double yMin, double xMax, double yMax)
+    {
+        if (viewPtr == System::IntPtr::Zero) return;
+        Handle(V3d_View) view =
+            reinterpret_cast<V3d_View*>(viewPtr.ToPointer());
+
+        if (view.IsNull() || xMin > xMax || yMin > yMax) return;
+
+        // The scene is still empty: nothing to animate from, and FitAll() would have no bounds to use
+        CameraAnimator::Interrupt(view);
+        Bnd_Box box;
+        box.Update(xMin, yMin, 0.0, xMax, yMax, 0.0);
+        const Standard_Boolean wasImmediate = view->SetImmediateUpdate(Standard_False);
         view->SetProj(V3d_Zpos);
         view->SetTwist(0.0);
-        view->FitAll();
-        view->Redraw();
+        view->FitAll(box, 0.01, Standard_False);
+        view->SetImmediateUpdate(wasImmediate);
+        FrameScheduler::Redraw(view);
     }
     namespace ViewHelper
     {
@@ -68,31 +101,8 @@ namespace PotaOCC
         // Clears any entities like lines, circles, and resets flags
         void ClearCreateEntity(NativeViewerHandle* native)
         {
-            // Dismiss the overlay line (if it exists)
-            if (!native->lineOverlay.IsNull())
-            {
-                native->context->Erase(native->lineOverlay, Standard_False);  // Remove the overlay
-                native->lineOverlay.Nullify();  // Nullify the handle to clear it
-            }
-
-            // Dismiss the overlay circle (if it exists)
-            if (!native->circleOverlay.IsNull())
-            {
-                native->context->Erase(native->circleOverlay, Standard_False);  // Remove the overlay
-                native->circleOverlay.Nullify();  // Nullify the handle to clear it
-            }
-
-            if (!native->ellipseOverlay.IsNull())
-            {
-                native->context->Erase(native->ellipseOverlay, Standard_False);  // Remove the overlay
-                native->ellipseOverlay.Nullify();  // Nullify the handle to clear it
-            }
-
-            if (!native->rectangleOverlay.IsNull())
-            {
-                native->context->Erase(native->rectangleOverlay, Standard_False);  // Remove the overlay
-                native->rectangleOverlay.Nullify();  // Nullify the handle to clear it
-            }
+            // Dismiss the rubber band / drag preview (if shown)
+            native->overlay.Hide(native);
 
             if (!native->highlightedFace.IsNull())
             {
@@ -136,9 +146,15 @@ namespace PotaOCC
             native->isCenterLineSet = false;
             native->revolveAxisObj.Nullify();
             native->revolveAxisShape.Nullify();
+            native->isRevolvingActive = false;
+            if (!native->revolvePreview.IsNull() && !native->context.IsNull())
+                native->context->Remove(native->revolvePreview, Standard_False);
+            native->revolvePreview.Nullify();
 
             native->isExtrudingActive = false;
-            native->extrudePreviewShape.Nullify();
+            if (!native->extrudePreview.IsNull() && !native->context.IsNull())
+                native->context->Remove(native->extrudePreview, Standard_False);
+            native->extrudePreview.Nullify();
             native->activeWire.Nullify();
 
             native->isDrawDimensionMode = false;
@@ -167,7 +183,8 @@ namespace PotaOCC
             Handle(AIS_InteractiveObject) marker = new Marker(x, y, z);
             native->centerOverlay = marker;
             context->Display(marker, Standard_False);  // Display without refreshing
-            context->Redisplay(marker, Standard_True); // Redisplay to show the marker immediately
+            context->Redisplay(marker, Standard_False); // Redisplay to show the marker on the next frame
+            FrameScheduler::Redraw(context);
         }
 
         // Clears the center marker
@@ -182,7 +199,7 @@ namespace PotaOCC
                 native->centerOverlay.Nullify();
 
                 // Redisplay the context to update the view
-                native->view->Redraw();
+                FrameScheduler::Redraw(native);
             }
         }
 
@@ -9,6 +9,9 @@ namespace PotaOCC
     {
     public:
         static void ResetView(System::IntPtr viewPtr);
+
+        // +Z, no twist, framed on the given XY box at once; for loads that know their extents before drawing
+        static void FrameExtents(System::IntPtr viewPtr, double xMin, double yMin, double xMax, double yMax);
     };
 
     // ✅ This stays as pure C++ native namespace (not C# visible)
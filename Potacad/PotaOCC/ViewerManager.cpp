@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "NativeViewerHandle.h"
+#include "FrameScheduler.h"
 #include "ViewerManager.h"
 
 #include <WNT_Window.hxx>
@@ -45,10 +46,48 @@
 
 using namespace PotaOCC;
 
-// Thread-safe map to keep track of NativeViewerHandle per viewer (optional, for future use)
-static std::map<NativeViewerHandle*, Handle(V3d_View)> g_viewMap;
+// Thread-safe map from AIS context to its NativeViewerHandle
+static std::map<const AIS_InteractiveContext*, NativeViewerHandle*> g_viewMap;
 static std::mutex g_viewMapMutex;
 
+namespace PotaOCC
+{
+    namespace ViewerRegistry
+    {
+        void Register(NativeViewerHandle* native)
+        {
+            if (!native || native->context.IsNull()) return;
+            std::lock_guard<std::mutex> lock(g_viewMapMutex);
+            g_viewMap[native->context.get()] = native;
+        }
+        void Unregister(NativeViewerHandle* native)
+        {
+            if (!native) return;
+            std::lock_guard<std::mutex> lock(g_viewMapMutex);
+            for (auto it = g_viewMap.begin(); it != g_viewMap.end(); )
+            {
+                if (it->second == native) it = g_viewMap.erase(it);
+                else ++it;
+            }
+        }
+        NativeViewerHandle* FindByContext(const AIS_InteractiveContext* context)
+        {
+            if (!context) return nullptr;
+            std::lock_guard<std::mutex> lock(g_viewMapMutex);
+            auto it = g_viewMap.find(context);
+            return it != g_viewMap.end() ? it->second : nullptr;
+        }
+        NativeViewerHandle* FindByView(const V3d_View* view)
+        {
+            if (!view) return nullptr;
+            std::lock_guard<std::mutex> lock(g_viewMapMutex);
+            for (const auto& entry : g_viewMap)
+                if (entry.second->view.get() == view) return entry.second;
+            return nullptr;
+        }
+    }
+}
+
 ViewerHandle^ ViewerManager::CreateViewer(IntPtr hwnd, int width, int height, Control^ hostControl)
 {
     Handle(Aspect_DisplayConnection) displayConnection = new Aspect_DisplayConnection();
@@ -80,6 +119,7 @@ ViewerHandle^ ViewerManager::CreateViewer(IntPtr hwnd, int width, int height, Co
     native->view = view;
     native->context = context;
     native->hostControl = hostControl; // ? This enables cursor updates
+    ViewerRegistry::Register(native);
 
 
     ViewerHandle^ handle = gcnew ViewerHandle();
@@ -108,7 +148,16 @@ void ViewerManager::ResizeViewer(IntPtr viewerHandlePtr, int width, int height)
 void ViewerManager::FitAll(IntPtr viewPtr)
 {
     Handle(V3d_View) view = static_cast<V3d_View*>(viewPtr.ToPointer());
-    if (!view.IsNull()) { view->FitAll(); view->Redraw(); }
+    if (view.IsNull()) return;
+
+    NativeViewerHandle* native = ViewerRegistry::FindByView(view.get());
+    if (native != nullptr)
+        native->cameraAnimation.AnimateTo(native, [](const Handle(V3d_View)& target) { LayerTable::FitAll(target); });
+    else
+    {
+        view->FitAll();
+        FrameScheduler::Redraw(view);
+    }
 }
 
 void ViewerManager::UpdateView(IntPtr viewerHandlePtr, bool isDisposing)
@@ -120,8 +169,7 @@ void ViewerManager::UpdateView(IntPtr viewerHandlePtr, bool isDisposing)
     if (!native) return;
     if (native->context.IsNull() || native->view.IsNull()) return;
 
-    native->context->UpdateCurrentViewer();
-    native->view->Redraw();
+    FrameScheduler::Redraw(native);
 }
 
 void ViewerManager::SetBackgroundColor(IntPtr viewPtr, int r, int g, int b)
@@ -130,7 +178,7 @@ void ViewerManager::SetBackgroundColor(IntPtr viewPtr, int r, int g, int b)
     if (!view.IsNull())
     {
         view->SetBackgroundColor(Quantity_Color(r / 255.0, g / 255.0, b / 255.0, Quantity_TOC_RGB));
-        view->Redraw();
+        FrameScheduler::Redraw(view);
     }
 }
 
@@ -141,6 +189,8 @@ void ViewerManager::DisposeViewer(System::IntPtr viewerHandlePtr)
     NativeViewerHandle* native = reinterpret_cast<NativeViewerHandle*>(viewerHandlePtr.ToPointer());
     if (!native) return;
 
+    ViewerRegistry::Unregister(native);
+
     if (!native->context.IsNull())
     {
         native->context->EraseAll(Standard_True);
@@ -197,7 +247,7 @@ void ViewerManager::Redraw(IntPtr viewPtr)
 
     if (!view.IsNull())
     {
-        view->Redraw();
+        FrameScheduler::Redraw(view);
     }
 }
 
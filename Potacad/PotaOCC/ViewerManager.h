@@ -3,7 +3,20 @@
 
 using namespace System;
 
+class AIS_InteractiveContext;
+class V3d_View;
+
 namespace PotaOCC {
+    struct NativeViewerHandle;
+
+    // Native lookup for batch APIs that only receive the AIS context pointer
+    namespace ViewerRegistry
+    {
+        void Register(NativeViewerHandle* native);
+        void Unregister(NativeViewerHandle* native);
+        NativeViewerHandle* FindByContext(const AIS_InteractiveContext* context);
+        NativeViewerHandle* FindByView(const V3d_View* view);
+    }
 
     // Managed handle to store pointers to native OCCT objects
     public ref class ViewerHandle
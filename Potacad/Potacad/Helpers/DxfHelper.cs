@@ -4,6 +4,7 @@ using System.Collections.Generic;
 using System.Globalization;
 using System.IO;
 using System.Linq.Expressions;
+using System.Threading;
 using System.Threading.Tasks;
 using static Potacad.Helpers.EntityDrawerHelper;
 using static Potacad.MouseActions;
@@ -12,6 +13,7 @@ using static PotaOCC.ShapeDrawer;
 using static PotaOCC.ViewerManager;
 using Application = System.Windows.Application;
 using System.Linq;
+using System.Windows.Threading;
 
 namespace Potacad.Helpers
 {
@@ -100,6 +102,227 @@ namespace Potacad.Helpers
         }
         #endregion
 
+        // ============================================================
+        #region --- Block Data Models ---
+        // ============================================================
+        public class BlockData
+        {
+            public string name = string.Empty;
+            public double baseX, baseY, baseZ;
+            public List<(double x1, double y1, double z1, double x2, double y2, double z2, int color)> lines = new();
+            public List<(double cx, double cy, double cz, double r, double startAngle, double endAngle, int color)> arcs = new(); // circles span 0..360
+            public List<(double[] x, double[] y, double[] bulge, double elevation, bool closed, int color)> polylines = new();
+            public List<(double[] corners, int color)> faces = new(); // x, y, z triples in outline order
+            public List<InsertData> inserts = new();
+        }
+
+        public class InsertData
+        {
+            public string name = string.Empty;
+            public double x, y, z;
+            public double scaleX = 1, scaleY = 1, scaleZ = 1;
+            public double rotationAngle;
+            public int columns = 1, rows = 1;
+            public double columnSpacing, rowSpacing;
+        }
+        #endregion
+
+        // ✅ INSERT group codes (also used for MINSERT arrays and nested references)
+        private static InsertData ReadInsert(List<(string code, string value)> fields)
+        {
+            var insert = new InsertData();
+            foreach (var (c, v) in fields)
+            {
+                double.TryParse(v, NumberStyles.Float, CultureInfo.InvariantCulture, out double dval);
+                int.TryParse(v, out int ival);
+
+                switch (c)
+                {
+                    case "2": insert.name = v; break;
+                    case "10": insert.x = dval; break;
+                    case "20": insert.y = dval; break;
+                    case "30": insert.z = dval; break;
+                    case "41": insert.scaleX = dval; break;
+                    case "42": insert.scaleY = dval; break;
+                    case "43": insert.scaleZ = dval; break;
+                    case "50": insert.rotationAngle = dval; break;
+                    case "70": insert.columns = Math.Max(1, ival); break;
+                    case "71": insert.rows = Math.Max(1, ival); break;
+                    case "44": insert.columnSpacing = dval; break;
+                    case "45": insert.rowSpacing = dval; break;
+                }
+            }
+            return insert;
+        }
+
+        // ✅ BLOCKS section parser: the geometry each block definition holds, in block coordinates.
+        // Text and hatches inside blocks are not read.
+        private static List<BlockData> ParseDxfBlocks(List<(string code, string value)> pairs)
+        {
+            var blocks = new List<BlockData>(64);
+
+            int i = 0;
+            bool inBlocks = false;
+            for (; i + 1 < pairs.Count; i++)
+            {
+                if (pairs[i].code == "0" && pairs[i].value.Equals("SECTION", StringComparison.OrdinalIgnoreCase)
+                    && pairs[i + 1].code == "2" && pairs[i + 1].value.Equals("BLOCKS", StringComparison.OrdinalIgnoreCase))
+                {
+                    i += 2;
+                    inBlocks = true;
+                    break;
+                }
+            }
+            if (!inBlocks) return blocks;
+
+            BlockData? block = null;
+            List<(double x, double y, double z, double bulge)>? polylineVertices = null;
+            bool polylineClosed = false;
+            int polylineColor = 7;
+
+            while (i < pairs.Count)
+            {
+                if (pairs[i].code != "0") { i++; continue; }
+
+                string entity = pairs[i].value.ToUpperInvariant();
+                if (entity == "ENDSEC") break;
+
+                // group codes of this entity, up to the next one
+                var fields = new List<(string code, string value)>(16);
+                for (i++; i < pairs.Count && pairs[i].code != "0"; i++)
+                    fields.Add(pairs[i]);
+
+                double D(string code, double fallback = 0)
+                {
+                    foreach (var (c, v) in fields)
+                        if (c == code && double.TryParse(v, NumberStyles.Float, CultureInfo.InvariantCulture, out double d)) return d;
+                    return fallback;
+                }
+                int I(string code, int fallback = 0)
+                {
+                    foreach (var (c, v) in fields)
+                        if (c == code && int.TryParse(v, out int n)) return n;
+                    return fallback;
+                }
+
+                if (entity == "BLOCK")
+                {
+                    string name = fields.FirstOrDefault(f => f.code == "2").value ?? string.Empty;
+
+                    // Layout blocks hold paper space, not anything an INSERT references
+                    bool isLayout = name.StartsWith("*MODEL_SPACE", StringComparison.OrdinalIgnoreCase)
+                                 || name.StartsWith("*PAPER_SPACE", StringComparison.OrdinalIgnoreCase);
+                    block = isLayout || name.Length == 0 ? null : new BlockData { name = name, baseX = D("10"), baseY = D("20"), baseZ = D("30") };
+                    if (block != null) blocks.Add(block);
+                    continue;
+                }
+                if (entity == "ENDBLK") { block = null; continue; }
+                if (block == null) continue;
+
+                switch (entity)
+                {
+                    case "LINE":
+                        block.lines.Add((D("10"), D("20"), D("30"), D("11"), D("21"), D("31"), I("62", 7)));
+                        break;
+
+                    case "ARC":
+                        block.arcs.Add((D("10"), D("20"), D("30"), D("40"), D("50"), D("51"), I("62", 7)));
+                        break;
+
+                    case "CIRCLE":
+                        block.arcs.Add((D("10"), D("20"), D("30"), D("40"), 0.0, 360.0, I("62", 7)));
+                        break;
+
+                    case "LWPOLYLINE":
+                    {
+                        var xs = new List<double>(); var ys = new List<double>(); var bulges = new List<double>();
+                        foreach (var (c, v) in fields)
+                        {
+                            double.TryParse(v, NumberStyles.Float, CultureInfo.InvariantCulture, out double dval);
+                            if (c == "10") { xs.Add(dval); bulges.Add(0); }
+                            else if (c == "20" && ys.Count < xs.Count) ys.Add(dval);
+                            else if (c == "42" && bulges.Count > 0) bulges[bulges.Count - 1] = dval;
+                        }
+                        int n = Math.Min(xs.Count, ys.Count);
+                        if (n >= 2)
+                            block.polylines.Add((xs.Take(n).ToArray(), ys.Take(n).ToArray(), bulges.Take(n).ToArray(), D("38"), (I("70") & 1) != 0, I("62", 7)));
+                        break;
+                    }
+
+                    case "POLYLINE":
+                        polylineVertices = new List<(double x, double y, double z, double bulge)>(32);
+                        polylineClosed = (I("70") & 1) != 0;
+                        polylineColor = I("62", 7);
+                        break;
+
+                    case "VERTEX":
+                        polylineVertices?.Add((D("10"), D("20"), D("30"), D("42")));
+                        break;
+
+                    case "SEQEND":
+                        if (polylineVertices != null && polylineVertices.Count >= 2)
+                        {
+                            block.polylines.Add((polylineVertices.Select(v => v.x).ToArray(), polylineVertices.Select(v => v.y).ToArray(),
+                                polylineVertices.Select(v => v.bulge).ToArray(), polylineVertices[0].z, polylineClosed, polylineColor));
+                        }
+                        polylineVertices = null;
+                        break;
+
+                    case "SOLID":
+                        // SOLID corners run 1-2-4-3 around the outline
+                        block.faces.Add((new[] { D("10"), D("20"), D("30"), D("11"), D("21"), D("31"),
+                                                 D("13"), D("23"), D("33"), D("12"), D("22"), D("32") }, I("62", 7)));
+                        break;
+
+                    case "3DFACE":
+                        block.faces.Add((new[] { D("10"), D("20"), D("30"), D("11"), D("21"), D("31"),
+                                                 D("12"), D("22"), D("32"), D("13"), D("23"), D("33") }, I("62", 7)));
+                        break;
+
+                    case "INSERT":
+                        block.inserts.Add(ReadInsert(fields));
+                        break;
+                }
+            }
+
+            return blocks;
+        }
+
+        // ✅ Hands the parsed block definitions to the viewer; INSERTs then share one presentation per block
+        private static void DefineBlocks(IntPtr nativeHandle, List<BlockData> blocks)
+        {
+            foreach (var block in blocks)
+            {
+                if (!BlockTablePublic.BeginBlock(nativeHandle, block.name, block.baseX, block.baseY, block.baseZ))
+                    continue;
+
+                foreach (var l in block.lines)
+                {
+                    var (r, g, b) = AcadColorToRgb(l.color);
+                    BlockTablePublic.AddLine(nativeHandle, l.x1, l.y1, l.z1, l.x2, l.y2, l.z2, r, g, b);
+                }
+                foreach (var a in block.arcs)
+                {
+                    var (r, g, b) = AcadColorToRgb(a.color);
+                    BlockTablePublic.AddArc(nativeHandle, a.cx, a.cy, a.cz, a.r, a.startAngle, a.endAngle, r, g, b);
+                }
+                foreach (var p in block.polylines)
+                {
+                    var (r, g, b) = AcadColorToRgb(p.color);
+                    BlockTablePublic.AddPolyline(nativeHandle, p.x, p.y, p.bulge, p.elevation, p.closed, r, g, b);
+                }
+                foreach (var f in block.faces)
+                {
+                    var (r, g, b) = AcadColorToRgb(f.color);
+                    BlockTablePublic.AddFace(nativeHandle, f.corners, r, g, b);
+                }
+                foreach (var ins in block.inserts)
+                    BlockTablePublic.AddInsert(nativeHandle, ins.name, ins.x, ins.y, ins.z, ins.scaleX, ins.scaleY, ins.scaleZ, ins.rotationAngle);
+
+                BlockTablePublic.EndBlock(nativeHandle);
+            }
+        }
+
 
         // ✅ DXF Entity Parser
         private (
@@ -120,10 +343,15 @@ namespace Potacad.Helpers
         List<(double x, double y, int color)> pointsList,
         List<(double x1, double y1, double x2, double y2, int color, string linetype)> linesList,
         List<(double cx, double cy, double r, int color, string linetype)> circlesList,
-        List<(double x, double y, string value, double height, double rotation, int color)> textsList)
-        ParseDxfEntities(string filePath)
+        List<(double x, double y, string value, double height, double rotation, int color)> textsList,
+        List<BlockData> blocksList,
+        List<InsertData> insertsList,
+        Dictionary<string, List<string>> entityLayers)
+        ParseDxfEntities(string filePath, CancellationToken token = default)
         {
             var pairs = ReadDxfPairs(filePath);
+            var blocksList = ParseDxfBlocks(pairs);
+            var insertsList = new List<InsertData>(1024);
 
             var faces3DList = new List<(double, double, double, double, double, double, double, double, double, double, double, double, int)>(1024);
             var lwpolylinesList = new List<(List<(double x, double y, double bulge)> vertices, bool closed, int color)>(512);
@@ -144,10 +372,25 @@ namespace Potacad.Helpers
             var textsList = new List<(double, double, string, double, double, int)>(2048);
             var hatchList = new List<(List<(double x, double y)> boundaryPoints, int color, string patternName, bool isSolid)>(512);
 
+            // Layer (group code 8) of every parsed entity, per entity kind and in list order
+            var entityLayers = new Dictionary<string, List<string>>(StringComparer.OrdinalIgnoreCase);
+            void Tag(string kind, string layerName)
+            {
+                if (!entityLayers.TryGetValue(kind, out var layers))
+                    entityLayers[kind] = layers = new List<string>(1024);
+                layers.Add(string.IsNullOrEmpty(layerName) ? "0" : layerName);
+            }
+
             bool inEntities = false;
+            int nextCancelCheck = 0;    // entity readers advance i on their own; look at the token every 64K pairs
 
             for (int i = 0; i < pairs.Count; i++)
             {
+                if (i >= nextCancelCheck)
+                {
+                    token.ThrowIfCancellationRequested();
+                    nextCancelCheck = i + 0x10000;
+                }
                 var (code, value) = pairs[i];
 
                 // wait until ENTITIES
@@ -176,8 +419,10 @@ namespace Potacad.Helpers
                 double px = 0, py = 0, pz = 0;
                 string textValue = string.Empty;
                 int color = 7;
+                int attributeFlags = 0;
 
                 string linetype = "CONTINUOUS";
+                string layer = "0";
 
                 // --- POLYLINE special handling ---
                 if (entity == "POLYLINE")
@@ -223,12 +468,16 @@ namespace Potacad.Helpers
                         // flags or color for the polyline itself
                         if (c == "70" && int.TryParse(v, out int flag)) isClosed = (flag & 1) != 0;
                         else if (c == "62") int.TryParse(v, out localColor);
+                        else if (c == "8") layer = v;
 
                         i++;
                     }
 
                     if (currentVertices.Count > 0)
+                    {
                         polylinesList.Add((currentVertices, isClosed));
+                        Tag("POLYLINE", layer);
+                    }
 
                     i--; // so the outer for sees the right next record
                     continue;
@@ -277,12 +526,19 @@ namespace Potacad.Helpers
                         {
                             int.TryParse(v, out localColor);
                         }
+                        else if (c == "8")
+                        {
+                            layer = v;
+                        }
 
                         i++;
                     }
 
                     if (currentVertices.Count > 0)
+                    {
                         lwpolylinesList.Add((currentVertices, isClosed, localColor));
+                        Tag("LWPOLYLINE", layer);
+                    }
 
                     i--; // outer loop continues correctly
                     continue;
@@ -307,6 +563,7 @@ namespace Potacad.Helpers
                         if (c == "70") int.TryParse(v, out _); // spline flags (optional)
                         else if (c == "71") int.TryParse(v, out splineDegree); // spline degree
                         else if (c == "62") int.TryParse(v, out localColor);
+                        else if (c == "8") layer = v;
                         else if (c == "10")
                         {
                             double.TryParse(v, NumberStyles.Float, CultureInfo.InvariantCulture, out double x);
@@ -330,6 +587,7 @@ namespace Potacad.Helpers
                     if (controlPoints.Count > 0)
                     {
                         splinesList.Add((controlPoints, localColor, splineDegree));
+                        Tag("SPLINE", layer);
                     }
 
                     i--; // backtrack to let main loop proceed correctly
@@ -356,16 +614,39 @@ namespace Potacad.Helpers
                         else if (c == "50") double.TryParse(v, NumberStyles.Float, CultureInfo.InvariantCulture, out rotationAngle); // Rotation angle
                         else if (c == "62") int.TryParse(v, out color); // Color
                         else if (c == "6") linetype = v; // Line type
+                        else if (c == "8") layer = v; // Layer
 
                         i++;
                     }
 
                     // Add the parsed ellipse data to the ellipsesList
                     ellipsesList.Add((cx, cy, semiMajor, semiMinor, rotationAngle, color, linetype));
+                    Tag("ELLIPSE", layer);
                     i--; // so the outer loop sees the right next record
                     continue;
                 }
 
+                // --- INSERT: a block reference, kept whole instead of exploded ---
+                if (entity == "INSERT")
+                {
+                    var fields = new List<(string code, string value)>(16);
+                    for (++i; i < pairs.Count && pairs[i].Item1 != "0"; i++)
+                    {
+                        if (pairs[i].Item1 == "8") layer = pairs[i].Item2;
+                        fields.Add(pairs[i]);
+                    }
+
+                    var insert = ReadInsert(fields);
+                    if (insert.name.Length > 0)
+                    {
+                        insertsList.Add(insert);
+                        Tag("INSERT", layer);
+                    }
+
+                    i--; // so the outer loop sees the ATTRIBs or next entity
+                    continue;
+                }
+
                 // ---------------- DIMENSION ----------------
                 if (entity == "DIMENSION")
                 {
@@ -633,6 +914,8 @@ namespace Potacad.Helpers
                     var (c, v) = pairs[i];
                     if (c == "0") { i--; break; }
 
+                    if (c == "8") { layer = v; continue; }
+
                     double dval = 0; int ival = 0;
                     double.TryParse(v, NumberStyles.Float, CultureInfo.InvariantCulture, out dval);
                     int.TryParse(v, out ival);
@@ -708,6 +991,16 @@ namespace Potacad.Helpers
                             else if (c == "62") color = ival;
                             break;
 
+                        case "ATTRIB":
+                            if (c == "10") tx = dval;
+                            else if (c == "20") ty = dval;
+                            else if (c == "1") textValue = v;
+                            else if (c == "40") height = dval;
+                            else if (c == "50") rotation = dval;
+                            else if (c == "62") color = ival;
+                            else if (c == "70") attributeFlags = ival;
+                            break;
+
                         case "BYBLOCK":
                             if (c == "10") x1 = dval;
                             else if (c == "20") y1 = dval;
@@ -730,30 +1023,47 @@ namespace Potacad.Helpers
                 {
                     case "3DFACE":
                         faces3DList.Add((x1, y1, z1, x2, y2, z2, x3, y3, z3, x4, y4, z4, color));
+                        Tag(entity, layer);
                         break;
                     case "SOLID":
                         solidsList.Add((x1, y1, x2, y2, x3, y3, x4, y4, color));
+                        Tag(entity, layer);
                         break;
                     case "ARC":
                         arcsList.Add((cx, cy, r, startAngle, endAngle, color, linetype));
+                        Tag(entity, layer);
                         break;
                     case "POINT":
                         pointsList.Add((px, py, color));
+                        Tag(entity, layer);
                         break;
                     case "LINE":
                         linesList.Add((x1, y1, x2, y2, color, linetype));
+                        Tag(entity, layer);
                         break;
                     case "CIRCLE":
                         circlesList.Add((cx, cy, r, color, linetype));
+                        Tag(entity, layer);
                         break;
                     case "TEXT":
                         textsList.Add((tx, ty, textValue, height, rotation, color));
+                        Tag(entity, layer);
+                        break;
+                    case "ATTRIB":
+                        // Attribute values of an INSERT show as plain text; flag 1 hides them
+                        if ((attributeFlags & 1) == 0 && textValue.Length > 0)
+                        {
+                            textsList.Add((tx, ty, textValue, height, rotation, color));
+                            Tag("TEXT", layer);
+                        }
                         break;
                     case "BYBLOCK":
                         byBlocksList.Add((x1, y1, x2, y2, color));
+                        Tag(entity, layer);
                         break;
                     case "VERTEX":
                         verticesList.Add((x1, y1, pz, color));
+                        Tag(entity, layer);
                         break;
                 }
             }
@@ -776,7 +1086,10 @@ namespace Potacad.Helpers
                 pointsList,
                 linesList,
                 circlesList,
-                textsList);
+                textsList,
+                blocksList,
+                insertsList,
+                entityLayers);
         }
 
 
@@ -843,13 +1156,43 @@ namespace Potacad.Helpers
         #endregion
 
 
-        // ✅ Load DXF and draw
+        // ✅ Build pending selection primitives while the UI is idle, a few ms at a time; stops once another file is opened
+        private static async Task BuildDeferredSelectionAsync(IntPtr nativeHandle, CancellationToken token)
+        {
+            if (nativeHandle == IntPtr.Zero) return;
+
+            int remaining;
+            do
+            {
+                remaining = await Application.Current.Dispatcher.InvokeAsync(
+                    () => token.IsCancellationRequested ? 0 : SelectionHelperPublic.ActivatePendingSelection(nativeHandle, 8),
+                    DispatcherPriority.ApplicationIdle);
+            }
+            while (remaining > 0);
+        }
+
+        // The most recent load; opening another file cancels it wherever it is (parse, drawing, deferred selection)
+        private static CancellationTokenSource? currentLoad;
+
+        // Completes once that load has unwound; the next one waits for it before clearing the scene
+        private static Task currentLoadDone = Task.CompletedTask;
+
+        // ✅ Load DXF and draw: extents first, then a first frame of the large geometry, then the rest tile by tile
         public async Task LoadDxfAsync(string filePath)
         {
             if (viewer == null) return; // viewer not ready yet
 
             if (string.IsNullOrEmpty(filePath) || !File.Exists(filePath)) return;
 
+            var load = new CancellationTokenSource();
+            var done = new TaskCompletionSource<bool>();
+            var previous = currentLoad;
+            var previousDone = currentLoadDone;
+            currentLoad = load;
+            currentLoadDone = done.Task;
+            previous?.Cancel();
+            CancellationToken token = load.Token;
+
             try
             {
                 // parse on background thread
@@ -871,7 +1214,17 @@ namespace Potacad.Helpers
                     pointsList,
                     linesList,
                     circlesList,
-                    textsListRaw) = await Task.Run(() => ParseDxfEntities(filePath));
+                    textsListRaw,
+                    blocksList,
+                    insertsList,
+                    entityLayers) = await Task.Run(() => ParseDxfEntities(filePath, token), token);
+                token.ThrowIfCancellationRequested();
+
+                // The cancelled load may still be inside a draw; let it stop before its shapes are cleared
+                await previousDone;
+                previous?.Dispose();
+                previous = null;
+                token.ThrowIfCancellationRequested();
 
                 // make sure viewer is present
                 if (viewer == null || viewer.NativeHandle == IntPtr.Zero) return;
@@ -880,167 +1233,144 @@ namespace Potacad.Helpers
                 if (viewer?.NativeHandle != IntPtr.Zero)
                     ClearAllShapes(viewer.NativeHandle);
 
-                _dxfShapeDict.Clear(); // <— clear previous IDs
+                // the batches below each ask for a redraw; let them share frames
+                MouseActions.DriveFrames(viewer.NativeHandle);
 
-                // Batch and draw ByBlock entities
-                if (byBlocksList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(byBlocksList, async (batch) =>
-                    {
-                        var byBlockBatch = batch.Select(b => (b.x1, b.y1, 0.0, b.x2, b.y2, 0.0, b.color)).ToList();
-                        await ByBlock(viewer, byBlockBatch);
-                    });
-                }
+                _dxfShapeDict.Clear(); // <— clear previous IDs
 
-                // Batch and draw polylines
-                if (verticesList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(verticesList, async (batch) =>
-                    {
-                        var vertexBatch = batch.Select(v => (v.x, v.y, 0.0, 0.0, 0.0, 0.0, v.color)).ToList();
-                        await Vertex(viewer, vertexBatch);  // Replace with actual method for drawing vertices
-                    });
+                // Each kind is drawn one layer at a time; the viewer files what it displays under the current layer
+                List<string>? LayersOf(string kind) => entityLayers.TryGetValue(kind, out var layers) ? layers : null;
+                IntPtr nativeHandle = viewer.NativeHandle;
 
-                }
+                var allDimensions = DimensionBuilder.BuildAllDimensions(linearDimensionsList, radialDimensionsList, diameterDimensionsList, angularDimensionsList);
 
-                foreach (var (vertices, closed) in polylinesList)
-                {
-                    await Polyline(viewer, vertices, closed);
-                }
+                // --- Draw HATCH entities ---
+                // (hatchList is parsed but not drawn yet)
 
-                // --- Draw LWPOLYLINEs ---
-                if (lwpolylinesList?.Count > 0)
+                // Kinds in stacking order; every pass below keeps this order
+                var kinds = new List<IProgressiveKind>
                 {
-                    foreach (var (vertices, closed, color) in lwpolylinesList)
-                    {
-                        // Merge outer color into vertices if the inner color is not already set
-                        var lwVerticesWithColor = vertices
-                            .Select(v => (v.x, v.y, 0.0, v.bulge, color))
-                            .ToList();
-
-                        await LwPolyline(viewer, lwVerticesWithColor, closed);
-                    }
-                }
+                    new ProgressiveKind<(double x1, double y1, double x2, double y2, int color)>(byBlocksList, LayersOf("BYBLOCK"),
+                        b => DrawingExtents.Of(b.x1, b.y1, b.x2, b.y2),
+                        async (batch) =>
+                        {
+                            var byBlockBatch = batch.Select(b => (b.x1, b.y1, 0.0, b.x2, b.y2, 0.0, b.color)).ToList();
+                            await ByBlock(viewer, byBlockBatch);
+                        }),
 
-                // Batch and draw solids
-                if (solidsList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(solidsList, async (batch) =>
-                    {
-                        await Solid(viewer, batch);
-                    });
-                }
+                    new ProgressiveKind<(double x, double y, double z, int color)>(verticesList, LayersOf("VERTEX"),
+                        v => DrawingExtents.Of(v.x, v.y),
+                        async (batch) =>
+                        {
+                            var vertexBatch = batch.Select(v => (v.x, v.y, 0.0, 0.0, 0.0, 0.0, v.color)).ToList();
+                            await Vertex(viewer, vertexBatch);
+                        }),
 
-                // Batch and draw arcs
-                if (arcsList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(arcsList, async (batch) =>
-                    {
-                        await Arc(viewer, batch);
-                    });
-                }
+                    new ProgressiveKind<(List<(double x, double y, double z, int color)> vertices, bool closed)>(polylinesList, LayersOf("POLYLINE"),
+                        p => DrawingExtents.Of(p.vertices.Select(v => (v.x, v.y))),
+                        async (batch) =>
+                        {
+                            foreach (var (vertices, closed) in batch)
+                                await Polyline(viewer, vertices, closed);
+                        }),
 
-                // Batch and draw points
-                if (pointsList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(pointsList, async (batch) =>
-                    {
-                        await Point(viewer, batch);
-                    });
-                }
+                    new ProgressiveKind<(List<(double x, double y, double bulge)> vertices, bool closed, int color)>(lwpolylinesList, LayersOf("LWPOLYLINE"),
+                        p => DrawingExtents.Of(p.vertices.Select(v => (v.x, v.y))),
+                        async (batch) =>
+                        {
+                            foreach (var (vertices, closed, color) in batch)
+                            {
+                                // Merge outer color into vertices if the inner color is not already set
+                                var lwVerticesWithColor = vertices
+                                    .Select(v => (v.x, v.y, 0.0, v.bulge, color))
+                                    .ToList();
 
-                // Batch and draw lines
-                if (linesList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(linesList, async (batch) =>
-                    {
-                        await Line(viewer, batch);
-                    });
-                }
+                                await LwPolyline(viewer, lwVerticesWithColor, closed);
+                            }
+                        }),
 
-                // Batch and draw circles
-                if (circlesList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(circlesList, async (batch) =>
-                    {
-                        await Circle(viewer, batch);
-                    });
-                }
+                    new ProgressiveKind<(double x1, double y1, double x2, double y2, double x3, double y3, double x4, double y4, int color)>(solidsList, LayersOf("SOLID"),
+                        s => DrawingExtents.Of(s.x1, s.y1, s.x2, s.y2, s.x3, s.y3, s.x4, s.y4),
+                        async (batch) => await Solid(viewer, batch)),
 
-                // --- Batch and Draw Ellipses ---
-                if (ellipsesList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(ellipsesList, async (batch) =>
-                    {
-                        await Ellipse(viewer, batch);
-                    });
-                }
+                    new ProgressiveKind<(double cx, double cy, double r, double startAngle, double endAngle, int color, string linetype)>(arcsList, LayersOf("ARC"),
+                        a => DrawingExtents.Around(a.cx, a.cy, a.r),
+                        async (batch) => await Arc(viewer, batch)),
 
-                // --- Draw SPLINES ---
-                if (splinesList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(splinesList, async (batch) =>
-                    {
-                        // Handle drawing of splines here
-                        foreach (var (controlPoints, color, degree) in batch)
-                        {
-                            // Assuming `DrawSpline` is a method to draw splines that takes control points, color, and degree
-                            await Spline(viewer, controlPoints, color, degree);
-                        }
-                    });
-                }
+                    new ProgressiveKind<(double x, double y, int color)>(pointsList, LayersOf("POINT"),
+                        p => DrawingExtents.Of(p.x, p.y),
+                        async (batch) => await Point(viewer, batch)),
 
-                // --- Draw HATCH entities ---
-                if (hatchList?.Count > 0)
-                {
-                    //await DrawEntitiesBatch(hatchList, async (batch) =>
-                    //{
-                    //    foreach (var (boundaryPoints, color, patternName, isSolid) in batch)
-                    //    {
-                    //        await Hatch(viewer, new List<List<(double x, double y)>> { boundaryPoints }, color, patternName, isSolid);
-                    //    }
-
-                    //});
-                }
+                    new ProgressiveKind<(double x1, double y1, double x2, double y2, int color, string linetype)>(linesList, LayersOf("LINE"),
+                        l => DrawingExtents.Of(l.x1, l.y1, l.x2, l.y2),
+                        async (batch) => await Line(viewer, batch)),
 
-                // Batch and draw circles
-                if (faces3DList?.Count > 0)
-                {
-                    await DrawEntitiesBatch(faces3DList, async (batch) =>
-                    {
-                        await Faces3D(viewer, batch);
-                    });
-                }
+                    new ProgressiveKind<(double cx, double cy, double r, int color, string linetype)>(circlesList, LayersOf("CIRCLE"),
+                        c => DrawingExtents.Around(c.cx, c.cy, c.r),
+                        async (batch) => await Circle(viewer, batch)),
 
-                // --- Draw Dimensions ---
-                var allDimensions = DimensionBuilder.BuildAllDimensions(linearDimensionsList, radialDimensionsList, diameterDimensionsList, angularDimensionsList);
-                foreach (var dim in allDimensions)
-                    await Dimension(viewer, new List<DimensionItem> { dim });
+                    new ProgressiveKind<(double cx, double cy, double semiMajor, double semiMinor, double rotationAngle, int color, string linetype)>(ellipsesList, LayersOf("ELLIPSE"),
+                        e => DrawingExtents.Around(e.cx, e.cy, e.semiMajor),
+                        async (batch) => await Ellipse(viewer, batch)),
 
+                    new ProgressiveKind<(List<(double x, double y, double z)> controlPoints, int color, int degree)>(splinesList, LayersOf("SPLINE"),
+                        s => DrawingExtents.Of(s.controlPoints.Select(p => (p.x, p.y))),
+                        async (batch) =>
+                        {
+                            foreach (var (controlPoints, color, degree) in batch)
+                                await Spline(viewer, controlPoints, color, degree);
+                        }),
+
+                    // INSERTs: each block is built once, every reference is a light instance of it.
+                    // Block contents are not measured; an insert counts for its insertion point and array span.
+                    new ProgressiveKind<InsertData>(insertsList, LayersOf("INSERT"),
+                        ins => DrawingExtents.Of(ins.x, ins.y,
+                            ins.x + (ins.columns - 1) * ins.columnSpacing, ins.y + (ins.rows - 1) * ins.rowSpacing),
+                        (batch) =>
+                        {
+                            foreach (var ins in batch)
+                            {
+                                BlockTablePublic.Insert(nativeHandle, ins.name, ins.x, ins.y, ins.z,
+                                    ins.scaleX, ins.scaleY, ins.scaleZ, ins.rotationAngle,
+                                    ins.columns, ins.rows, ins.columnSpacing, ins.rowSpacing);
+                            }
+                            return Task.CompletedTask;
+                        }),
 
+                    new ProgressiveKind<(double x1, double y1, double z1, double x2, double y2, double z2, double x3, double y3, double z3, double x4, double y4, double z4, int color)>(faces3DList, LayersOf("3DFACE"),
+                        f => DrawingExtents.Of(f.x1, f.y1, f.x2, f.y2, f.x3, f.y3, f.x4, f.y4),
+                        async (batch) => await Faces3D(viewer, batch)),
 
-                // --- Batch Draw ---
-                if (allDimensions.Count > 0)
-                {
-                    await DrawEntitiesBatch(allDimensions, async (batch) =>
-                    {
-                        foreach (var dim in batch)
+                    // Dimensions carry no layer of their own and stay on "0"
+                    new ProgressiveKind<DimensionItem>(allDimensions, null,
+                        d => DrawingExtents.Of(d.StartX, d.StartY, d.EndX, d.EndY, d.LeaderX, d.LeaderY),
+                        async (batch) =>
                         {
-                            await Dimension(viewer, new List<DimensionItem> { dim });
-                        }
-                    });
-                }
-
-                // --- Prepare Texts for DrawTextBatch ---
-                if (textsListRaw?.Count > 0 && viewer?.NativeHandle != IntPtr.Zero)
+                            foreach (var dim in batch)
+                                await Dimension(viewer, new List<DimensionItem> { dim });
+                        }),
+
+                    new ProgressiveKind<(double x, double y, string value, double height, double rotation, int color)>(textsListRaw, LayersOf("TEXT"),
+                        t => DrawingExtents.Around(t.x, t.y, t.height * Math.Max(t.value?.Length ?? 0, 1)),
+                        async (batch) => await Text(viewer, batch)),
+                };
+
+                // ✅ Frame the whole drawing before the first entity arrives, so streamed geometry lands in place
+                var extents = ExtentsOf(kinds);
+                if (!extents.IsEmpty && viewer?.ViewPtr != IntPtr.Zero)
                 {
-                    await DrawEntitiesBatch(textsListRaw, async (batch) =>
-                    {
-                        await Text(viewer, batch);
-                    });
+                    double margin = extents.Size > 0 ? 0.0 : 1.0;
+                    ViewHelperPublic.FrameExtents(viewer.ViewPtr,
+                        extents.MinX - margin, extents.MinY - margin, extents.MaxX + margin, extents.MaxY + margin);
                 }
 
+                if (insertsList?.Count > 0)
+                    DefineBlocks(nativeHandle, blocksList);
+
+                await DrawProgressiveAsync(nativeHandle, kinds, extents, token);
+
                 await Attach(HostPanel, viewer);
+                token.ThrowIfCancellationRequested();
 
                 if (viewer?.ViewPtr != IntPtr.Zero)
                 {
@@ -1058,15 +1388,35 @@ namespace Potacad.Helpers
 
                         SetShaded(viewer.NativeHandle);
                     });
+                    token.ThrowIfCancellationRequested();
+
+                    // Imported entities were displayed without selection primitives; build them in idle slices
+                    _ = BuildDeferredSelectionAsync(viewer.NativeHandle, token);
                 }
             }
+            catch (OperationCanceledException) when (token.IsCancellationRequested)
+            {
+                // Another file was opened; its load clears whatever this one drew
+                Console.WriteLine($"⚠️ DXF load cancelled: {filePath}");
+            }
             finally
             {
-                await Application.Current.Dispatcher.InvokeAsync(() =>
+                try
                 {
-                    loadingOverlay.Visible = false;
-                    ShapeDrawer.ResetView(viewer.NativeHandle);
-                });
+                    // A superseded load leaves the overlay and the camera to the load that replaced it
+                    if (currentLoad == load)
+                    {
+                        await Application.Current.Dispatcher.InvokeAsync(() =>
+                        {
+                            loadingOverlay.Visible = false;
+                            ShapeDrawer.ResetView(viewer.NativeHandle);
+                        });
+                    }
+                }
+                finally
+                {
+                    done.SetResult(true);
+                }
             }
         }
     }
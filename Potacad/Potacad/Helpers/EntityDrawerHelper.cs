@@ -2,8 +2,11 @@
 using System;
 using System.Collections.Generic;
 using System.IO;
+using System.Diagnostics;
 using System.Linq;
+using System.Threading;
 using System.Threading.Tasks;
+using System.Windows.Threading;
 using static Potacad.Helpers.DxfHelper;
 namespace Potacad.Helpers
 {
@@ -53,8 +56,43 @@ namespace Potacad.Helpers
             return Inner().GetEnumerator();
         }
 
-        // A method to handle batching and drawing
-        public static async Task DrawEntitiesBatch<T>(List<T> entitiesList, Func<List<T>, Task> drawBatchFunc)
+        // Draws a parsed list grouped by layer, in first-seen layer order; entities stay batched within a layer.
+        // Without a matching layer list everything goes to layer "0".
+        public static async Task DrawEntitiesByLayer<T>(IntPtr nativeHandle, List<T> entitiesList, List<string>? layers, Func<List<T>, Task> drawBatchFunc,
+            CancellationToken token = default)
+        {
+            if (layers == null || layers.Count != entitiesList.Count)
+            {
+                LayerTablePublic.SetCurrentLayer(nativeHandle, "0");
+                await DrawEntitiesBatch(entitiesList, drawBatchFunc, token);
+                return;
+            }
+
+            var groups = new Dictionary<string, List<T>>(StringComparer.OrdinalIgnoreCase);
+            var order = new List<string>();
+            for (int i = 0; i < entitiesList.Count; i++)
+            {
+                if (!groups.TryGetValue(layers[i], out var group))
+                {
+                    groups[layers[i]] = group = new List<T>();
+                    order.Add(layers[i]);
+                }
+                group.Add(entitiesList[i]);
+            }
+
+            foreach (var name in order)
+            {
+                LayerTablePublic.SetCurrentLayer(nativeHandle, name);
+                await DrawEntitiesBatch(groups[name], drawBatchFunc, token);
+                token.ThrowIfCancellationRequested();
+            }
+
+            // Entities drawn without a layer of their own (dimensions, interactive drawing) stay on "0"
+            LayerTablePublic.SetCurrentLayer(nativeHandle, "0");
+        }
+
+        // A method to handle batching and drawing; a cancelled token stops it as soon as the current batch is drawn
+        public static async Task DrawEntitiesBatch<T>(List<T> entitiesList, Func<List<T>, Task> drawBatchFunc, CancellationToken token = default)
         {
             var batch = new List<T>(BatchSize);
 
@@ -63,18 +101,226 @@ namespace Potacad.Helpers
                 batch.Add(entity);
                 if (batch.Count >= BatchSize)
                 {
+                    token.ThrowIfCancellationRequested();
                     await drawBatchFunc(batch);  // Call drawing method
+                    token.ThrowIfCancellationRequested();
                     batch.Clear();  // Clear the batch
                     await Task.Yield();  // Yield for UI update
+                    token.ThrowIfCancellationRequested();
                 }
             }
 
             // Handle any remaining items
             if (batch.Count > 0)
             {
+                token.ThrowIfCancellationRequested();
                 await drawBatchFunc(batch);
+                token.ThrowIfCancellationRequested();
+            }
+        }
+
+        // ============================================================
+        #region --- Progressive Drawing ---
+        // ============================================================
+
+        private const int FirstFrameBudgetMs = 150;     // time allowed for the large geometry before the first frame
+        private const int FirstFrameChunk = 256;        // entities drawn between two looks at the clock
+        private const double LargeEntityRatio = 1.0 / 64.0; // share of the drawing size that makes an entity "large"
+        private const int TileGrid = 8;                 // the rest streams in TileGrid x TileGrid tiles
+
+        // ✅ XY bounds of parsed entities; starts empty and ignores non-finite coordinates
+        public struct DrawingExtents
+        {
+            public double MinX, MinY, MaxX, MaxY;
+
+            public static DrawingExtents Empty => new DrawingExtents
+            {
+                MinX = double.MaxValue, MinY = double.MaxValue, MaxX = double.MinValue, MaxY = double.MinValue
+            };
+
+            // Coordinates as x, y pairs
+            public static DrawingExtents Of(params double[] xy)
+            {
+                var box = Empty;
+                for (int i = 0; i + 1 < xy.Length; i += 2)
+                    box.Add(xy[i], xy[i + 1]);
+                return box;
+            }
+
+            public static DrawingExtents Of(IEnumerable<(double x, double y)> points)
+            {
+                var box = Empty;
+                foreach (var (x, y) in points)
+                    box.Add(x, y);
+                return box;
+            }
+
+            public static DrawingExtents Around(double x, double y, double radius)
+            {
+                var box = Empty;
+                box.Add(x - radius, y - radius);
+                box.Add(x + radius, y + radius);
+                return box;
+            }
+
+            public bool IsEmpty => MinX > MaxX || MinY > MaxY;
+            public double Size => IsEmpty ? 0.0 : Math.Max(MaxX - MinX, MaxY - MinY);
+            public double CenterX => (MinX + MaxX) * 0.5;
+            public double CenterY => (MinY + MaxY) * 0.5;
+
+            public void Add(double x, double y)
+            {
+                if (double.IsNaN(x) || double.IsInfinity(x) || double.IsNaN(y) || double.IsInfinity(y)) return;
+                MinX = Math.Min(MinX, x); MinY = Math.Min(MinY, y);
+                MaxX = Math.Max(MaxX, x); MaxY = Math.Max(MaxY, y);
+            }
+
+            public void Add(DrawingExtents other)
+            {
+                if (other.IsEmpty) return;
+                Add(other.MinX, other.MinY);
+                Add(other.MaxX, other.MaxY);
+            }
+        }
+
+        // One parsed entity kind, drawn in whatever order the progressive passes pick
+        public interface IProgressiveKind
+        {
+            int Count { get; }
+            DrawingExtents Extents { get; }
+            DrawingExtents BoxOf(int index);
+            Task DrawAsync(IntPtr nativeHandle, List<int> indices, CancellationToken token);
+        }
+
+        public sealed class ProgressiveKind<T> : IProgressiveKind
+        {
+            private readonly List<T> entities;
+            private readonly List<string>? layers;
+            private readonly Func<List<T>, Task> drawBatchFunc;
+            private readonly DrawingExtents[] boxes;
+
+            public ProgressiveKind(List<T>? entities, List<string>? layers, Func<T, DrawingExtents> boxOf, Func<List<T>, Task> drawBatchFunc)
+            {
+                this.entities = entities ?? new List<T>();
+                this.layers = layers != null && layers.Count == this.entities.Count ? layers : null;
+                this.drawBatchFunc = drawBatchFunc;
+
+                boxes = new DrawingExtents[this.entities.Count];
+                var extents = DrawingExtents.Empty;
+                for (int i = 0; i < boxes.Length; i++)
+                {
+                    boxes[i] = boxOf(this.entities[i]);
+                    extents.Add(boxes[i]);
+                }
+                Extents = extents;
+            }
+
+            public int Count => entities.Count;
+            public DrawingExtents Extents { get; }
+            public DrawingExtents BoxOf(int index) => boxes[index];
+
+            public Task DrawAsync(IntPtr nativeHandle, List<int> indices, CancellationToken token)
+            {
+                if (indices.Count == 0) return Task.CompletedTask;
+
+                var subset = new List<T>(indices.Count);
+                var subsetLayers = layers != null ? new List<string>(indices.Count) : null;
+                foreach (int i in indices)
+                {
+                    subset.Add(entities[i]);
+                    subsetLayers?.Add(layers![i]);
+                }
+                return DrawEntitiesByLayer(nativeHandle, subset, subsetLayers, drawBatchFunc, token);
+            }
+        }
+
+        public static DrawingExtents ExtentsOf(IEnumerable<IProgressiveKind> kinds)
+        {
+            var extents = DrawingExtents.Empty;
+            foreach (var kind in kinds)
+                extents.Add(kind.Extents);
+            return extents;
+        }
+
+        // ✅ Draws every kind in two passes and lets a frame through after each step:
+        //    1. the largest entities, biggest first, until FirstFrameBudgetMs is spent;
+        //    2. everything else, one spatial tile at a time from the drawing centre outwards.
+        //    Within a step kinds keep their list order, so what overlaps still stacks as in a plain load.
+        public static async Task DrawProgressiveAsync(IntPtr nativeHandle, IReadOnlyList<IProgressiveKind> kinds, DrawingExtents extents,
+            CancellationToken token)
+        {
+            if (extents.IsEmpty) extents = DrawingExtents.Around(0, 0, 1);
+            var drawn = kinds.Select(k => new bool[k.Count]).ToArray();
+
+            // --- Pass 1: large geometry within the time budget ---
+            double largeSize = extents.Size * LargeEntityRatio;
+            var large = new List<(int kind, int index, double size)>();
+            for (int k = 0; k < kinds.Count; k++)
+            {
+                for (int i = 0; i < kinds[k].Count; i++)
+                {
+                    double size = kinds[k].BoxOf(i).Size;
+                    if (size >= largeSize) large.Add((k, i, size));
+                }
+            }
+            large.Sort((a, b) => b.size.CompareTo(a.size));
+
+            var clock = Stopwatch.StartNew();
+            for (int start = 0; start < large.Count && clock.ElapsedMilliseconds < FirstFrameBudgetMs; start += FirstFrameChunk)
+            {
+                var chunk = large.GetRange(start, Math.Min(FirstFrameChunk, large.Count - start));
+                for (int k = 0; k < kinds.Count; k++)
+                {
+                    var indices = chunk.Where(e => e.kind == k).Select(e => e.index).OrderBy(i => i).ToList();
+                    await kinds[k].DrawAsync(nativeHandle, indices, token);
+                    token.ThrowIfCancellationRequested();
+                    foreach (int i in indices) drawn[k][i] = true;
+                }
+            }
+            Console.WriteLine($"✅ First frame: {drawn.Sum(d => d.Count(x => x))} of {kinds.Sum(k => k.Count)} entities in {clock.ElapsedMilliseconds} ms");
+            await Dispatcher.Yield(DispatcherPriority.Background);
+            token.ThrowIfCancellationRequested();
+
+            // --- Pass 2: the rest by tile, nearest to the centre first ---
+            double cellX = Math.Max(extents.MaxX - extents.MinX, 1e-9) / TileGrid;
+            double cellY = Math.Max(extents.MaxY - extents.MinY, 1e-9) / TileGrid;
+            int TileOf(DrawingExtents box)
+            {
+                if (box.IsEmpty) return 0;
+                int col = Math.Min(Math.Max((int)((box.CenterX - extents.MinX) / cellX), 0), TileGrid - 1);
+                int row = Math.Min(Math.Max((int)((box.CenterY - extents.MinY) / cellY), 0), TileGrid - 1);
+                return row * TileGrid + col;
+            }
+
+            var tiles = new List<int>[kinds.Count, TileGrid * TileGrid];
+            for (int k = 0; k < kinds.Count; k++)
+            {
+                for (int i = 0; i < kinds[k].Count; i++)
+                {
+                    if (drawn[k][i]) continue;
+                    int tile = TileOf(kinds[k].BoxOf(i));
+                    (tiles[k, tile] ??= new List<int>()).Add(i);
+                }
+            }
+
+            double middle = (TileGrid - 1) * 0.5;
+            var tileOrder = Enumerable.Range(0, TileGrid * TileGrid)
+                .OrderBy(t => Math.Pow(t % TileGrid - middle, 2) + Math.Pow(t / TileGrid - middle, 2));
+            foreach (int tile in tileOrder)
+            {
+                bool any = false;
+                for (int k = 0; k < kinds.Count; k++)
+                {
+                    if (tiles[k, tile] == null) continue;
+                    await kinds[k].DrawAsync(nativeHandle, tiles[k, tile], token);
+                    token.ThrowIfCancellationRequested();
+                    any = true;
+                }
+                if (any) await Dispatcher.Yield(DispatcherPriority.Background);
+                token.ThrowIfCancellationRequested();
             }
         }
+        #endregion
         // ----- Color mapper -----
         public static (byte r, byte g, byte b) AcadColorToRgb(int index)
         {
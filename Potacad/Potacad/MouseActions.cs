@@ -1,5 +1,6 @@
 ﻿using PotaOCC;
 using System;
+using System.Collections.Generic;
 using System.Drawing;
 using System.Threading.Tasks;
 using System.Windows.Forms;
@@ -215,6 +216,71 @@ namespace Potacad
         #endregion
 
 
+        #region 🔹 Boolean Progress
+        private static readonly HashSet<IntPtr> booleanWatchers = new();
+
+        // ✅ Booleans run on a native worker thread; poll on the UI thread until the result is swapped in (one watcher per viewer)
+        private static async Task WatchBooleanAsync(IntPtr nativeHandle)
+        {
+            if (nativeHandle == IntPtr.Zero || !booleanWatchers.Add(nativeHandle)) return;
+
+            try
+            {
+                while (ShapeBooleanOperatorPublic.PollBoolean(nativeHandle) >= 0)
+                    await Task.Delay(50);
+            }
+            finally
+            {
+                booleanWatchers.Remove(nativeHandle);
+            }
+            await PumpMeshingAsync(nativeHandle);
+        }
+        #endregion
+
+        #region 🔹 Background Meshing
+        private static readonly HashSet<IntPtr> meshPumps = new();
+
+        // ✅ Solids show a coarse mesh first; move sharper meshes in as the native workers finish them (one pump per viewer)
+        private static async Task PumpMeshingAsync(IntPtr nativeHandle)
+        {
+            if (nativeHandle == IntPtr.Zero || !meshPumps.Add(nativeHandle)) return;
+
+            try
+            {
+                while (MeshingServicePublic.Update(nativeHandle) > 0)
+                    await Task.Delay(100);
+            }
+            finally
+            {
+                meshPumps.Remove(nativeHandle);
+            }
+        }
+        #endregion
+
+        #region 🔹 Frame Scheduling
+        private static readonly Dictionary<IntPtr, EventHandler> frameSources = new();
+
+        // ✅ Redraw requests only mark the viewer dirty; draw at most one frame per display refresh
+        public static void DriveFrames(IntPtr nativeHandle)
+        {
+            if (nativeHandle == IntPtr.Zero || frameSources.ContainsKey(nativeHandle)) return;
+
+            EventHandler onRendering = (_, _) => FrameSchedulerPublic.Present(nativeHandle);
+            frameSources[nativeHandle] = onRendering;
+            System.Windows.Media.CompositionTarget.Rendering += onRendering;
+        }
+
+        // ✅ Back to drawing at once; call before the viewer is disposed
+        public static void StopFrames(IntPtr nativeHandle)
+        {
+            if (!frameSources.TryGetValue(nativeHandle, out var onRendering)) return;
+
+            System.Windows.Media.CompositionTarget.Rendering -= onRendering;
+            frameSources.Remove(nativeHandle);
+            FrameSchedulerPublic.Detach(nativeHandle);
+        }
+        #endregion
+
         #region 🔹 Attach Mouse Events
         //public static async Task Attach(Panel panel, ViewerHandle viewer, EnvSousahouhouModel model)
         public static async Task Attach(Panel panel, ViewerHandle viewer)
@@ -222,6 +288,10 @@ namespace Potacad
             // enable face selection once at attach time
             ShapeDrawer.ActivateFaceSelection(viewer.NativeHandle);
 
+            // coalesce redraws into one frame per display refresh
+            DriveFrames(viewer.NativeHandle);
+            panel.Disposed += (_, _) => StopFrames(viewer.NativeHandle);
+
             Rectangle rubberBand = Rectangle.Empty;
             bool isDragging = false;
 
@@ -266,6 +336,8 @@ namespace Potacad
                 if (IsLeftButtonClick(e.Button))
                 {
                     OnMouseUp(viewer.NativeHandle, e.X, e.Y, panel.Height, panel.Width);
+                    _ = WatchBooleanAsync(viewer.NativeHandle);
+                    _ = PumpMeshingAsync(viewer.NativeHandle);
                 }
 
                 ResetMouseFlags(mouseState);
@@ -275,6 +347,7 @@ namespace Potacad
             panel.MouseWheel += (_, e) =>
             {
                 HandleMouseWheel(viewer, e, mouseState);
+                _ = PumpMeshingAsync(viewer.NativeHandle);
             };
             panel.MouseEnter += (s, e) => panel.Focus();
 